@@ -0,0 +1,237 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include "bench.h"
+#include "xDispatch.h"
+
+struct BenchOptions {
+	const char* filter;
+	const char* json_path;
+	const char* tag;
+	int samples;
+	double sample_ms;
+};
+
+struct BenchResult {
+	const Benchmark* benchmark;
+	size_t iterations;
+	double ns_min;
+	double ns_p10;
+	double ns_median;
+	double ns_p90;
+	double ns_max;
+	double cycles_median;
+	double gbps_median;
+	double items_per_s_median;
+};
+
+static std::vector<Benchmark>& Registry(){
+	static std::vector<Benchmark> benchmarks;
+	return benchmarks;
+}
+
+__declspec(noinline) void UseCharPointer(char const volatile* pointer){
+	(void)pointer;
+}
+
+void RegisterBenchmark(const std::string& group, const std::string& name,
+                       double operations, double bytes,
+                       std::function<BenchRun()> setup){
+	Benchmark benchmark;
+	benchmark.group = group;
+	benchmark.name = name;
+	benchmark.operations = operations;
+	benchmark.bytes = bytes;
+	benchmark.setup = setup;
+	Registry().push_back(benchmark);
+}
+
+struct BenchSample {
+	double nanoseconds;
+	double cycles;
+};
+
+static BenchSample RunSample(const BenchRun& run, size_t iterations){
+	std::chrono::steady_clock::time_point start_point = std::chrono::steady_clock::now();
+	unsigned long long start_cycles = __rdtsc();
+	run(iterations);
+	ClobberMemory();
+	unsigned long long end_cycles = __rdtsc();
+	std::chrono::steady_clock::time_point end_point = std::chrono::steady_clock::now();
+
+	BenchSample sample;
+	sample.nanoseconds = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end_point - start_point).count();
+	sample.cycles = (double)(end_cycles - start_cycles);
+	return sample;
+}
+
+// Grows the iteration count tenfold until a sample is long enough to
+// extrapolate from, then scales it to land just above target_ns.
+static size_t Calibrate(const BenchRun& run, double target_ns){
+	size_t iterations = 1;
+	for(;;){
+		BenchSample sample = RunSample(run, iterations);
+		if(sample.nanoseconds >= target_ns)
+			return iterations;
+		if(sample.nanoseconds < target_ns * 0.01){
+			iterations *= 10;
+		}else{
+			double scale = target_ns / sample.nanoseconds * 1.1;
+			return (size_t)ceil((double)iterations * scale);
+		}
+	}
+}
+
+// Nearest-rank percentile of an ascending array.
+static double Percentile(const std::vector<double>& sorted, double p){
+	size_t rank = (size_t)ceil(p * (double)sorted.size());
+	if(rank > 0) --rank;
+	if(rank >= sorted.size()) rank = sorted.size() - 1;
+	return sorted[rank];
+}
+
+static BenchResult Run(const Benchmark& benchmark, const BenchOptions& options){
+	BenchRun run = benchmark.setup();
+	size_t iterations = Calibrate(run, options.sample_ms * 1.0e6);
+	// Warmup: touches every page and settles caches, branch predictors
+	// and clock frequency before anything is recorded.
+	RunSample(run, iterations);
+
+	double operations = benchmark.operations * (double)iterations;
+	std::vector<double> ns_per_op;
+	std::vector<double> cycles_per_op;
+	std::vector<double> items_per_s;
+	for(int i = 0; i < options.samples; ++i){
+		BenchSample sample = RunSample(run, iterations);
+		ns_per_op.push_back(sample.nanoseconds / operations);
+		cycles_per_op.push_back(sample.cycles / operations);
+		items_per_s.push_back(operations / (sample.nanoseconds * 1.0e-9));
+	}
+	std::sort(ns_per_op.begin(), ns_per_op.end());
+	std::sort(cycles_per_op.begin(), cycles_per_op.end());
+	std::sort(items_per_s.begin(), items_per_s.end());
+
+	BenchResult result;
+	result.benchmark = &benchmark;
+	result.iterations = iterations;
+	result.ns_min = ns_per_op.front();
+	result.ns_p10 = Percentile(ns_per_op, 0.10);
+	result.ns_median = Percentile(ns_per_op, 0.50);
+	result.ns_p90 = Percentile(ns_per_op, 0.90);
+	result.ns_max = ns_per_op.back();
+	result.cycles_median = Percentile(cycles_per_op, 0.50);
+	result.gbps_median = benchmark.bytes / benchmark.operations / result.ns_median;
+	result.items_per_s_median = Percentile(items_per_s, 0.50);
+	return result;
+}
+
+static void PrintResult(const BenchResult& result){
+	printf("%-10s %-44s %10.3f %10.3f %10.3f %9.2f %8.2f %10.2f\n",
+		result.benchmark->group.c_str(), result.benchmark->name.c_str(),
+		result.ns_median, result.ns_p10, result.ns_p90,
+		result.cycles_median, result.gbps_median, result.items_per_s_median * 1.0e-6);
+	fflush(stdout);
+}
+
+static void WriteJsonString(FILE* file, const char* text){
+	fputc('"', file);
+	for(const char* c = text; *c; ++c){
+		if(*c == '"' || *c == '\\') fputc('\\', file);
+		fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+static bool WriteJson(const char* path, const BenchOptions& options,
+                      const std::vector<BenchResult>& results){
+	FILE* file = fopen(path, "w");
+	if(!file)
+		return false;
+
+	char date[32];
+	time_t now = time(NULL);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	fprintf(file, "{\n  \"context\": {\n    \"date\": ");
+	WriteJsonString(file, date);
+	fprintf(file, ",\n    \"tag\": ");
+	WriteJsonString(file, options.tag);
+	fprintf(file, ",\n    \"isa\": ");
+	WriteJsonString(file, IsaName(Kernels().isa));
+	fprintf(file, ",\n    \"samples\": %d,\n    \"sample_ms\": %g\n  },\n", options.samples, options.sample_ms);
+	fprintf(file, "  \"benchmarks\": [\n");
+	for(size_t i = 0; i < results.size(); ++i){
+		const BenchResult& r = results[i];
+		fprintf(file, "    {\"group\": ");
+		WriteJsonString(file, r.benchmark->group.c_str());
+		fprintf(file, ", \"name\": ");
+		WriteJsonString(file, r.benchmark->name.c_str());
+		fprintf(file, ", \"iterations\": %zu, \"ns_per_op\": {\"min\": %.4f, \"p10\": %.4f, \"median\": %.4f, \"p90\": %.4f, \"max\": %.4f}, "
+			"\"cycles_per_op\": %.4f, \"gb_per_s\": %.4f, \"items_per_s\": %.1f}%s\n",
+			r.iterations, r.ns_min, r.ns_p10, r.ns_median, r.ns_p90, r.ns_max,
+			r.cycles_median, r.gbps_median, r.items_per_s_median, i + 1 < results.size() ? "," : "");
+	}
+	fprintf(file, "  ]\n}\n");
+	fclose(file);
+	return true;
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions* options){
+	options->filter = "";
+	options->json_path = NULL;
+	options->tag = "";
+	options->samples = 15;
+	options->sample_ms = 10.0;
+
+	for(int i = 1; i < argc; ++i){
+		bool has_value = i + 1 < argc;
+		if(strcmp(argv[i], "--filter") == 0 && has_value){
+			options->filter = argv[++i];
+		}else if(strcmp(argv[i], "--json") == 0 && has_value){
+			options->json_path = argv[++i];
+		}else if(strcmp(argv[i], "--tag") == 0 && has_value){
+			options->tag = argv[++i];
+		}else if(strcmp(argv[i], "--samples") == 0 && has_value){
+			options->samples = std::max(1, atoi(argv[++i]));
+		}else if(strcmp(argv[i], "--sample-ms") == 0 && has_value){
+			options->sample_ms = std::max(0.01, atof(argv[++i]));
+		}else{
+			printf("usage: %s [--filter text] [--samples n] [--sample-ms ms] [--json path] [--tag text]\n", argv[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv){
+	BenchOptions options;
+	if(!ParseOptions(argc, argv, &options))
+		return 1;
+
+	RegisterVectorBenchmarks();
+	RegisterMatrixBenchmarks();
+	RegisterBatchBenchmarks();
+
+	printf("isa: %s  samples: %d  sample: %g ms\n", IsaName(Kernels().isa), options.samples, options.sample_ms);
+	printf("%-10s %-44s %10s %10s %10s %9s %8s %10s\n", "group", "benchmark", "ns/op", "p10", "p90", "cyc/op", "GB/s",
+		"Mitems/s");
+
+	std::vector<BenchResult> results;
+	const std::vector<Benchmark>& benchmarks = Registry();
+	for(size_t i = 0; i < benchmarks.size(); ++i){
+		std::string full_name = benchmarks[i].group + "/" + benchmarks[i].name;
+		if(full_name.find(options.filter) == std::string::npos)
+			continue;
+		results.push_back(Run(benchmarks[i], options));
+		PrintResult(results.back());
+	}
+
+	if(options.json_path && !WriteJson(options.json_path, options, results)){
+		printf("could not write %s\n", options.json_path);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,120 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Benchmark Harness.
+//--------------------------------------------------------------//
+//
+//   Every benchmark has a setup function that allocates its data and
+//   returns a BenchRun, which runs the operation a given number of
+//   iterations; the data is freed once the benchmark is done. The
+//   runner calibrates the iteration count until one sample lasts at
+//   least --sample-ms, runs one warmup sample, then takes --samples
+//   timed samples and reports the median and spread in ns/op, TSC
+//   cycles/op, GB/s and Mitems/s.
+//
+//   bench.exe [--filter text] [--samples n] [--sample-ms ms]
+//             [--json path] [--tag text]
+//
+//--------------------------------------------------------------//
+#ifndef __BENCH_H__
+#define __BENCH_H__ 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <functional>
+#include <string>
+#include <vector>
+#include <intrin.h>
+
+void UseCharPointer(char const volatile* pointer);
+
+// Makes value observable so the optimizer has to compute it.
+template<typename T>
+__forceinline void DoNotOptimize(T const& value){
+	UseCharPointer(&reinterpret_cast<char const volatile&>(value));
+	_ReadWriteBarrier();
+}
+
+// Forces pending stores to memory before the clock is read.
+__forceinline void ClobberMemory(){
+	_ReadWriteBarrier();
+}
+
+// Working-set sizes, in elements, for the batch benchmarks. Sized for
+// 12-16 byte elements: 1K fits L1, 16K fits L2, 256K fits L3 and 4M
+// spills to DRAM on current desktop and server parts.
+const size_t kBenchL1 = 1024;
+const size_t kBenchL2 = 16 * 1024;
+const size_t kBenchL3 = 256 * 1024;
+const size_t kBenchDRAM = 4 * 1024 * 1024;
+const size_t kBenchSizes[] = { kBenchL1, kBenchL2, kBenchL3, kBenchDRAM };
+const char* const kBenchSizeNames[] = { "L1", "L2", "L3", "DRAM" };
+
+typedef std::function<void(size_t iterations)> BenchRun;
+
+struct Benchmark {
+	std::string name;
+	std::string group;
+	// Operations and bytes touched by one call of run(1).
+	double operations;
+	double bytes;
+	std::function<BenchRun()> setup;
+};
+
+void RegisterBenchmark(const std::string& group, const std::string& name,
+                       double operations, double bytes,
+                       std::function<BenchRun()> setup);
+
+// Deterministic inputs so runs on different commits see the same data.
+inline float BenchRandom(uint32_t* state){
+	*state = *state * 1664525u + 1013904223u;
+	return (float)(*state >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+}
+
+// Applies op to an L1-resident array of inputs and stores every result,
+// so the reported time is per-call throughput of op.
+const size_t kScalarBatch = 256;
+
+template<typename In, typename Op>
+void RegisterUnary(const std::string& group, const std::string& name,
+                   std::vector<In> inputs, Op op){
+	typedef decltype(op(inputs[0])) Out;
+	std::vector<Out> outputs(inputs.size(), op(inputs[0]));
+	RegisterBenchmark(group, name, (double)inputs.size(),
+		(double)inputs.size() * (sizeof(In) + sizeof(Out)),
+		[inputs, outputs, op](){
+			return BenchRun([inputs, outputs, op](size_t iterations) mutable {
+				for(size_t it = 0; it < iterations; ++it){
+					for(size_t i = 0; i < inputs.size(); ++i)
+						outputs[i] = op(inputs[i]);
+					DoNotOptimize(outputs[0]);
+					ClobberMemory();
+				}
+			});
+		});
+}
+
+template<typename A, typename B, typename Op>
+void RegisterBinary(const std::string& group, const std::string& name,
+                    std::vector<A> a, std::vector<B> b, Op op){
+	typedef decltype(op(a[0], b[0])) Out;
+	std::vector<Out> outputs(a.size(), op(a[0], b[0]));
+	RegisterBenchmark(group, name, (double)a.size(),
+		(double)a.size() * (sizeof(A) + sizeof(B) + sizeof(Out)),
+		[a, b, outputs, op](){
+			return BenchRun([a, b, outputs, op](size_t iterations) mutable {
+				for(size_t it = 0; it < iterations; ++it){
+					for(size_t i = 0; i < a.size(); ++i)
+						outputs[i] = op(a[i], b[i]);
+					DoNotOptimize(outputs[0]);
+					ClobberMemory();
+				}
+			});
+		});
+}
+
+void RegisterVectorBenchmarks();
+void RegisterMatrixBenchmarks();
+void RegisterBatchBenchmarks();
+
+#endif // __BENCH_H__
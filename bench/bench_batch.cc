@@ -0,0 +1,951 @@
+#include <math.h>
+#include <memory>
+#include "bench_data.h"
+#include "xBounds.h"
+#include "xBvh.h"
+#include "xFrustum.h"
+#include "xHashGrid.h"
+#include "xKdTree.h"
+#include "xMat4Batch.h"
+#include "xPairwise.h"
+#include "xRay.h"
+#include "xTransform.h"
+#include "xQuatBatch.h"
+#include "xTRSBatch.h"
+#include "xTransformHierarchy.h"
+#include "xTranscendental.h"
+#include "xVec3SoA.h"
+
+// Each state owns the inputs and outputs of one working-set size. The
+// scalar AoS loops are the baseline the batch kernels are compared to.
+struct Vec3Batch {
+	explicit Vec3Batch(size_t count)
+		: a(RandomVec3(count, 40)), b(RandomVec3(count, 41)), out(count), scalars(count) {}
+	std::vector<Vec3> a;
+	std::vector<Vec3> b;
+	std::vector<Vec3> out;
+	std::vector<float> scalars;
+};
+
+struct SoABatch {
+	explicit SoABatch(size_t count)
+		: a(&RandomVec3(count, 42)[0], count), b(&RandomVec3(count, 43)[0], count),
+		  out(count), scalars(count) {}
+	Vec3SoA a;
+	Vec3SoA b;
+	Vec3SoA out;
+	std::vector<float> scalars;
+};
+
+struct Vec4Batch {
+	explicit Vec4Batch(size_t count) : in(RandomVec4(count, 44)), out(count) {}
+	std::vector<Vec4> in;
+	std::vector<Vec4> out;
+};
+
+struct XVector3Batch {
+	explicit XVector3Batch(size_t count) : in(RandomXVector3(count, 45)), out(count) {}
+	std::vector<xVector3> in;
+	std::vector<xVector3> out;
+};
+
+struct QuatBatch {
+	explicit QuatBatch(size_t count)
+		: a(RandomQuat(count, 47)), b(RandomQuat(count, 48)), t(count), out(count) {
+		for(size_t i = 0; i < count; ++i) t[i] = (float)i / (float)count;
+	}
+	std::vector<Quat> a;
+	std::vector<Quat> b;
+	std::vector<float> t;
+	std::vector<Quat> out;
+};
+
+struct TRSBatch {
+	explicit TRSBatch(size_t count)
+		: translate(count), scale(count), rotation(&RandomQuat(count, 49)[0], count),
+		  euler(RandomVec3(count, 50)), euler_soa(&euler[0], count), out(count), x_out(count) {
+		std::vector<Vec3> t = RandomVec3(count, 51), s = RandomVec3(count, 52);
+		for(size_t i = 0; i < count; ++i){
+			translate.Set(i, t[i] * 10.0f);
+			scale.Set(i, s[i] + 2.0f);
+		}
+	}
+	Vec3SoA translate;
+	Vec3SoA scale;
+	QuatSoA rotation;
+	std::vector<Vec3> euler;
+	Vec3SoA euler_soa;
+	std::vector<Mat4> out;
+	std::vector<xMatrix4> x_out;
+};
+
+// x holds angles in [-10, 10) for sin/cos/exp, y in [-1, 1) for acos
+// and atan2.
+struct FloatBatch {
+	explicit FloatBatch(size_t count) : x(count), y(count), out(count), out2(count) {
+		std::vector<Vec3> source = RandomVec3(count, 53);
+		for(size_t i = 0; i < count; ++i){
+			x[i] = source[i].x * 10.0f;
+			y[i] = source[i].y;
+		}
+	}
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> out;
+	std::vector<float> out2;
+};
+
+// Points as a Vec3 array, a Vec3SoA and an interleaved vertex buffer of
+// position, normal and uv (8 floats per vertex).
+const size_t kVertexStride = 8;
+
+struct BoundsBatch {
+	explicit BoundsBatch(size_t count)
+		: points(RandomVec3(count, 58)), soa(&points[0], count), vertices(count * kVertexStride) {
+		for(size_t i = 0; i < count; ++i){
+			vertices[i * kVertexStride] = points[i].x;
+			vertices[i * kVertexStride + 1] = points[i].y;
+			vertices[i * kVertexStride + 2] = points[i].z;
+		}
+	}
+	std::vector<Vec3> points;
+	Vec3SoA soa;
+	std::vector<float> vertices;
+	AABB bounds;
+};
+
+struct Mat4Batch {
+	explicit Mat4Batch(size_t count)
+		: in(RandomTransforms(count, 46, false)), out(count),
+		  x_in(ToXMatrix4(in)), x_out(count), invertible(count) {}
+	std::vector<Mat4> in;
+	std::vector<Mat4> out;
+	std::vector<xMatrix4> x_in;
+	std::vector<xMatrix4> x_out;
+	std::vector<uint8_t> invertible;
+};
+
+// Pairs of transforms for MultiplyBatch, in each layout.
+struct Mat4PairBatch {
+	explicit Mat4PairBatch(size_t count)
+		: a(RandomTransforms(count, 47, false)), b(RandomTransforms(count, 48, false)), out(count),
+		  x_a(ToXMatrix4(a)), x_b(ToXMatrix4(b)), x_out(count),
+		  a_soa(&a[0], count), b_soa(&b[0], count), out_soa(count) {}
+	std::vector<Mat4> a;
+	std::vector<Mat4> b;
+	std::vector<Mat4> out;
+	std::vector<xMatrix4> x_a;
+	std::vector<xMatrix4> x_b;
+	std::vector<xMatrix4> x_out;
+	Mat4SoA a_soa;
+	Mat4SoA b_soa;
+	Mat4SoA out_soa;
+};
+
+// A 4-ary tree of kHierarchyNodes transforms, 8 levels deep, in which a
+// random 2% of the nodes move each frame.
+const size_t kHierarchyNodes = 50000;
+const size_t kHierarchyMoved = kHierarchyNodes / 50;
+
+struct HierarchyScene {
+	HierarchyScene() : locals(RandomTransforms(kHierarchyNodes, 54, false)), worlds(kHierarchyNodes), seed(55) {
+		hierarchy.Reserve(kHierarchyNodes);
+		for(size_t i = 0; i < kHierarchyNodes; ++i)
+			hierarchy.AddNode(i ? (uint32_t)((i - 1) / 4) : kNoParent, locals[i]);
+		hierarchy.Update();
+	}
+	void Move(){
+		for(size_t k = 0; k < kHierarchyMoved; ++k){
+			size_t node = (size_t)((BenchRandom(&seed) * 0.5f + 0.5f) * (float)kHierarchyNodes) % kHierarchyNodes;
+			hierarchy.SetLocal((uint32_t)node, locals[(node + k) % kHierarchyNodes]);
+		}
+	}
+	std::vector<Mat4> locals;
+	std::vector<Mat4> worlds;
+	xTransformHierarchy hierarchy;
+	uint32_t seed;
+};
+
+// kCullObjects spheres and boxes spread over a 200-unit cube around a
+// camera with a 60 degree field of view, so roughly a tenth of them are
+// visible.
+const size_t kCullObjects = 200000;
+
+struct CullScene {
+	CullScene()
+		: frustum(Mat4::Translate(0.0f, 0.0f, -5.0f).Multiply(Mat4::PerspectiveMatrix(1.0472f, 16.0f / 9.0f, 0.1f, 500.0f))),
+		  centers(kCullObjects), radii(kCullObjects), min(kCullObjects), max(kCullObjects), visible(kCullObjects) {
+		std::vector<Vec3> c = RandomVec3(kCullObjects, 56), r = RandomVec3(kCullObjects, 57);
+		for(size_t i = 0; i < kCullObjects; ++i){
+			Vec3 center = c[i] * 100.0f;
+			float radius = fabsf(r[i].x) * 2.0f + 0.1f;
+			centers.Set(i, center);
+			radii[i] = radius;
+			min.Set(i, center - Vec3(radius, radius, radius));
+			max.Set(i, center + Vec3(radius, radius, radius));
+		}
+	}
+	xFrustum frustum;
+	Vec3SoA centers;
+	std::vector<float> radii;
+	Vec3SoA min;
+	Vec3SoA max;
+	std::vector<uint32_t> visible;
+};
+
+// kRayPrimitives triangles, boxes and spheres in the same 200-unit cube,
+// for one ray against all of them, and kPacketRays rays from one eye for
+// the packet kernels, each tested against the first kPacketPrimitives.
+const size_t kRayPrimitives = 100000;
+const size_t kPacketRays = 4096;
+const size_t kPacketPrimitives = 64;
+
+struct RayScene {
+	RayScene()
+		: ray(Vec3(0.0f, 0.0f, -150.0f), Vec3(0.01f, 0.02f, 1.0f)), triangles(kRayPrimitives),
+		  min(kRayPrimitives), max(kRayPrimitives), centers(kRayPrimitives), radii(kRayPrimitives),
+		  packet(kPacketRays), hits(kPacketRays) {
+		std::vector<Vec3> c = RandomVec3(kRayPrimitives, 58), e = RandomVec3(kRayPrimitives * 2, 59);
+		for(size_t i = 0; i < kRayPrimitives; ++i){
+			Vec3 center = c[i] * 100.0f;
+			float radius = fabsf(e[i].x) * 2.0f + 0.1f;
+			a.push_back(center);
+			b.push_back(center + e[i] * 2.0f);
+			this->c.push_back(center + e[kRayPrimitives + i] * 2.0f);
+			triangles.Set(i, a[i], b[i], this->c[i]);
+			min.Set(i, center - Vec3(radius, radius, radius));
+			max.Set(i, center + Vec3(radius, radius, radius));
+			centers.Set(i, center);
+			radii[i] = radius;
+		}
+		std::vector<Vec3> targets = RandomVec3(kPacketRays, 60);
+		for(size_t r = 0; r < kPacketRays; ++r){
+			rays.push_back(Ray(Vec3(0.0f, 0.0f, -150.0f), targets[r] * 100.0f - Vec3(0.0f, 0.0f, -150.0f)));
+			packet.Set(r, rays[r]);
+		}
+	}
+	void ResetHits(){
+		for(size_t r = 0; r < kPacketRays; ++r) hits[r] = RayHit();
+	}
+	Ray ray;
+	std::vector<Vec3> a, b, c;
+	TriangleSoA triangles;
+	Vec3SoA min;
+	Vec3SoA max;
+	Vec3SoA centers;
+	std::vector<float> radii;
+	std::vector<Ray> rays;
+	RaySoA packet;
+	std::vector<RayHit> hits;
+	RayHit hit;
+};
+
+// A wavy grid of kBvhSide^2 quads, about a million triangles, and
+// kBvhRays rays from above the grid into it.
+const size_t kBvhSide = 708;
+const size_t kBvhRays = 1024;
+
+struct BvhScene {
+	BvhScene() : stream(kBvhRays), hits(kBvhRays) {
+		const size_t side = kBvhSide + 1;
+		for(size_t z = 0; z < side; ++z){
+			for(size_t x = 0; x < side; ++x){
+				float height = sinf((float)x * 0.05f) * cosf((float)z * 0.07f) * 4.0f;
+				vertices.push_back(Vec3((float)x * 0.1f, height, (float)z * 0.1f));
+				moved.push_back(Vec3((float)x * 0.1f, height + sinf((float)(x + z) * 0.1f), (float)z * 0.1f));
+			}
+		}
+		for(size_t z = 0; z < kBvhSide; ++z){
+			for(size_t x = 0; x < kBvhSide; ++x){
+				uint32_t v = (uint32_t)(z * side + x), s = (uint32_t)side;
+				uint32_t quad[6] = { v, v + 1, v + s, v + 1, v + s + 1, v + s };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+		mesh = TriangleSoA(&vertices[0], &indices[0], Triangles());
+		bvh4.Build(&vertices[0], &indices[0], Triangles());
+		bvh8.Build(&vertices[0], &indices[0], Triangles());
+		std::vector<Vec3> targets = RandomVec3(kBvhRays, 61);
+		Vec3 center((float)kBvhSide * 0.05f, 20.0f, (float)kBvhSide * 0.05f);
+		for(size_t r = 0; r < kBvhRays; ++r){
+			Vec3 target = center + Vec3(targets[r].x, 0.0f, targets[r].z) * ((float)kBvhSide * 0.05f) - Vec3(0.0f, 20.0f, 0.0f);
+			rays.push_back(Ray(center, target - center));
+			stream.Set(r, rays[r]);
+		}
+	}
+	size_t Triangles() const { return indices.size() / 3; }
+	void ResetHits(){
+		for(size_t r = 0; r < kBvhRays; ++r) hits[r] = RayHit();
+	}
+	std::vector<Vec3> vertices;
+	std::vector<Vec3> moved;
+	std::vector<uint32_t> indices;
+	TriangleSoA mesh;
+	xBvh4 bvh4;
+	xBvh8 bvh8;
+	std::vector<Ray> rays;
+	RaySoA stream;
+	std::vector<RayHit> hits;
+	RayHit hit;
+};
+
+// A million points spread evenly over a cube of side 100, about one per
+// unit cell, and kHashGridQueries query points inside it.
+const size_t kHashGridPoints = 1 << 20;
+const size_t kHashGridQueries = 1024;
+const size_t kHashGridNeighbors = 8;
+const float kHashGridCell = 1.0f;
+
+struct HashGridScene {
+	HashGridScene()
+		: points(RandomVec3(kHashGridPoints, 62)), queries(RandomVec3(kHashGridQueries, 63)),
+		  indices(kHashGridQueries * kHashGridNeighbors), squared(kHashGridQueries * kHashGridNeighbors), step(0) {
+		for(size_t i = 0; i < kHashGridPoints; ++i) points[i] = points[i] * 50.0f;
+		for(size_t q = 0; q < kHashGridQueries; ++q) queries[q] = queries[q] * 50.0f;
+		grid.Build(&points[0], kHashGridPoints, kHashGridCell);
+	}
+	std::vector<Vec3> points;
+	std::vector<Vec3> queries;
+	xHashGrid grid;
+	std::vector<uint32_t> found;
+	std::vector<uint32_t> indices;
+	std::vector<float> squared;
+	size_t step;
+};
+
+// A scanned surface: a million points on a wavy sheet 100 units across,
+// and kKdTreeQueries queries just off it, as in an ICP step.
+const size_t kKdTreePoints = 1 << 20;
+const size_t kKdTreeQueries = 4096;
+const size_t kKdTreeNeighbors = 8;
+
+struct KdTreeScene {
+	KdTreeScene()
+		: points(RandomVec3(kKdTreePoints, 64)), queries(RandomVec3(kKdTreeQueries, 65)),
+		  indices(kKdTreeQueries * kKdTreeNeighbors), squared(kKdTreeQueries * kKdTreeNeighbors) {
+		for(size_t i = 0; i < kKdTreePoints; ++i){
+			Vec3 p = points[i] * 50.0f;
+			points[i] = Vec3(p.x, sinf(p.x * 0.1f) * cosf(p.z * 0.13f) * 5.0f + p.y * 0.01f, p.z);
+		}
+		for(size_t q = 0; q < kKdTreeQueries; ++q) queries[q] = points[q * 251] + queries[q] * 0.2f;
+		tree.Build(&points[0], kKdTreePoints);
+	}
+	std::vector<Vec3> points;
+	std::vector<Vec3> queries;
+	xKdTree tree;
+	std::vector<uint32_t> found;
+	std::vector<size_t> offsets;
+	std::vector<uint32_t> indices;
+	std::vector<float> squared;
+};
+
+// kPairwiseA query points against kPairwiseB points, both in the unit
+// cube, with room for the full distance matrix.
+const size_t kPairwiseA = 1024;
+const size_t kPairwiseB = 4096;
+const size_t kPairwiseNeighbors = 8;
+
+struct PairwiseScene {
+	PairwiseScene()
+		: a(RandomVec3(kPairwiseA, 66)), b(RandomVec3(kPairwiseB, 67)), a_soa(&a[0], kPairwiseA), b_soa(&b[0], kPairwiseB),
+		  matrix(kPairwiseA * kPairwiseB), indices(kPairwiseA * kPairwiseNeighbors), squared(kPairwiseA * kPairwiseNeighbors) {}
+	std::vector<Vec3> a;
+	std::vector<Vec3> b;
+	Vec3SoA a_soa;
+	Vec3SoA b_soa;
+	std::vector<float> matrix;
+	std::vector<uint32_t> indices;
+	std::vector<float> squared;
+};
+
+const xMatrix4 kBenchTransform = xMatrix4(Mat4::GetTransform(1.0f, 2.0f, 3.0f, 2.0f, 2.0f, 2.0f, 0.3f, 0.2f, 0.1f));
+
+// Registers kernel at every working-set size in kBenchSizes. Matrices are
+// 64 bytes, so their element counts are divided by element_scale to keep
+// the footprint of each size in the same cache level.
+template<typename State, typename Kernel>
+static void RegisterSizes(const std::string& group, const std::string& name,
+                          double bytes_per_element, size_t element_scale, Kernel kernel){
+	for(size_t s = 0; s < sizeof(kBenchSizes) / sizeof(kBenchSizes[0]); ++s){
+		size_t count = kBenchSizes[s] / element_scale;
+		RegisterBenchmark(group, name + "/" + kBenchSizeNames[s], (double)count, bytes_per_element * (double)count,
+			[count, kernel](){
+				std::shared_ptr<State> state(new State(count));
+				return BenchRun([state, kernel](size_t iterations){
+					for(size_t it = 0; it < iterations; ++it){
+						kernel(state.get());
+						ClobberMemory();
+					}
+				});
+			});
+	}
+}
+
+static void RegisterAoS(){
+	RegisterSizes<Vec3Batch>("Vec3[]", "operator+", 36, 1, [](Vec3Batch* s){
+		for(size_t i = 0; i < s->a.size(); ++i) s->out[i] = s->a[i] + s->b[i];
+	});
+	RegisterSizes<Vec3Batch>("Vec3[]", "DotProduct", 28, 1, [](Vec3Batch* s){
+		for(size_t i = 0; i < s->a.size(); ++i) s->scalars[i] = Vec3::DotProduct(s->a[i], s->b[i]);
+	});
+	RegisterSizes<Vec3Batch>("Vec3[]", "CrossProduct", 36, 1, [](Vec3Batch* s){
+		for(size_t i = 0; i < s->a.size(); ++i) s->out[i] = Vec3::CrossProduct(s->a[i], s->b[i]);
+	});
+	RegisterSizes<Vec3Batch>("Vec3[]", "Normalized", 24, 1, [](Vec3Batch* s){
+		for(size_t i = 0; i < s->a.size(); ++i) s->out[i] = s->a[i].Normalized();
+	});
+	RegisterSizes<Vec3Batch>("Vec3[]", "Mat4TransformVec3", 24, 1, [](Vec3Batch* s){
+		Mat4 m = kBenchTransform.ToMat4();
+		for(size_t i = 0; i < s->a.size(); ++i) s->out[i] = Mat4::Mat4TransformVec3(m, s->a[i]);
+	});
+}
+
+static void RegisterSoA(){
+	RegisterSizes<SoABatch>("Vec3SoA", "Add", 36, 1, [](SoABatch* s){ Add(s->a, s->b, &s->out); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Subtract", 36, 1, [](SoABatch* s){ Subtract(s->a, s->b, &s->out); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Scale", 24, 1, [](SoABatch* s){ Scale(s->a, 1.5f, &s->out); });
+	RegisterSizes<SoABatch>("Vec3SoA", "DotProduct", 28, 1, [](SoABatch* s){ DotProduct(s->a, s->b, &s->scalars[0]); });
+	RegisterSizes<SoABatch>("Vec3SoA", "CrossProduct", 36, 1, [](SoABatch* s){ CrossProduct(s->a, s->b, &s->out); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Magnitude", 16, 1, [](SoABatch* s){ Magnitude(s->a, &s->scalars[0]); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Normalize", 24, 1, [](SoABatch* s){ Normalize(s->a, &s->out); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Normalize<Fast>", 24, 1, [](SoABatch* s){ Normalize<kPrecisionFast>(s->a, &s->out); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Normalize<Fastest>", 24, 1, [](SoABatch* s){ Normalize<kPrecisionFastest>(s->a, &s->out); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Normalize(kParallel)", 24, 1, [](SoABatch* s){ Normalize(s->a, &s->out, kParallel); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Angle", 28, 1, [](SoABatch* s){ Angle(s->a, s->b, &s->scalars[0]); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Distance", 28, 1, [](SoABatch* s){ Distance(s->a, s->b, &s->scalars[0]); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Lerp", 36, 1, [](SoABatch* s){ Lerp(s->a, s->b, 0.25f, &s->out); });
+	RegisterSizes<SoABatch>("Vec3SoA", "Reflect", 36, 1, [](SoABatch* s){ Reflect(s->a, s->b, &s->out); });
+}
+
+static void RegisterTransforms(){
+	RegisterSizes<Vec3Batch>("Transform", "TransformPoints(Vec3)", 24, 1, [](Vec3Batch* s){
+		TransformPoints(kBenchTransform, &s->a[0], &s->out[0], s->a.size());
+	});
+	RegisterSizes<Vec3Batch>("Transform", "TransformPoints(Vec3, kParallel)", 24, 1, [](Vec3Batch* s){
+		TransformPoints(kBenchTransform, &s->a[0], &s->out[0], s->a.size(), kParallel);
+	});
+	RegisterSizes<Vec3Batch>("Transform", "TransformDirections(Vec3)", 24, 1, [](Vec3Batch* s){
+		TransformDirections(kBenchTransform, &s->a[0], &s->out[0], s->a.size());
+	});
+	RegisterSizes<Vec3Batch>("Transform", "TransformPointsProjective(Vec3)", 24, 1, [](Vec3Batch* s){
+		TransformPointsProjective(kBenchTransform, &s->a[0], &s->out[0], s->a.size());
+	});
+	RegisterSizes<Vec3Batch>("Transform", "TransformPointsProjective<Fast>(Vec3)", 24, 1, [](Vec3Batch* s){
+		TransformPointsProjective<kPrecisionFast>(kBenchTransform, &s->a[0], &s->out[0], s->a.size());
+	});
+	RegisterSizes<Vec3Batch>("Transform", "TransformPointsProjective<Fastest>(Vec3)", 24, 1, [](Vec3Batch* s){
+		TransformPointsProjective<kPrecisionFastest>(kBenchTransform, &s->a[0], &s->out[0], s->a.size());
+	});
+	RegisterSizes<XVector3Batch>("Transform", "TransformPoints(xVector3)", 32, 1, [](XVector3Batch* s){
+		TransformPoints(kBenchTransform, &s->in[0], &s->out[0], s->in.size());
+	});
+	RegisterSizes<Vec4Batch>("Transform", "Transform(Vec4)", 32, 1, [](Vec4Batch* s){
+		Transform(kBenchTransform, &s->in[0], &s->out[0], s->in.size());
+	});
+}
+
+static void RegisterInverses(){
+	RegisterSizes<Mat4Batch>("Mat4[]", "GetInverse", 128, 4, [](Mat4Batch* s){
+		for(size_t i = 0; i < s->in.size(); ++i) s->in[i].GetInverse(&s->out[i]);
+	});
+	RegisterSizes<Mat4Batch>("Mat4[]", "GetInverseAffine", 128, 4, [](Mat4Batch* s){
+		for(size_t i = 0; i < s->in.size(); ++i) s->in[i].GetInverseAffine(&s->out[i]);
+	});
+	RegisterSizes<Mat4Batch>("Mat4[]", "InverseBatch(xMatrix4)", 129, 4, [](Mat4Batch* s){
+		InverseBatch(&s->x_in[0], &s->x_out[0], &s->invertible[0], s->x_in.size());
+	});
+	RegisterSizes<Mat4Batch>("Mat4[]", "InverseBatch(Mat4)", 129, 4, [](Mat4Batch* s){
+		InverseBatch(&s->in[0], &s->out[0], &s->invertible[0], s->in.size());
+	});
+	RegisterSizes<Mat4Batch>("Mat4[]", "InverseBatch(Mat4, kParallel)", 129, 4, [](Mat4Batch* s){
+		InverseBatch(&s->in[0], &s->out[0], &s->invertible[0], s->in.size(), kMat4InverseEpsilon, kParallel);
+	});
+}
+
+// Mat4::Multiply and xMatrix4 Multiply loops against MultiplyBatch. The
+// element count is matrices multiplied, so matrices per second is
+// 1e9 / ns per element.
+static void RegisterMat4Multiply(){
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "Mat4::Multiply", 192, 4, [](Mat4PairBatch* s){
+		for(size_t i = 0; i < s->a.size(); ++i) s->out[i] = s->a[i].Multiply(s->b[i]);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "Multiply(xMatrix4)", 192, 4, [](Mat4PairBatch* s){
+		for(size_t i = 0; i < s->x_a.size(); ++i) s->x_out[i] = Multiply(s->x_a[i], s->x_b[i]);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "MultiplyBatch(xMatrix4)", 192, 4, [](Mat4PairBatch* s){
+		MultiplyBatch(&s->x_a[0], &s->x_b[0], &s->x_out[0], s->x_a.size(), kSequential);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "MultiplyBatch(Mat4)", 192, 4, [](Mat4PairBatch* s){
+		MultiplyBatch(&s->a[0], &s->b[0], &s->out[0], s->a.size(), kSequential);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "MultiplyBatch(Mat4SoA)", 192, 4, [](Mat4PairBatch* s){
+		MultiplyBatch(s->a_soa, s->b_soa, &s->out_soa, kSequential);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "Mat4::Multiply (broadcast)", 128, 4, [](Mat4PairBatch* s){
+		Mat4 m = kBenchTransform.ToMat4();
+		for(size_t i = 0; i < s->b.size(); ++i) s->out[i] = m.Multiply(s->b[i]);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "MultiplyBatch(Mat4, broadcast)", 128, 4, [](Mat4PairBatch* s){
+		MultiplyBatch(kBenchTransform.ToMat4(), &s->b[0], &s->out[0], s->b.size(), kSequential);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "MultiplyBatch(Mat4SoA, broadcast)", 128, 4, [](Mat4PairBatch* s){
+		MultiplyBatch(kBenchTransform.ToMat4(), s->b_soa, &s->out_soa, kSequential);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "ToMat4SoA", 128, 4, [](Mat4PairBatch* s){
+		ToMat4SoA(&s->a[0], s->a.size(), &s->out_soa, kSequential);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "MultiplyBatch(Mat4, kParallel)", 192, 4, [](Mat4PairBatch* s){
+		MultiplyBatch(&s->a[0], &s->b[0], &s->out[0], s->a.size(), kParallel);
+	});
+	RegisterSizes<Mat4PairBatch>("Mat4[]", "MultiplyBatch(Mat4SoA, kParallel)", 192, 4, [](Mat4PairBatch* s){
+		MultiplyBatch(s->a_soa, s->b_soa, &s->out_soa, kParallel);
+	});
+}
+
+static void RegisterQuaternions(){
+	RegisterSizes<QuatBatch>("Quat[]", "Quat::Slerp", 48, 1, [](QuatBatch* s){
+		for(size_t i = 0; i < s->a.size(); ++i) s->out[i] = Quat::Slerp(s->a[i], s->b[i], s->t[i]);
+	});
+	RegisterSizes<QuatBatch>("Quat[]", "Quat::Nlerp", 48, 1, [](QuatBatch* s){
+		for(size_t i = 0; i < s->a.size(); ++i) s->out[i] = Quat::Nlerp(s->a[i], s->b[i], s->t[i]);
+	});
+	RegisterSizes<QuatBatch>("Quat[]", "Slerp", 52, 1, [](QuatBatch* s){
+		Slerp(&s->a[0], &s->b[0], &s->t[0], &s->out[0], s->a.size());
+	});
+	RegisterSizes<QuatBatch>("Quat[]", "Slerp(uniform t)", 48, 1, [](QuatBatch* s){
+		Slerp(&s->a[0], &s->b[0], 0.25f, &s->out[0], s->a.size());
+	});
+	RegisterSizes<QuatBatch>("Quat[]", "Nlerp", 52, 1, [](QuatBatch* s){
+		Nlerp(&s->a[0], &s->b[0], &s->t[0], &s->out[0], s->a.size());
+	});
+	RegisterSizes<QuatBatch>("Quat[]", "Nlerp<Fast>", 52, 1, [](QuatBatch* s){
+		Nlerp<kPrecisionFast>(&s->a[0], &s->b[0], &s->t[0], &s->out[0], s->a.size());
+	});
+}
+
+static void RegisterTRS(){
+	RegisterSizes<TRSBatch>("TRS", "Mat4::GetTransform", 104, 4, [](TRSBatch* s){
+		for(size_t i = 0; i < s->out.size(); ++i)
+			s->out[i] = Mat4::GetTransform(s->translate.Get(i), s->scale.Get(i), s->euler[i].x, s->euler[i].y, s->euler[i].z);
+	});
+	RegisterSizes<TRSBatch>("TRS", "Quat::ToTransform", 104, 4, [](TRSBatch* s){
+		for(size_t i = 0; i < s->out.size(); ++i)
+			s->out[i] = s->rotation.Get(i).ToTransform(s->translate.Get(i), s->scale.Get(i));
+	});
+	RegisterSizes<TRSBatch>("TRS", "GetTransforms(Mat4)", 104, 4, [](TRSBatch* s){
+		GetTransforms(s->translate, s->rotation, s->scale, &s->out[0]);
+	});
+	RegisterSizes<TRSBatch>("TRS", "GetTransforms(xMatrix4)", 104, 4, [](TRSBatch* s){
+		GetTransforms(s->translate, s->rotation, s->scale, &s->x_out[0]);
+	});
+	RegisterSizes<TRSBatch>("TRS", "GetTransforms(Euler)", 100, 4, [](TRSBatch* s){
+		GetTransforms(s->translate, s->euler_soa, s->scale, &s->out[0]);
+	});
+}
+
+// One frame of the scene: the full Mat4::Multiply recompute every node
+// would need without dirty flags, against Update after 2% moved.
+// Operations count nodes, so ns/op compares per-node cost.
+static void RegisterHierarchy(){
+	RegisterBenchmark("Hierarchy", "Mat4::Multiply (all nodes)", (double)kHierarchyNodes, 128.0 * kHierarchyNodes, [](){
+		std::shared_ptr<HierarchyScene> scene(new HierarchyScene());
+		return BenchRun([scene](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				scene->worlds[0] = scene->locals[0];
+				for(size_t i = 1; i < kHierarchyNodes; ++i)
+					scene->worlds[i] = scene->locals[i].Multiply(scene->worlds[(i - 1) / 4]);
+				ClobberMemory();
+			}
+		});
+	});
+	RegisterBenchmark("Hierarchy", "UpdateAll", (double)kHierarchyNodes, 128.0 * kHierarchyNodes, [](){
+		std::shared_ptr<HierarchyScene> scene(new HierarchyScene());
+		return BenchRun([scene](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				scene->hierarchy.UpdateAll();
+				ClobberMemory();
+			}
+		});
+	});
+	RegisterBenchmark("Hierarchy", "Update (2% moved)", (double)kHierarchyNodes, 128.0 * kHierarchyNodes, [](){
+		std::shared_ptr<HierarchyScene> scene(new HierarchyScene());
+		return BenchRun([scene](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				scene->Move();
+				scene->hierarchy.Update();
+				ClobberMemory();
+			}
+		});
+	});
+}
+
+static void RegisterBounds(){
+	RegisterSizes<BoundsBatch>("Bounds", "AABB::Merge", 12, 1, [](BoundsBatch* s){
+		AABB bounds;
+		for(size_t i = 0; i < s->points.size(); ++i) bounds.Merge(s->points[i]);
+		s->bounds = bounds;
+	});
+	RegisterSizes<BoundsBatch>("Bounds", "ComputeBounds(Vec3)", 12, 1, [](BoundsBatch* s){
+		s->bounds = ComputeBounds(&s->points[0], s->points.size(), kSequential);
+	});
+	RegisterSizes<BoundsBatch>("Bounds", "ComputeBounds(Vec3, kParallel)", 12, 1, [](BoundsBatch* s){
+		s->bounds = ComputeBounds(&s->points[0], s->points.size());
+	});
+	RegisterSizes<BoundsBatch>("Bounds", "ComputeBounds(Vec3SoA)", 12, 1, [](BoundsBatch* s){
+		s->bounds = ComputeBounds(s->soa, kSequential);
+	});
+	RegisterSizes<BoundsBatch>("Bounds", "ComputeBounds(stride 8)", 32, 1, [](BoundsBatch* s){
+		s->bounds = ComputeBounds(&s->vertices[0], kVertexStride, s->points.size(), kSequential);
+	});
+	RegisterSizes<BoundsBatch>("Bounds", "ComputeBoundingSphere(Vec3)", 24, 1, [](BoundsBatch* s){
+		s->bounds.min.x = ComputeBoundingSphere(&s->points[0], s->points.size(), kSequential).radius;
+	});
+}
+
+// Scalar plane tests against the lane kernels, both writing an index list.
+// Operations count objects.
+template<typename Kernel>
+static void RegisterCull(const std::string& name, double bytes_per_object, Kernel kernel){
+	RegisterBenchmark("Cull", name, (double)kCullObjects, bytes_per_object * kCullObjects, [kernel](){
+		std::shared_ptr<CullScene> scene(new CullScene());
+		return BenchRun([scene, kernel](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				kernel(scene.get());
+				ClobberMemory();
+			}
+		});
+	});
+}
+
+static void RegisterCulling(){
+	RegisterCull("IntersectsSphere", 16, [](CullScene* s){
+		size_t written = 0;
+		for(size_t i = 0; i < kCullObjects; ++i)
+			if(s->frustum.IntersectsSphere(s->centers.Get(i), s->radii[i])) s->visible[written++] = (uint32_t)i;
+	});
+	RegisterCull("CullSpheres", 16, [](CullScene* s){ CullSpheres(s->frustum, s->centers, &s->radii[0], &s->visible[0]); });
+	RegisterCull("CullSpheres(kParallel)", 16, [](CullScene* s){
+		CullSpheres(s->frustum, s->centers, &s->radii[0], &s->visible[0], kParallel);
+	});
+	RegisterCull("IntersectsBox", 24, [](CullScene* s){
+		size_t written = 0;
+		for(size_t i = 0; i < kCullObjects; ++i)
+			if(s->frustum.IntersectsBox(s->min.Get(i), s->max.Get(i))) s->visible[written++] = (uint32_t)i;
+	});
+	RegisterCull("CullBoxes", 24, [](CullScene* s){ CullBoxes(s->frustum, s->min, s->max, &s->visible[0]); });
+	RegisterCull("CullBoxes(kParallel)", 24, [](CullScene* s){ CullBoxes(s->frustum, s->min, s->max, &s->visible[0], kParallel); });
+}
+
+// Scalar loops of the single-primitive tests against the lane kernels.
+// Operations count ray-primitive tests.
+template<typename Kernel>
+static void RegisterRay(const std::string& name, double tests, double bytes, Kernel kernel){
+	RegisterBenchmark("Ray", name, tests, bytes, [kernel](){
+		std::shared_ptr<RayScene> scene(new RayScene());
+		return BenchRun([scene, kernel](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				kernel(scene.get());
+				ClobberMemory();
+			}
+		});
+	});
+}
+
+static void RegisterRays(){
+	const double one = (double)kRayPrimitives, packets = (double)kPacketRays * kPacketPrimitives;
+	RegisterRay("IntersectTriangle (1 ray)", one, 36 * one, [](RayScene* s){
+		RayHit hit;
+		for(size_t i = 0; i < kRayPrimitives; ++i) IntersectTriangle(s->ray, s->a[i], s->b[i], s->c[i], (uint32_t)i, &hit);
+		s->hit = hit;
+	});
+	RegisterRay("IntersectTriangles", one, 36 * one, [](RayScene* s){ s->hit = IntersectTriangles(s->ray, s->triangles); });
+	RegisterRay("IntersectTriangles(kParallel)", one, 36 * one, [](RayScene* s){
+		s->hit = IntersectTriangles(s->ray, s->triangles, kParallel);
+	});
+	RegisterRay("IntersectBox (1 ray)", one, 24 * one, [](RayScene* s){
+		RayHit hit;
+		for(size_t i = 0; i < kRayPrimitives; ++i) IntersectBox(s->ray, AABB(s->min.Get(i), s->max.Get(i)), (uint32_t)i, &hit);
+		s->hit = hit;
+	});
+	RegisterRay("IntersectBoxes", one, 24 * one, [](RayScene* s){ s->hit = IntersectBoxes(s->ray, s->min, s->max); });
+	RegisterRay("IntersectSphere (1 ray)", one, 16 * one, [](RayScene* s){
+		RayHit hit;
+		for(size_t i = 0; i < kRayPrimitives; ++i) IntersectSphere(s->ray, Sphere(s->centers.Get(i), s->radii[i]), (uint32_t)i, &hit);
+		s->hit = hit;
+	});
+	RegisterRay("IntersectSpheres", one, 16 * one, [](RayScene* s){ s->hit = IntersectSpheres(s->ray, s->centers, &s->radii[0]); });
+	RegisterRay("IntersectTriangle (per ray)", packets, 44 * packets / kPacketPrimitives, [](RayScene* s){
+		s->ResetHits();
+		for(size_t r = 0; r < kPacketRays; ++r)
+			for(size_t i = 0; i < kPacketPrimitives; ++i) IntersectTriangle(s->rays[r], s->a[i], s->b[i], s->c[i], (uint32_t)i, &s->hits[r]);
+	});
+	RegisterRay("IntersectTriangle (packet)", packets, 44 * packets / kPacketPrimitives, [](RayScene* s){
+		s->ResetHits();
+		for(size_t i = 0; i < kPacketPrimitives; ++i) IntersectTriangle(s->packet, s->a[i], s->b[i], s->c[i], (uint32_t)i, &s->hits[0]);
+	});
+	RegisterRay("IntersectBox (per ray)", packets, 44 * packets / kPacketPrimitives, [](RayScene* s){
+		s->ResetHits();
+		for(size_t r = 0; r < kPacketRays; ++r)
+			for(size_t i = 0; i < kPacketPrimitives; ++i)
+				IntersectBox(s->rays[r], AABB(s->min.Get(i), s->max.Get(i)), (uint32_t)i, &s->hits[r]);
+	});
+	RegisterRay("IntersectBox (packet)", packets, 44 * packets / kPacketPrimitives, [](RayScene* s){
+		s->ResetHits();
+		for(size_t i = 0; i < kPacketPrimitives; ++i)
+			IntersectBox(s->packet, AABB(s->min.Get(i), s->max.Get(i)), (uint32_t)i, &s->hits[0]);
+	});
+}
+
+// Query latency of both widths on a million triangles, against the
+// brute-force scan, and the cost of Build and Refit. Operations count
+// rays for the queries and triangles for Build and Refit.
+template<typename Kernel>
+static void RegisterBvhBenchmark(const std::string& name, double operations, Kernel kernel){
+	RegisterBenchmark("Bvh", name, operations, 0.0, [kernel](){
+		std::shared_ptr<BvhScene> scene(new BvhScene());
+		return BenchRun([scene, kernel](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				kernel(scene.get());
+				ClobberMemory();
+			}
+		});
+	});
+}
+
+static void RegisterBvh(){
+	const double triangles = (double)(kBvhSide * kBvhSide * 2), rays = (double)kBvhRays;
+	RegisterBvhBenchmark("IntersectTriangles (1 ray)", 1.0, [](BvhScene* s){
+		s->hit = IntersectTriangles(s->rays[0], s->mesh);
+	});
+	RegisterBvhBenchmark("xBvh4::Intersect", rays, [](BvhScene* s){
+		for(size_t r = 0; r < kBvhRays; ++r) s->hits[r] = s->bvh4.Intersect(s->rays[r]);
+	});
+	RegisterBvhBenchmark("xBvh8::Intersect", rays, [](BvhScene* s){
+		for(size_t r = 0; r < kBvhRays; ++r) s->hits[r] = s->bvh8.Intersect(s->rays[r]);
+	});
+	RegisterBvhBenchmark("xBvh8::Intersect(RaySoA, kParallel)", rays, [](BvhScene* s){
+		s->ResetHits();
+		s->bvh8.Intersect(s->stream, &s->hits[0], kParallel);
+	});
+	RegisterBvhBenchmark("xBvh4::Build(kSequential)", triangles, [](BvhScene* s){
+		s->bvh4.Build(&s->vertices[0], &s->indices[0], s->Triangles(), kSequential);
+	});
+	RegisterBvhBenchmark("xBvh8::Build", triangles, [](BvhScene* s){
+		s->bvh8.Build(&s->vertices[0], &s->indices[0], s->Triangles());
+	});
+	RegisterBvhBenchmark("xBvh8::Refit", triangles, [](BvhScene* s){ s->bvh8.Refit(&s->moved[0]); });
+}
+
+// Radius and k-nearest queries against scans of every point, and the
+// cost of Build and Move. Operations count queries, or points for Build
+// and Move.
+template<typename Kernel>
+static void RegisterHashGridBenchmark(const std::string& name, double operations, Kernel kernel){
+	RegisterBenchmark("HashGrid", name, operations, 0.0, [kernel](){
+		std::shared_ptr<HashGridScene> scene(new HashGridScene());
+		return BenchRun([scene, kernel](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				kernel(scene.get());
+				ClobberMemory();
+			}
+		});
+	});
+}
+
+static void RegisterHashGrid(){
+	const double queries = (double)kHashGridQueries, points = (double)kHashGridPoints;
+	RegisterHashGridBenchmark("Vec3::Distance <= r (1 query)", 1.0, [](HashGridScene* s){
+		s->found.clear();
+		for(size_t i = 0; i < kHashGridPoints; ++i)
+			if(Vec3::Distance(s->points[i], s->queries[0]) <= kHashGridCell) s->found.push_back((uint32_t)i);
+	});
+	RegisterHashGridBenchmark("QueryRadius", queries, [](HashGridScene* s){
+		s->found.clear();
+		for(size_t q = 0; q < kHashGridQueries; ++q) s->grid.QueryRadius(s->queries[q], kHashGridCell, &s->found);
+	});
+	RegisterHashGridBenchmark("SqrMagnitude nearest (1 query)", 1.0, [](HashGridScene* s){
+		float best = INFINITY;
+		for(size_t i = 0; i < kHashGridPoints; ++i){
+			float d = (s->points[i] - s->queries[0]).SqrMagnitude();
+			if(d < best){
+				best = d;
+				s->indices[0] = (uint32_t)i;
+			}
+		}
+		s->squared[0] = best;
+	});
+	RegisterHashGridBenchmark("QueryNearest (k = 8)", queries, [](HashGridScene* s){
+		for(size_t q = 0; q < kHashGridQueries; ++q)
+			s->grid.QueryNearest(s->queries[q], kHashGridNeighbors, &s->indices[q * kHashGridNeighbors],
+			                     &s->squared[q * kHashGridNeighbors]);
+	});
+	RegisterHashGridBenchmark("QueryNearest (k = 8, kParallel)", queries, [](HashGridScene* s){
+		s->grid.QueryNearest(&s->queries[0], kHashGridQueries, kHashGridNeighbors, &s->indices[0], &s->squared[0]);
+	});
+	RegisterHashGridBenchmark("Build(kSequential)", points, [](HashGridScene* s){
+		s->grid.Build(&s->points[0], kHashGridPoints, kHashGridCell, kSequential);
+	});
+	RegisterHashGridBenchmark("Build", points, [](HashGridScene* s){
+		s->grid.Build(&s->points[0], kHashGridPoints, kHashGridCell);
+	});
+	// Every point steps a tenth of a cell back and forth.
+	RegisterHashGridBenchmark("Move", points, [](HashGridScene* s){
+		float offset = ++s->step % 2 ? 0.1f : -0.1f;
+		for(size_t i = 0; i < kHashGridPoints; ++i){
+			s->points[i].x += offset;
+			s->grid.Move((uint32_t)i, s->points[i]);
+		}
+	});
+}
+
+// Nearest-neighbor and radius queries against a scan of every point,
+// and the cost of Build. Operations count queries, or points for Build.
+template<typename Kernel>
+static void RegisterKdTreeBenchmark(const std::string& name, double operations, Kernel kernel){
+	RegisterBenchmark("KdTree", name, operations, 0.0, [kernel](){
+		std::shared_ptr<KdTreeScene> scene(new KdTreeScene());
+		return BenchRun([scene, kernel](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				kernel(scene.get());
+				ClobberMemory();
+			}
+		});
+	});
+}
+
+static void RegisterKdTree(){
+	const double queries = (double)kKdTreeQueries, points = (double)kKdTreePoints;
+	RegisterKdTreeBenchmark("SqrMagnitude nearest (1 query)", 1.0, [](KdTreeScene* s){
+		float best = INFINITY;
+		for(size_t i = 0; i < kKdTreePoints; ++i){
+			float d = (s->points[i] - s->queries[0]).SqrMagnitude();
+			if(d < best){
+				best = d;
+				s->indices[0] = (uint32_t)i;
+			}
+		}
+		s->squared[0] = best;
+	});
+	RegisterKdTreeBenchmark("QueryNearest (k = 1)", queries, [](KdTreeScene* s){
+		for(size_t q = 0; q < kKdTreeQueries; ++q) s->tree.QueryNearest(s->queries[q], 1, &s->indices[q], &s->squared[q]);
+	});
+	RegisterKdTreeBenchmark("QueryNearest (k = 1, kParallel)", queries, [](KdTreeScene* s){
+		s->tree.QueryNearest(&s->queries[0], kKdTreeQueries, 1, &s->indices[0], &s->squared[0]);
+	});
+	RegisterKdTreeBenchmark("QueryNearest (k = 8)", queries, [](KdTreeScene* s){
+		for(size_t q = 0; q < kKdTreeQueries; ++q)
+			s->tree.QueryNearest(s->queries[q], kKdTreeNeighbors, &s->indices[q * kKdTreeNeighbors], &s->squared[q * kKdTreeNeighbors]);
+	});
+	RegisterKdTreeBenchmark("QueryRadius (r = 0.5, kParallel)", queries, [](KdTreeScene* s){
+		s->tree.QueryRadius(&s->queries[0], kKdTreeQueries, 0.5f, &s->found, &s->offsets);
+	});
+	RegisterKdTreeBenchmark("Build(kSequential)", points, [](KdTreeScene* s){
+		s->tree.Build(&s->points[0], kKdTreePoints, kSequential);
+	});
+	RegisterKdTreeBenchmark("Build", points, [](KdTreeScene* s){ s->tree.Build(&s->points[0], kKdTreePoints); });
+}
+
+// Scalar loops over every pair against the tiled kernels, for the full
+// matrix and for the k nearest of each row. Operations count pairs.
+template<typename Kernel>
+static void RegisterPairwiseBenchmark(const std::string& name, double bytes, Kernel kernel){
+	const double pairs = (double)kPairwiseA * kPairwiseB;
+	RegisterBenchmark("Pairwise", name, pairs, bytes * pairs, [kernel](){
+		std::shared_ptr<PairwiseScene> scene(new PairwiseScene());
+		return BenchRun([scene, kernel](size_t iterations){
+			for(size_t it = 0; it < iterations; ++it){
+				kernel(scene.get());
+				ClobberMemory();
+			}
+		});
+	});
+}
+
+static void RegisterPairwise(){
+	RegisterPairwiseBenchmark("SqrMagnitude (matrix)", 4, [](PairwiseScene* s){
+		for(size_t i = 0; i < kPairwiseA; ++i)
+			for(size_t j = 0; j < kPairwiseB; ++j) s->matrix[i * kPairwiseB + j] = (s->a[i] - s->b[j]).SqrMagnitude();
+	});
+	RegisterPairwiseBenchmark("PairwiseSquaredDistances", 4, [](PairwiseScene* s){
+		PairwiseSquaredDistances(s->a_soa, s->b_soa, &s->matrix[0], kPairwiseB);
+	});
+	RegisterPairwiseBenchmark("PairwiseSquaredDistances(kParallel)", 4, [](PairwiseScene* s){
+		PairwiseSquaredDistances(s->a_soa, s->b_soa, &s->matrix[0], kPairwiseB, kParallel);
+	});
+	// Insertion into a sorted list of 8, as a hand-written scan would.
+	RegisterPairwiseBenchmark("SqrMagnitude (k = 8)", 0, [](PairwiseScene* s){
+		for(size_t i = 0; i < kPairwiseA; ++i){
+			uint32_t* indices = &s->indices[i * kPairwiseNeighbors];
+			float* squared = &s->squared[i * kPairwiseNeighbors];
+			size_t found = 0;
+			for(size_t j = 0; j < kPairwiseB; ++j){
+				float d = (s->a[i] - s->b[j]).SqrMagnitude();
+				if(found == kPairwiseNeighbors && d >= squared[found - 1]) continue;
+				size_t at = found < kPairwiseNeighbors ? found++ : found - 1;
+				for(; at > 0 && squared[at - 1] > d; --at){
+					squared[at] = squared[at - 1];
+					indices[at] = indices[at - 1];
+				}
+				squared[at] = d;
+				indices[at] = (uint32_t)j;
+			}
+		}
+	});
+	RegisterPairwiseBenchmark("PairwiseNearest (k = 8)", 0, [](PairwiseScene* s){
+		PairwiseNearest(s->a_soa, s->b_soa, kPairwiseNeighbors, &s->indices[0], &s->squared[0]);
+	});
+	RegisterPairwiseBenchmark("PairwiseNearest (k = 8, kParallel)", 0, [](PairwiseScene* s){
+		PairwiseNearest(s->a_soa, s->b_soa, kPairwiseNeighbors, &s->indices[0], &s->squared[0], kParallel);
+	});
+}
+
+// libm loops against the array kernels of xTranscendental.h.
+static void RegisterTranscendentals(){
+	RegisterSizes<FloatBatch>("float[]", "sinf", 8, 1, [](FloatBatch* s){
+		for(size_t i = 0; i < s->x.size(); ++i) s->out[i] = sinf(s->x[i]);
+	});
+	RegisterSizes<FloatBatch>("float[]", "Sin", 8, 1, [](FloatBatch* s){ Sin(&s->x[0], &s->out[0], s->x.size()); });
+	RegisterSizes<FloatBatch>("float[]", "Sin(kParallel)", 8, 1, [](FloatBatch* s){ Sin(&s->x[0], &s->out[0], s->x.size(), kParallel); });
+	RegisterSizes<FloatBatch>("float[]", "sinf+cosf", 12, 1, [](FloatBatch* s){
+		for(size_t i = 0; i < s->x.size(); ++i){
+			s->out[i] = sinf(s->x[i]);
+			s->out2[i] = cosf(s->x[i]);
+		}
+	});
+	RegisterSizes<FloatBatch>("float[]", "SinCos", 12, 1, [](FloatBatch* s){
+		SinCos(&s->x[0], &s->out[0], &s->out2[0], s->x.size());
+	});
+	RegisterSizes<FloatBatch>("float[]", "acosf", 8, 1, [](FloatBatch* s){
+		for(size_t i = 0; i < s->y.size(); ++i) s->out[i] = acosf(s->y[i]);
+	});
+	RegisterSizes<FloatBatch>("float[]", "Acos", 8, 1, [](FloatBatch* s){ Acos(&s->y[0], &s->out[0], s->y.size()); });
+	RegisterSizes<FloatBatch>("float[]", "atan2f", 12, 1, [](FloatBatch* s){
+		for(size_t i = 0; i < s->y.size(); ++i) s->out[i] = atan2f(s->y[i], s->x[i]);
+	});
+	RegisterSizes<FloatBatch>("float[]", "Atan2", 12, 1, [](FloatBatch* s){
+		Atan2(&s->y[0], &s->x[0], &s->out[0], s->y.size());
+	});
+	RegisterSizes<FloatBatch>("float[]", "expf", 8, 1, [](FloatBatch* s){
+		for(size_t i = 0; i < s->x.size(); ++i) s->out[i] = expf(s->x[i]);
+	});
+	RegisterSizes<FloatBatch>("float[]", "Exp", 8, 1, [](FloatBatch* s){ Exp(&s->x[0], &s->out[0], s->x.size()); });
+}
+
+void RegisterBatchBenchmarks(){
+	RegisterAoS();
+	RegisterSoA();
+	RegisterTransforms();
+	RegisterInverses();
+	RegisterMat4Multiply();
+	RegisterQuaternions();
+	RegisterTRS();
+	RegisterHierarchy();
+	RegisterBounds();
+	RegisterCulling();
+	RegisterRays();
+	RegisterBvh();
+	RegisterHashGrid();
+	RegisterKdTree();
+	RegisterPairwise();
+	RegisterTranscendentals();
+}
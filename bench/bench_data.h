@@ -0,0 +1,135 @@
+#ifndef __BENCH_DATA_H__
+#define __BENCH_DATA_H__ 1
+
+#include <vector>
+#include "bench.h"
+#include "vector_2.h"
+#include "vector_3.h"
+#include "vector_4.h"
+#include "matrix_2.h"
+#include "matrix_3.h"
+#include "matrix_4.h"
+#include "quaternion.h"
+#include "xVector3.h"
+#include "xVector4.h"
+#include "xVector2x2.h"
+#include "xQuaternion.h"
+#include "xMatrix4.h"
+
+// Values in [-1, 1), except scalars used as divisors, which stay in [1, 2).
+inline std::vector<float> RandomFloats(size_t count, uint32_t seed){
+	std::vector<float> result(count);
+	for(size_t i = 0; i < count; ++i) result[i] = BenchRandom(&seed) * 0.5f + 1.5f;
+	return result;
+}
+
+inline std::vector<Vec2> RandomVec2(size_t count, uint32_t seed){
+	std::vector<Vec2> result(count);
+	for(size_t i = 0; i < count; ++i){
+		result[i].x = BenchRandom(&seed);
+		result[i].y = BenchRandom(&seed);
+	}
+	return result;
+}
+
+inline std::vector<Vec3> RandomVec3(size_t count, uint32_t seed){
+	std::vector<Vec3> result(count);
+	for(size_t i = 0; i < count; ++i){
+		float x = BenchRandom(&seed);
+		float y = BenchRandom(&seed);
+		float z = BenchRandom(&seed);
+		result[i] = Vec3(x, y, z);
+	}
+	return result;
+}
+
+inline std::vector<Vec4> RandomVec4(size_t count, uint32_t seed){
+	std::vector<Vec4> result(count);
+	for(size_t i = 0; i < count; ++i){
+		float x = BenchRandom(&seed);
+		float y = BenchRandom(&seed);
+		float z = BenchRandom(&seed);
+		float w = BenchRandom(&seed);
+		result[i] = Vec4(x, y, z, w);
+	}
+	return result;
+}
+
+inline std::vector<xVector3> RandomXVector3(size_t count, uint32_t seed){
+	std::vector<Vec3> source = RandomVec3(count, seed);
+	std::vector<xVector3> result(count);
+	for(size_t i = 0; i < count; ++i) result[i] = xVector3(&source[i].x);
+	return result;
+}
+
+inline std::vector<xVector4> RandomXVector4(size_t count, uint32_t seed){
+	std::vector<Vec4> source = RandomVec4(count, seed);
+	std::vector<xVector4> result(count);
+	for(size_t i = 0; i < count; ++i) result[i] = xVector4(source[i]);
+	return result;
+}
+
+inline std::vector<xVector2x2> RandomXVector2x2(size_t count, uint32_t seed){
+	std::vector<Vec2> source = RandomVec2(count * 2, seed);
+	std::vector<xVector2x2> result(count);
+	for(size_t i = 0; i < count; ++i) result[i] = xVector2x2(&source[i * 2]);
+	return result;
+}
+
+// Unit quaternions.
+inline std::vector<xQuaternion> RandomXQuaternion(size_t count, uint32_t seed){
+	std::vector<Vec4> source = RandomVec4(count, seed);
+	std::vector<xQuaternion> result(count);
+	for(size_t i = 0; i < count; ++i) result[i] = Normalize(xQuaternion(source[i]));
+	return result;
+}
+
+inline std::vector<Quat> RandomQuat(size_t count, uint32_t seed){
+	std::vector<xQuaternion> source = RandomXQuaternion(count, seed);
+	std::vector<Quat> result(count);
+	for(size_t i = 0; i < count; ++i) result[i] = source[i].ToQuat();
+	return result;
+}
+
+inline std::vector<Mat2> RandomMat2(size_t count, uint32_t seed){
+	std::vector<Mat2> result(count);
+	for(size_t i = 0; i < count; ++i)
+		for(int j = 0; j < 4; ++j) result[i].m[j] = BenchRandom(&seed);
+	return result;
+}
+
+inline std::vector<Mat3> RandomMat3(size_t count, uint32_t seed){
+	std::vector<Mat3> result(count);
+	for(size_t i = 0; i < count; ++i)
+		for(int j = 0; j < 9; ++j) result[i].m[j] = BenchRandom(&seed);
+	return result;
+}
+
+inline std::vector<Mat4> RandomMat4(size_t count, uint32_t seed){
+	std::vector<Mat4> result(count);
+	for(size_t i = 0; i < count; ++i)
+		for(int j = 0; j < 16; ++j) result[i].m[j] = BenchRandom(&seed);
+	return result;
+}
+
+// Scale-rotate-translate matrices, so the affine and rigid inverse paths
+// see the inputs they are written for.
+inline std::vector<Mat4> RandomTransforms(size_t count, uint32_t seed, bool unit_scale){
+	std::vector<Mat4> result(count);
+	for(size_t i = 0; i < count; ++i){
+		float t[3], s[3], r[3];
+		for(int j = 0; j < 3; ++j) t[j] = BenchRandom(&seed) * 10.0f;
+		for(int j = 0; j < 3; ++j) s[j] = unit_scale ? 1.0f : BenchRandom(&seed) * 0.5f + 1.5f;
+		for(int j = 0; j < 3; ++j) r[j] = BenchRandom(&seed) * 3.14159265f;
+		result[i] = Mat4::GetTransform(t[0], t[1], t[2], s[0], s[1], s[2], r[0], r[1], r[2]);
+	}
+	return result;
+}
+
+inline std::vector<xMatrix4> ToXMatrix4(const std::vector<Mat4>& source){
+	std::vector<xMatrix4> result(source.size());
+	for(size_t i = 0; i < source.size(); ++i) result[i] = xMatrix4(source[i]);
+	return result;
+}
+
+#endif // __BENCH_DATA_H__
@@ -0,0 +1,148 @@
+#include "bench_data.h"
+
+static void RegisterMat2(){
+	std::vector<Mat2> a = RandomMat2(kScalarBatch, 20);
+	std::vector<Mat2> b = RandomMat2(kScalarBatch, 21);
+	std::vector<float> s = RandomFloats(kScalarBatch, 22);
+	std::vector<int> index(kScalarBatch);
+	for(size_t i = 0; i < kScalarBatch; ++i) index[i] = (int)(i & 1);
+
+	RegisterUnary("Mat2", "Identity", s, [](float){ return Mat2::Identity(); });
+	RegisterBinary("Mat2", "Multiply", a, b, [](const Mat2& a, const Mat2& b){ return a.Multiply(b); });
+	RegisterUnary("Mat2", "Determinant", a, [](const Mat2& a){ return a.Determinant(); });
+	RegisterUnary("Mat2", "Adjoint", a, [](const Mat2& a){ return a.Adjoint(); });
+	RegisterUnary("Mat2", "Inverse", a, [](const Mat2& a){ return a.Inverse(); });
+	RegisterUnary("Mat2", "Transpose", a, [](const Mat2& a){ return a.Transpose(); });
+	RegisterBinary("Mat2", "GetLine", a, index, [](const Mat2& a, int i){ return a.GetLine(i); });
+	RegisterBinary("Mat2", "GetColum", a, index, [](const Mat2& a, int i){ return a.GetColum(i); });
+	RegisterBinary("Mat2", "operator+", a, b, [](const Mat2& a, const Mat2& b){ return a + b; });
+	RegisterBinary("Mat2", "operator+=", a, b, [](Mat2 a, const Mat2& b){ a += b; return a; });
+	RegisterBinary("Mat2", "operator+(float)", a, s, [](const Mat2& a, float s){ return a + s; });
+	RegisterBinary("Mat2", "operator-", a, b, [](const Mat2& a, const Mat2& b){ return a - b; });
+	RegisterBinary("Mat2", "operator-=", a, b, [](Mat2 a, const Mat2& b){ a -= b; return a; });
+	RegisterBinary("Mat2", "operator-(float)", a, s, [](const Mat2& a, float s){ return a - s; });
+	RegisterBinary("Mat2", "operator*(float)", a, s, [](const Mat2& a, float s){ return a * s; });
+	RegisterBinary("Mat2", "operator*=(float)", a, s, [](Mat2 a, float s){ a *= s; return a; });
+	RegisterBinary("Mat2", "operator/(float)", a, s, [](const Mat2& a, float s){ return a / s; });
+	RegisterBinary("Mat2", "operator/=(float)", a, s, [](Mat2 a, float s){ a /= s; return a; });
+	RegisterBinary("Mat2", "operator==", a, b, [](const Mat2& a, const Mat2& b){ return a == b; });
+	RegisterBinary("Mat2", "operator!=", a, b, [](const Mat2& a, const Mat2& b){ return a != b; });
+}
+
+static void RegisterMat3(){
+	std::vector<Mat3> a = RandomMat3(kScalarBatch, 23);
+	std::vector<Mat3> b = RandomMat3(kScalarBatch, 24);
+	std::vector<float> s = RandomFloats(kScalarBatch, 25);
+	std::vector<Vec2> v = RandomVec2(kScalarBatch, 26);
+	std::vector<int> index(kScalarBatch);
+	for(size_t i = 0; i < kScalarBatch; ++i) index[i] = (int)(i % 3);
+
+	RegisterUnary("Mat3", "Identity", s, [](float){ return Mat3::Identity(); });
+	RegisterBinary("Mat3", "Multiply", a, b, [](const Mat3& a, const Mat3& b){ return a.Multiply(b); });
+	RegisterUnary("Mat3", "Determinant", a, [](const Mat3& a){ return a.Determinant(); });
+	RegisterUnary("Mat3", "Adjoint", a, [](const Mat3& a){ return a.Adjoint(); });
+	RegisterUnary("Mat3", "GetInverse", a, [](const Mat3& a){ Mat3 out; a.GetInverse(out); return out; });
+	RegisterUnary("Mat3", "Inverse", a, [](Mat3 a){ a.Inverse(); return a; });
+	RegisterUnary("Mat3", "Transpose", a, [](const Mat3& a){ return a.Transpose(); });
+	RegisterUnary("Mat3", "Translate", v, [](const Vec2& v){ return Mat3::Translate(v); });
+	RegisterUnary("Mat3", "Scale", v, [](const Vec2& v){ return Mat3::Scale(v); });
+	RegisterUnary("Mat3", "Rotate", s, [](float s){ return Mat3::Rotate(s); });
+	RegisterBinary("Mat3", "GetColum", a, index, [](const Mat3& a, int i){ return a.GetColum(i); });
+	RegisterBinary("Mat3", "GetLine", a, index, [](const Mat3& a, int i){ return a.GetLine(i); });
+	RegisterBinary("Mat3", "operator+", a, b, [](const Mat3& a, const Mat3& b){ return a + b; });
+	RegisterBinary("Mat3", "operator+=", a, b, [](Mat3 a, const Mat3& b){ a += b; return a; });
+	RegisterBinary("Mat3", "operator+(float)", a, s, [](const Mat3& a, float s){ return a + s; });
+	RegisterBinary("Mat3", "operator-", a, b, [](const Mat3& a, const Mat3& b){ return a - b; });
+	RegisterBinary("Mat3", "operator-=", a, b, [](Mat3 a, const Mat3& b){ a -= b; return a; });
+	RegisterBinary("Mat3", "operator-(float)", a, s, [](const Mat3& a, float s){ return a - s; });
+	RegisterBinary("Mat3", "operator*(float)", a, s, [](const Mat3& a, float s){ return a * s; });
+	RegisterBinary("Mat3", "operator*=(float)", a, s, [](Mat3 a, float s){ a *= s; return a; });
+	RegisterBinary("Mat3", "operator/(float)", a, s, [](const Mat3& a, float s){ return a / s; });
+	RegisterBinary("Mat3", "operator/=(float)", a, s, [](Mat3 a, float s){ a /= s; return a; });
+	RegisterBinary("Mat3", "operator==", a, b, [](const Mat3& a, const Mat3& b){ return a == b; });
+	RegisterBinary("Mat3", "operator!=", a, b, [](const Mat3& a, const Mat3& b){ return a != b; });
+}
+
+static void RegisterMat4(){
+	std::vector<Mat4> a = RandomMat4(kScalarBatch, 27);
+	std::vector<Mat4> b = RandomMat4(kScalarBatch, 28);
+	std::vector<Mat4> affine = RandomTransforms(kScalarBatch, 29, false);
+	std::vector<Mat4> rigid = RandomTransforms(kScalarBatch, 30, true);
+	std::vector<float> s = RandomFloats(kScalarBatch, 31);
+	std::vector<Vec3> v3 = RandomVec3(kScalarBatch, 32);
+	std::vector<Vec4> v4 = RandomVec4(kScalarBatch, 33);
+	std::vector<Quat> q = RandomQuat(kScalarBatch, 34);
+	std::vector<Mat3> r(kScalarBatch);
+	for(size_t i = 0; i < kScalarBatch; ++i) r[i] = q[i].ToMat3();
+	std::vector<int> index(kScalarBatch);
+	for(size_t i = 0; i < kScalarBatch; ++i) index[i] = (int)(i & 3);
+
+	RegisterUnary("Mat4", "Identity", s, [](float){ return Mat4::Identity(); });
+	RegisterBinary("Mat4", "Multiply", a, b, [](const Mat4& a, const Mat4& b){ return a.Multiply(b); });
+	RegisterUnary("Mat4", "Determinant", a, [](const Mat4& a){ return a.Determinant(); });
+	RegisterUnary("Mat4", "Adjoint", a, [](const Mat4& a){ return a.Adjoint(); });
+	RegisterUnary("Mat4", "GetInverse", affine, [](const Mat4& a){ Mat4 out; a.GetInverse(&out); return out; });
+	RegisterUnary("Mat4", "Inverse", affine, [](Mat4 a){ a.Inverse(); return a; });
+	RegisterUnary("Mat4", "IsAffine", affine, [](const Mat4& a){ return a.IsAffine(); });
+	RegisterUnary("Mat4", "GetInverseAffine", affine, [](const Mat4& a){ Mat4 out; a.GetInverseAffine(&out); return out; });
+	RegisterUnary("Mat4", "InverseAffine", affine, [](Mat4 a){ a.InverseAffine(); return a; });
+	RegisterUnary("Mat4", "GetInverseRigid", rigid, [](const Mat4& a){ Mat4 out; a.GetInverseRigid(&out); return out; });
+	RegisterUnary("Mat4", "InverseRigid", rigid, [](Mat4 a){ a.InverseRigid(); return a; });
+	RegisterUnary("Mat4", "Transpose", a, [](const Mat4& a){ return a.Transpose(); });
+	RegisterUnary("Mat4", "Translate", v3, [](const Vec3& v){ return Mat4::Translate(v); });
+	RegisterUnary("Mat4", "Scale", v3, [](const Vec3& v){ return Mat4::Scale(v); });
+	RegisterUnary("Mat4", "RotateX", s, [](float s){ return Mat4::RotateX(s); });
+	RegisterUnary("Mat4", "RotateY", s, [](float s){ return Mat4::RotateY(s); });
+	RegisterUnary("Mat4", "RotateZ", s, [](float s){ return Mat4::RotateZ(s); });
+	RegisterBinary("Mat4", "GetTransform", v3, s, [](const Vec3& v, float s){ return Mat4::GetTransform(v, v, s, s, s); });
+	RegisterBinary("Mat4", "GetTransform(ZYX)", v3, s, [](const Vec3& v, float s){ return Mat4::GetTransform(v, v, s, s, s, kRotateZYX); });
+	RegisterUnary("Mat4", "GetRotation", s, [](float s){ return Mat4::GetRotation(s, s, s); });
+	RegisterBinary("Mat4", "GetTransform(Mat3)", v3, r, [](const Vec3& v, const Mat3& r){ return Mat4::GetTransform(v, v, r); });
+	RegisterBinary("Quat", "ToTransform", q, v3, [](const Quat& q, const Vec3& v){ return q.ToTransform(v, v); });
+	RegisterBinary("Mat4", "GetColum", a, index, [](const Mat4& a, int i){ return a.GetColum(i); });
+	RegisterBinary("Mat4", "GetLine", a, index, [](const Mat4& a, int i){ return a.GetLine(i); });
+	RegisterBinary("Mat4", "operator+", a, b, [](const Mat4& a, const Mat4& b){ return a + b; });
+	RegisterBinary("Mat4", "operator+=", a, b, [](Mat4 a, const Mat4& b){ a += b; return a; });
+	RegisterBinary("Mat4", "operator+(float)", a, s, [](const Mat4& a, float s){ return a + s; });
+	RegisterBinary("Mat4", "operator-", a, b, [](const Mat4& a, const Mat4& b){ return a - b; });
+	RegisterBinary("Mat4", "operator-=", a, b, [](Mat4 a, const Mat4& b){ a -= b; return a; });
+	RegisterBinary("Mat4", "operator-(float)", a, s, [](const Mat4& a, float s){ return a - s; });
+	RegisterBinary("Mat4", "operator*(float)", a, s, [](const Mat4& a, float s){ return a * s; });
+	RegisterBinary("Mat4", "operator*=(float)", a, s, [](Mat4 a, float s){ a *= s; return a; });
+	RegisterBinary("Mat4", "operator/(float)", a, s, [](const Mat4& a, float s){ return a / s; });
+	RegisterBinary("Mat4", "operator/=(float)", a, s, [](Mat4 a, float s){ a /= s; return a; });
+	RegisterBinary("Mat4", "operator==", a, b, [](Mat4 a, const Mat4& b){ return a == b; });
+	RegisterBinary("Mat4", "operator!=", a, b, [](Mat4 a, const Mat4& b){ return a != b; });
+	RegisterBinary("Mat4", "Mat4TransformVec3", a, v3, [](const Mat4& a, const Vec3& v){ return Mat4::Mat4TransformVec3(a, v); });
+	RegisterBinary("Mat4", "Mat4TransformVec4", a, v4, [](const Mat4& a, const Vec4& v){ return Mat4::Mat4TransformVec4(a, v); });
+}
+
+static void RegisterXMatrix4(){
+	std::vector<xMatrix4> a = ToXMatrix4(RandomMat4(kScalarBatch, 34));
+	std::vector<xMatrix4> b = ToXMatrix4(RandomMat4(kScalarBatch, 35));
+	std::vector<xMatrix4> affine = ToXMatrix4(RandomTransforms(kScalarBatch, 29, false));
+	std::vector<xMatrix4> rigid = ToXMatrix4(RandomTransforms(kScalarBatch, 30, true));
+	std::vector<float> s = RandomFloats(kScalarBatch, 36);
+	std::vector<xVector3> v = RandomXVector3(kScalarBatch, 37);
+
+	RegisterBinary("xMatrix4", "Multiply", a, b, [](const xMatrix4& a, const xMatrix4& b){ return Multiply(a, b); });
+	RegisterBinary("xMatrix4", "Transform", a, v, [](const xMatrix4& a, xVector3 v){ return Transform(a, v.xmm); });
+	RegisterBinary("xMatrix4", "TransformPoint", a, v, [](const xMatrix4& a, xVector3 v){ return TransformPoint(a, v); });
+	RegisterBinary("xMatrix4", "TransformDirection", a, v, [](const xMatrix4& a, xVector3 v){ return TransformDirection(a, v); });
+	RegisterUnary("xMatrix4", "Transpose", a, [](const xMatrix4& a){ return Transpose(a); });
+	RegisterUnary("xMatrix4", "Inverse", affine, [](const xMatrix4& a){ xMatrix4 out; Inverse(a, &out); return out; });
+	RegisterUnary("xMatrix4", "InverseAffine", affine, [](const xMatrix4& a){ xMatrix4 out; InverseAffine(a, &out); return out; });
+	RegisterUnary("xMatrix4", "InverseRigid", rigid, [](const xMatrix4& a){ return InverseRigid(a); });
+	RegisterBinary("xMatrix4", "operator+", a, b, [](const xMatrix4& a, const xMatrix4& b){ return a + b; });
+	RegisterBinary("xMatrix4", "operator-", a, b, [](const xMatrix4& a, const xMatrix4& b){ return a - b; });
+	RegisterBinary("xMatrix4", "operator*(float)", a, s, [](const xMatrix4& a, float s){ return a * s; });
+	RegisterBinary("xMatrix4", "operator==", a, b, [](const xMatrix4& a, const xMatrix4& b){ return a == b; });
+	RegisterBinary("xMatrix4", "operator!=", a, b, [](const xMatrix4& a, const xMatrix4& b){ return a != b; });
+}
+
+void RegisterMatrixBenchmarks(){
+	RegisterMat2();
+	RegisterMat3();
+	RegisterMat4();
+	RegisterXMatrix4();
+}
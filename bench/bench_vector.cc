@@ -0,0 +1,228 @@
+#include "bench_data.h"
+
+static void RegisterVec2(){
+	std::vector<Vec2> a = RandomVec2(kScalarBatch, 1);
+	std::vector<Vec2> b = RandomVec2(kScalarBatch, 2);
+	std::vector<float> s = RandomFloats(kScalarBatch, 3);
+
+	RegisterBinary("Vec2", "operator+", a, b, [](const Vec2& a, const Vec2& b){ return a + b; });
+	RegisterBinary("Vec2", "operator+(float)", a, s, [](Vec2 a, float s){ return a + s; });
+	RegisterBinary("Vec2", "operator+=", a, b, [](Vec2 a, const Vec2& b){ a += b; return a; });
+	RegisterBinary("Vec2", "operator+=(float)", a, s, [](Vec2 a, float s){ a += s; return a; });
+	RegisterBinary("Vec2", "operator-", a, b, [](const Vec2& a, const Vec2& b){ return a - b; });
+	RegisterBinary("Vec2", "operator-(float)", a, s, [](const Vec2& a, float s){ return a - s; });
+	RegisterBinary("Vec2", "operator-=", a, b, [](Vec2 a, const Vec2& b){ a -= b; return a; });
+	RegisterBinary("Vec2", "operator-=(float)", a, s, [](Vec2 a, float s){ a -= s; return a; });
+	RegisterBinary("Vec2", "operator*(float)", a, s, [](const Vec2& a, float s){ return a * s; });
+	RegisterBinary("Vec2", "operator*=(float)", a, s, [](Vec2 a, float s){ a *= s; return a; });
+	RegisterBinary("Vec2", "operator/(float)", a, s, [](const Vec2& a, float s){ return a / s; });
+	RegisterBinary("Vec2", "operator/=(float)", a, s, [](Vec2 a, float s){ a /= s; return a; });
+	RegisterBinary("Vec2", "operator==", a, b, [](const Vec2& a, const Vec2& b){ return a == b; });
+	RegisterBinary("Vec2", "operator!=", a, b, [](const Vec2& a, const Vec2& b){ return a != b; });
+	RegisterUnary("Vec2", "Magnitude", a, [](const Vec2& a){ return a.Magnitude(); });
+	RegisterUnary("Vec2", "SqrMagnitude", a, [](const Vec2& a){ return a.SqrMagnitude(); });
+	RegisterUnary("Vec2", "Normalize", a, [](Vec2 a){ a.Normalize(); return a; });
+	RegisterUnary("Vec2", "Normalized", a, [](const Vec2& a){ return a.Normalized(); });
+	RegisterBinary("Vec2", "Scale", a, b, [](Vec2 a, const Vec2& b){ a.Scale(b); return a; });
+	RegisterBinary("Vec2", "Distance", a, b, [](const Vec2& a, const Vec2& b){ return Vec2::Distance(a, b); });
+	RegisterBinary("Vec2", "DotProduct", a, b, [](const Vec2& a, const Vec2& b){ return Vec2::DotProduct(a, b); });
+	RegisterBinary("Vec2", "Lerp", a, b, [](const Vec2& a, const Vec2& b){ return Vec2::Lerp(a, b, 0.25f); });
+	RegisterBinary("Vec2", "LerpUnclamped", a, b, [](const Vec2& a, const Vec2& b){ return Vec2::LerpUnclamped(a, b, 0.25f); });
+}
+
+static void RegisterVec3(){
+	std::vector<Vec3> a = RandomVec3(kScalarBatch, 4);
+	std::vector<Vec3> b = RandomVec3(kScalarBatch, 5);
+	std::vector<float> s = RandomFloats(kScalarBatch, 6);
+
+	RegisterBinary("Vec3", "operator+", a, b, [](const Vec3& a, const Vec3& b){ return a + b; });
+	RegisterBinary("Vec3", "operator+(float)", a, s, [](const Vec3& a, float s){ return a + s; });
+	RegisterBinary("Vec3", "operator+=", a, b, [](Vec3 a, const Vec3& b){ a += b; return a; });
+	RegisterBinary("Vec3", "operator+=(float)", a, s, [](Vec3 a, float s){ a += s; return a; });
+	RegisterBinary("Vec3", "operator-", a, b, [](const Vec3& a, const Vec3& b){ return a - b; });
+	RegisterBinary("Vec3", "operator-(float)", a, s, [](const Vec3& a, float s){ return a - s; });
+	RegisterBinary("Vec3", "operator-=", a, b, [](Vec3 a, const Vec3& b){ a -= b; return a; });
+	RegisterBinary("Vec3", "operator-=(float)", a, s, [](Vec3 a, float s){ a -= s; return a; });
+	RegisterBinary("Vec3", "operator*(float)", a, s, [](const Vec3& a, float s){ return a * s; });
+	RegisterBinary("Vec3", "operator*=(float)", a, s, [](Vec3 a, float s){ a *= s; return a; });
+	RegisterBinary("Vec3", "operator/(float)", a, s, [](const Vec3& a, float s){ return a / s; });
+	RegisterBinary("Vec3", "operator/=(float)", a, s, [](Vec3 a, float s){ a /= s; return a; });
+	RegisterBinary("Vec3", "operator==", a, b, [](const Vec3& a, const Vec3& b){ return a == b; });
+	RegisterBinary("Vec3", "operator!=", a, b, [](const Vec3& a, const Vec3& b){ return a != b; });
+	RegisterUnary("Vec3", "Magnitude", a, [](const Vec3& a){ return a.Magnitude(); });
+	RegisterUnary("Vec3", "SqrMagnitude", a, [](const Vec3& a){ return a.SqrMagnitude(); });
+	RegisterUnary("Vec3", "Normalize", a, [](Vec3 a){ a.Normalize(); return a; });
+	RegisterUnary("Vec3", "Normalized", a, [](const Vec3& a){ return a.Normalized(); });
+	RegisterBinary("Vec3", "Scale", a, b, [](Vec3 a, const Vec3& b){ a.Scale(b); return a; });
+	RegisterBinary("Vec3", "Lerp", a, b, [](const Vec3& a, const Vec3& b){ return Vec3::Lerp(a, b, 0.25f); });
+	RegisterBinary("Vec3", "LerpUnclamped", a, b, [](const Vec3& a, const Vec3& b){ return Vec3::LerpUnclamped(a, b, 0.25f); });
+	RegisterBinary("Vec3", "DotProduct", a, b, [](const Vec3& a, const Vec3& b){ return Vec3::DotProduct(a, b); });
+	RegisterBinary("Vec3", "Angle", a, b, [](const Vec3& a, const Vec3& b){ return Vec3::Angle(a, b); });
+	RegisterBinary("Vec3", "CrossProduct", a, b, [](const Vec3& a, const Vec3& b){ return Vec3::CrossProduct(a, b); });
+	RegisterBinary("Vec3", "Distance", a, b, [](const Vec3& a, const Vec3& b){ return Vec3::Distance(a, b); });
+	RegisterBinary("Vec3", "Reflect", a, b, [](const Vec3& a, const Vec3& b){ return Vec3::Reflect(a, b); });
+}
+
+static void RegisterVec4(){
+	std::vector<Vec4> a = RandomVec4(kScalarBatch, 7);
+	std::vector<Vec4> b = RandomVec4(kScalarBatch, 8);
+	std::vector<float> s = RandomFloats(kScalarBatch, 9);
+
+	// Vec4's comparison operators are not const, so these take copies.
+	RegisterBinary("Vec4", "operator+", a, b, [](const Vec4& a, const Vec4& b){ return a + b; });
+	RegisterBinary("Vec4", "operator+(float)", a, s, [](const Vec4& a, float s){ return a + s; });
+	RegisterBinary("Vec4", "operator+=", a, b, [](Vec4 a, const Vec4& b){ a += b; return a; });
+	RegisterBinary("Vec4", "operator+=(float)", a, s, [](Vec4 a, float s){ a += s; return a; });
+	RegisterBinary("Vec4", "operator-", a, b, [](const Vec4& a, const Vec4& b){ return a - b; });
+	RegisterBinary("Vec4", "operator-(float)", a, s, [](const Vec4& a, float s){ return a - s; });
+	RegisterBinary("Vec4", "operator-=", a, b, [](Vec4 a, const Vec4& b){ a -= b; return a; });
+	RegisterBinary("Vec4", "operator-=(float)", a, s, [](Vec4 a, float s){ a -= s; return a; });
+	RegisterBinary("Vec4", "operator*(float)", a, s, [](const Vec4& a, float s){ return a * s; });
+	RegisterBinary("Vec4", "operator*=(float)", a, s, [](Vec4 a, float s){ a *= s; return a; });
+	RegisterBinary("Vec4", "operator/(float)", a, s, [](const Vec4& a, float s){ return a / s; });
+	RegisterBinary("Vec4", "operator/=(float)", a, s, [](Vec4 a, float s){ a /= s; return a; });
+	RegisterBinary("Vec4", "operator==", a, b, [](Vec4 a, const Vec4& b){ return a == b; });
+	RegisterBinary("Vec4", "operator!=", a, b, [](Vec4 a, const Vec4& b){ return a != b; });
+	RegisterUnary("Vec4", "Magnitude", a, [](const Vec4& a){ return a.Magnitude(); });
+	RegisterUnary("Vec4", "SqrMagnitude", a, [](const Vec4& a){ return a.SqrMagnitude(); });
+	RegisterUnary("Vec4", "Normalize", a, [](Vec4 a){ a.Normalize(); return a; });
+	RegisterUnary("Vec4", "Normalized", a, [](const Vec4& a){ return a.Normalized(); });
+	RegisterBinary("Vec4", "Scale", a, b, [](Vec4 a, const Vec4& b){ a.Scale(b); return a; });
+	RegisterBinary("Vec4", "Distance", a, b, [](const Vec4& a, const Vec4& b){ return Vec4::Distance(a, b); });
+	RegisterBinary("Vec4", "DotProduct", a, b, [](const Vec4& a, const Vec4& b){ return Vec4::DotProduct(a, b); });
+	RegisterBinary("Vec4", "Lerp", a, b, [](const Vec4& a, const Vec4& b){ return Vec4::Lerp(a, b, 0.25f); });
+}
+
+// The compound assignment operators of xVector3 take their left operand
+// by value and do not modify it, so there is nothing to measure there.
+static void RegisterXVector3(){
+	std::vector<xVector3> a = RandomXVector3(kScalarBatch, 10);
+	std::vector<xVector3> b = RandomXVector3(kScalarBatch, 11);
+	std::vector<float> s = RandomFloats(kScalarBatch, 12);
+
+	RegisterBinary("xVector3", "operator+", a, b, [](xVector3 a, xVector3 b){ return a + b; });
+	RegisterBinary("xVector3", "operator-", a, b, [](xVector3 a, xVector3 b){ return a - b; });
+	RegisterBinary("xVector3", "operator*", a, b, [](xVector3 a, xVector3 b){ return a * b; });
+	RegisterBinary("xVector3", "operator*(float)", a, s, [](xVector3 a, float s){ return a * s; });
+	RegisterBinary("xVector3", "operator/", a, b, [](xVector3 a, xVector3 b){ return a / b; });
+	RegisterBinary("xVector3", "operator/(float)", a, s, [](xVector3 a, float s){ return a / s; });
+	RegisterBinary("xVector3", "operator==", a, b, [](xVector3 a, xVector3 b){ return a == b; });
+	RegisterBinary("xVector3", "operator!=", a, b, [](xVector3 a, xVector3 b){ return a != b; });
+	RegisterBinary("xVector3", "operator<", a, b, [](xVector3 a, xVector3 b){ return a < b; });
+	RegisterBinary("xVector3", "operator>", a, b, [](xVector3 a, xVector3 b){ return a > b; });
+	RegisterBinary("xVector3", "operator<=", a, b, [](xVector3 a, xVector3 b){ return a <= b; });
+	RegisterBinary("xVector3", "operator>=", a, b, [](xVector3 a, xVector3 b){ return a >= b; });
+	RegisterUnary("xVector3", "operator-(unary)", a, [](xVector3 a){ return -a; });
+	RegisterUnary("xVector3", "Abs", a, [](xVector3 a){ return Abs(a); });
+	RegisterBinary("xVector3", "Max", a, b, [](xVector3 a, xVector3 b){ return Max(a, b); });
+	RegisterBinary("xVector3", "Min", a, b, [](xVector3 a, xVector3 b){ return Min(a, b); });
+	RegisterBinary("xVector3", "Clamp", a, b, [](xVector3 a, xVector3 b){ return Clamp(a, Min(a, b), Max(a, b)); });
+	RegisterUnary("xVector3", "Sum", a, [](xVector3 a){ return Sum(a); });
+	RegisterBinary("xVector3", "DotProduct", a, b, [](xVector3 a, xVector3 b){ return DotProduct(a, b); });
+	RegisterUnary("xVector3", "Magnitude", a, [](xVector3 a){ return Magnitude(a); });
+	RegisterUnary("xVector3", "SqrMagnitude", a, [](xVector3 a){ return SqrMagnitude(a); });
+	RegisterBinary("xVector3", "Angle", a, b, [](xVector3 a, xVector3 b){ return Angle(a, b); });
+	RegisterBinary("xVector3", "Distance", a, b, [](xVector3 a, xVector3 b){ return Distance(a, b); });
+	RegisterUnary("xVector3", "Normalize", a, [](xVector3 a){ return Normalize(a); });
+	RegisterBinary("xVector3", "LerpUnclamped", a, b, [](xVector3 a, xVector3 b){ return LerpUnclamped(a, b, 0.25f); });
+	RegisterBinary("xVector3", "Reflect", a, b, [](xVector3 a, xVector3 b){ return Reflect(a, b); });
+	RegisterUnary("xVector3", "Scale", a, [](xVector3 a){ return Scale(a); });
+	RegisterUnary("xVector3", "SumV", a, [](xVector3 a){ return SumV(a); });
+	RegisterBinary("xVector3", "DotProductV", a, b, [](xVector3 a, xVector3 b){ return DotProductV(a, b); });
+	RegisterUnary("xVector3", "MagnitudeV", a, [](xVector3 a){ return MagnitudeV(a); });
+	RegisterUnary("xVector3", "SqrMagnitudeV", a, [](xVector3 a){ return SqrMagnitudeV(a); });
+	RegisterBinary("xVector3", "DistanceV", a, b, [](xVector3 a, xVector3 b){ return DistanceV(a, b); });
+	RegisterBinary("xVector3", "AngleV", a, b, [](xVector3 a, xVector3 b){ return AngleV(a, b); });
+	RegisterBinary("xVector3", "Divide<Fast>", a, b, [](xVector3 a, xVector3 b){ return Divide<kPrecisionFast>(a, b); });
+	RegisterBinary("xVector3", "Divide<Fastest>", a, b, [](xVector3 a, xVector3 b){ return Divide<kPrecisionFastest>(a, b); });
+	RegisterUnary("xVector3", "Normalize<Fast>", a, [](xVector3 a){ return Normalize<kPrecisionFast>(a); });
+	RegisterUnary("xVector3", "Normalize<Fastest>", a, [](xVector3 a){ return Normalize<kPrecisionFastest>(a); });
+	RegisterBinary("xVector3", "AngleV<Fast>", a, b, [](xVector3 a, xVector3 b){ return AngleV<kPrecisionFast>(a, b); });
+	RegisterBinary("xVector3", "AngleV<Fastest>", a, b, [](xVector3 a, xVector3 b){ return AngleV<kPrecisionFastest>(a, b); });
+	// Diffuse plus specular term, the shape of the lighting loops.
+	RegisterBinary("xVector3", "LightingChain", a, b, [](xVector3 light, xVector3 normal){
+		xVector3 n = Normalize(normal);
+		xVector3 l = Normalize(light);
+		__m128 diffuse = _mm_max_ps(DotProductV(n, l), _mm_setzero_ps());
+		__m128 specular = _mm_max_ps(DotProductV(Reflect(-l, n), n), _mm_setzero_ps());
+		return _mm_add_ps(diffuse, specular);
+	});
+}
+
+static void RegisterXVector4(){
+	std::vector<xVector4> a = RandomXVector4(kScalarBatch, 13);
+	std::vector<xVector4> b = RandomXVector4(kScalarBatch, 14);
+	std::vector<float> s = RandomFloats(kScalarBatch, 15);
+
+	RegisterBinary("xVector4", "operator+", a, b, [](xVector4 a, xVector4 b){ return a + b; });
+	RegisterBinary("xVector4", "operator-", a, b, [](xVector4 a, xVector4 b){ return a - b; });
+	RegisterBinary("xVector4", "operator*", a, b, [](xVector4 a, xVector4 b){ return a * b; });
+	RegisterBinary("xVector4", "operator*(float)", a, s, [](xVector4 a, float s){ return a * s; });
+	RegisterBinary("xVector4", "operator/(float)", a, s, [](xVector4 a, float s){ return a / s; });
+	RegisterBinary("xVector4", "operator+=", a, b, [](xVector4 a, xVector4 b){ a += b; return a; });
+	RegisterBinary("xVector4", "operator==", a, b, [](xVector4 a, xVector4 b){ return a == b; });
+	RegisterBinary("xVector4", "DotProduct", a, b, [](xVector4 a, xVector4 b){ return DotProduct(a, b); });
+	RegisterUnary("xVector4", "Magnitude", a, [](xVector4 a){ return Magnitude(a); });
+	RegisterUnary("xVector4", "SqrMagnitude", a, [](xVector4 a){ return SqrMagnitude(a); });
+	RegisterBinary("xVector4", "Distance", a, b, [](xVector4 a, xVector4 b){ return Distance(a, b); });
+	RegisterUnary("xVector4", "Normalize", a, [](xVector4 a){ return Normalize(a); });
+	RegisterUnary("xVector4", "Normalize<Fast>", a, [](xVector4 a){ return Normalize<kPrecisionFast>(a); });
+	RegisterBinary("xVector4", "Lerp", a, b, [](xVector4 a, xVector4 b){ return Lerp(a, b, 0.25f); });
+}
+
+// Each op handles two Vec2, so these report ns per pair.
+static void RegisterXVector2x2(){
+	std::vector<xVector2x2> a = RandomXVector2x2(kScalarBatch, 16);
+	std::vector<xVector2x2> b = RandomXVector2x2(kScalarBatch, 17);
+	std::vector<float> s = RandomFloats(kScalarBatch, 18);
+
+	RegisterBinary("xVector2x2", "operator+", a, b, [](xVector2x2 a, xVector2x2 b){ return a + b; });
+	RegisterBinary("xVector2x2", "operator-", a, b, [](xVector2x2 a, xVector2x2 b){ return a - b; });
+	RegisterBinary("xVector2x2", "operator*(float)", a, s, [](xVector2x2 a, float s){ return a * s; });
+	RegisterBinary("xVector2x2", "operator/(float)", a, s, [](xVector2x2 a, float s){ return a / s; });
+	RegisterBinary("xVector2x2", "DotProductV", a, b, [](xVector2x2 a, xVector2x2 b){ return DotProductV(a, b); });
+	RegisterUnary("xVector2x2", "MagnitudeV", a, [](xVector2x2 a){ return MagnitudeV(a); });
+	RegisterBinary("xVector2x2", "DistanceV", a, b, [](xVector2x2 a, xVector2x2 b){ return DistanceV(a, b); });
+	RegisterUnary("xVector2x2", "Normalize", a, [](xVector2x2 a){ return Normalize(a); });
+	RegisterUnary("xVector2x2", "Normalize<Fast>", a, [](xVector2x2 a){ return Normalize<kPrecisionFast>(a); });
+	RegisterBinary("xVector2x2", "Lerp", a, b, [](xVector2x2 a, xVector2x2 b){ return Lerp(a, b, 0.25f); });
+}
+
+static void RegisterXQuaternion(){
+	std::vector<xQuaternion> a = RandomXQuaternion(kScalarBatch, 19);
+	std::vector<xQuaternion> b = RandomXQuaternion(kScalarBatch, 20);
+	std::vector<float> s = RandomFloats(kScalarBatch, 21);
+	std::vector<xVector3> v = RandomXVector3(kScalarBatch, 22);
+	std::vector<Quat> qa = RandomQuat(kScalarBatch, 19);
+	std::vector<Quat> qb = RandomQuat(kScalarBatch, 20);
+	std::vector<Vec3> va = RandomVec3(kScalarBatch, 22);
+
+	RegisterBinary("xQuaternion", "operator+", a, b, [](xQuaternion a, xQuaternion b){ return a + b; });
+	RegisterBinary("xQuaternion", "operator*", a, b, [](xQuaternion a, xQuaternion b){ return a * b; });
+	RegisterBinary("xQuaternion", "operator*(float)", a, s, [](xQuaternion a, float s){ return a * s; });
+	RegisterBinary("xQuaternion", "operator==", a, b, [](xQuaternion a, xQuaternion b){ return a == b; });
+	RegisterUnary("xQuaternion", "Conjugate", a, [](xQuaternion a){ return Conjugate(a); });
+	RegisterBinary("xQuaternion", "DotProduct", a, b, [](xQuaternion a, xQuaternion b){ return DotProduct(a, b); });
+	RegisterUnary("xQuaternion", "Normalize", a, [](xQuaternion a){ return Normalize(a); });
+	RegisterUnary("xQuaternion", "Normalize<Fast>", a, [](xQuaternion a){ return Normalize<kPrecisionFast>(a); });
+	RegisterUnary("xQuaternion", "Inverse", a, [](xQuaternion a){ return Inverse(a); });
+	RegisterBinary("xQuaternion", "Rotate", a, v, [](xQuaternion a, xVector3 v){ return Rotate(a, v); });
+	RegisterUnary("xQuaternion", "ToXMatrix4", a, [](xQuaternion a){ return ToXMatrix4(a); });
+	RegisterBinary("xQuaternion", "Nlerp", a, b, [](xQuaternion a, xQuaternion b){ return Nlerp(a, b, 0.25f); });
+	RegisterBinary("xQuaternion", "Slerp", a, b, [](xQuaternion a, xQuaternion b){ return Slerp(a, b, 0.25f); });
+	RegisterBinary("Quat", "Rotate", qa, va, [](const Quat& a, const Vec3& v){ return a.Rotate(v); });
+	RegisterBinary("Quat", "operator*", qa, qb, [](const Quat& a, const Quat& b){ return a * b; });
+	RegisterUnary("Quat", "ToMat4", qa, [](const Quat& a){ return a.ToMat4(); });
+	RegisterBinary("Quat", "Nlerp", qa, qb, [](const Quat& a, const Quat& b){ return Quat::Nlerp(a, b, 0.25f); });
+	RegisterBinary("Quat", "Slerp", qa, qb, [](const Quat& a, const Quat& b){ return Quat::Slerp(a, b, 0.25f); });
+}
+
+void RegisterVectorBenchmarks(){
+	RegisterVec2();
+	RegisterVec3();
+	RegisterVec4();
+	RegisterXVector3();
+	RegisterXVector4();
+	RegisterXVector2x2();
+	RegisterXQuaternion();
+}
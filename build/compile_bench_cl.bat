@@ -0,0 +1,10 @@
+@echo off
+cls
+del *.obj *.ilk *.pdb *.exe
+
+set FLAGS=/nologo /Ob1 /Oi /fp:fast /O2 /MD /GR- /EHs /W4 /DXMATH_RUNTIME_DISPATCH -I ../include -I ../deps/math_lib/include
+
+cl %FLAGS% /arch:SSE2 /c ../bench/*.cc ../src/kernels/kernels_sse2.cc
+cl %FLAGS% /arch:AVX2 /c ../src/kernels/kernels_avx2.cc
+cl %FLAGS% /arch:AVX512 /c ../src/kernels/kernels_avx512.cc
+cl /nologo /Fe: ../bin/bench.exe *.obj
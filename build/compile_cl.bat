@@ -2,5 +2,9 @@
 cls
 del *.obj *.ilk *.pdb *.exe
 
-cl /nologo /Ob1 /Oi /arch:SSE2 /fp:fast /O2 /MD /GR- /EHs /W4 -I ../include -I ../deps/math_lib/include /c ../src/*.cc
-cl /nologo /Ob1 /Oi /arch:SSE2 /fp:fast /O2 /MD /GR- /EHs /W4 /Fe: ../bin/main.exe *.obj ../deps/math_lib/lib/math.lib
\ No newline at end of file
+set FLAGS=/nologo /Ob1 /Oi /fp:fast /O2 /MD /GR- /EHs /W4 /DXMATH_RUNTIME_DISPATCH -I ../include -I ../deps/math_lib/include
+
+cl %FLAGS% /arch:SSE2 /c ../src/*.cc ../src/kernels/kernels_sse2.cc
+cl %FLAGS% /arch:AVX2 /c ../src/kernels/kernels_avx2.cc
+cl %FLAGS% /arch:AVX512 /c ../src/kernels/kernels_avx512.cc
+cl /nologo /Fe: ../bin/main.exe *.obj
@@ -6,14 +6,12 @@
 class Mat2 {
 public:
 
-	Mat2();
-	Mat2(float a[4]);
-	Mat2(float value);
-	Mat2(const Vec2& a, const Vec2& b); 
-	Mat2(const Mat2& copy);
-	~Mat2();
-
-	static Mat2 Identity();
+	constexpr Mat2();
+	constexpr Mat2(const float a[4]);
+	constexpr Mat2(float value);
+	constexpr Mat2(const Vec2& a, const Vec2& b);
+
+	static constexpr Mat2 Identity();
 	Mat2 Multiply(const Mat2& other) const;
 	float Determinant() const;
 	Mat2 Adjoint() const;
@@ -39,11 +37,18 @@ public:
 
 	bool operator==(const Mat2& other) const;
 	bool operator!=(const Mat2& other) const;
-	inline void operator=(const Mat2& other);
 
 	float m[4];
 };
 
+constexpr Mat2::Mat2() : m{ 0.0f, 0.0f, 0.0f, 0.0f } {}
+
+constexpr Mat2::Mat2(const float a[4]) : m{ a[0], a[1], a[2], a[3] } {}
+
+constexpr Mat2::Mat2(float value) : m{ value, value, value, value } {}
+
+constexpr Mat2::Mat2(const Vec2& a, const Vec2& b) : m{ a.x, a.y, b.x, b.y } {}
+
 inline Mat2 Mat2::operator+(const Mat2& other) const {
 	Mat2 result = Mat2();
 	result.m[0] += other.m[0];
@@ -156,14 +161,7 @@ inline bool Mat2::operator!=(const Mat2& other) const {
 	return true;
 }
 
-inline void Mat2::operator=(const Mat2& other) {
-	this->m[0] = other.m[0];
-	this->m[1] = other.m[1];
-	this->m[2] = other.m[2];
-	this->m[3] = other.m[3];
-}
-
-inline Mat2 Mat2::Identity() {
+constexpr Mat2 Mat2::Identity() {
 	Mat2 result = Mat2();
 	result.m[0] = 1.0f;
 	result.m[3] = 1.0f;
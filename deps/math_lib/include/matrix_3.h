@@ -19,15 +19,12 @@
 class Mat3 {
 public:
 
-	Mat3();
-	Mat3(float *values_array);
-	Mat3(float value);
-	Mat3(Vec3 a, Vec3 b, Vec3 c);
+	constexpr Mat3();
+	constexpr Mat3(const float* values_array);
+	constexpr Mat3(float value);
+	constexpr Mat3(Vec3 a, Vec3 b, Vec3 c);
 
-	Mat3(const Mat3& copy);
-	~Mat3();
-
-	static Mat3 Identity();
+	static constexpr Mat3 Identity();
 
 	Mat3 Multiply(const Mat3& other) const;
 
@@ -62,11 +59,21 @@ public:
 	inline Mat3& operator/=(float value);
 	bool operator==(const Mat3& other) const;
 	bool operator!=(const Mat3& other) const;
-	inline void operator=(const Mat3& other);
 
 	float m[9];
 };
 
+constexpr Mat3::Mat3() : m{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } {}
+
+constexpr Mat3::Mat3(const float* values_array)
+	: m{ values_array[0], values_array[1], values_array[2],
+	     values_array[3], values_array[4], values_array[5],
+	     values_array[6], values_array[7], values_array[8] } {}
+
+constexpr Mat3::Mat3(float value) : m{ value, value, value, value, value, value, value, value, value } {}
+
+constexpr Mat3::Mat3(Vec3 a, Vec3 b, Vec3 c) : m{ a.x, a.y, a.z, b.x, b.y, b.z, c.x, c.y, c.z } {}
+
 inline Mat3 Mat3::operator+(const Mat3& other) const {
 	Mat3 result(*this);
 	for(int i = 0; i < 9; ++i)
@@ -161,12 +168,7 @@ inline bool Mat3::operator!=(const Mat3& other) const {
 	return true;
 }
 
-inline void Mat3::operator=(const Mat3& other) {
-	for(int i = 0; i < 9; ++i)
-		this->m[i] = other.m[i];
-}
-
-inline Mat3 Mat3::Identity() {
+constexpr Mat3 Mat3::Identity() {
 	Mat3 result = Mat3();
 	result.m[0] = 1.0f;
 	result.m[4] = 1.0f;
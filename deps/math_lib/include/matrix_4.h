@@ -1,27 +1,66 @@
 #ifndef __MATRIX4_H__
 #define __MATRIX4_H__ 1
 
+#include <assert.h>
 #include <math.h>
 #include "vector_3.h"
 #include "vector_4.h"
 #include "matrix_3.h"
 
+// The inverse functions treat a matrix as singular when |det| is at or
+// below epsilon times the product of its column lengths, the largest |det|
+// those columns allow. The test is relative, so a uniform scale of 0.001
+// (det 1e-9) inverts like the identity does.
+const float kMat4InverseEpsilon = 1.0e-6f;
+
+// Order in which GetRotation/GetTransform apply the three axis rotations:
+// kRotateXYZ turns about X first, then Y, then Z, which in the layout of
+// RotateX/Y/Z is the product RotateZ * RotateY * RotateX.
+enum RotationOrder {
+  kRotateXYZ,
+  kRotateXZY,
+  kRotateYXZ,
+  kRotateYZX,
+  kRotateZXY,
+  kRotateZYX
+};
+
+// Clip-space depth range the projection matrices map the near and far
+// planes to. kDepthZeroToOne is the Direct3D/Vulkan range and
+// kDepthMinusOneToOne the OpenGL one. kDepthReversedZ maps near to 1 and
+// far to 0, which spreads float depth precision evenly over the range.
+enum ClipDepth {
+  kDepthZeroToOne,
+  kDepthMinusOneToOne,
+  kDepthReversedZ
+};
+
+// m is row-major, entry (row r, column c) at m[r * 4 + c], and vectors
+// are columns: p' = M p. The translation is m[3], m[7], m[11] and the
+// bottom line m[12..15] gives the projective w. Every builder below and
+// the Mat4TransformVec3/Vec4 functions follow this, as do xMatrix4 and
+// the batch transforms. a.Multiply(b) applies a first and then b, which
+// is the product b * a.
 class Mat4 {
  public:
 
-  Mat4();
-  Mat4(float a[16]);
-  Mat4(float value);
-  Mat4(const Mat4& copy);
-  ~Mat4();
+  constexpr Mat4();
+  constexpr Mat4(const float a[16]);
+  constexpr Mat4(float value);
 
-  static Mat4 Identity();
+  static constexpr Mat4 Identity();
   Mat4 Multiply(const Mat4& other) const;
 
   float Determinant() const;
   Mat4 Adjoint() const;
-  bool GetInverse(Mat4* out) const;
-  bool Inverse();
+  bool GetInverse(Mat4* out, float epsilon = kMat4InverseEpsilon) const;
+  bool Inverse(float epsilon = kMat4InverseEpsilon);
+
+  bool IsAffine(float epsilon = 1.0e-6f) const;
+  bool GetInverseAffine(Mat4* out, float epsilon = kMat4InverseEpsilon) const;
+  bool InverseAffine(float epsilon = kMat4InverseEpsilon);
+  void GetInverseRigid(Mat4* out) const;
+  void InverseRigid();
 
   Mat4 Transpose() const;
 
@@ -35,18 +74,32 @@ class Mat4 {
   static Mat4 RotateY(float radians);
   static Mat4 RotateZ(float radians);
 
+  static Mat3 GetRotation(float rotateX, float rotateY, float rotateZ,
+                      RotationOrder order = kRotateXYZ);
+
+  static Mat4 GetTransform(const Vec3& translate, const Vec3& scale,
+                      const Mat3& rotation);
+
   static Mat4 GetTransform(const Vec3& translate, const Vec3& scale,
-                      float rotateX, float rotateY, float rotateZ);
+                      float rotateX, float rotateY, float rotateZ,
+                      RotationOrder order = kRotateXYZ);
 
   static Mat4 GetTransform(float trans_x, float trans_y, float trans_z,
                       float scale_x, float scale_y, float scale_Z,
-                      float rotateX, float rotateY, float rotateZ);
+                      float rotateX, float rotateY, float rotateZ,
+                      RotationOrder order = kRotateXYZ);
 
-  Mat4 PerspectiveMatrix(float fov, float aspect,
-	  float near, float far) const;
+  // Right-handed view space looking down -z; z_near and z_far are positive
+  // distances and fov is the vertical field of view in radians. z_far may
+  // be INFINITY for a projection with no far plane. Both are static and
+  // build a new matrix; depth picks the clip-space range near and far map to.
+  static Mat4 PerspectiveMatrix(float fov, float aspect,
+                      float z_near, float z_far,
+                      ClipDepth depth = kDepthMinusOneToOne);
 
-  Mat4 OrthoMatrix(float right, float left, float top, float valueottom,
-	  float near, float far) const;
+  static Mat4 OrthoMatrix(float right, float left, float top, float bottom,
+                      float z_near, float z_far,
+                      ClipDepth depth = kDepthMinusOneToOne);
 
   Vec4 GetColum(int colum) const;
   Vec4 GetLine(int line) const;
@@ -65,7 +118,6 @@ class Mat4 {
   Mat4 operator/(float value) const;
   bool operator==(const Mat4& other);
   bool operator!=(const Mat4& other);
-  void operator=(const Mat4& other);
 
   static Vec3 Mat4TransformVec3(const Mat4& mat, Vec3 vec);
   static Vec4 Mat4TransformVec4(const Mat4& mat, Vec4 vec);
@@ -76,8 +128,16 @@ class Mat4 {
   float m[16];
 };
 
+constexpr Mat4::Mat4()
+	: m{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f } {}
 
-inline Mat4 Mat4::Identity() {
+constexpr Mat4::Mat4(const float a[16])
+	: m{ a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8], a[9], a[10], a[11], a[12], a[13], a[14], a[15] } {}
+
+constexpr Mat4::Mat4(float value)
+	: m{ value, value, value, value, value, value, value, value, value, value, value, value, value, value, value, value } {}
+
+constexpr Mat4 Mat4::Identity() {
 	Mat4 result = Mat4();
 	result.m[0] = 1.0f;
 	result.m[5] = 1.0f;
@@ -92,46 +152,42 @@ inline Mat4 Mat4::Multiply(const Mat4& other)const  {
 	multiply[0] = (this->m[0] * other.m[0]) + (this->m[4] * other.m[1]) + (this->m[8] * other.m[2]) + (this->m[12] * other.m[3]);
 	multiply[4] = (this->m[0] * other.m[4]) + (this->m[4] * other.m[5]) + (this->m[8] * other.m[6]) + (this->m[12] * other.m[7]);
 	multiply[8] = (this->m[0] * other.m[8]) + (this->m[4] * other.m[9]) + (this->m[8] * other.m[10]) + (this->m[12] * other.m[11]);
-	multiply[12] = (this->m[0] * other.m[11]) + (this->m[4] * other.m[12]) + (this->m[8] * other.m[14]) + (this->m[12] * other.m[15]);
+	multiply[12] = (this->m[0] * other.m[12]) + (this->m[4] * other.m[13]) + (this->m[8] * other.m[14]) + (this->m[12] * other.m[15]);
 
 	multiply[1] = (this->m[1] * other.m[0]) + (this->m[5] * other.m[1]) + (this->m[9] * other.m[2]) + (this->m[13] * other.m[3]);
 	multiply[5] = (this->m[1] * other.m[4]) + (this->m[5] * other.m[5]) + (this->m[9] * other.m[6]) + (this->m[13] * other.m[7]);
 	multiply[9] = (this->m[1] * other.m[8]) + (this->m[5] * other.m[9]) + (this->m[9] * other.m[10]) + (this->m[13] * other.m[11]);
-	multiply[13] = (this->m[1] * other.m[11]) + (this->m[5] * other.m[12]) + (this->m[9] * other.m[14]) + (this->m[13] * other.m[15]);
+	multiply[13] = (this->m[1] * other.m[12]) + (this->m[5] * other.m[13]) + (this->m[9] * other.m[14]) + (this->m[13] * other.m[15]);
 
 	multiply[2] = (this->m[2] * other.m[0]) + (this->m[6] * other.m[1]) + (this->m[10] * other.m[2]) + (this->m[14] * other.m[3]);
 	multiply[6] = (this->m[2] * other.m[4]) + (this->m[6] * other.m[5]) + (this->m[10] * other.m[6]) + (this->m[14] * other.m[7]);
 	multiply[10] = (this->m[2] * other.m[8]) + (this->m[6] * other.m[9]) + (this->m[10] * other.m[10]) + (this->m[14] * other.m[11]);
-	multiply[14] = (this->m[2] * other.m[11]) + (this->m[6] * other.m[12]) + (this->m[10] * other.m[14]) + (this->m[14] * other.m[15]);
+	multiply[14] = (this->m[2] * other.m[12]) + (this->m[6] * other.m[13]) + (this->m[10] * other.m[14]) + (this->m[14] * other.m[15]);
 
 	multiply[3] = (this->m[3] * other.m[0]) + (this->m[7] * other.m[1]) + (this->m[11] * other.m[2]) + (this->m[15] * other.m[3]);
 	multiply[7] = (this->m[3] * other.m[4]) + (this->m[7] * other.m[5]) + (this->m[11] * other.m[6]) + (this->m[15] * other.m[7]);
 	multiply[11] = (this->m[3] * other.m[8]) + (this->m[7] * other.m[9]) + (this->m[11] * other.m[10]) + (this->m[15] * other.m[11]);
-	multiply[15] = (this->m[3] * other.m[11]) + (this->m[7] * other.m[12]) + (this->m[11] * other.m[14]) + (this->m[15] * other.m[15]);
+	multiply[15] = (this->m[3] * other.m[12]) + (this->m[7] * other.m[13]) + (this->m[11] * other.m[14]) + (this->m[15] * other.m[15]);
 
 	return Mat4(multiply);
 }
 
 inline float Mat4::Determinant() const {
+	float s0 = m[0] * m[5] - m[4] * m[1];
+	float s1 = m[0] * m[6] - m[4] * m[2];
+	float s2 = m[0] * m[7] - m[4] * m[3];
+	float s3 = m[1] * m[6] - m[5] * m[2];
+	float s4 = m[1] * m[7] - m[5] * m[3];
+	float s5 = m[2] * m[7] - m[6] * m[3];
 
- 	float det_0[9] = { this->m[5], this->m[9], this->m[13],
-                     this->m[6], this->m[10], this->m[14],
-                     this->m[7], this->m[11], this->m[15] };
-
-  float det_1[9] = { this->m[4], this->m[8], this->m[12],
-                     this->m[6], this->m[10], this->m[14],
-                     this->m[7], this->m[11], this->m[15] };
-
-  float det_2[9] = { this->m[4], this->m[8], this->m[12],
-                     this->m[5], this->m[9], this->m[13],
-                     this->m[7], this->m[11], this->m[15] };
-
-  float det_3[9] = { this->m[4], this->m[8], this->m[12],
-                     this->m[5], this->m[9], this->m[13],
-                     this->m[6], this->m[10], this->m[14] };
+	float c0 = m[8] * m[13] - m[12] * m[9];
+	float c1 = m[8] * m[14] - m[12] * m[10];
+	float c2 = m[8] * m[15] - m[12] * m[11];
+	float c3 = m[9] * m[14] - m[13] * m[10];
+	float c4 = m[9] * m[15] - m[13] * m[11];
+	float c5 = m[10] * m[15] - m[14] * m[11];
 
-  return (  this->m[0] * Mat3(det_0).Determinant() - this->m[1] * Mat3(det_1).Determinant() 
-          + this->m[2] * Mat3(det_2).Determinant() - this->m[3] * Mat3(det_3).Determinant());
+	return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
 }
 
 inline Mat4 Mat4::Adjoint() const { 
@@ -208,20 +264,137 @@ inline Mat4 Mat4::Adjoint() const {
   return Mat4(array);
 }
 
-inline bool Mat4::Inverse() {
-	if(this->Determinant() != 0.0f){
-		*this = this->Adjoint().Transpose() / this->Determinant();	
-		return true;
-	}
-	return false;
+inline bool Mat4::Inverse(float epsilon) {
+	return GetInverse(this, epsilon);
+}
+
+// Laplace expansion over the 2x2 minors of the top and bottom row pairs:
+// the twelve minors are shared by all sixteen cofactors and the determinant.
+inline bool Mat4::GetInverse(Mat4* out, float epsilon) const {
+	float s0 = m[0] * m[5] - m[4] * m[1];
+	float s1 = m[0] * m[6] - m[4] * m[2];
+	float s2 = m[0] * m[7] - m[4] * m[3];
+	float s3 = m[1] * m[6] - m[5] * m[2];
+	float s4 = m[1] * m[7] - m[5] * m[3];
+	float s5 = m[2] * m[7] - m[6] * m[3];
+
+	float c0 = m[8] * m[13] - m[12] * m[9];
+	float c1 = m[8] * m[14] - m[12] * m[10];
+	float c2 = m[8] * m[15] - m[12] * m[11];
+	float c3 = m[9] * m[14] - m[13] * m[10];
+	float c4 = m[9] * m[15] - m[13] * m[11];
+	float c5 = m[10] * m[15] - m[14] * m[11];
+
+	float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	float bound = 1.0f;
+	for(int c = 0; c < 4; ++c)
+		bound *= sqrtf(m[c] * m[c] + m[4 + c] * m[4 + c] + m[8 + c] * m[8 + c] + m[12 + c] * m[12 + c]);
+	if(fabsf(det) <= epsilon * bound)
+		return false;
+
+	float inverse_det = 1.0f / det;
+	float inverse[16];
+
+	inverse[0] = ( m[5] * c5 - m[6] * c4 + m[7] * c3) * inverse_det;
+	inverse[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * inverse_det;
+	inverse[2] = ( m[13] * s5 - m[14] * s4 + m[15] * s3) * inverse_det;
+	inverse[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * inverse_det;
+
+	inverse[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * inverse_det;
+	inverse[5] = ( m[0] * c5 - m[2] * c2 + m[3] * c1) * inverse_det;
+	inverse[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * inverse_det;
+	inverse[7] = ( m[8] * s5 - m[10] * s2 + m[11] * s1) * inverse_det;
+
+	inverse[8] = ( m[4] * c4 - m[5] * c2 + m[7] * c0) * inverse_det;
+	inverse[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * inverse_det;
+	inverse[10] = ( m[12] * s4 - m[13] * s2 + m[15] * s0) * inverse_det;
+	inverse[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * inverse_det;
+
+	inverse[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * inverse_det;
+	inverse[13] = ( m[0] * c3 - m[1] * c1 + m[2] * c0) * inverse_det;
+	inverse[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * inverse_det;
+	inverse[15] = ( m[8] * s3 - m[9] * s1 + m[10] * s0) * inverse_det;
+
+	for(int i = 0; i < 16; ++i)
+		out->m[i] = inverse[i];
+	return true;
 }
 
-inline bool Mat4::GetInverse(Mat4* out) const {
-	if(this->Determinant() != 0.0f){
-		*out = this->Adjoint().Transpose() / this->Determinant();	
-		return true;
-	}
-	return false;
+// Affine means the bottom line is (0, 0, 0, 1), which holds for everything
+// built from Translate, Scale, RotateX/Y/Z and GetTransform.
+inline bool Mat4::IsAffine(float epsilon) const {
+	return fabsf(m[12]) <= epsilon && fabsf(m[13]) <= epsilon &&
+	       fabsf(m[14]) <= epsilon && fabsf(m[15] - 1.0f) <= epsilon;
+}
+
+// Inverse of [A t; 0 1] is [A^-1  -A^-1 t; 0 1]. A^-1 is the transposed
+// cofactor block rescaled by 1/det(A); its columns are the cross products of
+// the lines of A, which also covers non-uniform scale and shear.
+inline bool Mat4::GetInverseAffine(Mat4* out, float epsilon) const {
+	assert(IsAffine());
+
+	float c0x = m[5] * m[10] - m[6] * m[9];
+	float c0y = m[6] * m[8] - m[4] * m[10];
+	float c0z = m[4] * m[9] - m[5] * m[8];
+
+	float det = m[0] * c0x + m[1] * c0y + m[2] * c0z;
+	float bound = 1.0f;
+	for(int c = 0; c < 3; ++c)
+		bound *= sqrtf(m[c] * m[c] + m[4 + c] * m[4 + c] + m[8 + c] * m[8 + c]);
+	if(fabsf(det) <= epsilon * bound)
+		return false;
+
+	float inverse_det = 1.0f / det;
+	c0x *= inverse_det;
+	c0y *= inverse_det;
+	c0z *= inverse_det;
+
+	float c1x = (m[9] * m[2] - m[10] * m[1]) * inverse_det;
+	float c1y = (m[10] * m[0] - m[8] * m[2]) * inverse_det;
+	float c1z = (m[8] * m[1] - m[9] * m[0]) * inverse_det;
+
+	float c2x = (m[1] * m[6] - m[2] * m[5]) * inverse_det;
+	float c2y = (m[2] * m[4] - m[0] * m[6]) * inverse_det;
+	float c2z = (m[0] * m[5] - m[1] * m[4]) * inverse_det;
+
+	float tx = m[3];
+	float ty = m[7];
+	float tz = m[11];
+
+	out->m[0] = c0x; out->m[1] = c1x; out->m[2] = c2x;
+	out->m[3] = -(c0x * tx + c1x * ty + c2x * tz);
+	out->m[4] = c0y; out->m[5] = c1y; out->m[6] = c2y;
+	out->m[7] = -(c0y * tx + c1y * ty + c2y * tz);
+	out->m[8] = c0z; out->m[9] = c1z; out->m[10] = c2z;
+	out->m[11] = -(c0z * tx + c1z * ty + c2z * tz);
+	out->m[12] = 0.0f; out->m[13] = 0.0f; out->m[14] = 0.0f; out->m[15] = 1.0f;
+	return true;
+}
+
+inline bool Mat4::InverseAffine(float epsilon) {
+	return GetInverseAffine(this, epsilon);
+}
+
+// Rotation and translation only: A^-1 is A transposed.
+inline void Mat4::GetInverseRigid(Mat4* out) const {
+	assert(IsAffine());
+
+	float a0 = m[0], a1 = m[1], a2 = m[2];
+	float a4 = m[4], a5 = m[5], a6 = m[6];
+	float a8 = m[8], a9 = m[9], a10 = m[10];
+	float tx = m[3], ty = m[7], tz = m[11];
+
+	out->m[0] = a0; out->m[1] = a4; out->m[2] = a8;
+	out->m[3] = -(a0 * tx + a4 * ty + a8 * tz);
+	out->m[4] = a1; out->m[5] = a5; out->m[6] = a9;
+	out->m[7] = -(a1 * tx + a5 * ty + a9 * tz);
+	out->m[8] = a2; out->m[9] = a6; out->m[10] = a10;
+	out->m[11] = -(a2 * tx + a6 * ty + a10 * tz);
+	out->m[12] = 0.0f; out->m[13] = 0.0f; out->m[14] = 0.0f; out->m[15] = 1.0f;
+}
+
+inline void Mat4::InverseRigid() {
+	GetInverseRigid(this);
 }
 
 inline Mat4 Mat4::Transpose() const {
@@ -292,34 +465,84 @@ inline Mat4 Mat4::RotateZ(float radians) {
 	return result;
 }
 
-inline Mat4 Mat4::GetTransform(	const Vec3& translate,
-																const Vec3& scale,
-																float rotateX, float rotateY, float rotateZ)   {
+// Closed form of the three axis rotations, one sinf/cosf per angle.
+inline Mat3 Mat4::GetRotation(float rotateX, float rotateY, float rotateZ,
+                              RotationOrder order) {
+	float cx = cosf(rotateX), sx = sinf(rotateX);
+	float cy = cosf(rotateY), sy = sinf(rotateY);
+	float cz = cosf(rotateZ), sz = sinf(rotateZ);
+
+	Mat3 result;
+	float* r = result.m;
+	switch(order) {
+		case kRotateXYZ:
+			r[0] = cz * cy; r[1] = cz * sy * sx - sz * cx; r[2] = cz * sy * cx + sz * sx;
+			r[3] = sz * cy; r[4] = sz * sy * sx + cz * cx; r[5] = sz * sy * cx - cz * sx;
+			r[6] = -sy;     r[7] = cy * sx;                r[8] = cy * cx;
+			break;
+		case kRotateXZY:
+			r[0] = cy * cz;  r[1] = sy * sx - cy * sz * cx; r[2] = cy * sz * sx + sy * cx;
+			r[3] = sz;       r[4] = cz * cx;                r[5] = -cz * sx;
+			r[6] = -sy * cz; r[7] = sy * sz * cx + cy * sx; r[8] = cy * cx - sy * sz * sx;
+			break;
+		case kRotateYXZ:
+			r[0] = cz * cy - sz * sx * sy; r[1] = -sz * cx; r[2] = cz * sy + sz * sx * cy;
+			r[3] = sz * cy + cz * sx * sy; r[4] = cz * cx;  r[5] = sz * sy - cz * sx * cy;
+			r[6] = -cx * sy;               r[7] = sx;       r[8] = cx * cy;
+			break;
+		case kRotateYZX:
+			r[0] = cz * cy;                r[1] = -sz;     r[2] = cz * sy;
+			r[3] = cx * sz * cy + sx * sy; r[4] = cx * cz; r[5] = cx * sz * sy - sx * cy;
+			r[6] = sx * sz * cy - cx * sy; r[7] = sx * cz; r[8] = sx * sz * sy + cx * cy;
+			break;
+		case kRotateZXY:
+			r[0] = cy * cz + sy * sx * sz; r[1] = sy * sx * cz - cy * sz; r[2] = sy * cx;
+			r[3] = cx * sz;                r[4] = cx * cz;                r[5] = -sx;
+			r[6] = cy * sx * sz - sy * cz; r[7] = sy * sz + cy * sx * cz; r[8] = cy * cx;
+			break;
+		case kRotateZYX:
+			r[0] = cy * cz;                r[1] = -cy * sz;               r[2] = sy;
+			r[3] = cx * sz + sx * sy * cz; r[4] = cx * cz - sx * sy * sz; r[5] = -sx * cy;
+			r[6] = sx * sz - cx * sy * cz; r[7] = sx * cz + cx * sy * sz; r[8] = cx * cy;
+			break;
+	}
+	return result;
+}
 
-	Mat4 result = result.Identity();
-  Mat4 translation;
-  Mat4 scalation;
-  Mat4 rotation;
+// Scale * rotation * Translate(translate), the product GetTransform has
+// always built: row i of the rotation is scaled by scale[i] and the
+// translation is rotated and scaled with it. Writes the 12 entries
+// directly instead of multiplying 4x4 matrices.
+inline Mat4 Mat4::GetTransform(const Vec3& translate, const Vec3& scale,
+                               const Mat3& rotation) {
+	const float s[3] = { scale.x, scale.y, scale.z };
+	Mat4 result;
+	for(int i = 0; i < 3; ++i) {
+		float r0 = rotation.m[i * 3] * s[i];
+		float r1 = rotation.m[i * 3 + 1] * s[i];
+		float r2 = rotation.m[i * 3 + 2] * s[i];
+		result.m[i * 4] = r0;
+		result.m[i * 4 + 1] = r1;
+		result.m[i * 4 + 2] = r2;
+		result.m[i * 4 + 3] = r0 * translate.x + r1 * translate.y + r2 * translate.z;
+	}
+	result.m[15] = 1.0f;
+	return result;
+}
 
-  rotation = rotation.RotateX(rotateX).Multiply(rotation.RotateY(rotateY).Multiply(rotation.RotateZ(rotateZ)));
-  result = translation.Translate(translate.x, translate.y, translate.z).Multiply(rotation.Multiply(scalation.Scale(scale.x, scale.y, scale.z)));
-  
-  return result;
+inline Mat4 Mat4::GetTransform(	const Vec3& translate,
+																const Vec3& scale,
+																float rotateX, float rotateY, float rotateZ,
+																RotationOrder order)   {
+	return GetTransform(translate, scale, GetRotation(rotateX, rotateY, rotateZ, order));
 }
 
 inline Mat4 Mat4::GetTransform(	float trans_x, float trans_y, float trans_z,
 																float scale_x, float scale_y, float scale_z,
-																float rotateX, float rotateY, float rotateZ)  {
-
-	Mat4 result = result.Identity();
-  Mat4 translation;
-  Mat4 scalation;
-  Mat4 rotation;
-
-  rotation = rotation.RotateX(rotateX).Multiply(rotation.RotateY(rotateY).Multiply(rotation.RotateZ(rotateZ)));
-  result = translation.Translate(trans_x, trans_y, trans_z).Multiply(rotation.Multiply(scalation.Scale(scale_x, scale_y, scale_z)));
-  
-  return result;
+																float rotateX, float rotateY, float rotateZ,
+																RotationOrder order)  {
+	return GetTransform(Vec3(trans_x, trans_y, trans_z), Vec3(scale_x, scale_y, scale_z),
+	                    GetRotation(rotateX, rotateY, rotateZ, order));
 }
 
 inline Vec4 Mat4::GetColum(int column) const {
@@ -330,28 +553,51 @@ inline Vec4 Mat4::GetLine(int line) const {
 	return Vec4(this->m[line * 4], this->m[line * 4 + 1], this->m[line * 4 + 2], this->m[line * 4 + 3]);
 }
 
+// Clip z is a * z + b and clip w is -z, so depth = b / d - a at view
+// distance d. Solving for depth(z_near) = near_depth and depth(z_far) =
+// far_depth gives a and b; with z_far infinite, b / d vanishes there.
 inline Mat4 Mat4::PerspectiveMatrix(float fov, float aspect,
-	float near, float far) const {
-	
-	fov = 0.0f;
-	aspect = 0.0f; 
-	near = 0.0f;
-	far = 0.0f;
+                                    float z_near, float z_far,
+                                    ClipDepth depth) {
+	assert(z_near > 0.0f && z_far > z_near && aspect != 0.0f);
+	const float near_depth = depth == kDepthReversedZ ? 1.0f : (depth == kDepthZeroToOne ? 0.0f : -1.0f);
+	const float far_depth = depth == kDepthReversedZ ? 0.0f : 1.0f;
+	float focal = 1.0f / tanf(fov * 0.5f);
+	float a, b;
+	if(isinf(z_far)) {
+		a = -far_depth;
+		b = (near_depth - far_depth) * z_near;
+	} else {
+		b = (near_depth - far_depth) * z_near * z_far / (z_far - z_near);
+		a = b / z_near - near_depth;
+	}
 
-	return Mat4();
+	Mat4 result;
+	result.m[0] = focal / aspect;
+	result.m[5] = focal;
+	result.m[10] = a;
+	result.m[11] = b;
+	result.m[14] = -1.0f;
+	return result;
 }
 
-inline Mat4 Mat4::OrthoMatrix(float right, float left, float top, float valueottom,
-	float near, float far) const {
-
-	right = 0.0f;
-	left = 0.0f;
-	top = 0.0f;
-	valueottom = 0.0f;
-	near = 0.0f;
-	far = 0.0f;
-
-	return Mat4();
+inline Mat4 Mat4::OrthoMatrix(float right, float left, float top, float bottom,
+                              float z_near, float z_far,
+                              ClipDepth depth) {
+	assert(right != left && top != bottom && z_far != z_near);
+	const float near_depth = depth == kDepthReversedZ ? 1.0f : (depth == kDepthZeroToOne ? 0.0f : -1.0f);
+	const float far_depth = depth == kDepthReversedZ ? 0.0f : 1.0f;
+	float a = (near_depth - far_depth) / (z_far - z_near);
+
+	Mat4 result;
+	result.m[0] = 2.0f / (right - left);
+	result.m[3] = -(right + left) / (right - left);
+	result.m[5] = 2.0f / (top - bottom);
+	result.m[7] = -(top + bottom) / (top - bottom);
+	result.m[10] = a;
+	result.m[11] = near_depth + a * z_near;
+	result.m[15] = 1.0f;
+	return result;
 }
 
 inline Mat4 Mat4::operator+(const Mat4& other) const {
@@ -448,24 +694,18 @@ inline bool Mat4::operator!=(const Mat4& other) {
 	return true;
 }
 
-inline void Mat4::operator=(const Mat4& other) {
-	for(int i = 0; i < 16; ++i)
-		this->m[i] = other.m[i];
-}
-
+// w = 1 and no divide, as TransformPoints (xTransform.h).
 inline Vec3 Mat4::Mat4TransformVec3(const Mat4& mat, Vec3 vec){
-  vec.x = {mat.m[0] * vec.x + mat.m[4] * vec.y + mat.m[8] * vec.z + mat.m[12] * 1.0f };
-  vec.y = {mat.m[1] * vec.x + mat.m[5] * vec.y + mat.m[9] * vec.z + mat.m[13] * 1.0f };
-  vec.z = {mat.m[2] * vec.x + mat.m[6] * vec.y + mat.m[10] * vec.z + mat.m[14] * 1.0f };
-  return vec;
+  return Vec3(mat.m[0] * vec.x + mat.m[1] * vec.y + mat.m[2] * vec.z + mat.m[3],
+              mat.m[4] * vec.x + mat.m[5] * vec.y + mat.m[6] * vec.z + mat.m[7],
+              mat.m[8] * vec.x + mat.m[9] * vec.y + mat.m[10] * vec.z + mat.m[11]);
 }
 
 inline Vec4 Mat4::Mat4TransformVec4(const Mat4& mat, Vec4 vec){
-  vec.x = {mat.m[0] * vec.x + mat.m[4] * vec.y + mat.m[8] * vec.z + mat.m[12] * vec.w };
-  vec.y = {mat.m[1] * vec.x + mat.m[5] * vec.y + mat.m[9] * vec.z + mat.m[13] * vec.w };
-  vec.z = {mat.m[2] * vec.x + mat.m[6] * vec.y + mat.m[10] * vec.z + mat.m[14] * vec.w };
-  vec.w = {mat.m[3] * vec.x + mat.m[7] * vec.y + mat.m[11] * vec.z + mat.m[15] * vec.w };
-  return vec;  
+  return Vec4(mat.m[0] * vec.x + mat.m[1] * vec.y + mat.m[2] * vec.z + mat.m[3] * vec.w,
+              mat.m[4] * vec.x + mat.m[5] * vec.y + mat.m[6] * vec.z + mat.m[7] * vec.w,
+              mat.m[8] * vec.x + mat.m[9] * vec.y + mat.m[10] * vec.z + mat.m[11] * vec.w,
+              mat.m[12] * vec.x + mat.m[13] * vec.y + mat.m[14] * vec.z + mat.m[15] * vec.w);
 }
 
 inline Vec4 Mat4::Mat4TransformVec4(const Vec4& v) {
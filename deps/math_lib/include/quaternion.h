@@ -0,0 +1,194 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Quaternion Class Definition.
+//--------------------------------------------------------------//
+//
+//   q = w + xi + yj + zk
+//
+//   Rotation quaternions are unit length. a * b applies b first,
+//   then a. ToMat3/ToMat4 follow the layout of Mat4::RotateX/Y/Z,
+//   so FromAxisAngle(Vec3(1, 0, 0), r).ToMat4() == RotateX(r).
+//
+//--------------------------------------------------------------//
+#ifndef __QUATERNION_H__
+#define __QUATERNION_H__ 1
+
+#include <math.h>
+#include "vector_3.h"
+#include "matrix_3.h"
+#include "matrix_4.h"
+
+class Quat {
+public:
+
+	constexpr Quat();
+	constexpr Quat(float x, float y, float z, float w);
+
+	static constexpr Quat Identity();
+	// axis must be unit length.
+	static Quat FromAxisAngle(const Vec3& axis, float radians);
+
+	Quat operator+(const Quat& other) const;
+	Quat operator-(const Quat& other) const;
+	Quat operator-() const;
+	Quat operator*(const Quat& other) const;
+	Quat operator*(float value) const;
+	bool operator==(const Quat& other) const;
+	bool operator!=(const Quat& other) const;
+
+	Quat Conjugate() const;
+	Quat Inverse() const;
+	float Magnitude() const;
+	float SqrMagnitude() const;
+	Quat Normalized() const;
+	void Normalize();
+
+	Vec3 Rotate(const Vec3& v) const;
+	Mat3 ToMat3() const;
+	Mat4 ToMat4() const;
+	// Mat4::GetTransform with this rotation.
+	Mat4 ToTransform(const Vec3& translate, const Vec3& scale) const;
+
+	static float DotProduct(const Quat& a, const Quat& b);
+	// Both take the shorter arc and clamp t to [0, 1].
+	static Quat Nlerp(const Quat& a, const Quat& b, float t);
+	static Quat Slerp(const Quat& a, const Quat& b, float t);
+
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+constexpr Quat::Quat() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+
+constexpr Quat::Quat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+constexpr Quat Quat::Identity() {
+	return Quat(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+inline Quat Quat::FromAxisAngle(const Vec3& axis, float radians) {
+	float s = sinf(radians * 0.5f);
+	return Quat(axis.x * s, axis.y * s, axis.z * s, cosf(radians * 0.5f));
+}
+
+inline Quat Quat::operator+(const Quat& other) const {
+	return Quat(x + other.x, y + other.y, z + other.z, w + other.w);
+}
+
+inline Quat Quat::operator-(const Quat& other) const {
+	return Quat(x - other.x, y - other.y, z - other.z, w - other.w);
+}
+
+inline Quat Quat::operator-() const {
+	return Quat(-x, -y, -z, -w);
+}
+
+inline Quat Quat::operator*(const Quat& other) const {
+	return Quat(w * other.x + x * other.w + y * other.z - z * other.y,
+	            w * other.y - x * other.z + y * other.w + z * other.x,
+	            w * other.z + x * other.y - y * other.x + z * other.w,
+	            w * other.w - x * other.x - y * other.y - z * other.z);
+}
+
+inline Quat Quat::operator*(float value) const {
+	return Quat(x * value, y * value, z * value, w * value);
+}
+
+inline bool Quat::operator==(const Quat& other) const {
+	return x == other.x && y == other.y && z == other.z && w == other.w;
+}
+
+inline bool Quat::operator!=(const Quat& other) const {
+	return !(*this == other);
+}
+
+inline Quat Quat::Conjugate() const {
+	return Quat(-x, -y, -z, w);
+}
+
+inline Quat Quat::Inverse() const {
+	return Conjugate() * (1.0f / SqrMagnitude());
+}
+
+inline float Quat::SqrMagnitude() const {
+	return x * x + y * y + z * z + w * w;
+}
+
+inline float Quat::Magnitude() const {
+	return sqrtf(SqrMagnitude());
+}
+
+inline Quat Quat::Normalized() const {
+	return *this * (1.0f / Magnitude());
+}
+
+inline void Quat::Normalize() {
+	*this = Normalized();
+}
+
+// v + w * t + u x t with u = (x, y, z) and t = 2 * (u x v).
+inline Vec3 Quat::Rotate(const Vec3& v) const {
+	Vec3 u(x, y, z);
+	Vec3 t = Vec3::CrossProduct(u, v) * 2.0f;
+	return v + t * w + Vec3::CrossProduct(u, t);
+}
+
+inline Mat3 Quat::ToMat3() const {
+	float x2 = x + x, y2 = y + y, z2 = z + z;
+	float xx = x * x2, yy = y * y2, zz = z * z2;
+	float xy = x * y2, xz = x * z2, yz = y * z2;
+	float wx = w * x2, wy = w * y2, wz = w * z2;
+
+	Mat3 result;
+	result.m[0] = 1.0f - (yy + zz); result.m[1] = xy - wz;          result.m[2] = xz + wy;
+	result.m[3] = xy + wz;          result.m[4] = 1.0f - (xx + zz); result.m[5] = yz - wx;
+	result.m[6] = xz - wy;          result.m[7] = yz + wx;          result.m[8] = 1.0f - (xx + yy);
+	return result;
+}
+
+inline Mat4 Quat::ToMat4() const {
+	Mat3 r = ToMat3();
+	Mat4 result = Mat4::Identity();
+	result.m[0] = r.m[0]; result.m[1] = r.m[1]; result.m[2] = r.m[2];
+	result.m[4] = r.m[3]; result.m[5] = r.m[4]; result.m[6] = r.m[5];
+	result.m[8] = r.m[6]; result.m[9] = r.m[7]; result.m[10] = r.m[8];
+	return result;
+}
+
+inline Mat4 Quat::ToTransform(const Vec3& translate, const Vec3& scale) const {
+	return Mat4::GetTransform(translate, scale, ToMat3());
+}
+
+inline float Quat::DotProduct(const Quat& a, const Quat& b) {
+	return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+inline Quat Quat::Nlerp(const Quat& a, const Quat& b, float t) {
+	t = MathUtils::Clamp(t, 0.0f, 1.0f);
+	float tb = DotProduct(a, b) < 0.0f ? -t : t;
+	return (a * (1.0f - t) + b * tb).Normalized();
+}
+
+// Falls back to Nlerp when the two are too close for sin(theta) to be a
+// safe divisor.
+inline Quat Quat::Slerp(const Quat& a, const Quat& b, float t) {
+	t = MathUtils::Clamp(t, 0.0f, 1.0f);
+	float cosine = DotProduct(a, b);
+	float sign = 1.0f;
+	if(cosine < 0.0f) {
+		cosine = -cosine;
+		sign = -1.0f;
+	}
+	if(cosine > 0.9995f)
+		return Nlerp(a, b, t);
+
+	float theta = acosf(cosine);
+	float inverse_sin = 1.0f / sinf(theta);
+	float wa = sinf((1.0f - t) * theta) * inverse_sin;
+	float wb = sinf(t * theta) * inverse_sin * sign;
+	return a * wa + b * wb;
+}
+
+#endif // __QUATERNION_H__
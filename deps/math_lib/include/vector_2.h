@@ -7,10 +7,8 @@
 class Vec2 {
  public:
 
-  Vec2();
-  inline Vec2(float x, float y);
-  Vec2(const Vec2& copy);
-  ~Vec2();
+  constexpr Vec2();
+  constexpr Vec2(float x, float y);
 
   Vec2 operator+(const Vec2& other) const;
   Vec2 operator+(float value);
@@ -18,12 +16,11 @@ class Vec2 {
   Vec2& operator+=(float value);
   Vec2 operator-(const Vec2& other) const;
   Vec2 operator-(float value) const;
-  Vec2& operator-();
+  Vec2 operator-() const;
   Vec2& operator-=(const Vec2& other);
   Vec2& operator-=(float value);
   bool operator==(const Vec2& other) const;
   bool operator!=(const Vec2& other) const;
-  void operator=(const Vec2& other);
   void operator=(float value);
   Vec2 operator*(float value) const;
   Vec2& operator*=(float value);
@@ -55,6 +52,17 @@ class Vec2 {
   float y;
 };
 
+constexpr Vec2::Vec2() : x(0.0f), y(0.0f) {}
+
+constexpr Vec2::Vec2(float x, float y) : x(x), y(y) {}
+
+__declspec(selectany) constexpr Vec2 Vec2::up = Vec2(0.0f, 1.0f);
+__declspec(selectany) constexpr Vec2 Vec2::down = Vec2(0.0f, -1.0f);
+__declspec(selectany) constexpr Vec2 Vec2::right = Vec2(1.0f, 0.0f);
+__declspec(selectany) constexpr Vec2 Vec2::left = Vec2(-1.0f, 0.0f);
+__declspec(selectany) constexpr Vec2 Vec2::zero = Vec2(0.0f, 0.0f);
+__declspec(selectany) constexpr Vec2 Vec2::one = Vec2(1.0f, 1.0f);
+
 inline Vec2 Vec2::operator+(const Vec2& other) const {
   return Vec2(this->x + other.x, this->y + other.y);
 }
@@ -83,8 +91,8 @@ inline Vec2 Vec2::operator-(float value) const {
   return Vec2(this->x - value, this->y - value);
 }
 
-inline Vec2& Vec2::operator-() {
-	return *this;
+inline Vec2 Vec2::operator-() const {
+	return Vec2(-this->x, -this->y);
 }
 
 inline Vec2& Vec2::operator-=(const Vec2& other) {
@@ -107,11 +115,6 @@ inline bool Vec2::operator!=(const Vec2& value) const {
   return (this->x != value.x || this->y != value.y);
 }
 
-inline void Vec2::operator=(const Vec2& other) {
-  this->x = other.x;
-  this->y = other.y;
-}
-
 inline void Vec2::operator=(float value) {
   this->x = value;
   this->y = value;
@@ -171,7 +174,7 @@ inline Vec2 Vec2::Lerp(const Vec2 a, const Vec2 b, float t) {
 }
 
 inline Vec2 Vec2::LerpUnclamped(const Vec2 a, const Vec2 b, float t) {
-	return Vec2((a.x + t) * (b.x - a.x), (a.y + t) * (b.y - a.y));
+	return Vec2(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y));
 }
 
 inline float Vec2::DotProduct(Vec2 a, Vec2 b) {
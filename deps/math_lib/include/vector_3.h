@@ -7,12 +7,10 @@
 class Vec3 {
 
 public:
-	Vec3();
-	Vec3(float value);
-	Vec3(float x, float y, float z);
-	Vec3(float* values_array);
-	Vec3(const Vec3& other);
-	~Vec3();
+	constexpr Vec3();
+	constexpr Vec3(float value);
+	constexpr Vec3(float x, float y, float z);
+	constexpr Vec3(const float* values_array);
 
 	Vec3 operator+(const Vec3& other) const;
 	Vec3 operator+(float value) const;
@@ -24,7 +22,6 @@ public:
 	Vec3& operator-=(float value);
 	bool operator==(const Vec3& other) const;
 	bool operator!=(const Vec3& other) const;
-	void operator=(const Vec3& other);
 	void operator=(float value);
 	Vec3 operator*(float value) const;
 	Vec3& operator*=(float value);
@@ -44,6 +41,9 @@ public:
 	static Vec3 CrossProduct(const Vec3& a,const Vec3& b);	
 	static float Distance(const Vec3& a, const Vec3& b);
 	static Vec3 Reflect(const Vec3& direction, const Vec3& normal);
+	// Componentwise.
+	static Vec3 Min(const Vec3& a, const Vec3& b);
+	static Vec3 Max(const Vec3& a, const Vec3& b);
 
 	static const Vec3 up;
 	static const Vec3 down;
@@ -59,6 +59,23 @@ public:
 	float z;
 };
 
+constexpr Vec3::Vec3() : x(0.0f), y(0.0f), z(0.0f) {}
+
+constexpr Vec3::Vec3(float value) : x(value), y(value), z(value) {}
+
+constexpr Vec3::Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+constexpr Vec3::Vec3(const float* values_array) : x(values_array[0]), y(values_array[1]), z(values_array[2]) {}
+
+__declspec(selectany) constexpr Vec3 Vec3::up = Vec3(0.0f, 1.0f, 0.0f);
+__declspec(selectany) constexpr Vec3 Vec3::down = Vec3(0.0f, -1.0f, 0.0f);
+__declspec(selectany) constexpr Vec3 Vec3::right = Vec3(1.0f, 0.0f, 0.0f);
+__declspec(selectany) constexpr Vec3 Vec3::left = Vec3(-1.0f, 0.0f, 0.0f);
+__declspec(selectany) constexpr Vec3 Vec3::forward = Vec3(0.0f, 0.0f, 1.0f);
+__declspec(selectany) constexpr Vec3 Vec3::back = Vec3(0.0f, 0.0f, -1.0f);
+__declspec(selectany) constexpr Vec3 Vec3::zero = Vec3(0.0f, 0.0f, 0.0f);
+__declspec(selectany) constexpr Vec3 Vec3::unit = Vec3(1.0f, 1.0f, 1.0f);
+
 inline float Vec3::Magnitude() const {
 	return sqrtf(SqrMagnitude());
 }
@@ -101,7 +118,7 @@ inline Vec3 Vec3::Lerp(const Vec3& a, const Vec3& b, float t) {
 }
 
 inline Vec3 Vec3::LerpUnclamped(const Vec3& a, const Vec3& b, float t) {
-	return Vec3((a.x + t) * (b.x - a.x), (a.y + t) * (b.y - a.y), (a.z + t) * (b.z - a.z));
+	return Vec3(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y), a.z + t * (b.z - a.z));
 }
 
 inline float Vec3::Distance(const Vec3& a, const Vec3& b) {
@@ -112,6 +129,14 @@ inline Vec3 Vec3::Reflect(const Vec3& direction, const Vec3& normal) {
 	return Vec3(direction - normal * (DotProduct(direction, normal) * 2.0f));
 }
 
+inline Vec3 Vec3::Min(const Vec3& a, const Vec3& b) {
+	return Vec3(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z);
+}
+
+inline Vec3 Vec3::Max(const Vec3& a, const Vec3& b) {
+	return Vec3(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z);
+}
+
 inline Vec3 Vec3::operator+(const Vec3& other) const {
 	return Vec3(this->x + other.x, this->y + other.y, this->z + other.z);
 }
@@ -164,12 +189,6 @@ inline bool Vec3::operator!=(const Vec3& other) const {
 	return (this->x != other.x || this->y != other.y || this->z != other.z);
 }
 
-inline void Vec3::operator=(const Vec3& other) {	
-	this->x = other.x;
-	this->y = other.y;
-	this->z = other.z;
-}
-
 inline void Vec3::operator=(float value) {
 	this->x = value;	
 	this->y = value;	
@@ -8,13 +8,11 @@
 class Vec4 {
 public:
 
-	Vec4();
-	Vec4(float x, float y, float z, float w);
-	Vec4(Vec3 a, float w);
-	Vec4(float a);
-	Vec4(float* values_array);
-	Vec4(const Vec4& other);
-	~Vec4();
+	constexpr Vec4();
+	constexpr Vec4(float x, float y, float z, float w);
+	constexpr Vec4(Vec3 a, float w);
+	constexpr Vec4(float a);
+	constexpr Vec4(const float* values_array);
 	
 	Vec4 operator+(const Vec4& other) const;
 	Vec4 operator+(float value) const;
@@ -31,7 +29,6 @@ public:
 	void operator/=(float value);
 	bool operator==(const Vec4& other);
 	bool operator!=(const Vec4& other);
-	void operator=(const Vec4& other);
 
 	float Magnitude() const;
 	void Normalize();
@@ -53,6 +50,19 @@ public:
 
 };
 
+constexpr Vec4::Vec4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+
+constexpr Vec4::Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+constexpr Vec4::Vec4(Vec3 a, float w) : x(a.x), y(a.y), z(a.z), w(w) {}
+
+constexpr Vec4::Vec4(float a) : x(a), y(a), z(a), w(a) {}
+
+constexpr Vec4::Vec4(const float* values_array)
+	: x(values_array[0]), y(values_array[1]), z(values_array[2]), w(values_array[3]) {}
+
+__declspec(selectany) constexpr Vec4 Vec4::one = Vec4(1.0f, 1.0f, 1.0f, 1.0f);
+__declspec(selectany) constexpr Vec4 Vec4::zero = Vec4(0.0f, 0.0f, 0.0f, 0.0f);
 
 inline float Vec4::Magnitude() const{
 	return sqrtf(SqrMagnitude());
@@ -86,7 +96,7 @@ inline float Vec4::DotProduct(Vec4 a, Vec4 b) {
 
 inline Vec4 Vec4::Lerp(const Vec4& a, const Vec4& b, float t) {	
 	t = MathUtils::Clamp(t, 0.0f, 1.0f);
-	return Vec4((a.x + t) * (b.x - a.x), (a.y + t) * (b.y - a.y), (a.z + t) * (b.z - a.z), (a.w + t) * (b.w - a.w));
+	return Vec4(a.x + t * (b.x - a.x), a.y + t * (b.y - a.y), a.z + t * (b.z - a.z), a.w + t * (b.w - a.w));
 }
 
 inline Vec4 Vec4::operator+(const Vec4& other) const{
@@ -163,11 +173,4 @@ inline bool Vec4::operator==(const Vec4& other) {
 inline bool Vec4::operator!=(const Vec4& other) {
 	return (this->x != other.x || this->y != other.y || this->z != other.z || this->w != other.w);
 }
-inline void Vec4::operator=(const Vec4& other) {
-	this->x = other.x;
-	this->y = other.y;
-	this->z = other.z;
-	this->w = other.w;
-}
-
 #endif 
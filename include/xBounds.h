@@ -0,0 +1,478 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Bounding Boxes and Spheres.
+//--------------------------------------------------------------//
+//
+//   AABB    min and max corners, axis-aligned.
+//   Sphere  center and radius.
+//
+//   A default-constructed volume is empty: it contains nothing,
+//   overlaps nothing and the first Merge replaces it.
+//
+//   ComputeBounds reduces a point set to its AABB. Points can come
+//   as a Vec3 array, a Vec3SoA stream or a strided vertex buffer.
+//   The kernels keep one running min and max register per axis and
+//   fold the lanes together once at the end. Packed Vec3 arrays are
+//   read as plain floats, three registers per kLaneWidth points: lane
+//   j of register r always holds the same component, so the loop
+//   needs no shuffles at all. The last partial register is read
+//   again from end - kLaneWidth, since min and max do not mind seeing
+//   a point twice. By default a batch runs on the thread pool
+//   (xParallel.h) in tasks of kBoundsGrain points. Points must be
+//   finite.
+//
+//--------------------------------------------------------------//
+#ifndef __XBOUNDS_H__
+#define __XBOUNDS_H__ 1
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xVec3SoA.h"
+#include "matrix_4.h"
+#include "vector_3.h"
+
+// Points per task when a policy computes bounds in parallel.
+const size_t kBoundsGrain = 16384;
+
+struct Sphere;
+
+struct AABB {
+
+	AABB();
+	AABB(const Vec3& min, const Vec3& max);
+
+	bool IsEmpty() const;
+	Vec3 Center() const;
+	// Half the size along each axis.
+	Vec3 Extent() const;
+	// 0 for an empty box.
+	float SurfaceArea() const;
+
+	void Merge(const Vec3& point);
+	void Merge(const AABB& other);
+
+	bool Contains(const Vec3& point) const;
+	bool Contains(const AABB& other) const;
+	bool Overlaps(const AABB& other) const;
+	bool Overlaps(const Sphere& sphere) const;
+
+	// The box around the transformed box, by Arvo's method: each output
+	// axis picks the smaller and the larger of entry * min and entry * max
+	// per input axis, so no corners are transformed.
+	AABB Transformed(const Mat4& m) const;
+
+	Vec3 min;
+	Vec3 max;
+};
+
+struct Sphere {
+
+	Sphere();
+	Sphere(const Vec3& center, float radius);
+	// The sphere through the corners of box.
+	explicit Sphere(const AABB& box);
+
+	bool IsEmpty() const;
+
+	// Grows just enough to take in the point or sphere; the result is the
+	// smallest sphere around both.
+	void Merge(const Vec3& point);
+	void Merge(const Sphere& other);
+
+	bool Contains(const Vec3& point) const;
+	bool Contains(const Sphere& other) const;
+	bool Overlaps(const Sphere& other) const;
+	bool Overlaps(const AABB& box) const;
+
+	// The radius grows by a bound on the largest stretch of the upper 3x3,
+	// exact when it is a rotation times a scale or a scale times a rotation.
+	Sphere Transformed(const Mat4& m) const;
+
+	Vec3 center;
+	float radius;
+};
+
+__forceinline AABB::AABB() : min(INFINITY, INFINITY, INFINITY), max(-INFINITY, -INFINITY, -INFINITY) {}
+
+__forceinline AABB::AABB(const Vec3& min, const Vec3& max) : min(min), max(max) {}
+
+inline bool AABB::IsEmpty() const {
+	return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+inline Vec3 AABB::Center() const {
+	return (min + max) * 0.5f;
+}
+
+inline Vec3 AABB::Extent() const {
+	return (max - min) * 0.5f;
+}
+
+inline float AABB::SurfaceArea() const {
+	if(IsEmpty()) return 0.0f;
+	Vec3 size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+inline void AABB::Merge(const Vec3& point) {
+	min = Vec3::Min(min, point);
+	max = Vec3::Max(max, point);
+}
+
+inline void AABB::Merge(const AABB& other) {
+	min = Vec3::Min(min, other.min);
+	max = Vec3::Max(max, other.max);
+}
+
+inline bool AABB::Contains(const Vec3& point) const {
+	return point.x >= min.x && point.x <= max.x &&
+	       point.y >= min.y && point.y <= max.y &&
+	       point.z >= min.z && point.z <= max.z;
+}
+
+inline bool AABB::Contains(const AABB& other) const {
+	return !other.IsEmpty() && Contains(other.min) && Contains(other.max);
+}
+
+inline bool AABB::Overlaps(const AABB& other) const {
+	return min.x <= other.max.x && max.x >= other.min.x &&
+	       min.y <= other.max.y && max.y >= other.min.y &&
+	       min.z <= other.max.z && max.z >= other.min.z;
+}
+
+// Squared distance from the sphere center to the nearest point of the box.
+inline bool AABB::Overlaps(const Sphere& sphere) const {
+	if(IsEmpty() || sphere.IsEmpty()) return false;
+	Vec3 nearest = Vec3::Min(Vec3::Max(sphere.center, min), max);
+	return (sphere.center - nearest).SqrMagnitude() <= sphere.radius * sphere.radius;
+}
+
+inline AABB AABB::Transformed(const Mat4& m) const {
+	if(IsEmpty()) return AABB();
+	const float low[3] = { min.x, min.y, min.z };
+	const float high[3] = { max.x, max.y, max.z };
+	float out_low[3], out_high[3];
+	for(int r = 0; r < 3; ++r){
+		out_low[r] = out_high[r] = m.m[r * 4 + 3];
+		for(int c = 0; c < 3; ++c){
+			float a = m.m[r * 4 + c] * low[c];
+			float b = m.m[r * 4 + c] * high[c];
+			out_low[r] += a < b ? a : b;
+			out_high[r] += a < b ? b : a;
+		}
+	}
+	return AABB(Vec3(out_low[0], out_low[1], out_low[2]), Vec3(out_high[0], out_high[1], out_high[2]));
+}
+
+inline Sphere::Sphere() : center(0.0f, 0.0f, 0.0f), radius(-1.0f) {}
+
+inline Sphere::Sphere(const Vec3& center, float radius) : center(center), radius(radius) {}
+
+inline Sphere::Sphere(const AABB& box) : center(0.0f, 0.0f, 0.0f), radius(-1.0f) {
+	if(box.IsEmpty()) return;
+	center = box.Center();
+	radius = box.Extent().Magnitude();
+}
+
+inline bool Sphere::IsEmpty() const {
+	return radius < 0.0f;
+}
+
+inline void Sphere::Merge(const Vec3& point) {
+	Merge(Sphere(point, 0.0f));
+}
+
+inline void Sphere::Merge(const Sphere& other) {
+	if(other.IsEmpty()) return;
+	if(IsEmpty()){
+		*this = other;
+		return;
+	}
+	Vec3 offset = other.center - center;
+	float distance = offset.Magnitude();
+	if(distance + other.radius <= radius) return;
+	if(distance + radius <= other.radius){
+		*this = other;
+		return;
+	}
+	float merged = (distance + radius + other.radius) * 0.5f;
+	center += offset * ((merged - radius) / distance);
+	radius = merged;
+}
+
+inline bool Sphere::Contains(const Vec3& point) const {
+	return !IsEmpty() && (point - center).SqrMagnitude() <= radius * radius;
+}
+
+inline bool Sphere::Contains(const Sphere& other) const {
+	return !IsEmpty() && !other.IsEmpty() && Vec3::Distance(center, other.center) + other.radius <= radius;
+}
+
+inline bool Sphere::Overlaps(const Sphere& other) const {
+	if(IsEmpty() || other.IsEmpty()) return false;
+	float reach = radius + other.radius;
+	return (other.center - center).SqrMagnitude() <= reach * reach;
+}
+
+inline bool Sphere::Overlaps(const AABB& box) const {
+	return box.Overlaps(*this);
+}
+
+// The largest stretch is the square root of the largest eigenvalue of
+// M^T M, which M M^T shares. Each row sum of absolute entries of either
+// product bounds that eigenvalue (Gershgorin), and the smaller bound is
+// taken: M^T M is diagonal when the scale comes last, M M^T when it
+// comes first, and a diagonal matrix gives the eigenvalue exactly.
+inline Sphere Sphere::Transformed(const Mat4& m) const {
+	if(IsEmpty()) return Sphere();
+	float columns[3][3], rows[3][3];
+	for(int i = 0; i < 3; ++i){
+		for(int j = 0; j < 3; ++j){
+			columns[i][j] = m.m[i] * m.m[j] + m.m[4 + i] * m.m[4 + j] + m.m[8 + i] * m.m[8 + j];
+			rows[i][j] = m.m[i * 4] * m.m[j * 4] + m.m[i * 4 + 1] * m.m[j * 4 + 1] + m.m[i * 4 + 2] * m.m[j * 4 + 2];
+		}
+	}
+	float column_bound = 0.0f, row_bound = 0.0f;
+	for(int i = 0; i < 3; ++i){
+		float column = fabsf(columns[i][0]) + fabsf(columns[i][1]) + fabsf(columns[i][2]);
+		float row = fabsf(rows[i][0]) + fabsf(rows[i][1]) + fabsf(rows[i][2]);
+		column_bound = column > column_bound ? column : column_bound;
+		row_bound = row > row_bound ? row : row_bound;
+	}
+	float stretch = sqrtf(column_bound < row_bound ? column_bound : row_bound);
+	Vec3 moved(m.m[0] * center.x + m.m[1] * center.y + m.m[2] * center.z + m.m[3],
+	           m.m[4] * center.x + m.m[5] * center.y + m.m[6] * center.z + m.m[7],
+	           m.m[8] * center.x + m.m[9] * center.y + m.m[10] * center.z + m.m[11]);
+	return Sphere(moved, radius * stretch);
+}
+
+// Per-ISA kernels over the points [begin, end). Bounds kernels return the
+// AABB of those points, Farthest kernels the largest squared distance from
+// center. stride is the distance between points in floats, at least 3.
+inline namespace XMATH_ISA {
+
+__forceinline float LaneMinOf(xLane v){
+	float lanes[kLaneWidth];
+	LaneStore(lanes, v, kLaneWidth);
+	float result = lanes[0];
+	for(size_t k = 1; k < kLaneWidth; ++k) result = lanes[k] < result ? lanes[k] : result;
+	return result;
+}
+
+__forceinline float LaneMaxOf(xLane v){
+	float lanes[kLaneWidth];
+	LaneStore(lanes, v, kLaneWidth);
+	float result = lanes[0];
+	for(size_t k = 1; k < kLaneWidth; ++k) result = lanes[k] > result ? lanes[k] : result;
+	return result;
+}
+
+// Bounds and farthest squared distance of the points i * stride on from
+// x, y and z, for the ranges too short for a window.
+__forceinline AABB BoundsFew(const float* x, const float* y, const float* z, size_t stride, size_t begin, size_t end){
+	float low[3] = { INFINITY, INFINITY, INFINITY }, high[3] = { -INFINITY, -INFINITY, -INFINITY };
+	for(size_t i = begin; i < end; ++i){
+		const float v[3] = { x[i * stride], y[i * stride], z[i * stride] };
+		for(int a = 0; a < 3; ++a){
+			low[a] = v[a] < low[a] ? v[a] : low[a];
+			high[a] = v[a] > high[a] ? v[a] : high[a];
+		}
+	}
+	return AABB(Vec3(low[0], low[1], low[2]), Vec3(high[0], high[1], high[2]));
+}
+
+__forceinline float FarthestFew(const float* x, const float* y, const float* z, size_t stride, const Vec3& center,
+                                size_t begin, size_t end){
+	float farthest = 0.0f;
+	for(size_t i = begin; i < end; ++i){
+		float dx = x[i * stride] - center.x, dy = y[i * stride] - center.y, dz = z[i * stride] - center.z;
+		float d = dx * dx + dy * dy + dz * dz;
+		farthest = d > farthest ? d : farthest;
+	}
+	return farthest;
+}
+
+// Calls kernel(i) for windows of kLaneWidth points covering [begin, end),
+// the last one moved back to end at end - kLaneWidth. Needs at least
+// kLaneWidth points.
+template<typename Kernel>
+__forceinline void LaneWindows(size_t begin, size_t end, Kernel kernel){
+	for(size_t i = begin; i < end; i += kLaneWidth)
+		kernel(i + kLaneWidth <= end ? i : end - kLaneWidth);
+}
+
+inline AABB BoundsSoAKernel(const Vec3SoA& points, size_t begin, size_t end){
+	if(end - begin < kLaneWidth) return BoundsFew(points.x, points.y, points.z, 1, begin, end);
+	const float* axes[3] = { points.x, points.y, points.z };
+	xLane low[3], high[3];
+	for(int a = 0; a < 3; ++a) low[a] = high[a] = LaneLoad(axes[a] + begin, kLaneWidth);
+	LaneWindows(begin, end, [&](size_t i){
+		for(int a = 0; a < 3; ++a){
+			xLane v = LaneLoad(axes[a] + i, kLaneWidth);
+			low[a] = LaneMin(low[a], v);
+			high[a] = LaneMax(high[a], v);
+		}
+	});
+	return AABB(Vec3(LaneMinOf(low[0]), LaneMinOf(low[1]), LaneMinOf(low[2])),
+	            Vec3(LaneMaxOf(high[0]), LaneMaxOf(high[1]), LaneMaxOf(high[2])));
+}
+
+// Packed points: registers r = 0, 1, 2 of a window read floats
+// 3 * i + r * kLaneWidth onwards, so lane j of register r holds component
+// (r * kLaneWidth + j) % 3 of some point.
+inline AABB BoundsPacked(const float* p, size_t begin, size_t end){
+	xLane low[3], high[3];
+	for(int r = 0; r < 3; ++r) low[r] = high[r] = LaneLoad(p + begin * 3 + r * kLaneWidth, kLaneWidth);
+	LaneWindows(begin, end, [&](size_t i){
+		for(int r = 0; r < 3; ++r){
+			xLane v = LaneLoad(p + i * 3 + r * kLaneWidth, kLaneWidth);
+			low[r] = LaneMin(low[r], v);
+			high[r] = LaneMax(high[r], v);
+		}
+	});
+	float lows[3][kLaneWidth], highs[3][kLaneWidth];
+	float out_low[3] = { INFINITY, INFINITY, INFINITY }, out_high[3] = { -INFINITY, -INFINITY, -INFINITY };
+	for(int r = 0; r < 3; ++r){
+		LaneStore(lows[r], low[r], kLaneWidth);
+		LaneStore(highs[r], high[r], kLaneWidth);
+		for(size_t j = 0; j < kLaneWidth; ++j){
+			size_t c = (r * kLaneWidth + j) % 3;
+			out_low[c] = lows[r][j] < out_low[c] ? lows[r][j] : out_low[c];
+			out_high[c] = highs[r][j] > out_high[c] ? highs[r][j] : out_high[c];
+		}
+	}
+	return AABB(Vec3(out_low[0], out_low[1], out_low[2]), Vec3(out_high[0], out_high[1], out_high[2]));
+}
+
+inline AABB BoundsStridedKernel(const float* p, size_t stride, size_t begin, size_t end){
+	if(end - begin < kLaneWidth) return BoundsFew(p, p + 1, p + 2, stride, begin, end);
+	if(stride == 3) return BoundsPacked(p, begin, end);
+	xLane low[3], high[3], w;
+	LaneLoadAoS4Full(p + begin * stride, stride, &low[0], &low[1], &low[2], &w);
+	for(int a = 0; a < 3; ++a) high[a] = low[a];
+	LaneWindows(begin, end, [&](size_t i){
+		xLane v[3];
+		LaneLoadAoS4Full(p + i * stride, stride, &v[0], &v[1], &v[2], &w);
+		for(int a = 0; a < 3; ++a){
+			low[a] = LaneMin(low[a], v[a]);
+			high[a] = LaneMax(high[a], v[a]);
+		}
+	});
+	return AABB(Vec3(LaneMinOf(low[0]), LaneMinOf(low[1]), LaneMinOf(low[2])),
+	            Vec3(LaneMaxOf(high[0]), LaneMaxOf(high[1]), LaneMaxOf(high[2])));
+}
+
+__forceinline xLane __vectorcall LaneDistanceSquared(xLane x, xLane y, xLane z, const xLane center[3]){
+	xLane dx = LaneSub(x, center[0]), dy = LaneSub(y, center[1]), dz = LaneSub(z, center[2]);
+	return LaneMultiplyAdd(dz, dz, LaneMultiplyAdd(dy, dy, LaneMul(dx, dx)));
+}
+
+inline float FarthestSoAKernel(const Vec3SoA& points, const Vec3& center, size_t begin, size_t end){
+	if(end - begin < kLaneWidth) return FarthestFew(points.x, points.y, points.z, 1, center, begin, end);
+	const xLane c[3] = { LaneSet(center.x), LaneSet(center.y), LaneSet(center.z) };
+	xLane high = LaneSet(0.0f);
+	LaneWindows(begin, end, [&](size_t i){
+		xLane d = LaneDistanceSquared(LaneLoad(points.x + i, kLaneWidth), LaneLoad(points.y + i, kLaneWidth),
+		                              LaneLoad(points.z + i, kLaneWidth), c);
+		high = LaneMax(high, d);
+	});
+	return LaneMaxOf(high);
+}
+
+// kLaneWidth points as x, y and z lanes. Each point is read as four
+// floats, which for packed points runs one float into the next point;
+// a window that ends at end goes through a stack copy instead.
+__forceinline void LaneLoadPositions(const float* p, size_t stride, bool at_end, xLane* x, xLane* y, xLane* z){
+	xLane w;
+	if(stride == 3 && at_end){
+		float copy[kLaneWidth * 4];
+		for(size_t k = 0; k < kLaneWidth; ++k)
+			for(size_t c = 0; c < 3; ++c) copy[k * 4 + c] = p[k * 3 + c];
+		LaneLoadAoS4Full(copy, 4, x, y, z, &w);
+	} else {
+		LaneLoadAoS4Full(p, stride, x, y, z, &w);
+	}
+}
+
+inline float FarthestStridedKernel(const float* p, size_t stride, const Vec3& center, size_t begin, size_t end){
+	if(end - begin < kLaneWidth) return FarthestFew(p, p + 1, p + 2, stride, center, begin, end);
+	const xLane c[3] = { LaneSet(center.x), LaneSet(center.y), LaneSet(center.z) };
+	xLane high = LaneSet(0.0f);
+	LaneWindows(begin, end, [&](size_t i){
+		xLane x, y, z;
+		LaneLoadPositions(p + i * stride, stride, i + kLaneWidth == end, &x, &y, &z);
+		high = LaneMax(high, LaneDistanceSquared(x, y, z, c));
+	});
+	return LaneMaxOf(high);
+}
+
+} // namespace XMATH_ISA
+
+inline AABB MergeBounds(const AABB& a, const AABB& b){
+	AABB merged = a;
+	merged.Merge(b);
+	return merged;
+}
+
+inline float MaxOf(float a, float b){
+	return a > b ? a : b;
+}
+
+template<typename Policy = xParallelPolicy>
+inline AABB ComputeBounds(const Vec3SoA& points, Policy policy = Policy()){
+	return ParallelReduce(policy, points.count, kBoundsGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(BoundsSoA)(points, begin, end);
+	}, MergeBounds);
+}
+
+// positions points at the x of the first vertex; x, y and z are
+// consecutive floats and stride floats separate one vertex from the next.
+template<typename Policy = xParallelPolicy>
+inline AABB ComputeBounds(const float* positions, size_t stride, size_t count, Policy policy = Policy()){
+	assert(stride >= 3);
+	return ParallelReduce(policy, count, kBoundsGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(BoundsStrided)(positions, stride, begin, end);
+	}, MergeBounds);
+}
+
+template<typename Policy = xParallelPolicy>
+inline AABB ComputeBounds(const Vec3* points, size_t count, Policy policy = Policy()){
+	return ComputeBounds(&points->x, 3, count, policy);
+}
+
+// Centered on the AABB, so two passes over the points; the radius is
+// rounded up so that every point passes Contains. Not the minimal
+// sphere, but within sqrt(3) of it.
+template<typename Policy = xParallelPolicy>
+inline Sphere ComputeBoundingSphere(const Vec3SoA& points, Policy policy = Policy()){
+	AABB bounds = ComputeBounds(points, policy);
+	if(bounds.IsEmpty()) return Sphere();
+	Vec3 center = bounds.Center();
+	float farthest = ParallelReduce(policy, points.count, kBoundsGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(FarthestSoA)(points, center, begin, end);
+	}, MaxOf);
+	return Sphere(center, sqrtf(farthest) * (1.0f + FLT_EPSILON));
+}
+
+template<typename Policy = xParallelPolicy>
+inline Sphere ComputeBoundingSphere(const float* positions, size_t stride, size_t count, Policy policy = Policy()){
+	AABB bounds = ComputeBounds(positions, stride, count, policy);
+	if(bounds.IsEmpty()) return Sphere();
+	Vec3 center = bounds.Center();
+	float farthest = ParallelReduce(policy, count, kBoundsGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(FarthestStrided)(positions, stride, center, begin, end);
+	}, MaxOf);
+	return Sphere(center, sqrtf(farthest) * (1.0f + FLT_EPSILON));
+}
+
+template<typename Policy = xParallelPolicy>
+inline Sphere ComputeBoundingSphere(const Vec3* points, size_t count, Policy policy = Policy()){
+	return ComputeBoundingSphere(&points->x, 3, count, policy);
+}
+
+#endif // __XBOUNDS_H__
@@ -0,0 +1,738 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Bounding Volume Hierarchy.
+//--------------------------------------------------------------//
+//
+//   xBvh4 and xBvh8 over triangle meshes: every node holds the
+//   boxes of up to 4 or 8 children.
+//
+//   Build splits the triangles top-down by the surface area
+//   heuristic, binned: the centroids of a node fall into kBvhBins
+//   slices per axis and the cheapest of the 3 * (kBvhBins - 1)
+//   planes between them wins, unless one leaf of all the triangles
+//   is cheaper still. By default subtrees of more than kBvhGrain
+//   triangles are built side by side on the thread pool
+//   (xParallel.h), and the binning passes of such nodes are split
+//   across it too. The binary tree is then collapsed into wide nodes
+//   by opening the child with the largest surface area until the
+//   node is full.
+//
+//   A node keeps its child boxes as six rows of Width floats, min x
+//   y z then max x y z, so LaneBox tests all children of a node at
+//   once: one register for a BVH4 node, one or two for a BVH8 node.
+//   A BVH4 node is 128 bytes and a BVH8 node 256, two and four whole
+//   cache lines on 64-byte boundaries. Nodes are in depth-first
+//   order, so a parent comes before its children. Unused slots hold
+//   a box at +infinity that no ray can enter.
+//
+//   The triangles are copied into a TriangleSoA in leaf order, so a
+//   leaf is a contiguous run for the lane kernel of xRay.h. Hits
+//   report the index of the triangle in the mesh.
+//
+//   Refit takes moved vertices of the same mesh and recomputes the
+//   boxes bottom-up without touching the tree. It costs a fraction of
+//   a Build, but the tree only stays good while the mesh stays close
+//   to the pose it was built in; rebuild after large deformations.
+//
+//--------------------------------------------------------------//
+#ifndef __XBVH_H__
+#define __XBVH_H__ 1
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <xmmintrin.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xBounds.h"
+#include "xRay.h"
+#include "vector_3.h"
+
+const size_t kBvhAlignment = 64;
+// Triangles above which a subtree is built as a task of its own.
+const size_t kBvhGrain = 4096;
+// Rays per task when a policy traces in parallel.
+const size_t kBvhRayGrain = 256;
+const int kBvhBins = 16;
+// Largest leaf, unless the depth limit stops the split first.
+const uint32_t kBvhMaxLeaf = 8;
+// Depth limit of the binary tree. It also bounds the traversal stack.
+const uint32_t kBvhMaxDepth = 64;
+// Cost of visiting a node relative to one triangle test.
+const float kBvhTraversalCost = 1.0f;
+// child of an unused slot.
+const uint32_t kBvhEmptySlot = 0xFFFFFFFFu;
+
+template<int Width>
+struct xBvhNode {
+
+	AABB Bounds(int slot) const;
+	void SetBounds(int slot, const AABB& box);
+	void Clear();
+
+	// min x, min y, min z, max x, max y, max z of each slot.
+	float bounds[6][Width];
+	// A node index for an inner child, the first triangle of a leaf, or
+	// kBvhEmptySlot.
+	uint32_t child[Width];
+	// Triangles in a leaf; 0 for an inner child or an unused slot.
+	uint32_t count[Width];
+};
+
+template<int Width>
+class xBvh {
+public:
+
+	xBvh();
+	~xBvh();
+
+	// Triangle i is vertices[indices[3 i]], vertices[indices[3 i + 1]],
+	// vertices[indices[3 i + 2]].
+	template<typename Policy = xParallelPolicy>
+	void Build(const Vec3* vertices, const uint32_t* indices, size_t triangles, Policy policy = Policy());
+	// Triangle i is vertices[3 i], vertices[3 i + 1], vertices[3 i + 2].
+	template<typename Policy = xParallelPolicy>
+	void Build(const Vec3* vertices, size_t triangles, Policy policy = Policy());
+	// vertices are the ones of the last Build, moved; the triangles keep
+	// their indices.
+	template<typename Policy = xParallelPolicy>
+	void Refit(const Vec3* vertices, Policy policy = Policy());
+	void Clear();
+
+	size_t NodeCount() const;
+	size_t TriangleCount() const;
+	AABB Bounds() const;
+	const xBvhNode<Width>* Nodes() const;
+	// The triangles in leaf order.
+	const TriangleSoA& Triangles() const;
+	// Mesh index of the triangle at leaf position i.
+	uint32_t TriangleIndex(size_t i) const;
+
+	// The nearest hit with ray.t_min <= t < ray.t_max. index is the mesh
+	// triangle, or kNoHit when there is none.
+	RayHit Intersect(const Ray& ray) const;
+	// Traces every ray of rays. As for the packet functions of xRay.h,
+	// hits holds rays.Count() entries, hits[i].t is the far limit of ray
+	// i and a nearer hit replaces hits[i].
+	template<typename Policy = xSequentialPolicy>
+	void Intersect(const RaySoA& rays, RayHit* hits, Policy policy = Policy()) const;
+
+private:
+	xBvh(const xBvh&) = delete;
+	xBvh& operator=(const xBvh&) = delete;
+
+	// Build merges boxes a few hundred times per triangle, so it and Refit
+	// keep them as plain floats rather than AABB and Vec3.
+	struct BuildBox {
+		BuildBox();
+		void Merge(const BuildBox& other);
+		void Merge(const float* point);
+		float SurfaceArea() const;
+		AABB ToAABB() const;
+		float min[3];
+		float max[3];
+	};
+
+	// Binary tree of the build. count 0 marks an inner node.
+	struct BuildNode {
+		BuildBox bounds;
+		uint32_t left;
+		uint32_t right;
+		uint32_t first;
+		uint32_t count;
+	};
+
+	// Box of the triangles and box of their centroids.
+	struct BuildRange {
+		void Merge(const BuildRange& other);
+		BuildBox bounds;
+		BuildBox centers;
+	};
+
+	struct BuildBins {
+		BuildBins();
+		void Merge(const BuildBins& other);
+		BuildBox bounds[3][kBvhBins];
+		uint32_t count[3][kBvhBins];
+	};
+
+	// A triangle as the build sees it. Split partitions these in place, so
+	// every node is a contiguous run and every pass reads memory in order.
+	struct BuildRef {
+		BuildBox box;
+		float center[3];
+		uint32_t index;
+	};
+
+	struct BuildState {
+		BuildRef* refs;
+		BuildNode* nodes;
+		std::atomic<uint32_t> next;
+	};
+
+	template<typename Policy>
+	static BuildRange RangeOf(const BuildState* state, uint32_t begin, uint32_t end, Policy policy);
+	template<typename Policy>
+	static void Split(BuildState* state, uint32_t node, uint32_t begin, uint32_t end, const BuildRange& range,
+	                  uint32_t depth, Policy policy);
+	uint32_t Collapse(const BuildNode* nodes, uint32_t node);
+	void Reserve(size_t size);
+
+	xBvhNode<Width>* nodes_;
+	size_t count_;
+	size_t capacity_;
+	TriangleSoA triangles_;
+	// Mesh index of each triangle, in leaf order.
+	std::vector<uint32_t> order_;
+	// Vertex indices, three per triangle in leaf order, for Refit.
+	std::vector<uint32_t> indices_;
+};
+
+typedef xBvh<4> xBvh4;
+typedef xBvh<8> xBvh8;
+
+template<int Width>
+inline AABB xBvhNode<Width>::Bounds(int slot) const {
+	return AABB(Vec3(bounds[0][slot], bounds[1][slot], bounds[2][slot]),
+	            Vec3(bounds[3][slot], bounds[4][slot], bounds[5][slot]));
+}
+
+template<int Width>
+inline void xBvhNode<Width>::SetBounds(int slot, const AABB& box) {
+	bounds[0][slot] = box.min.x; bounds[1][slot] = box.min.y; bounds[2][slot] = box.min.z;
+	bounds[3][slot] = box.max.x; bounds[4][slot] = box.max.y; bounds[5][slot] = box.max.z;
+}
+
+// Entry and exit of a box at +infinity are both +infinity or both
+// -infinity along every axis the ray moves on, so LaneBox never accepts it.
+template<int Width>
+inline void xBvhNode<Width>::Clear() {
+	for(int slot = 0; slot < Width; ++slot){
+		for(int k = 0; k < 6; ++k) bounds[k][slot] = INFINITY;
+		child[slot] = kBvhEmptySlot;
+		count[slot] = 0;
+	}
+}
+
+// Slice of axis that the centroid c falls into.
+__forceinline int BvhBin(const float* c, int axis, const float* low, const float* scale){
+	int bin = (int)((c[axis] - low[axis]) * scale[axis]);
+	return bin < kBvhBins - 1 ? bin : kBvhBins - 1;
+}
+
+template<int Width>
+inline xBvh<Width>::BuildBox::BuildBox() {
+	for(int a = 0; a < 3; ++a){
+		min[a] = INFINITY;
+		max[a] = -INFINITY;
+	}
+}
+
+template<int Width>
+inline void xBvh<Width>::BuildBox::Merge(const BuildBox& other) {
+	for(int a = 0; a < 3; ++a){
+		min[a] = other.min[a] < min[a] ? other.min[a] : min[a];
+		max[a] = other.max[a] > max[a] ? other.max[a] : max[a];
+	}
+}
+
+template<int Width>
+inline void xBvh<Width>::BuildBox::Merge(const float* point) {
+	for(int a = 0; a < 3; ++a){
+		min[a] = point[a] < min[a] ? point[a] : min[a];
+		max[a] = point[a] > max[a] ? point[a] : max[a];
+	}
+}
+
+template<int Width>
+inline float xBvh<Width>::BuildBox::SurfaceArea() const {
+	if(min[0] > max[0] || min[1] > max[1] || min[2] > max[2]) return 0.0f;
+	float x = max[0] - min[0], y = max[1] - min[1], z = max[2] - min[2];
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+template<int Width>
+inline AABB xBvh<Width>::BuildBox::ToAABB() const {
+	return AABB(Vec3(min[0], min[1], min[2]), Vec3(max[0], max[1], max[2]));
+}
+
+template<int Width>
+inline void xBvh<Width>::BuildRange::Merge(const BuildRange& other) {
+	bounds.Merge(other.bounds);
+	centers.Merge(other.centers);
+}
+
+template<int Width>
+inline xBvh<Width>::BuildBins::BuildBins() {
+	memset(count, 0, sizeof(count));
+}
+
+template<int Width>
+inline void xBvh<Width>::BuildBins::Merge(const BuildBins& other) {
+	for(int a = 0; a < 3; ++a){
+		for(int b = 0; b < kBvhBins; ++b){
+			bounds[a][b].Merge(other.bounds[a][b]);
+			count[a][b] += other.count[a][b];
+		}
+	}
+}
+
+template<int Width>
+inline xBvh<Width>::xBvh() : nodes_(NULL), count_(0), capacity_(0) {}
+
+template<int Width>
+inline xBvh<Width>::~xBvh() {
+	_mm_free(nodes_);
+}
+
+template<int Width>
+inline void xBvh<Width>::Reserve(size_t size) {
+	if(size <= capacity_) return;
+	_mm_free(nodes_);
+	nodes_ = (xBvhNode<Width>*)_mm_malloc(size * sizeof(xBvhNode<Width>), kBvhAlignment);
+	capacity_ = size;
+}
+
+template<int Width>
+inline void xBvh<Width>::Clear() {
+	count_ = 0;
+	triangles_.Resize(0);
+	order_.clear();
+	indices_.clear();
+}
+
+template<int Width>
+__forceinline size_t xBvh<Width>::NodeCount() const {
+	return count_;
+}
+
+template<int Width>
+inline size_t xBvh<Width>::TriangleCount() const {
+	return order_.size();
+}
+
+template<int Width>
+inline AABB xBvh<Width>::Bounds() const {
+	AABB box;
+	if(!count_) return box;
+	for(int slot = 0; slot < Width; ++slot)
+		if(nodes_[0].child[slot] != kBvhEmptySlot) box.Merge(nodes_[0].Bounds(slot));
+	return box;
+}
+
+template<int Width>
+__forceinline const xBvhNode<Width>* xBvh<Width>::Nodes() const {
+	return nodes_;
+}
+
+template<int Width>
+__forceinline const TriangleSoA& xBvh<Width>::Triangles() const {
+	return triangles_;
+}
+
+template<int Width>
+__forceinline uint32_t xBvh<Width>::TriangleIndex(size_t i) const {
+	return order_[i];
+}
+
+template<int Width>
+template<typename Policy>
+inline void xBvh<Width>::Build(const Vec3* vertices, size_t triangles, Policy policy) {
+	std::vector<uint32_t> indices(triangles * 3);
+	for(size_t i = 0; i < indices.size(); ++i) indices[i] = (uint32_t)i;
+	Build(vertices, indices.empty() ? NULL : &indices[0], triangles, policy);
+}
+
+template<int Width>
+template<typename Policy>
+inline void xBvh<Width>::Build(const Vec3* vertices, const uint32_t* indices, size_t triangles, Policy policy) {
+	Clear();
+	if(!triangles) return;
+	assert(triangles < kNoHit);
+
+	std::vector<BuildRef> refs(triangles);
+	ParallelFor(policy, triangles, kBvhGrain, [&](size_t begin, size_t end){
+		for(size_t i = begin; i < end; ++i){
+			BuildRef& ref = refs[i];
+			ref.box = BuildBox();
+			for(int k = 0; k < 3; ++k) ref.box.Merge(&vertices[indices[i * 3 + k]].x);
+			for(int a = 0; a < 3; ++a) ref.center[a] = (ref.box.min[a] + ref.box.max[a]) * 0.5f;
+			ref.index = (uint32_t)i;
+		}
+	});
+
+	// A binary tree over n triangles has at most 2 n - 1 nodes.
+	std::vector<BuildNode> nodes(triangles * 2 - 1);
+	BuildState state;
+	state.refs = &refs[0];
+	state.nodes = &nodes[0];
+	state.next.store(1);
+	Split(&state, 0, 0, (uint32_t)triangles, RangeOf(&state, 0, (uint32_t)triangles, policy), 0, policy);
+
+	// Every wide node takes the place of at least one inner binary node.
+	size_t inner = (state.next.load() - 1) / 2;
+	Reserve(inner ? inner : 1);
+	if(nodes[0].count){
+		count_ = 1;
+		nodes_[0].Clear();
+		nodes_[0].SetBounds(0, nodes[0].bounds.ToAABB());
+		nodes_[0].child[0] = 0;
+		nodes_[0].count[0] = nodes[0].count;
+	}else{
+		Collapse(&nodes[0], 0);
+	}
+
+	triangles_.Resize(triangles);
+	order_.resize(triangles);
+	indices_.resize(triangles * 3);
+	ParallelFor(policy, triangles, kBvhGrain, [&](size_t begin, size_t end){
+		for(size_t i = begin; i < end; ++i){
+			order_[i] = refs[i].index;
+			const uint32_t* corner = indices + (size_t)order_[i] * 3;
+			for(int k = 0; k < 3; ++k) indices_[i * 3 + k] = corner[k];
+			triangles_.Set(i, vertices[corner[0]], vertices[corner[1]], vertices[corner[2]]);
+		}
+	});
+}
+
+template<int Width>
+template<typename Policy>
+inline typename xBvh<Width>::BuildRange xBvh<Width>::RangeOf(const BuildState* state, uint32_t begin, uint32_t end,
+                                                             Policy policy) {
+	const BuildRef* refs = state->refs + begin;
+	return ParallelReduce(policy, end - begin, kBvhGrain, [&](size_t first, size_t last){
+		BuildRange part;
+		for(size_t i = first; i < last; ++i){
+			part.bounds.Merge(refs[i].box);
+			part.centers.Merge(refs[i].center);
+		}
+		return part;
+	}, [](BuildRange a, const BuildRange& b){ a.Merge(b); return a; });
+}
+
+// Makes node the root of refs[begin, end), whose boxes and centroids
+// range covers, and splits it recursively.
+template<int Width>
+template<typename Policy>
+inline void xBvh<Width>::Split(BuildState* state, uint32_t node, uint32_t begin, uint32_t end, const BuildRange& range,
+                               uint32_t depth, Policy policy) {
+	uint32_t count = end - begin;
+	BuildRef* refs = state->refs + begin;
+	BuildNode& self = state->nodes[node];
+	self.bounds = range.bounds;
+	self.left = self.right = 0;
+	self.first = begin;
+	self.count = count;
+	if(count == 1 || depth >= kBvhMaxDepth) return;
+
+	// Axes along which all centroids coincide get no bins.
+	const float* low = range.centers.min;
+	float scale[3];
+	for(int a = 0; a < 3; ++a){
+		float extent = range.centers.max[a] - range.centers.min[a];
+		scale[a] = extent > 0.0f ? kBvhBins * 0.99999f / extent : 0.0f;
+	}
+	BuildBins bins = ParallelReduce(policy, count, kBvhGrain, [&](size_t first, size_t last){
+		BuildBins part;
+		for(size_t i = first; i < last; ++i){
+			for(int a = 0; a < 3; ++a){
+				if(scale[a] == 0.0f) continue;
+				int bin = BvhBin(refs[i].center, a, low, scale);
+				part.bounds[a][bin].Merge(refs[i].box);
+				++part.count[a][bin];
+			}
+		}
+		return part;
+	}, [](BuildBins a, const BuildBins& b){ a.Merge(b); return a; });
+
+	// Plane s puts bins [0, s) on the left. Sweep the right sides in from
+	// the top, then the left sides up from the bottom.
+	float best_cost = INFINITY;
+	int best_axis = -1, best_plane = 0;
+	for(int a = 0; a < 3; ++a){
+		if(scale[a] == 0.0f) continue;
+		float right_area[kBvhBins];
+		uint32_t right_count[kBvhBins];
+		BuildBox box;
+		uint32_t n = 0;
+		for(int s = kBvhBins - 1; s > 0; --s){
+			box.Merge(bins.bounds[a][s]);
+			n += bins.count[a][s];
+			right_area[s] = box.SurfaceArea();
+			right_count[s] = n;
+		}
+		box = BuildBox();
+		n = 0;
+		for(int s = 1; s < kBvhBins; ++s){
+			box.Merge(bins.bounds[a][s - 1]);
+			n += bins.count[a][s - 1];
+			if(!n || !right_count[s]) continue;
+			float cost = box.SurfaceArea() * n + right_area[s] * right_count[s];
+			if(cost < best_cost){
+				best_cost = cost;
+				best_axis = a;
+				best_plane = s;
+			}
+		}
+	}
+
+	// The partition gathers the ranges of both sides on the way, so the
+	// children need no pass of their own for them.
+	uint32_t middle;
+	BuildRange sides[2];
+	if(best_axis < 0){
+		// All centroids in one point: no plane separates them.
+		if(count <= kBvhMaxLeaf) return;
+		middle = begin + count / 2;
+		sides[0] = RangeOf(state, begin, middle, policy);
+		sides[1] = RangeOf(state, middle, end, policy);
+	}else{
+		float area = range.bounds.SurfaceArea();
+		if(count <= kBvhMaxLeaf && kBvhTraversalCost * area + best_cost >= count * area) return;
+		uint32_t left_end = 0, right_begin = count;
+		while(left_end < right_begin){
+			BuildRef ref = refs[left_end];
+			int side = BvhBin(ref.center, best_axis, low, scale) >= best_plane;
+			sides[side].bounds.Merge(ref.box);
+			sides[side].centers.Merge(ref.center);
+			if(side){
+				refs[left_end] = refs[--right_begin];
+				refs[right_begin] = ref;
+			}else{
+				++left_end;
+			}
+		}
+		middle = begin + left_end;
+	}
+
+	uint32_t left = state->next.fetch_add(2);
+	self.left = left;
+	self.right = left + 1;
+	self.count = 0;
+	if(count > kBvhGrain){
+		ParallelInvoke(policy,
+			[&](){ Split(state, left, begin, middle, sides[0], depth + 1, policy); },
+			[&](){ Split(state, left + 1, middle, end, sides[1], depth + 1, policy); });
+	}else{
+		Split(state, left, begin, middle, sides[0], depth + 1, kSequential);
+		Split(state, left + 1, middle, end, sides[1], depth + 1, kSequential);
+	}
+}
+
+// Turns the inner binary node into a wide node, then its inner children,
+// depth first. Returns the index of the wide node.
+template<int Width>
+inline uint32_t xBvh<Width>::Collapse(const BuildNode* nodes, uint32_t node) {
+	uint32_t slots[Width];
+	int used = 2;
+	slots[0] = nodes[node].left;
+	slots[1] = nodes[node].right;
+	while(used < Width){
+		int open = -1;
+		float largest = -1.0f;
+		for(int k = 0; k < used; ++k){
+			const BuildNode& child = nodes[slots[k]];
+			if(child.count) continue;
+			float area = child.bounds.SurfaceArea();
+			if(area > largest){
+				largest = area;
+				open = k;
+			}
+		}
+		if(open < 0) break;
+		uint32_t opened = slots[open];
+		slots[open] = nodes[opened].left;
+		slots[used++] = nodes[opened].right;
+	}
+
+	uint32_t index = (uint32_t)count_++;
+	assert(count_ <= capacity_);
+	nodes_[index].Clear();
+	for(int k = 0; k < used; ++k){
+		const BuildNode& child = nodes[slots[k]];
+		uint32_t target = child.count ? child.first : Collapse(nodes, slots[k]);
+		nodes_[index].SetBounds(k, child.bounds.ToAABB());
+		nodes_[index].child[k] = target;
+		nodes_[index].count[k] = child.count;
+	}
+	return index;
+}
+
+template<int Width>
+template<typename Policy>
+inline void xBvh<Width>::Refit(const Vec3* vertices, Policy policy) {
+	const size_t triangles = order_.size();
+	ParallelFor(policy, triangles, kBvhGrain, [&](size_t begin, size_t end){
+		for(size_t i = begin; i < end; ++i)
+			triangles_.Set(i, vertices[indices_[i * 3]], vertices[indices_[i * 3 + 1]], vertices[indices_[i * 3 + 2]]);
+	});
+
+	// Leaf boxes do not depend on each other.
+	ParallelFor(policy, count_, kBvhGrain / kBvhMaxLeaf, [&](size_t begin, size_t end){
+		for(size_t n = begin; n < end; ++n){
+			xBvhNode<Width>& node = nodes_[n];
+			for(int slot = 0; slot < Width; ++slot){
+				if(!node.count[slot]) continue;
+				BuildBox box;
+				const uint32_t* corner = &indices_[(size_t)node.child[slot] * 3];
+				for(uint32_t k = 0; k < node.count[slot] * 3; ++k) box.Merge(&vertices[corner[k]].x);
+				for(int a = 0; a < 3; ++a){
+					node.bounds[a][slot] = box.min[a];
+					node.bounds[a + 3][slot] = box.max[a];
+				}
+			}
+		}
+	});
+
+	// Inner boxes bottom-up: children always come after their parent.
+	for(size_t n = count_; n-- > 0;){
+		xBvhNode<Width>& node = nodes_[n];
+		for(int slot = 0; slot < Width; ++slot){
+			if(node.count[slot] || node.child[slot] == kBvhEmptySlot) continue;
+			const xBvhNode<Width>& child = nodes_[node.child[slot]];
+			for(int a = 0; a < 3; ++a){
+				float low = INFINITY, high = -INFINITY;
+				for(int k = 0; k < Width; ++k){
+					if(child.child[k] == kBvhEmptySlot) continue;
+					low = child.bounds[a][k] < low ? child.bounds[a][k] : low;
+					high = child.bounds[a + 3][k] > high ? child.bounds[a + 3][k] : high;
+				}
+				node.bounds[a][slot] = low;
+				node.bounds[a + 3][slot] = high;
+			}
+		}
+	}
+}
+
+// Per-ISA kernels.
+inline namespace XMATH_ISA {
+
+// Visits the boxes nearest first and skips every subtree the ray enters
+// beyond the nearest hit so far.
+template<int Width>
+inline RayHit IntersectBvhKernel(const xBvh<Width>& bvh, const Ray& ray){
+	struct Entry {
+		uint32_t child;
+		uint32_t count;
+		float t;
+	};
+
+	RayHit best(ray.t_max);
+	if(!bvh.NodeCount()) return best;
+	const xBvhNode<Width>* nodes = bvh.Nodes();
+	xLane o[3], inverse[3];
+	LaneBroadcast(ray.origin, o);
+	LaneBroadcast(Vec3(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z), inverse);
+	const xLane t_min = LaneSet(ray.t_min);
+
+	// Each wide level pops one entry and pushes at most Width.
+	Entry stack[(kBvhMaxDepth + 1) * (Width - 1) + 1];
+	size_t top = 0;
+	Entry root = { 0, 0, ray.t_min };
+	stack[top++] = root;
+	while(top){
+		Entry entry = stack[--top];
+		if(entry.t >= best.t) continue;
+		if(entry.count){
+			Ray limited(ray.origin, ray.direction, ray.t_min, best.t);
+			RayHit hit = IntersectTrianglesKernel(limited, bvh.Triangles(), entry.child, entry.child + entry.count);
+			if(hit.IsHit()) best = hit;
+			continue;
+		}
+
+		const xBvhNode<Width>& node = nodes[entry.child];
+		const xLane limit = LaneSet(best.t);
+		float t[Width];
+		uint32_t bits = 0;
+		for(size_t k = 0; k < (size_t)Width; k += kLaneWidth){
+			size_t n = (size_t)Width - k < kLaneWidth ? (size_t)Width - k : kLaneWidth;
+			xLane low[3], high[3], t_near;
+			for(int a = 0; a < 3; ++a){
+				low[a] = LaneLoad(node.bounds[a] + k, n);
+				high[a] = LaneLoad(node.bounds[a + 3] + k, n);
+			}
+			bits |= (LaneBox(o, inverse, low, high, t_min, limit, &t_near) & LaneCountMask(n)) << k;
+			LaneStore(t + k, t_near, n);
+		}
+		if(!bits) continue;
+
+		// Farthest first, so the nearest child is popped next.
+		Entry hit[Width];
+		size_t hits = 0;
+		for(int k = 0; k < Width; ++k){
+			if(!((bits >> k) & 1)) continue;
+			Entry child = { node.child[k], node.count[k], t[k] };
+			size_t j = hits++;
+			for(; j > 0 && hit[j - 1].t < child.t; --j) hit[j] = hit[j - 1];
+			hit[j] = child;
+		}
+		for(size_t j = 0; j < hits; ++j) stack[top++] = hit[j];
+	}
+	if(best.IsHit()) best.index = bvh.TriangleIndex(best.index);
+	return best;
+}
+
+template<int Width>
+inline void IntersectBvhRaysKernel(const xBvh<Width>& bvh, const RaySoA& rays, RayHit* hits, size_t begin, size_t end){
+	for(size_t i = begin; i < end; ++i){
+		Ray ray(rays.origin.Get(i), rays.direction.Get(i), rays.t_min, hits[i].t);
+		RayHit hit = IntersectBvhKernel(bvh, ray);
+		if(hit.IsHit()) hits[i] = hit;
+	}
+}
+
+inline RayHit IntersectBvh4Kernel(const xBvh4& bvh, const Ray& ray){
+	return IntersectBvhKernel(bvh, ray);
+}
+
+inline RayHit IntersectBvh8Kernel(const xBvh8& bvh, const Ray& ray){
+	return IntersectBvhKernel(bvh, ray);
+}
+
+inline void IntersectBvh4RaysKernel(const xBvh4& bvh, const RaySoA& rays, RayHit* hits, size_t begin, size_t end){
+	IntersectBvhRaysKernel(bvh, rays, hits, begin, end);
+}
+
+inline void IntersectBvh8RaysKernel(const xBvh8& bvh, const RaySoA& rays, RayHit* hits, size_t begin, size_t end){
+	IntersectBvhRaysKernel(bvh, rays, hits, begin, end);
+}
+
+} // namespace XMATH_ISA
+
+// The dispatch slots of each width.
+inline RayHit DispatchIntersectBvh(const xBvh4& bvh, const Ray& ray){
+	return XMATH_DISPATCH(IntersectBvh4)(bvh, ray);
+}
+
+inline RayHit DispatchIntersectBvh(const xBvh8& bvh, const Ray& ray){
+	return XMATH_DISPATCH(IntersectBvh8)(bvh, ray);
+}
+
+inline void DispatchIntersectBvh(const xBvh4& bvh, const RaySoA& rays, RayHit* hits, size_t begin, size_t end){
+	XMATH_DISPATCH(IntersectBvh4Rays)(bvh, rays, hits, begin, end);
+}
+
+inline void DispatchIntersectBvh(const xBvh8& bvh, const RaySoA& rays, RayHit* hits, size_t begin, size_t end){
+	XMATH_DISPATCH(IntersectBvh8Rays)(bvh, rays, hits, begin, end);
+}
+
+template<int Width>
+inline RayHit xBvh<Width>::Intersect(const Ray& ray) const {
+	return DispatchIntersectBvh(*this, ray);
+}
+
+template<int Width>
+template<typename Policy>
+inline void xBvh<Width>::Intersect(const RaySoA& rays, RayHit* hits, Policy policy) const {
+	ParallelFor(policy, rays.Count(), kBvhRayGrain, [&](size_t begin, size_t end){
+		DispatchIntersectBvh(*this, rays, hits, begin, end);
+	});
+}
+
+#endif // __XBVH_H__
@@ -0,0 +1,278 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Runtime ISA Dispatch.
+//--------------------------------------------------------------//
+//
+//   src/kernels/kernels.inl is compiled three times, with
+//   /arch:SSE2, /arch:AVX2 and /arch:AVX512. Each build fills an
+//   xKernelTable with its own copy of every batch kernel. The first
+//   call to Kernels() runs CPUID, picks the widest ISA the CPU and OS
+//   support and binds that table for the rest of the run.
+//
+//   XMATH_FORCE_ISA=sse2|avx2|avx512 in the environment caps the
+//   choice, for A/B runs on one machine. It never selects an ISA the
+//   CPU cannot execute.
+//
+//   Builds that define XMATH_RUNTIME_DISPATCH route the public batch
+//   functions through the table; without it they call the kernels
+//   compiled for the current translation unit and need no extra objects.
+//
+//--------------------------------------------------------------//
+#ifndef __XDISPATCH_H__
+#define __XDISPATCH_H__ 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <intrin.h>
+#include <vector>
+#include "xSimd.h"
+
+class Vec3;
+class Vec4;
+class Mat4;
+class Quat;
+struct xVector3;
+struct xMatrix4;
+struct Vec3SoA;
+struct QuatSoA;
+struct xFrustum;
+struct AABB;
+struct Sphere;
+struct Ray;
+struct RayHit;
+struct RaySoA;
+struct TriangleSoA;
+template<int Width> class xBvh;
+class xHashGrid;
+class xKdTree;
+struct Mat4SoA;
+
+// Where the radius queries put the indices they find. The kernels never
+// grow a container themselves (xSimd.h); they hand runs of indices to
+// append, which IndexSink points at a std::vector<uint32_t>.
+struct xIndexSink {
+	void (*append)(void* target, const uint32_t* indices, size_t count);
+	void* target;
+};
+
+inline void AppendIndices(void* target, const uint32_t* indices, size_t count){
+	std::vector<uint32_t>* out = (std::vector<uint32_t>*)target;
+	out->insert(out->end(), indices, indices + count);
+}
+
+inline xIndexSink IndexSink(std::vector<uint32_t>* out){
+	xIndexSink sink = { AppendIndices, out };
+	return sink;
+}
+
+inline namespace XMATH_ISA {
+
+// The kernels' side of an xIndexSink: collects indices and passes them on
+// kIndexRun at a time. Flush before returning.
+struct xIndexRun {
+	static const size_t kIndexRun = 64;
+
+	__forceinline explicit xIndexRun(const xIndexSink& sink) : sink(sink), count(0) {}
+
+	__forceinline void Push(uint32_t index){
+		indices[count++] = index;
+		if(count == kIndexRun) Flush();
+	}
+
+	__forceinline void Flush(){
+		if(count) sink.append(sink.target, indices, count);
+		count = 0;
+	}
+
+	xIndexSink sink;
+	size_t count;
+	uint32_t indices[kIndexRun];
+};
+
+} // namespace XMATH_ISA
+
+enum xIsa {
+	kIsaSSE2,
+	kIsaAVX2,
+	kIsaAVX512,
+	kIsaCount
+};
+
+// Kernels that take a kPrecision template parameter have one slot per
+// xPrecision tier. Kernels with begin and end work on that index range so
+// ParallelFor (xParallel.h) can hand them out in pieces.
+struct xKernelTable {
+	xIsa isa;
+
+	void (*SoAAdd)(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, size_t begin, size_t end);
+	void (*SoASubtract)(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, size_t begin, size_t end);
+	void (*SoAScale)(const Vec3SoA& a, float scale, Vec3SoA* out, size_t begin, size_t end);
+	void (*SoADotProduct)(const Vec3SoA& a, const Vec3SoA& b, float* out, size_t begin, size_t end);
+	void (*SoACrossProduct)(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, size_t begin, size_t end);
+	void (*SoAMagnitude)(const Vec3SoA& a, float* out, size_t begin, size_t end);
+	void (*SoANormalize[kPrecisionCount])(const Vec3SoA& a, Vec3SoA* out, size_t begin, size_t end);
+	void (*SoAAngle)(const Vec3SoA& a, const Vec3SoA& b, float* out, size_t begin, size_t end);
+	void (*SoADistance)(const Vec3SoA& a, const Vec3SoA& b, float* out, size_t begin, size_t end);
+	void (*SoALerp)(const Vec3SoA& a, const Vec3SoA& b, float t, Vec3SoA* out, size_t begin, size_t end);
+	void (*SoAReflect)(const Vec3SoA& direction, const Vec3SoA& normal, Vec3SoA* out, size_t begin, size_t end);
+
+	void (*TransformPointsVec3)(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count, bool stream);
+	void (*TransformDirectionsVec3)(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count, bool stream);
+	void (*TransformProjectiveVec3[kPrecisionCount])(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count,
+	                                                 bool stream);
+	void (*TransformPointsXVector3)(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count, bool stream);
+	void (*TransformDirectionsXVector3)(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count, bool stream);
+	void (*TransformProjectiveXVector3[kPrecisionCount])(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count,
+	                                                     bool stream);
+	void (*TransformVec4)(const xMatrix4& m, const Vec4* in, Vec4* out, size_t count, bool stream);
+
+	size_t (*InverseBatchXMatrix4)(const xMatrix4* in, xMatrix4* out, uint8_t* invertible, size_t count, float epsilon);
+	size_t (*InverseBatchMat4)(const Mat4* in, Mat4* out, uint8_t* invertible, size_t count, float epsilon);
+
+	void (*SlerpQuat)(const Quat* a, const Quat* b, const float* t, size_t t_step, Quat* out, size_t count);
+	void (*NlerpQuat[kPrecisionCount])(const Quat* a, const Quat* b, const float* t, size_t t_step, Quat* out, size_t count);
+
+	void (*ComposeTransforms)(const Vec3SoA& translate, const QuatSoA& rotation, const Vec3SoA& scale,
+	                          float* out, size_t begin, size_t end);
+	void (*ComposeTransformsEuler)(const Vec3SoA& translate, const Vec3SoA& radians, const Vec3SoA& scale,
+	                               int order, float* out, size_t begin, size_t end);
+
+	size_t (*CullSpheres)(const xFrustum& frustum, const Vec3SoA& centers, const float* radii,
+	                      uint32_t* visible, size_t begin, size_t end);
+	size_t (*CullBoxes)(const xFrustum& frustum, const Vec3SoA& min, const Vec3SoA& max,
+	                    uint32_t* visible, size_t begin, size_t end);
+
+	AABB (*BoundsSoA)(const Vec3SoA& points, size_t begin, size_t end);
+	AABB (*BoundsStrided)(const float* p, size_t stride, size_t begin, size_t end);
+	float (*FarthestSoA)(const Vec3SoA& points, const Vec3& center, size_t begin, size_t end);
+	float (*FarthestStrided)(const float* p, size_t stride, const Vec3& center, size_t begin, size_t end);
+
+	RayHit (*IntersectTriangles)(const Ray& ray, const TriangleSoA& triangles, size_t begin, size_t end);
+	RayHit (*IntersectBoxes)(const Ray& ray, const Vec3SoA& min, const Vec3SoA& max, size_t begin, size_t end);
+	RayHit (*IntersectSpheres)(const Ray& ray, const Vec3SoA& centers, const float* radii, size_t begin, size_t end);
+	void (*IntersectTrianglePacket)(const RaySoA& rays, const Vec3& a, const Vec3& b, const Vec3& c, uint32_t index,
+	                                RayHit* hits, size_t begin, size_t end);
+	void (*IntersectBoxPacket)(const RaySoA& rays, const AABB& box, uint32_t index, RayHit* hits, size_t begin, size_t end);
+	void (*IntersectSpherePacket)(const RaySoA& rays, const Sphere& sphere, uint32_t index, RayHit* hits,
+	                              size_t begin, size_t end);
+
+	RayHit (*IntersectBvh4)(const xBvh<4>& bvh, const Ray& ray);
+	RayHit (*IntersectBvh8)(const xBvh<8>& bvh, const Ray& ray);
+	void (*IntersectBvh4Rays)(const xBvh<4>& bvh, const RaySoA& rays, RayHit* hits, size_t begin, size_t end);
+	void (*IntersectBvh8Rays)(const xBvh<8>& bvh, const RaySoA& rays, RayHit* hits, size_t begin, size_t end);
+
+	size_t (*HashGridRadius)(const xHashGrid& grid, const uint32_t* buckets, size_t bucket_count, const Vec3& center, float radius,
+	                         xIndexSink out);
+	size_t (*HashGridNearest)(const xHashGrid& grid, const Vec3& center, size_t k, uint32_t* indices, float* distances);
+	void (*HashGridNearestBatch)(const xHashGrid& grid, const Vec3* centers, size_t k, uint32_t* indices,
+	                             float* distances, size_t begin, size_t end);
+
+	size_t (*KdTreeRadius)(const xKdTree& tree, const Vec3& center, float radius, xIndexSink out);
+	size_t (*KdTreeNearest)(const xKdTree& tree, const Vec3& center, size_t k, uint32_t* indices, float* distances);
+	void (*KdTreeNearestBatch)(const xKdTree& tree, const Vec3* centers, size_t k, uint32_t* indices,
+	                           float* distances, size_t begin, size_t end);
+	void (*KdTreeRadiusBatch)(const xKdTree& tree, const Vec3* centers, float radius, size_t* counts,
+	                          xIndexSink out, size_t begin, size_t end);
+
+	void (*PairwiseDistances)(const Vec3SoA& a, const float* a_lengths, const Vec3SoA& b, const float* b_lengths,
+	                          float* out, size_t stride, size_t begin, size_t end);
+	void (*PairwiseNearest)(const Vec3SoA& a, const float* a_lengths, const Vec3SoA& b, const float* b_lengths,
+	                        size_t k, uint32_t* indices, float* squared_distances, size_t begin, size_t end);
+
+	void (*Mat4MultiplyArrays)(const float* a, const float* b, float* out, size_t count);
+	void (*Mat4MultiplyLeft)(const float* a, const float* b, float* out, size_t count);
+	void (*Mat4MultiplyRight)(const float* a, const float* b, float* out, size_t count);
+	void (*Mat4SoAMultiply)(const Mat4SoA& a, const Mat4SoA& b, Mat4SoA* out, size_t begin, size_t end);
+	void (*Mat4SoAMultiplyLeft)(const Mat4& a, const Mat4SoA& b, Mat4SoA* out, size_t begin, size_t end);
+	void (*Mat4SoAMultiplyRight)(const Mat4SoA& a, const Mat4& b, Mat4SoA* out, size_t begin, size_t end);
+	void (*Mat4ToSoA)(const float* in, Mat4SoA* out, size_t begin, size_t end);
+	void (*Mat4FromSoA)(const Mat4SoA& in, float* out, size_t begin, size_t end);
+
+	void (*SinArray)(const float* in, float* out, size_t count);
+	void (*CosArray)(const float* in, float* out, size_t count);
+	void (*SinCosArray)(const float* in, float* sin_out, float* cos_out, size_t count);
+	void (*AcosArray)(const float* in, float* out, size_t count);
+	void (*Atan2Array)(const float* y, const float* x, float* out, size_t count);
+	void (*ExpArray)(const float* in, float* out, size_t count);
+	void (*SqrtArray)(const float* in, float* out, size_t count);
+};
+
+namespace sse2 { void FillKernelTable(xKernelTable* table); }
+namespace avx2 { void FillKernelTable(xKernelTable* table); }
+namespace avx512 { void FillKernelTable(xKernelTable* table); }
+
+inline const char* IsaName(xIsa isa){
+	static const char* names[kIsaCount] = { "sse2", "avx2", "avx512" };
+	return names[isa];
+}
+
+// AVX needs the OS to save YMM state (XCR0 bits 1-2); AVX-512 additionally
+// needs opmask and ZMM state (bits 5-7). /arch:AVX512 lets the compiler use
+// the F, CD, BW, DQ and VL subsets, so all five must be present.
+inline xIsa DetectIsa(){
+	int info[4];
+	__cpuid(info, 0);
+	int max_leaf = info[0];
+
+	__cpuid(info, 1);
+	bool fma = (info[2] & (1 << 12)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+	if(!osxsave || !avx || !fma || max_leaf < 7)
+		return kIsaSSE2;
+
+	unsigned long long xcr0 = _xgetbv(0);
+	if((xcr0 & 0x6) != 0x6)
+		return kIsaSSE2;
+
+	__cpuidex(info, 7, 0);
+	bool avx2 = (info[1] & (1 << 5)) != 0;
+	// F (16), DQ (17), CD (28), BW (30) and VL (31).
+	const unsigned avx512_bits = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+	bool avx512 = ((unsigned)info[1] & avx512_bits) == avx512_bits;
+	if(!avx2)
+		return kIsaSSE2;
+	if(avx512 && (xcr0 & 0xE0) == 0xE0)
+		return kIsaAVX512;
+	return kIsaAVX2;
+}
+
+inline xIsa SelectIsa(){
+	xIsa isa = DetectIsa();
+	const char* forced = getenv("XMATH_FORCE_ISA");
+	if(forced){
+		for(int i = 0; i < kIsaCount; ++i){
+			if(strcmp(forced, IsaName((xIsa)i)) == 0 && (xIsa)i < isa)
+				isa = (xIsa)i;
+		}
+	}
+	return isa;
+}
+
+inline xKernelTable BindKernelTable(xIsa isa){
+	xKernelTable table;
+	switch(isa){
+		case kIsaAVX512: avx512::FillKernelTable(&table); break;
+		case kIsaAVX2: avx2::FillKernelTable(&table); break;
+		default: sse2::FillKernelTable(&table); break;
+	}
+	table.isa = isa;
+	return table;
+}
+
+inline const xKernelTable& Kernels(){
+	static const xKernelTable table = BindKernelTable(SelectIsa());
+	return table;
+}
+
+#if defined(XMATH_RUNTIME_DISPATCH)
+#define XMATH_DISPATCH(kernel) (Kernels().kernel)
+#define XMATH_DISPATCH_PRECISION(kernel, precision) (Kernels().kernel[precision])
+#else
+#define XMATH_DISPATCH(kernel) (XMATH_ISA::kernel##Kernel)
+#define XMATH_DISPATCH_PRECISION(kernel, precision) (XMATH_ISA::kernel##Kernel<precision>)
+#endif
+
+#endif // __XDISPATCH_H__
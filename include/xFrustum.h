@@ -0,0 +1,220 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  View Frustum Culling.
+//--------------------------------------------------------------//
+//
+//   a * x + b * y + c * z + d >= 0   inside each of the six planes
+//
+//   The planes are read straight off the rows of a view-projection
+//   matrix (Gribb and Hartmann): a clip-space point is inside when
+//   -w <= x, y <= w and z lies in the depth range of the ClipDepth
+//   the projection was built with. The planes are normalised, so a
+//   plane distance is a world-space distance.
+//
+//   The batch kernels take bounding volumes as SoA streams and test
+//   one volume per lane (4 with SSE, 8 with AVX2, 16 with AVX-512)
+//   against all six planes without branching. The per-lane verdicts
+//   become a bit mask and the indices of the visible volumes are
+//   written out in ascending order, so the result can drive a draw
+//   list directly. Volumes that only graze a plane count as visible.
+//
+//--------------------------------------------------------------//
+#ifndef __XFRUSTUM_H__
+#define __XFRUSTUM_H__ 1
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xMatrix4.h"
+#include "xVec3SoA.h"
+#include "matrix_4.h"
+#include "vector_3.h"
+
+// Items per task when a policy culls in parallel.
+const size_t kCullGrain = 16384;
+
+enum FrustumPlane {
+	kPlaneLeft,
+	kPlaneRight,
+	kPlaneBottom,
+	kPlaneTop,
+	kPlaneNear,
+	kPlaneFar,
+	kPlaneCount
+};
+
+struct xFrustum {
+
+	// depth must match the projection inside view_projection.
+	explicit xFrustum(const Mat4& view_projection, ClipDepth depth = kDepthMinusOneToOne);
+	explicit xFrustum(const xMatrix4& view_projection, ClipDepth depth = kDepthMinusOneToOne);
+
+	float Distance(int plane, const Vec3& point) const;
+
+	bool ContainsPoint(const Vec3& point) const;
+	bool IntersectsSphere(const Vec3& center, float radius) const;
+	bool IntersectsBox(const Vec3& min, const Vec3& max) const;
+
+	// a b c d of each FrustumPlane.
+	float planes[kPlaneCount][4];
+};
+
+// A plane with no normal, such as the far plane of an infinite projection,
+// is left as it is: its d alone decides, and it is positive.
+inline xFrustum::xFrustum(const Mat4& view_projection, ClipDepth depth) {
+	const float* r0 = view_projection.m;
+	const float* r1 = view_projection.m + 4;
+	const float* r2 = view_projection.m + 8;
+	const float* r3 = view_projection.m + 12;
+	for(int k = 0; k < 4; ++k){
+		planes[kPlaneLeft][k] = r3[k] + r0[k];
+		planes[kPlaneRight][k] = r3[k] - r0[k];
+		planes[kPlaneBottom][k] = r3[k] + r1[k];
+		planes[kPlaneTop][k] = r3[k] - r1[k];
+		switch(depth){
+			case kDepthZeroToOne:
+				planes[kPlaneNear][k] = r2[k];
+				planes[kPlaneFar][k] = r3[k] - r2[k];
+				break;
+			case kDepthReversedZ:
+				planes[kPlaneNear][k] = r3[k] - r2[k];
+				planes[kPlaneFar][k] = r2[k];
+				break;
+			default:
+				planes[kPlaneNear][k] = r3[k] + r2[k];
+				planes[kPlaneFar][k] = r3[k] - r2[k];
+				break;
+		}
+	}
+	for(int p = 0; p < kPlaneCount; ++p){
+		float* plane = planes[p];
+		float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+		if(length == 0.0f) continue;
+		for(int k = 0; k < 4; ++k) plane[k] /= length;
+	}
+}
+
+inline xFrustum::xFrustum(const xMatrix4& view_projection, ClipDepth depth)
+	: xFrustum(view_projection.ToMat4(), depth) {}
+
+inline float xFrustum::Distance(int plane, const Vec3& point) const {
+	const float* p = planes[plane];
+	return p[0] * point.x + p[1] * point.y + p[2] * point.z + p[3];
+}
+
+inline bool xFrustum::ContainsPoint(const Vec3& point) const {
+	return IntersectsSphere(point, 0.0f);
+}
+
+inline bool xFrustum::IntersectsSphere(const Vec3& center, float radius) const {
+	for(int p = 0; p < kPlaneCount; ++p)
+		if(Distance(p, center) + radius < 0.0f) return false;
+	return true;
+}
+
+// Tests the corner furthest along each plane normal, through the box's
+// center and half extent.
+inline bool xFrustum::IntersectsBox(const Vec3& min, const Vec3& max) const {
+	Vec3 center((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+	Vec3 extent((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f);
+	for(int p = 0; p < kPlaneCount; ++p){
+		const float* plane = planes[p];
+		float reach = fabsf(plane[0]) * extent.x + fabsf(plane[1]) * extent.y + fabsf(plane[2]) * extent.z;
+		if(Distance(p, center) + reach < 0.0f) return false;
+	}
+	return true;
+}
+
+// Per-ISA kernels. Write the indices in [begin, end) that pass to visible,
+// starting at visible[0], and return how many there are.
+inline namespace XMATH_ISA {
+
+// Appends i + k for every set bit k of the n-lane mask. Every lane stores
+// and only the passing ones advance the cursor, so there is no branch on
+// the mask; the stray store lands on a slot the next pass overwrites.
+__forceinline size_t CompactLaneIndices(uint32_t bits, size_t i, size_t n, uint32_t* visible){
+	size_t written = 0;
+	for(size_t k = 0; k < n; ++k){
+		visible[written] = (uint32_t)(i + k);
+		written += (bits >> k) & 1;
+	}
+	return written;
+}
+
+inline size_t CullSpheresKernel(const xFrustum& frustum, const Vec3SoA& centers, const float* radii,
+                                uint32_t* visible, size_t begin, size_t end){
+	xLane plane[kPlaneCount][4];
+	for(int p = 0; p < kPlaneCount; ++p)
+		for(int k = 0; k < 4; ++k) plane[p][k] = LaneSet(frustum.planes[p][k]);
+	const xLane zero = LaneSet(0.0f);
+
+	size_t written = 0;
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane x = LaneLoad(centers.x + i, n), y = LaneLoad(centers.y + i, n), z = LaneLoad(centers.z + i, n);
+		xLane nearest = LaneSet(INFINITY);
+		for(int p = 0; p < kPlaneCount; ++p){
+			xLane distance = LaneMultiplyAdd(plane[p][2], z, LaneMultiplyAdd(plane[p][1], y, LaneMultiplyAdd(plane[p][0], x, plane[p][3])));
+			nearest = LaneMin(nearest, distance);
+		}
+		nearest = LaneAdd(nearest, LaneLoad(radii + i, n));
+		uint32_t bits = ~LaneLessBits(nearest, zero) & LaneCountMask(n);
+		written += CompactLaneIndices(bits, i, n, visible + written);
+	});
+	return written;
+}
+
+inline size_t CullBoxesKernel(const xFrustum& frustum, const Vec3SoA& min, const Vec3SoA& max,
+                              uint32_t* visible, size_t begin, size_t end){
+	xLane plane[kPlaneCount][4], reach[kPlaneCount][3];
+	for(int p = 0; p < kPlaneCount; ++p){
+		for(int k = 0; k < 4; ++k) plane[p][k] = LaneSet(frustum.planes[p][k]);
+		for(int k = 0; k < 3; ++k) reach[p][k] = LaneSet(fabsf(frustum.planes[p][k]));
+	}
+	const xLane zero = LaneSet(0.0f), half = LaneSet(0.5f);
+
+	size_t written = 0;
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane lx = LaneLoad(min.x + i, n), ly = LaneLoad(min.y + i, n), lz = LaneLoad(min.z + i, n);
+		xLane hx = LaneLoad(max.x + i, n), hy = LaneLoad(max.y + i, n), hz = LaneLoad(max.z + i, n);
+		xLane cx = LaneMul(LaneAdd(lx, hx), half), cy = LaneMul(LaneAdd(ly, hy), half), cz = LaneMul(LaneAdd(lz, hz), half);
+		xLane ex = LaneMul(LaneSub(hx, lx), half), ey = LaneMul(LaneSub(hy, ly), half), ez = LaneMul(LaneSub(hz, lz), half);
+		xLane nearest = LaneSet(INFINITY);
+		for(int p = 0; p < kPlaneCount; ++p){
+			xLane distance = LaneMultiplyAdd(plane[p][2], cz, LaneMultiplyAdd(plane[p][1], cy, LaneMultiplyAdd(plane[p][0], cx, plane[p][3])));
+			distance = LaneMultiplyAdd(reach[p][2], ez, LaneMultiplyAdd(reach[p][1], ey, LaneMultiplyAdd(reach[p][0], ex, distance)));
+			nearest = LaneMin(nearest, distance);
+		}
+		uint32_t bits = ~LaneLessBits(nearest, zero) & LaneCountMask(n);
+		written += CompactLaneIndices(bits, i, n, visible + written);
+	});
+	return written;
+}
+
+} // namespace XMATH_ISA
+
+// Writes the indices of the spheres that touch the frustum to visible in
+// ascending order and returns how many. visible must hold centers.count
+// entries; the ones past the returned count are left unspecified.
+template<typename Policy = xSequentialPolicy>
+inline size_t CullSpheres(const xFrustum& frustum, const Vec3SoA& centers, const float* radii, uint32_t* visible,
+                          Policy policy = Policy()){
+	return ParallelCompact(policy, centers.count, kCullGrain, visible, [&](size_t begin, size_t end, uint32_t* out){
+		return XMATH_DISPATCH(CullSpheres)(frustum, centers, radii, out, begin, end);
+	});
+}
+
+// Boxes are axis-aligned, from min to max. min and max must have the same count.
+template<typename Policy = xSequentialPolicy>
+inline size_t CullBoxes(const xFrustum& frustum, const Vec3SoA& min, const Vec3SoA& max, uint32_t* visible,
+                        Policy policy = Policy()){
+	assert(min.count == max.count);
+	return ParallelCompact(policy, min.count, kCullGrain, visible, [&](size_t begin, size_t end, uint32_t* out){
+		return XMATH_DISPATCH(CullBoxes)(frustum, min, max, out, begin, end);
+	});
+}
+
+#endif // __XFRUSTUM_H__
@@ -0,0 +1,579 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Spatial Hash Grid.
+//--------------------------------------------------------------//
+//
+//   cell(p) = floor(p / cell_size)   bucket = hash(cell) mod buckets
+//
+//   Space is cut into cubes of cell_size, and each cube hashes to one
+//   of a power-of-two number of buckets, at least as many as there
+//   are points. No memory goes to empty space, so the points can
+//   spread far apart. Cell coordinates are clamped to
+//   +-kHashGridCellLimit per axis; points beyond that share the
+//   outermost cells, where queries still test them by distance.
+//
+//   A bucket is a contiguous run of 16-byte entries, x y z and the
+//   point index, four to a cache line. Queries read the entries with
+//   LaneLoadAoS4Full, kLaneWidth at a time, and mask off the entries
+//   past the end of the bucket; the entry array keeps
+//   kHashGridPadding spare entries at its end so those reads stay
+//   inside it. Two cells can share a bucket, so every entry is still
+//   tested by its distance.
+//
+//   Build places the points by counting sort: bucket sizes, a prefix
+//   sum, a scatter, then each bucket sorted by index. By default the
+//   passes run on the thread pool (xParallel.h); the result does not
+//   depend on the thread count.
+//
+//   Insert, Remove and Move change single points. A bucket that runs
+//   out of room moves to the end of the entry array with twice the
+//   capacity. When the holes this leaves outnumber the points, or the
+//   points outnumber the buckets twice over, the grid lays itself out
+//   again.
+//
+//   QueryRadius finds every point within a radius. QueryNearest
+//   searches shells of cells around the query, one cell wider each
+//   time, and stops once the k-th nearest point is closer than any
+//   cell not yet visited. Choose cell_size near the usual query radius.
+//   Queries work on squared distances and report them as such, so no
+//   query takes a square root.
+//
+//--------------------------------------------------------------//
+#ifndef __XHASHGRID_H__
+#define __XHASHGRID_H__ 1
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "vector_3.h"
+
+// Points per task when a policy builds or queries in parallel.
+const size_t kHashGridGrain = 16384;
+const size_t kHashGridQueryGrain = 256;
+// Spare entries at the end of the entry array: the widest lane count.
+const size_t kHashGridPadding = 16;
+const size_t kHashGridMinBuckets = 16;
+// Largest cell coordinate on each axis, so that a cell and the shells
+// around it stay within int32_t.
+const float kHashGridCellLimit = 1073741824.0f;
+// Index of a removed point, and of a missing neighbor.
+const uint32_t kNoPoint = 0xFFFFFFFFu;
+
+struct xHashGridEntry {
+	float x;
+	float y;
+	float z;
+	uint32_t index;
+};
+
+struct xHashGridBucket {
+	uint32_t first;
+	uint32_t count;
+	uint32_t capacity;
+};
+
+class xHashGrid {
+public:
+
+	xHashGrid();
+
+	// Replaces the grid with points[0, count), which get the indices 0 to
+	// count - 1. cell_size must be positive.
+	template<typename Policy = xParallelPolicy>
+	void Build(const Vec3* points, size_t count, float cell_size, Policy policy = Policy());
+	// Adds a point and returns its index, one past the highest so far.
+	uint32_t Insert(const Vec3& point);
+	void Remove(uint32_t index);
+	void Move(uint32_t index, const Vec3& point);
+	void Clear();
+
+	// Points in the grid.
+	size_t Count() const;
+	// One past the highest index handed out, including removed points.
+	size_t IndexCount() const;
+	bool Contains(uint32_t index) const;
+	Vec3 Position(uint32_t index) const;
+	float CellSize() const;
+
+	void CellOf(const Vec3& point, int32_t cell[3]) const;
+	size_t BucketOf(const int32_t cell[3]) const;
+	size_t BucketCount() const;
+	const xHashGridEntry* Entries(size_t bucket, size_t* count) const;
+	// A box of cells holding every point. Insert and Move grow it; it
+	// shrinks to the live points when the grid lays itself out again.
+	void CellBounds(int32_t low[3], int32_t high[3]) const;
+
+	// Appends the indices of the points within radius of center, edge
+	// included, to out in no particular order and returns how many.
+	size_t QueryRadius(const Vec3& center, float radius, std::vector<uint32_t>* out) const;
+	// The k nearest points to center, nearest first and the lower index
+	// first between equals. Returns how many there are, at most k; the
+	// slots past it get kNoPoint and INFINITY. squared_distances may be NULL.
+	size_t QueryNearest(const Vec3& center, size_t k, uint32_t* indices, float* squared_distances) const;
+	// QueryNearest for each of centers; query i writes indices[i k, i k + k)
+	// and the same range of squared_distances.
+	template<typename Policy = xParallelPolicy>
+	void QueryNearest(const Vec3* centers, size_t count, size_t k, uint32_t* indices, float* squared_distances,
+	                  Policy policy = Policy()) const;
+
+private:
+	// Lays out the points at their current positions with room for count
+	// entries each bucket, over the given number of buckets.
+	template<typename Policy>
+	void Layout(const xHashGridEntry* points, size_t count, size_t buckets, Policy policy);
+	void Relayout();
+	void Place(uint32_t index, const Vec3& point);
+	void Unplace(uint32_t index);
+	void Grow(const int32_t cell[3]);
+
+	float cell_size_;
+	float inverse_cell_size_;
+	size_t count_;
+	// End of the entries in use; the padding follows.
+	size_t used_;
+	// Entry slots of moved buckets that nothing uses any more.
+	size_t holes_;
+	size_t mask_;
+	int32_t low_[3];
+	int32_t high_[3];
+	std::vector<xHashGridBucket> buckets_;
+	std::vector<xHashGridEntry> entries_;
+	// Entry slot of each index, or kNoPoint once removed.
+	std::vector<uint32_t> slot_;
+};
+
+inline size_t HashGridBuckets(size_t points){
+	size_t buckets = kHashGridMinBuckets;
+	while(buckets < points) buckets *= 2;
+	return buckets;
+}
+
+inline xHashGrid::xHashGrid()
+	: cell_size_(1.0f), inverse_cell_size_(1.0f), count_(0), used_(0), holes_(0), mask_(0) {
+	Clear();
+}
+
+inline void xHashGrid::Clear() {
+	count_ = 0;
+	used_ = 0;
+	holes_ = 0;
+	mask_ = kHashGridMinBuckets - 1;
+	for(int a = 0; a < 3; ++a){
+		low_[a] = INT32_MAX;
+		high_[a] = INT32_MIN;
+	}
+	xHashGridBucket empty = { 0, 0, 0 };
+	buckets_.assign(kHashGridMinBuckets, empty);
+	entries_.assign(kHashGridPadding, xHashGridEntry());
+	slot_.clear();
+}
+
+__forceinline size_t xHashGrid::Count() const {
+	return count_;
+}
+
+inline size_t xHashGrid::IndexCount() const {
+	return slot_.size();
+}
+
+inline bool xHashGrid::Contains(uint32_t index) const {
+	return index < slot_.size() && slot_[index] != kNoPoint;
+}
+
+inline Vec3 xHashGrid::Position(uint32_t index) const {
+	assert(Contains(index));
+	const xHashGridEntry& entry = entries_[slot_[index]];
+	return Vec3(entry.x, entry.y, entry.z);
+}
+
+__forceinline float xHashGrid::CellSize() const {
+	return cell_size_;
+}
+
+// Clamped before the cast, which is undefined out of range; NaN lands on
+// the upper limit.
+__forceinline void xHashGrid::CellOf(const Vec3& point, int32_t cell[3]) const {
+	for(int a = 0; a < 3; ++a){
+		float c = floorf((&point.x)[a] * inverse_cell_size_);
+		c = c < -kHashGridCellLimit ? -kHashGridCellLimit : c;
+		c = c < kHashGridCellLimit ? c : kHashGridCellLimit;
+		cell[a] = (int32_t)c;
+	}
+}
+
+// Teschner et al., Optimized Spatial Hashing for Collision Detection.
+__forceinline size_t xHashGrid::BucketOf(const int32_t cell[3]) const {
+	uint32_t hash = ((uint32_t)cell[0] * 73856093u) ^ ((uint32_t)cell[1] * 19349663u) ^ ((uint32_t)cell[2] * 83492791u);
+	return hash & mask_;
+}
+
+__forceinline size_t xHashGrid::BucketCount() const {
+	return buckets_.size();
+}
+
+__forceinline const xHashGridEntry* xHashGrid::Entries(size_t bucket, size_t* count) const {
+	*count = buckets_[bucket].count;
+	return &entries_[buckets_[bucket].first];
+}
+
+__forceinline void xHashGrid::CellBounds(int32_t low[3], int32_t high[3]) const {
+	for(int a = 0; a < 3; ++a){
+		low[a] = low_[a];
+		high[a] = high_[a];
+	}
+}
+
+inline void xHashGrid::Grow(const int32_t cell[3]) {
+	for(int a = 0; a < 3; ++a){
+		low_[a] = cell[a] < low_[a] ? cell[a] : low_[a];
+		high_[a] = cell[a] > high_[a] ? cell[a] : high_[a];
+	}
+}
+
+template<typename Policy>
+inline void xHashGrid::Build(const Vec3* points, size_t count, float cell_size, Policy policy) {
+	assert(cell_size > 0.0f && count < kNoPoint);
+	Clear();
+	cell_size_ = cell_size;
+	inverse_cell_size_ = 1.0f / cell_size;
+	std::vector<xHashGridEntry> records(count);
+	ParallelFor(policy, count, kHashGridGrain, [&](size_t begin, size_t end){
+		for(size_t i = begin; i < end; ++i){
+			xHashGridEntry record = { points[i].x, points[i].y, points[i].z, (uint32_t)i };
+			records[i] = record;
+		}
+	});
+	slot_.resize(count);
+	Layout(records.empty() ? NULL : &records[0], count, HashGridBuckets(count), policy);
+}
+
+// Counting sort. The scatter takes slots with atomic cursors, so the order
+// inside a bucket depends on the threads until each bucket is sorted by
+// index at the end.
+template<typename Policy>
+inline void xHashGrid::Layout(const xHashGridEntry* points, size_t count, size_t buckets, Policy policy) {
+	mask_ = buckets - 1;
+	std::vector<uint32_t> keys(count);
+	std::vector<std::atomic<uint32_t> > cursor(buckets);
+	std::vector<int32_t> bounds(count ? 6 * ((count + kHashGridGrain - 1) / kHashGridGrain) : 0);
+	ParallelFor(policy, count, kHashGridGrain, [&](size_t begin, size_t end){
+		int32_t low[3] = { INT32_MAX, INT32_MAX, INT32_MAX }, high[3] = { INT32_MIN, INT32_MIN, INT32_MIN };
+		for(size_t i = begin; i < end; ++i){
+			int32_t cell[3];
+			CellOf(Vec3(points[i].x, points[i].y, points[i].z), cell);
+			for(int a = 0; a < 3; ++a){
+				low[a] = cell[a] < low[a] ? cell[a] : low[a];
+				high[a] = cell[a] > high[a] ? cell[a] : high[a];
+			}
+			keys[i] = (uint32_t)BucketOf(cell);
+			cursor[keys[i]].fetch_add(1, std::memory_order_relaxed);
+		}
+		int32_t* block = &bounds[begin / kHashGridGrain * 6];
+		for(int a = 0; a < 3; ++a){
+			block[a] = low[a];
+			block[a + 3] = high[a];
+		}
+	});
+	for(size_t b = 0; b < bounds.size(); b += 6){
+		Grow(&bounds[b]);
+		Grow(&bounds[b + 3]);
+	}
+
+	buckets_.resize(buckets);
+	uint32_t first = 0;
+	for(size_t b = 0; b < buckets; ++b){
+		uint32_t size = cursor[b].load(std::memory_order_relaxed);
+		xHashGridBucket bucket = { first, size, size };
+		buckets_[b] = bucket;
+		cursor[b].store(first, std::memory_order_relaxed);
+		first += size;
+	}
+	used_ = count;
+	holes_ = 0;
+	count_ = count;
+	entries_.resize(count + kHashGridPadding);
+
+	ParallelFor(policy, count, kHashGridGrain, [&](size_t begin, size_t end){
+		for(size_t i = begin; i < end; ++i)
+			entries_[cursor[keys[i]].fetch_add(1, std::memory_order_relaxed)] = points[i];
+	});
+	ParallelFor(policy, buckets, kHashGridGrain, [&](size_t begin, size_t end){
+		for(size_t b = begin; b < end; ++b){
+			xHashGridEntry* run = &entries_[buckets_[b].first];
+			uint32_t size = buckets_[b].count;
+			for(uint32_t j = 1; j < size; ++j){
+				xHashGridEntry entry = run[j];
+				uint32_t k = j;
+				for(; k > 0 && run[k - 1].index > entry.index; --k) run[k] = run[k - 1];
+				run[k] = entry;
+			}
+			for(uint32_t j = 0; j < size; ++j) slot_[run[j].index] = buckets_[b].first + j;
+		}
+	});
+}
+
+// Keeps the indices, the removed ones included.
+inline void xHashGrid::Relayout() {
+	std::vector<xHashGridEntry> live;
+	live.reserve(count_);
+	for(size_t b = 0; b < buckets_.size(); ++b)
+		for(uint32_t j = 0; j < buckets_[b].count; ++j) live.push_back(entries_[buckets_[b].first + j]);
+	for(int a = 0; a < 3; ++a){
+		low_[a] = INT32_MAX;
+		high_[a] = INT32_MIN;
+	}
+	Layout(live.empty() ? NULL : &live[0], live.size(), HashGridBuckets(live.size()), kSequential);
+}
+
+inline void xHashGrid::Place(uint32_t index, const Vec3& point) {
+	int32_t cell[3];
+	CellOf(point, cell);
+	Grow(cell);
+	xHashGridBucket& bucket = buckets_[BucketOf(cell)];
+	if(bucket.count == bucket.capacity){
+		uint32_t capacity = bucket.capacity ? bucket.capacity * 2 : 2;
+		entries_.resize(used_ + capacity + kHashGridPadding);
+		for(uint32_t j = 0; j < bucket.count; ++j){
+			entries_[used_ + j] = entries_[bucket.first + j];
+			slot_[entries_[used_ + j].index] = (uint32_t)used_ + j;
+		}
+		holes_ += bucket.capacity;
+		bucket.first = (uint32_t)used_;
+		bucket.capacity = capacity;
+		used_ += capacity;
+	}
+	uint32_t slot = bucket.first + bucket.count++;
+	xHashGridEntry entry = { point.x, point.y, point.z, index };
+	entries_[slot] = entry;
+	slot_[index] = slot;
+	++count_;
+}
+
+// The last entry of the bucket fills the gap.
+inline void xHashGrid::Unplace(uint32_t index) {
+	uint32_t slot = slot_[index];
+	const xHashGridEntry& entry = entries_[slot];
+	int32_t cell[3];
+	CellOf(Vec3(entry.x, entry.y, entry.z), cell);
+	xHashGridBucket& bucket = buckets_[BucketOf(cell)];
+	uint32_t last = bucket.first + --bucket.count;
+	entries_[slot] = entries_[last];
+	slot_[entries_[slot].index] = slot;
+	slot_[index] = kNoPoint;
+	--count_;
+}
+
+inline uint32_t xHashGrid::Insert(const Vec3& point) {
+	assert(slot_.size() < kNoPoint);
+	uint32_t index = (uint32_t)slot_.size();
+	slot_.push_back(kNoPoint);
+	Place(index, point);
+	if(count_ > buckets_.size() * 2 || holes_ > count_ + kHashGridMinBuckets) Relayout();
+	return index;
+}
+
+inline void xHashGrid::Remove(uint32_t index) {
+	assert(Contains(index));
+	Unplace(index);
+}
+
+// A point that stays in its cell is updated in place.
+inline void xHashGrid::Move(uint32_t index, const Vec3& point) {
+	assert(Contains(index));
+	xHashGridEntry& entry = entries_[slot_[index]];
+	int32_t from[3], to[3];
+	CellOf(Vec3(entry.x, entry.y, entry.z), from);
+	CellOf(point, to);
+	if(BucketOf(from) == BucketOf(to)){
+		Grow(to);
+		entry.x = point.x;
+		entry.y = point.y;
+		entry.z = point.z;
+		return;
+	}
+	Unplace(index);
+	Place(index, point);
+	if(holes_ > count_ + kHashGridMinBuckets) Relayout();
+}
+
+// Per-ISA kernels.
+inline namespace XMATH_ISA {
+
+// Squared distances from center to the first n entries, one entry per
+// lane. Reads whole registers; the padding keeps that inside the array.
+__forceinline xLane HashGridDistances(const xHashGridEntry* entries, const xLane center[3]){
+	xLane x, y, z, index;
+	LaneLoadAoS4Full((const float*)entries, 4, &x, &y, &z, &index);
+	xLane dx = LaneSub(x, center[0]), dy = LaneSub(y, center[1]), dz = LaneSub(z, center[2]);
+	return LaneMultiplyAdd(dz, dz, LaneMultiplyAdd(dy, dy, LaneMul(dx, dx)));
+}
+
+// Scans buckets[0, bucket_count), which QueryRadius lists once each.
+inline size_t HashGridRadiusKernel(const xHashGrid& grid, const uint32_t* buckets, size_t bucket_count, const Vec3& center,
+                                   float radius, xIndexSink out){
+	xLane c[3] = { LaneSet(center.x), LaneSet(center.y), LaneSet(center.z) };
+	const xLane limit = LaneSet(radius * radius);
+	xIndexRun run(out);
+	size_t found = 0;
+	for(size_t v = 0; v < bucket_count; ++v){
+		size_t count;
+		const xHashGridEntry* entries = grid.Entries(buckets[v], &count);
+		LaneLoop(count, [&](size_t i, size_t n){
+			uint32_t bits = ~LaneLessBits(limit, HashGridDistances(entries + i, c)) & LaneCountMask(n);
+			for(size_t k = 0; bits; ++k, bits >>= 1){
+				if(!(bits & 1)) continue;
+				run.Push(entries[i + k].index);
+				++found;
+			}
+		});
+	}
+	run.Flush();
+	return found;
+}
+
+// Keeps indices and squared distances sorted, nearest first. Cells that
+// share a bucket can offer an entry twice; the second offer changes
+// nothing.
+__forceinline void HashGridOffer(uint32_t index, float distance, size_t k, size_t* found, uint32_t* indices, float* distances){
+	size_t at = *found;
+	if(at == k && !(distance < distances[k - 1] || (distance == distances[k - 1] && index < indices[k - 1]))) return;
+	for(size_t j = 0; j < *found; ++j)
+		if(indices[j] == index) return;
+	if(at == k) --at;
+	else ++*found;
+	for(; at > 0 && (distances[at - 1] > distance || (distances[at - 1] == distance && indices[at - 1] > index)); --at){
+		indices[at] = indices[at - 1];
+		distances[at] = distances[at - 1];
+	}
+	indices[at] = index;
+	distances[at] = distance;
+}
+
+__forceinline void HashGridNearestInBucket(const xHashGrid& grid, size_t bucket, const xLane c[3], size_t k, size_t* found,
+                                           uint32_t* indices, float* distances){
+	size_t count;
+	const xHashGridEntry* entries = grid.Entries(bucket, &count);
+	LaneLoop(count, [&](size_t i, size_t n){
+		xLane d = HashGridDistances(entries + i, c);
+		uint32_t bits = LaneCountMask(n);
+		if(*found == k) bits &= ~LaneLessBits(LaneSet(distances[k - 1]), d);
+		if(!bits) return;
+		float lanes[kLaneWidth];
+		LaneStore(lanes, d, kLaneWidth);
+		for(size_t j = 0; bits; ++j, bits >>= 1)
+			if(bits & 1) HashGridOffer(entries[i + j].index, lanes[j], k, found, indices, distances);
+	});
+}
+
+inline size_t HashGridNearestKernel(const xHashGrid& grid, const Vec3& center, size_t k, uint32_t* indices, float* distances){
+	size_t found = 0;
+	if(k && grid.Count()){
+		xLane c[3] = { LaneSet(center.x), LaneSet(center.y), LaneSet(center.z) };
+		int32_t origin[3], low[3], high[3];
+		grid.CellOf(center, origin);
+		grid.CellBounds(low, high);
+		int64_t rings = 0;
+		for(int a = 0; a < 3; ++a){
+			int64_t below = (int64_t)origin[a] - low[a], above = (int64_t)high[a] - origin[a];
+			rings = below > rings ? below : rings;
+			rings = above > rings ? above : rings;
+		}
+		const float cell_size = grid.CellSize();
+		for(int64_t r = 0; r <= rings; ++r){
+			// Once a shell has as many cells as there are buckets, reading
+			// every bucket is cheaper and finishes the search.
+			double side = (double)(2 * r + 1);
+			if(side * side * side >= (double)grid.BucketCount()){
+				for(size_t b = 0; b < grid.BucketCount(); ++b) HashGridNearestInBucket(grid, b, c, k, &found, indices, distances);
+				break;
+			}
+			int32_t cell[3];
+			for(int64_t z = -r; z <= r; ++z){
+				for(int64_t y = -r; y <= r; ++y){
+					// Inside the shell only the two faces of x are new.
+					bool face = z == -r || z == r || y == -r || y == r;
+					for(int64_t x = -r; x <= r; x += face || r == 0 ? 1 : 2 * r){
+						cell[0] = (int32_t)(origin[0] + x);
+						cell[1] = (int32_t)(origin[1] + y);
+						cell[2] = (int32_t)(origin[2] + z);
+						HashGridNearestInBucket(grid, grid.BucketOf(cell), c, k, &found, indices, distances);
+					}
+				}
+			}
+			// Cells beyond shell r lie past the faces of the cube it closes.
+			float reach = INFINITY;
+			for(int a = 0; a < 3; ++a){
+				float position = (&center.x)[a];
+				float below = position - (float)((double)(origin[a] - r) * cell_size);
+				float above = (float)((double)(origin[a] + r + 1) * cell_size) - position;
+				reach = below < reach ? below : reach;
+				reach = above < reach ? above : reach;
+			}
+			reach = reach > 0.0f ? reach : 0.0f;
+			if(found == k && distances[k - 1] <= reach * reach) break;
+		}
+	}
+	for(size_t j = found; j < k; ++j){
+		indices[j] = kNoPoint;
+		distances[j] = INFINITY;
+	}
+	return found;
+}
+
+inline void HashGridNearestBatchKernel(const xHashGrid& grid, const Vec3* centers, size_t k, uint32_t* indices,
+                                       float* distances, size_t begin, size_t end){
+	float* scratch = distances || !k ? NULL : (float*)_mm_malloc(k * sizeof(float), 64);
+	for(size_t i = begin; i < end; ++i)
+		HashGridNearestKernel(grid, centers[i], k, indices + i * k, distances ? distances + i * k : scratch);
+	_mm_free(scratch);
+}
+
+} // namespace XMATH_ISA
+
+// Cells can share a bucket, so the kernel gets the buckets, each once.
+inline size_t xHashGrid::QueryRadius(const Vec3& center, float radius, std::vector<uint32_t>* out) const {
+	if(!count_ || !(radius >= 0.0f)) return 0;
+	int32_t low[3], high[3];
+	CellOf(center - Vec3(radius, radius, radius), low);
+	CellOf(center + Vec3(radius, radius, radius), high);
+	double cells = 1.0;
+	for(int a = 0; a < 3; ++a) cells *= (double)high[a] - (double)low[a] + 1.0;
+
+	std::vector<uint32_t> visit;
+	if(cells >= (double)BucketCount()){
+		visit.resize(BucketCount());
+		for(size_t b = 0; b < visit.size(); ++b) visit[b] = (uint32_t)b;
+	}else{
+		visit.reserve((size_t)cells);
+		int32_t cell[3];
+		for(cell[2] = low[2]; cell[2] <= high[2]; ++cell[2])
+			for(cell[1] = low[1]; cell[1] <= high[1]; ++cell[1])
+				for(cell[0] = low[0]; cell[0] <= high[0]; ++cell[0]) visit.push_back((uint32_t)BucketOf(cell));
+		std::sort(visit.begin(), visit.end());
+		visit.erase(std::unique(visit.begin(), visit.end()), visit.end());
+	}
+	return XMATH_DISPATCH(HashGridRadius)(*this, &visit[0], visit.size(), center, radius, IndexSink(out));
+}
+
+inline size_t xHashGrid::QueryNearest(const Vec3& center, size_t k, uint32_t* indices, float* squared_distances) const {
+	std::vector<float> scratch(squared_distances ? 0 : k);
+	return XMATH_DISPATCH(HashGridNearest)(*this, center, k, indices,
+		squared_distances ? squared_distances : (scratch.empty() ? NULL : &scratch[0]));
+}
+
+template<typename Policy>
+inline void xHashGrid::QueryNearest(const Vec3* centers, size_t count, size_t k, uint32_t* indices, float* squared_distances,
+                                    Policy policy) const {
+	ParallelFor(policy, count, kHashGridQueryGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(HashGridNearestBatch)(*this, centers, k, indices, squared_distances, begin, end);
+	});
+}
+
+#endif // __XHASHGRID_H__
@@ -0,0 +1,377 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  k-d Tree.
+//--------------------------------------------------------------//
+//
+//   A balanced k-d tree over a static point set, for clouds too
+//   sparse or too uneven for xHashGrid.
+//
+//   Build splits the points at the median of the axis along which
+//   they spread furthest, halving every range until a leaf holds at
+//   most kKdTreeLeaf points. All leaves sit at the same depth, so the
+//   tree is implicit: node i has children 2i + 1 and 2i + 2, and
+//   stores only its split value and axis. A range [begin, end) splits
+//   at begin + (end - begin) / 2; the points left of that are at or
+//   below the split, the rest at or above it. By default subtrees of
+//   more than kKdTreeGrain points are built side by side on the
+//   thread pool (xParallel.h). The result does not depend on the
+//   thread count.
+//
+//   The points are copied in leaf order as 16-byte entries, x y z
+//   and the index in the input, so a leaf is one contiguous run that
+//   LaneLoadAoS4Full reads kLaneWidth at a time. kKdTreePadding
+//   spare entries at the end keep the last read inside the array.
+//
+//   Queries work on squared distances and report them as such, so no
+//   query takes a square root. QueryNearest visits the nearer child
+//   first and skips any subtree whose slab lies further than the k-th
+//   point found so far.
+//
+//--------------------------------------------------------------//
+#ifndef __XKDTREE_H__
+#define __XKDTREE_H__ 1
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "vector_3.h"
+
+// Points above which a subtree is built as a task of its own.
+const size_t kKdTreeGrain = 16384;
+// Queries per task when a policy queries in parallel.
+const size_t kKdTreeQueryGrain = 256;
+const size_t kKdTreeLeaf = 16;
+// Spare entries at the end of the point array: the widest lane count.
+const size_t kKdTreePadding = 16;
+// Indices are 32-bit, so no range halves more often than this.
+const size_t kKdTreeMaxDepth = 32;
+// Index of a missing neighbor.
+const uint32_t kKdTreeNoPoint = 0xFFFFFFFFu;
+
+struct xKdTreePoint {
+	float x;
+	float y;
+	float z;
+	uint32_t index;
+};
+
+class xKdTree {
+public:
+
+	xKdTree();
+
+	// Replaces the tree with points[0, count), which keep their indices.
+	template<typename Policy = xParallelPolicy>
+	void Build(const Vec3* points, size_t count, Policy policy = Policy());
+	void Clear();
+
+	size_t Count() const;
+	// Levels of split nodes above the leaves.
+	size_t Depth() const;
+	// Split value and axis of each of the 2^Depth() - 1 split nodes.
+	const float* Splits() const;
+	const uint8_t* Axes() const;
+	// The points in leaf order.
+	const xKdTreePoint* Points() const;
+
+	// Appends the indices of the points within radius of center, edge
+	// included, to out in no particular order and returns how many.
+	size_t QueryRadius(const Vec3& center, float radius, std::vector<uint32_t>* out) const;
+	// QueryRadius for each of centers. The indices of query i end up in
+	// (*indices)[(*offsets)[i], (*offsets)[i + 1]).
+	template<typename Policy = xParallelPolicy>
+	void QueryRadius(const Vec3* centers, size_t count, float radius, std::vector<uint32_t>* indices,
+	                 std::vector<size_t>* offsets, Policy policy = Policy()) const;
+	// The k nearest points to center, nearest first and the lower index
+	// first between equals. Returns how many there are, at most k; the
+	// slots past it get kKdTreeNoPoint and INFINITY. squared_distances
+	// may be NULL.
+	size_t QueryNearest(const Vec3& center, size_t k, uint32_t* indices, float* squared_distances) const;
+	// QueryNearest for each of centers; query i writes indices[i k, i k + k)
+	// and the same range of squared_distances.
+	template<typename Policy = xParallelPolicy>
+	void QueryNearest(const Vec3* centers, size_t count, size_t k, uint32_t* indices, float* squared_distances,
+	                  Policy policy = Policy()) const;
+
+private:
+	template<typename Policy>
+	void BuildNode(size_t node, size_t begin, size_t end, size_t level, Policy policy);
+
+	size_t count_;
+	size_t depth_;
+	std::vector<float> splits_;
+	std::vector<uint8_t> axes_;
+	std::vector<xKdTreePoint> points_;
+};
+
+inline xKdTree::xKdTree() : count_(0), depth_(0) {
+	Clear();
+}
+
+inline void xKdTree::Clear() {
+	count_ = 0;
+	depth_ = 0;
+	splits_.clear();
+	axes_.clear();
+	points_.assign(kKdTreePadding, xKdTreePoint());
+}
+
+__forceinline size_t xKdTree::Count() const {
+	return count_;
+}
+
+__forceinline size_t xKdTree::Depth() const {
+	return depth_;
+}
+
+__forceinline const float* xKdTree::Splits() const {
+	return splits_.empty() ? NULL : &splits_[0];
+}
+
+__forceinline const uint8_t* xKdTree::Axes() const {
+	return axes_.empty() ? NULL : &axes_[0];
+}
+
+__forceinline const xKdTreePoint* xKdTree::Points() const {
+	return &points_[0];
+}
+
+template<typename Policy>
+inline void xKdTree::Build(const Vec3* points, size_t count, Policy policy) {
+	assert(count < kKdTreeNoPoint);
+	Clear();
+	count_ = count;
+	while(((count + ((size_t)1 << depth_) - 1) >> depth_) > kKdTreeLeaf) ++depth_;
+	splits_.resize(((size_t)1 << depth_) - 1);
+	axes_.resize(splits_.size());
+	points_.resize(count + kKdTreePadding);
+	ParallelFor(policy, count, kKdTreeGrain, [&](size_t begin, size_t end){
+		for(size_t i = begin; i < end; ++i){
+			xKdTreePoint point = { points[i].x, points[i].y, points[i].z, (uint32_t)i };
+			points_[i] = point;
+		}
+	});
+	if(depth_) BuildNode(0, 0, count, 0, policy);
+}
+
+// Ties on the split axis are broken by index, so the median and with it
+// the whole tree is the same however the input was ordered.
+template<typename Policy>
+inline void xKdTree::BuildNode(size_t node, size_t begin, size_t end, size_t level, Policy policy) {
+	xKdTreePoint* first = &points_[0];
+	float low[3] = { INFINITY, INFINITY, INFINITY }, high[3] = { -INFINITY, -INFINITY, -INFINITY };
+	for(size_t i = begin; i < end; ++i){
+		const float* p = &first[i].x;
+		for(int a = 0; a < 3; ++a){
+			low[a] = p[a] < low[a] ? p[a] : low[a];
+			high[a] = p[a] > high[a] ? p[a] : high[a];
+		}
+	}
+	int axis = 0;
+	for(int a = 1; a < 3; ++a)
+		if(high[a] - low[a] > high[axis] - low[axis]) axis = a;
+	size_t middle = begin + (end - begin) / 2;
+	std::nth_element(first + begin, first + middle, first + end, [axis](const xKdTreePoint& a, const xKdTreePoint& b){
+		float pa = (&a.x)[axis], pb = (&b.x)[axis];
+		return pa < pb || (pa == pb && a.index < b.index);
+	});
+	splits_[node] = (&first[middle].x)[axis];
+	axes_[node] = (uint8_t)axis;
+	if(level + 1 == depth_) return;
+	if(end - begin > kKdTreeGrain){
+		ParallelInvoke(policy,
+			[&](){ BuildNode(2 * node + 1, begin, middle, level + 1, policy); },
+			[&](){ BuildNode(2 * node + 2, middle, end, level + 1, policy); });
+	}else{
+		BuildNode(2 * node + 1, begin, middle, level + 1, kSequential);
+		BuildNode(2 * node + 2, middle, end, level + 1, kSequential);
+	}
+}
+
+// Per-ISA kernels.
+inline namespace XMATH_ISA {
+
+// A subtree still to visit and the least squared distance any of its
+// points can have.
+struct xKdTreeVisit {
+	size_t node;
+	size_t begin;
+	size_t end;
+	float bound;
+};
+
+// Squared distances from center to kLaneWidth entries, one per lane.
+__forceinline xLane KdTreeDistances(const xKdTreePoint* points, const xLane center[3]){
+	xLane x, y, z, index;
+	LaneLoadAoS4Full((const float*)points, 4, &x, &y, &z, &index);
+	xLane dx = LaneSub(x, center[0]), dy = LaneSub(y, center[1]), dz = LaneSub(z, center[2]);
+	return LaneMultiplyAdd(dz, dz, LaneMultiplyAdd(dy, dy, LaneMul(dx, dx)));
+}
+
+// Walks the tree from the root, nearer child first, and calls leaf(begin,
+// end) on each leaf whose bound passes limit(). The far child of a split
+// is at least the distance to the split plane away, and at least as far
+// as the split itself.
+template<typename Limit, typename Leaf>
+__forceinline void KdTreeWalk(const xKdTree& tree, const Vec3& center, const Limit& limit, const Leaf& leaf){
+	const float* splits = tree.Splits();
+	const uint8_t* axes = tree.Axes();
+	const size_t inner = ((size_t)1 << tree.Depth()) - 1;
+	xKdTreeVisit stack[kKdTreeMaxDepth + 1];
+	size_t top = 0;
+	xKdTreeVisit root = { 0, 0, tree.Count(), 0.0f };
+	stack[top++] = root;
+	while(top){
+		xKdTreeVisit visit = stack[--top];
+		if(visit.bound > limit()) continue;
+		while(visit.node < inner){
+			float offset = (&center.x)[axes[visit.node]] - splits[visit.node];
+			size_t middle = visit.begin + (visit.end - visit.begin) / 2;
+			xKdTreeVisit left = { 2 * visit.node + 1, visit.begin, middle, visit.bound };
+			xKdTreeVisit right = { 2 * visit.node + 2, middle, visit.end, visit.bound };
+			xKdTreeVisit& far_side = offset < 0.0f ? right : left;
+			far_side.bound = offset * offset > visit.bound ? offset * offset : visit.bound;
+			if(far_side.bound <= limit()) stack[top++] = far_side;
+			visit = offset < 0.0f ? left : right;
+		}
+		leaf(visit.begin, visit.end);
+	}
+}
+
+// Leaves the run unflushed, so a batch passes all its queries on together.
+__forceinline size_t KdTreeRadiusRun(const xKdTree& tree, const Vec3& center, float radius, xIndexRun* run){
+	if(!tree.Count() || !(radius >= 0.0f)) return 0;
+	const xKdTreePoint* points = tree.Points();
+	const xLane c[3] = { LaneSet(center.x), LaneSet(center.y), LaneSet(center.z) };
+	const float squared = radius * radius;
+	const xLane limit = LaneSet(squared);
+	size_t found = 0;
+	KdTreeWalk(tree, center, [&](){ return squared; }, [&](size_t begin, size_t end){
+		LaneLoop(begin, end, [&](size_t i, size_t n){
+			uint32_t bits = ~LaneLessBits(limit, KdTreeDistances(points + i, c)) & LaneCountMask(n);
+			for(size_t k = 0; bits; ++k, bits >>= 1){
+				if(!(bits & 1)) continue;
+				run->Push(points[i + k].index);
+				++found;
+			}
+		});
+	});
+	return found;
+}
+
+inline size_t KdTreeRadiusKernel(const xKdTree& tree, const Vec3& center, float radius, xIndexSink out){
+	xIndexRun run(out);
+	size_t found = KdTreeRadiusRun(tree, center, radius, &run);
+	run.Flush();
+	return found;
+}
+
+// Keeps indices and squared distances sorted, nearest first.
+__forceinline void KdTreeOffer(uint32_t index, float distance, size_t k, size_t* found, uint32_t* indices, float* distances){
+	size_t at = *found;
+	if(at == k){
+		if(!(distance < distances[k - 1] || (distance == distances[k - 1] && index < indices[k - 1]))) return;
+		--at;
+	}else{
+		++*found;
+	}
+	for(; at > 0 && (distances[at - 1] > distance || (distances[at - 1] == distance && indices[at - 1] > index)); --at){
+		indices[at] = indices[at - 1];
+		distances[at] = distances[at - 1];
+	}
+	indices[at] = index;
+	distances[at] = distance;
+}
+
+inline size_t KdTreeNearestKernel(const xKdTree& tree, const Vec3& center, size_t k, uint32_t* indices, float* distances){
+	size_t found = 0;
+	if(k && tree.Count()){
+		const xKdTreePoint* points = tree.Points();
+		const xLane c[3] = { LaneSet(center.x), LaneSet(center.y), LaneSet(center.z) };
+		KdTreeWalk(tree, center, [&](){ return found == k ? distances[k - 1] : INFINITY; }, [&](size_t begin, size_t end){
+			LaneLoop(begin, end, [&](size_t i, size_t n){
+				xLane d = KdTreeDistances(points + i, c);
+				uint32_t bits = LaneCountMask(n);
+				if(found == k) bits &= ~LaneLessBits(LaneSet(distances[k - 1]), d);
+				if(!bits) return;
+				float lanes[kLaneWidth];
+				LaneStore(lanes, d, kLaneWidth);
+				for(size_t j = 0; bits; ++j, bits >>= 1)
+					if(bits & 1) KdTreeOffer(points[i + j].index, lanes[j], k, &found, indices, distances);
+			});
+		});
+	}
+	for(size_t j = found; j < k; ++j){
+		indices[j] = kKdTreeNoPoint;
+		distances[j] = INFINITY;
+	}
+	return found;
+}
+
+inline void KdTreeNearestBatchKernel(const xKdTree& tree, const Vec3* centers, size_t k, uint32_t* indices,
+                                     float* distances, size_t begin, size_t end){
+	float* scratch = distances || !k ? NULL : (float*)_mm_malloc(k * sizeof(float), 64);
+	for(size_t i = begin; i < end; ++i)
+		KdTreeNearestKernel(tree, centers[i], k, indices + i * k, distances ? distances + i * k : scratch);
+	_mm_free(scratch);
+}
+
+inline void KdTreeRadiusBatchKernel(const xKdTree& tree, const Vec3* centers, float radius, size_t* counts,
+                                    xIndexSink out, size_t begin, size_t end){
+	xIndexRun run(out);
+	for(size_t i = begin; i < end; ++i) counts[i] = KdTreeRadiusRun(tree, centers[i], radius, &run);
+	run.Flush();
+}
+
+} // namespace XMATH_ISA
+
+inline size_t xKdTree::QueryRadius(const Vec3& center, float radius, std::vector<uint32_t>* out) const {
+	return XMATH_DISPATCH(KdTreeRadius)(*this, center, radius, IndexSink(out));
+}
+
+// Each task gathers its queries' indices on its own, and the runs are
+// joined in query order.
+template<typename Policy>
+inline void xKdTree::QueryRadius(const Vec3* centers, size_t count, float radius, std::vector<uint32_t>* indices,
+                                 std::vector<size_t>* offsets, Policy policy) const {
+	offsets->assign(count + 1, 0);
+	std::vector<std::pair<size_t, std::vector<uint32_t> > > runs;
+	std::mutex lock;
+	ParallelFor(policy, count, kKdTreeQueryGrain, [&](size_t begin, size_t end){
+		std::vector<uint32_t> run;
+		XMATH_DISPATCH(KdTreeRadiusBatch)(*this, centers, radius, &(*offsets)[1], IndexSink(&run), begin, end);
+		std::lock_guard<std::mutex> hold(lock);
+		runs.push_back(std::make_pair(begin, std::vector<uint32_t>()));
+		runs.back().second.swap(run);
+	});
+	std::sort(runs.begin(), runs.end(), [](const std::pair<size_t, std::vector<uint32_t> >& a,
+	                                        const std::pair<size_t, std::vector<uint32_t> >& b){ return a.first < b.first; });
+	for(size_t i = 0; i < count; ++i) (*offsets)[i + 1] += (*offsets)[i];
+	indices->clear();
+	indices->reserve((*offsets)[count]);
+	for(size_t r = 0; r < runs.size(); ++r) indices->insert(indices->end(), runs[r].second.begin(), runs[r].second.end());
+}
+
+inline size_t xKdTree::QueryNearest(const Vec3& center, size_t k, uint32_t* indices, float* squared_distances) const {
+	std::vector<float> scratch(squared_distances ? 0 : k);
+	return XMATH_DISPATCH(KdTreeNearest)(*this, center, k, indices,
+		squared_distances ? squared_distances : (scratch.empty() ? NULL : &scratch[0]));
+}
+
+template<typename Policy>
+inline void xKdTree::QueryNearest(const Vec3* centers, size_t count, size_t k, uint32_t* indices, float* squared_distances,
+                                  Policy policy) const {
+	ParallelFor(policy, count, kKdTreeQueryGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(KdTreeNearestBatch)(*this, centers, k, indices, squared_distances, begin, end);
+	});
+}
+
+#endif // __XKDTREE_H__
@@ -0,0 +1,340 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Batch Mat4 Multiply.
+//--------------------------------------------------------------//
+//
+//   out[i] = a[i].Multiply(b[i])
+//
+//   Multiplies arrays of independent matrix pairs, such as bone
+//   local times parent or instance model times view. Mat4SoA keeps
+//   the matrices in 16 streams of floats, one per element, so element
+//   (r, c) of kLaneWidth matrices loads into one register and a
+//   product is 64 multiply-adds over kLaneWidth pairs with no
+//   shuffles. On AVX-512 that is some 3x the xMatrix4 Multiply loop.
+//
+//   Mat4 and xMatrix4 arrays take one matrix at a time through
+//   xMatrix4 Multiply built for the running ISA; transposing their
+//   columns into lanes and back costs more than it saves. ToMat4SoA
+//   and ToMat4Array convert between the two layouts, for data that
+//   is multiplied more than once.
+//
+//   The broadcast forms multiply one matrix by every matrix of an
+//   array, on either side. The fixed matrix is splatted into
+//   registers once per task.
+//
+//   Every form sums the products in the order xMatrix4 Multiply
+//   does, so a kernel gives the same bits as xMatrix4 Multiply
+//   built for the same ISA. out may be a or b. By default batches run
+//   on the thread pool (xParallel.h) in tasks of kMat4BatchGrain
+//   matrices.
+//
+//--------------------------------------------------------------//
+#ifndef __XMAT4BATCH_H__
+#define __XMAT4BATCH_H__ 1
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include <xmmintrin.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xMatrix4.h"
+#include "xVec3SoA.h"
+#include "matrix_4.h"
+
+const size_t kMat4BatchGrain = 4096;
+
+struct Mat4SoA {
+
+	Mat4SoA() : count(0), capacity(0) { memset(m, 0, sizeof(m)); }
+	explicit Mat4SoA(size_t size) : count(0), capacity(0) {
+		memset(m, 0, sizeof(m));
+		Resize(size);
+	}
+	Mat4SoA(const Mat4* values, size_t size) : count(0), capacity(0) {
+		memset(m, 0, sizeof(m));
+		Resize(size);
+		for(size_t i = 0; i < size; ++i) Set(i, values[i]);
+	}
+	Mat4SoA(const Mat4SoA& copy) : count(0), capacity(0) {
+		memset(m, 0, sizeof(m));
+		*this = copy;
+	}
+	~Mat4SoA() { Release(); }
+
+	Mat4SoA& operator=(const Mat4SoA& other) {
+		if(this == &other) return *this;
+		Resize(other.count);
+		for(int e = 0; e < 16; ++e) memcpy(m[e], other.m[e], count * sizeof(float));
+		return *this;
+	}
+
+	// Keeps the first min(count, size) elements; new elements are identity.
+	void Resize(size_t size) {
+		if(size > capacity) {
+			size_t new_capacity = (size + 15) & ~(size_t)15;
+			for(int e = 0; e < 16; ++e) {
+				float* stream = (float*)_mm_malloc(new_capacity * sizeof(float), kSoAAlignment);
+				if(count) memcpy(stream, m[e], count * sizeof(float));
+				_mm_free(m[e]);
+				m[e] = stream;
+			}
+			capacity = new_capacity;
+		}
+		for(size_t i = count; i < size; ++i) Set(i, Mat4::Identity());
+		count = size;
+	}
+
+	Mat4 Get(size_t i) const {
+		Mat4 result;
+		for(int e = 0; e < 16; ++e) result.m[e] = m[e][i];
+		return result;
+	}
+	void Set(size_t i, const Mat4& value) {
+		for(int e = 0; e < 16; ++e) m[e][i] = value.m[e];
+	}
+
+	// Element e of every matrix, in Mat4::m order.
+	float* m[16];
+	size_t count;
+	size_t capacity;
+
+ private:
+	void Release() {
+		for(int e = 0; e < 16; ++e) {
+			_mm_free(m[e]);
+			m[e] = NULL;
+		}
+		capacity = 0;
+	}
+};
+
+// Per-ISA kernels. Matrix arrays are 16 floats each in Mat4 order, which is
+// also the xMatrix4 layout; the array kernels take pointers to the first
+// matrix and a count.
+inline namespace XMATH_ISA {
+
+// One column of kLaneWidth matrices. The kernels name every register
+// rather than index arrays of them, which compilers would keep in memory.
+struct xLaneColumn {
+	xLane x, y, z, w;
+};
+
+// Row (a0, a1, a2, a3) of a times column b, in the order of xMatrix4
+// Multiply: (a0 b.x + a1 b.y) + (a2 b.z + a3 b.w).
+__forceinline xLane __vectorcall LaneMat4Dot(xLane a0, xLane a1, xLane a2, xLane a3, const xLaneColumn& b){
+	return LaneAdd(LaneMultiplyAdd(a1, b.y, LaneMul(a0, b.x)), LaneMultiplyAdd(a3, b.w, LaneMul(a2, b.z)));
+}
+
+// Column b of a times b, for a with columns a0..a3.
+__forceinline xLaneColumn LaneMat4Column(const xLaneColumn& a0, const xLaneColumn& a1, const xLaneColumn& a2,
+                                         const xLaneColumn& a3, const xLaneColumn& b){
+	xLaneColumn result;
+	result.x = LaneMat4Dot(a0.x, a1.x, a2.x, a3.x, b);
+	result.y = LaneMat4Dot(a0.y, a1.y, a2.y, a3.y, b);
+	result.z = LaneMat4Dot(a0.z, a1.z, a2.z, a3.z, b);
+	result.w = LaneMat4Dot(a0.w, a1.w, a2.w, a3.w, b);
+	return result;
+}
+
+__forceinline xLaneColumn LaneLoadColumn(const Mat4SoA& s, int c, size_t i, size_t n){
+	xLaneColumn result;
+	result.x = LaneLoad(s.m[c * 4] + i, n);
+	result.y = LaneLoad(s.m[c * 4 + 1] + i, n);
+	result.z = LaneLoad(s.m[c * 4 + 2] + i, n);
+	result.w = LaneLoad(s.m[c * 4 + 3] + i, n);
+	return result;
+}
+
+__forceinline void LaneStoreColumn(Mat4SoA* s, int c, size_t i, size_t n, const xLaneColumn& column){
+	LaneStore(s->m[c * 4] + i, column.x, n);
+	LaneStore(s->m[c * 4 + 1] + i, column.y, n);
+	LaneStore(s->m[c * 4 + 2] + i, column.z, n);
+	LaneStore(s->m[c * 4 + 3] + i, column.w, n);
+}
+
+// Column c of one matrix in every lane.
+__forceinline xLaneColumn LaneSetColumn(const Mat4& m, int c){
+	xLaneColumn result;
+	result.x = LaneSet(m.m[c * 4]);
+	result.y = LaneSet(m.m[c * 4 + 1]);
+	result.z = LaneSet(m.m[c * 4 + 2]);
+	result.w = LaneSet(m.m[c * 4 + 3]);
+	return result;
+}
+
+// The array kernels take one matrix at a time: xMatrix4 Multiply already
+// fills the registers without a transpose, and built for this ISA it adds
+// in the same order as the lane kernels.
+inline void Mat4MultiplyArraysKernel(const float* a, const float* b, float* out, size_t count){
+	for(size_t i = 0; i < count; ++i) Multiply(xMatrix4(a + i * 16), xMatrix4(b + i * 16)).store(out + i * 16);
+}
+
+// out[i] = a * b[i].
+inline void Mat4MultiplyLeftKernel(const float* a, const float* b, float* out, size_t count){
+	xMatrix4 x(a);
+	for(size_t i = 0; i < count; ++i) Multiply(x, xMatrix4(b + i * 16)).store(out + i * 16);
+}
+
+// out[i] = a[i] * b.
+inline void Mat4MultiplyRightKernel(const float* a, const float* b, float* out, size_t count){
+	xMatrix4 y(b);
+	for(size_t i = 0; i < count; ++i) Multiply(xMatrix4(a + i * 16), y).store(out + i * 16);
+}
+
+// Each column of b is read before the same column of out is written, and
+// all of a before any, so out may be a or b.
+inline void Mat4SoAMultiplyKernel(const Mat4SoA& a, const Mat4SoA& b, Mat4SoA* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLaneColumn a0 = LaneLoadColumn(a, 0, i, n), a1 = LaneLoadColumn(a, 1, i, n);
+		xLaneColumn a2 = LaneLoadColumn(a, 2, i, n), a3 = LaneLoadColumn(a, 3, i, n);
+		for(int c = 0; c < 4; ++c) LaneStoreColumn(out, c, i, n, LaneMat4Column(a0, a1, a2, a3, LaneLoadColumn(b, c, i, n)));
+	});
+}
+
+inline void Mat4SoAMultiplyLeftKernel(const Mat4& a, const Mat4SoA& b, Mat4SoA* out, size_t begin, size_t end){
+	xLaneColumn a0 = LaneSetColumn(a, 0), a1 = LaneSetColumn(a, 1), a2 = LaneSetColumn(a, 2), a3 = LaneSetColumn(a, 3);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		for(int c = 0; c < 4; ++c) LaneStoreColumn(out, c, i, n, LaneMat4Column(a0, a1, a2, a3, LaneLoadColumn(b, c, i, n)));
+	});
+}
+
+inline void Mat4SoAMultiplyRightKernel(const Mat4SoA& a, const Mat4& b, Mat4SoA* out, size_t begin, size_t end){
+	xLaneColumn b0 = LaneSetColumn(b, 0), b1 = LaneSetColumn(b, 1), b2 = LaneSetColumn(b, 2), b3 = LaneSetColumn(b, 3);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLaneColumn a0 = LaneLoadColumn(a, 0, i, n), a1 = LaneLoadColumn(a, 1, i, n);
+		xLaneColumn a2 = LaneLoadColumn(a, 2, i, n), a3 = LaneLoadColumn(a, 3, i, n);
+		LaneStoreColumn(out, 0, i, n, LaneMat4Column(a0, a1, a2, a3, b0));
+		LaneStoreColumn(out, 1, i, n, LaneMat4Column(a0, a1, a2, a3, b1));
+		LaneStoreColumn(out, 2, i, n, LaneMat4Column(a0, a1, a2, a3, b2));
+		LaneStoreColumn(out, 3, i, n, LaneMat4Column(a0, a1, a2, a3, b3));
+	});
+}
+
+inline void Mat4ToSoAKernel(const float* in, Mat4SoA* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		for(int c = 0; c < 4; ++c){
+			xLaneColumn column;
+			LaneLoadAoS4(in + i * 16 + c * 4, n, &column.x, &column.y, &column.z, &column.w, 16);
+			LaneStoreColumn(out, c, i, n, column);
+		}
+	});
+}
+
+inline void Mat4FromSoAKernel(const Mat4SoA& in, float* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		for(int c = 0; c < 4; ++c){
+			xLaneColumn column = LaneLoadColumn(in, c, i, n);
+			LaneStoreAoS4(out + i * 16 + c * 4, n, column.x, column.y, column.z, column.w, 16);
+		}
+	});
+}
+
+} // namespace XMATH_ISA
+
+// out[i] = a[i].Multiply(b[i]) for count matrices.
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const Mat4* a, const Mat4* b, Mat4* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4MultiplyArrays)(a[begin].m, b[begin].m, out[begin].m, end - begin);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const xMatrix4* a, const xMatrix4* b, xMatrix4* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4MultiplyArrays)((const float*)a[begin].col, (const float*)b[begin].col, (float*)out[begin].col,
+		                                   end - begin);
+	});
+}
+
+// out[i] = a.Multiply(b[i]).
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const Mat4& a, const Mat4* b, Mat4* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4MultiplyLeft)(a.m, b[begin].m, out[begin].m, end - begin);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const xMatrix4& a, const xMatrix4* b, xMatrix4* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4MultiplyLeft)((const float*)a.col, (const float*)b[begin].col, (float*)out[begin].col, end - begin);
+	});
+}
+
+// out[i] = a[i].Multiply(b).
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const Mat4* a, const Mat4& b, Mat4* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4MultiplyRight)(a[begin].m, b.m, out[begin].m, end - begin);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const xMatrix4* a, const xMatrix4& b, xMatrix4* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4MultiplyRight)((const float*)a[begin].col, (const float*)b.col, (float*)out[begin].col, end - begin);
+	});
+}
+
+// The Mat4SoA forms resize out to the count of the array operands, which
+// must match.
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const Mat4SoA& a, const Mat4SoA& b, Mat4SoA* out, Policy policy = Policy()){
+	assert(a.count == b.count);
+	out->Resize(a.count);
+	ParallelFor(policy, a.count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4SoAMultiply)(a, b, out, begin, end);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const Mat4& a, const Mat4SoA& b, Mat4SoA* out, Policy policy = Policy()){
+	out->Resize(b.count);
+	ParallelFor(policy, b.count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4SoAMultiplyLeft)(a, b, out, begin, end);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void MultiplyBatch(const Mat4SoA& a, const Mat4& b, Mat4SoA* out, Policy policy = Policy()){
+	out->Resize(a.count);
+	ParallelFor(policy, a.count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4SoAMultiplyRight)(a, b, out, begin, end);
+	});
+}
+
+// Layout conversions. out is resized to count, or holds in.count matrices.
+template<typename Policy = xParallelPolicy>
+inline void ToMat4SoA(const Mat4* in, size_t count, Mat4SoA* out, Policy policy = Policy()){
+	out->Resize(count);
+	ParallelFor(policy, count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4ToSoA)(in->m, out, begin, end);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void ToMat4SoA(const xMatrix4* in, size_t count, Mat4SoA* out, Policy policy = Policy()){
+	out->Resize(count);
+	ParallelFor(policy, count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4ToSoA)((const float*)in->col, out, begin, end);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void ToMat4Array(const Mat4SoA& in, Mat4* out, Policy policy = Policy()){
+	ParallelFor(policy, in.count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4FromSoA)(in, out->m, begin, end);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void ToMat4Array(const Mat4SoA& in, xMatrix4* out, Policy policy = Policy()){
+	ParallelFor(policy, in.count, kMat4BatchGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Mat4FromSoA)(in, (float*)out->col, begin, end);
+	});
+}
+
+#endif // __XMAT4BATCH_H__
@@ -0,0 +1,368 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  SSE Matrix 4 Definition.
+//--------------------------------------------------------------//
+//
+//   col[0] = m0  m1  m2  m3
+//   col[1] = m4  m5  m6  m7
+//   col[2] = m8  m9  m10 m11
+//   col[3] = m12 m13 m14 m15
+//
+//   Same memory order as Mat4::m, so converting either way is
+//   four unaligned loads or stores. col[i] is therefore line i of
+//   the matrix in the Mat4 convention (matrix_4.h) and col[i].w is
+//   translation i. Multiply and Transform give the same results as
+//   Mat4::Multiply and the member Mat4::Mat4TransformVec4; a * b is
+//   the mathematical product, Multiply(b, a).
+//
+//--------------------------------------------------------------//
+#ifndef __XMATRIX4_H__
+#define __XMATRIX4_H__ 1
+
+#include <assert.h>
+#include <stdint.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xVector3.h"
+#include "matrix_4.h"
+
+// Matrices per task when a policy runs InverseBatch in parallel.
+const size_t kInverseGrain = 2048;
+
+struct xMatrix4 {
+
+	__forceinline xMatrix4() {}
+	__forceinline explicit xMatrix4(__m128 c0, __m128 c1, __m128 c2, __m128 c3) {
+		col[0] = c0; col[1] = c1; col[2] = c2; col[3] = c3;
+	}
+	__forceinline explicit xMatrix4(const float* p) {
+		col[0] = _mm_loadu_ps(p);
+		col[1] = _mm_loadu_ps(p + 4);
+		col[2] = _mm_loadu_ps(p + 8);
+		col[3] = _mm_loadu_ps(p + 12);
+	}
+	__forceinline explicit xMatrix4(const Mat4& mat) {
+		col[0] = _mm_loadu_ps(mat.m);
+		col[1] = _mm_loadu_ps(mat.m + 4);
+		col[2] = _mm_loadu_ps(mat.m + 8);
+		col[3] = _mm_loadu_ps(mat.m + 12);
+	}
+
+	__forceinline static xMatrix4 __vectorcall Identity() {
+		return xMatrix4(_mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f),
+		                _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f),
+		                _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f),
+		                _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	__forceinline void __vectorcall store(float* p) const {
+		_mm_storeu_ps(p, col[0]);
+		_mm_storeu_ps(p + 4, col[1]);
+		_mm_storeu_ps(p + 8, col[2]);
+		_mm_storeu_ps(p + 12, col[3]);
+	}
+	__forceinline void __vectorcall store(Mat4* out) const { store(out->m); }
+
+	__forceinline Mat4 __vectorcall ToMat4() const {
+		Mat4 result;
+		store(result.m);
+		return result;
+	}
+
+	__forceinline __m128 __vectorcall operator[] (size_t i) const { return col[i]; }
+	__forceinline __m128& __vectorcall operator[] (size_t i) { return col[i]; }
+
+	__m128 col[4];
+
+};
+
+inline namespace XMATH_ISA {
+
+// col[0] * v.x + col[1] * v.y + col[2] * v.z + col[3] * v.w, split in two
+// independent chains so the adds of one half overlap the other. That is v
+// as a row times m; Multiply is built from it, and on Transpose(m) it is
+// the column product the transforms below need.
+__forceinline __m128 __vectorcall Combine(const xMatrix4& m, __m128 v){
+	__m128 a = _mm_mul_ps(m.col[0], Splat<0>(v));
+	__m128 b = _mm_mul_ps(m.col[2], Splat<2>(v));
+	a = MultiplyAdd(m.col[1], Splat<1>(v), a);
+	b = MultiplyAdd(m.col[3], Splat<3>(v), b);
+	return _mm_add_ps(a, b);
+}
+
+// Point and direction forms of Combine with w = 1 and w = 0. t is the
+// transposed matrix, so t.col[3] holds the translation; loops transpose
+// once and call these directly.
+__forceinline xVector3 __vectorcall CombinePoint(const xMatrix4& t, xVector3 p){
+	__m128 a = _mm_mul_ps(t.col[0], Splat<0>(p.xmm));
+	__m128 b = MultiplyAdd(t.col[2], Splat<2>(p.xmm), t.col[3]);
+	a = MultiplyAdd(t.col[1], Splat<1>(p.xmm), a);
+	return xVector3(_mm_add_ps(a, b));
+}
+
+__forceinline xVector3 __vectorcall CombineDirection(const xMatrix4& t, xVector3 d){
+	__m128 a = _mm_mul_ps(t.col[0], Splat<0>(d.xmm));
+	__m128 b = _mm_mul_ps(t.col[2], Splat<2>(d.xmm));
+	a = MultiplyAdd(t.col[1], Splat<1>(d.xmm), a);
+	return xVector3(_mm_add_ps(a, b));
+}
+
+__forceinline xMatrix4 __vectorcall Transpose(xMatrix4 m){
+	_MM_TRANSPOSE4_PS(m.col[0], m.col[1], m.col[2], m.col[3]);
+	return m;
+}
+
+// m * v with v a column, as Mat4::Mat4TransformVec4: the result is
+// dot(col[i], v) for each i.
+__forceinline __m128 __vectorcall Transform(const xMatrix4& m, __m128 v){
+	return Combine(Transpose(m), v);
+}
+
+// w = 1: adds the translation col[i].w. The w lane of the result is the
+// projective w, dot(col[3], (p, 1)).
+__forceinline xVector3 __vectorcall TransformPoint(const xMatrix4& m, xVector3 p){
+	return CombinePoint(Transpose(m), p);
+}
+
+// w = 0: the translation is ignored.
+__forceinline xVector3 __vectorcall TransformDirection(const xMatrix4& m, xVector3 d){
+	return CombineDirection(Transpose(m), d);
+}
+
+// Same product as a.Multiply(b): a is applied first, then b.
+__forceinline xMatrix4 __vectorcall Multiply(const xMatrix4& a, const xMatrix4& b){
+	return xMatrix4(Combine(a, b.col[0]), Combine(a, b.col[1]),
+	                Combine(a, b.col[2]), Combine(a, b.col[3]));
+}
+
+// The mathematical product a b: b is applied first, then a, the same order
+// as xQuaternion and Quat operator*. a * b == Multiply(b, a).
+__forceinline xMatrix4 __vectorcall operator*(const xMatrix4& a, const xMatrix4& b){
+	return Multiply(b, a);
+}
+
+__forceinline xMatrix4 __vectorcall operator+(xMatrix4 a, const xMatrix4& b){
+	a.col[0] = _mm_add_ps(a.col[0], b.col[0]);
+	a.col[1] = _mm_add_ps(a.col[1], b.col[1]);
+	a.col[2] = _mm_add_ps(a.col[2], b.col[2]);
+	a.col[3] = _mm_add_ps(a.col[3], b.col[3]);
+	return a;
+}
+
+__forceinline xMatrix4 __vectorcall operator-(xMatrix4 a, const xMatrix4& b){
+	a.col[0] = _mm_sub_ps(a.col[0], b.col[0]);
+	a.col[1] = _mm_sub_ps(a.col[1], b.col[1]);
+	a.col[2] = _mm_sub_ps(a.col[2], b.col[2]);
+	a.col[3] = _mm_sub_ps(a.col[3], b.col[3]);
+	return a;
+}
+
+__forceinline xMatrix4 __vectorcall operator*(xMatrix4 a, float b){
+	__m128 s = _mm_set1_ps(b);
+	a.col[0] = _mm_mul_ps(a.col[0], s);
+	a.col[1] = _mm_mul_ps(a.col[1], s);
+	a.col[2] = _mm_mul_ps(a.col[2], s);
+	a.col[3] = _mm_mul_ps(a.col[3], s);
+	return a;
+}
+
+__forceinline xMatrix4 __vectorcall operator*(float a, xMatrix4 b){
+	return b * a;
+}
+
+__forceinline bool __vectorcall operator==(const xMatrix4& a, const xMatrix4& b){
+	__m128 eq = _mm_and_ps(_mm_and_ps(_mm_cmpeq_ps(a.col[0], b.col[0]), _mm_cmpeq_ps(a.col[1], b.col[1])),
+	                       _mm_and_ps(_mm_cmpeq_ps(a.col[2], b.col[2]), _mm_cmpeq_ps(a.col[3], b.col[3])));
+	return _mm_movemask_ps(eq) == 0xF;
+}
+
+__forceinline bool __vectorcall operator!=(const xMatrix4& a, const xMatrix4& b){
+	return !(a == b);
+}
+
+// 2x2 blocks are packed into one register as (m00, m01, m10, m11).
+#define XMATRIX4_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps((a), (b), _MM_SHUFFLE(w, z, y, x))
+#define XMATRIX4_SWIZZLE(v, x, y, z, w) _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), _MM_SHUFFLE(w, z, y, x)))
+
+// A * B
+__forceinline __m128 __vectorcall Block2Multiply(__m128 a, __m128 b){
+	return _mm_add_ps(_mm_mul_ps(a, XMATRIX4_SWIZZLE(b, 0, 3, 0, 3)),
+	                  _mm_mul_ps(XMATRIX4_SWIZZLE(a, 1, 0, 3, 2), XMATRIX4_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adj(A) * B
+__forceinline __m128 __vectorcall Block2AdjointMultiply(__m128 a, __m128 b){
+	return _mm_sub_ps(_mm_mul_ps(XMATRIX4_SWIZZLE(a, 3, 3, 0, 0), b),
+	                  _mm_mul_ps(XMATRIX4_SWIZZLE(a, 1, 1, 2, 2), XMATRIX4_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// A * adj(B)
+__forceinline __m128 __vectorcall Block2MultiplyAdjoint(__m128 a, __m128 b){
+	return _mm_sub_ps(_mm_mul_ps(a, XMATRIX4_SWIZZLE(b, 3, 0, 3, 0)),
+	                  _mm_mul_ps(XMATRIX4_SWIZZLE(a, 1, 0, 3, 2), XMATRIX4_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// General inverse by 2x2 blocks. The four block determinants come out of a
+// single multiply-subtract and the adj(A)B / adj(D)C products are shared by
+// all four output blocks, so there is one divide and no scalar code.
+// Returns false and leaves *out untouched when |det| <= epsilon times the
+// product of the column lengths (kMat4InverseEpsilon).
+__forceinline bool __vectorcall Inverse(const xMatrix4& m, xMatrix4* out, float epsilon = kMat4InverseEpsilon){
+	__m128 a = _mm_movelh_ps(m.col[0], m.col[1]);
+	__m128 b = _mm_movehl_ps(m.col[1], m.col[0]);
+	__m128 c = _mm_movelh_ps(m.col[2], m.col[3]);
+	__m128 d = _mm_movehl_ps(m.col[3], m.col[2]);
+
+	__m128 det_sub = _mm_sub_ps(
+		_mm_mul_ps(XMATRIX4_SHUFFLE(m.col[0], m.col[2], 0, 2, 0, 2), XMATRIX4_SHUFFLE(m.col[1], m.col[3], 1, 3, 1, 3)),
+		_mm_mul_ps(XMATRIX4_SHUFFLE(m.col[0], m.col[2], 1, 3, 1, 3), XMATRIX4_SHUFFLE(m.col[1], m.col[3], 0, 2, 0, 2)));
+	__m128 det_a = Splat<0>(det_sub);
+	__m128 det_b = Splat<1>(det_sub);
+	__m128 det_c = Splat<2>(det_sub);
+	__m128 det_d = Splat<3>(det_sub);
+
+	__m128 d_c = Block2AdjointMultiply(d, c);
+	__m128 a_b = Block2AdjointMultiply(a, b);
+
+	__m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), Block2Multiply(b, d_c));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), Block2Multiply(c, a_b));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), Block2MultiplyAdjoint(d, a_b));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), Block2MultiplyAdjoint(a, d_c));
+
+	__m128 trace = _mm_mul_ps(a_b, XMATRIX4_SWIZZLE(d_c, 0, 2, 1, 3));
+	trace = _mm_add_ps(trace, XMATRIX4_SWIZZLE(trace, 2, 3, 0, 1));
+	trace = _mm_add_ps(trace, XMATRIX4_SWIZZLE(trace, 1, 0, 3, 2));
+
+	__m128 det = _mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c));
+	det = _mm_sub_ps(det, trace);
+
+	// col[i] holds line i, so the column lengths are lane-wise.
+	__m128 bound = _mm_mul_ps(m.col[0], m.col[0]);
+	bound = MultiplyAdd(m.col[1], m.col[1], bound);
+	bound = MultiplyAdd(m.col[2], m.col[2], bound);
+	bound = _mm_sqrt_ps(MultiplyAdd(m.col[3], m.col[3], bound));
+	bound = _mm_mul_ps(bound, XMATRIX4_SWIZZLE(bound, 2, 3, 0, 1));
+	bound = _mm_mul_ps(bound, XMATRIX4_SWIZZLE(bound, 1, 0, 3, 2));
+
+	__m128 abs_det = _mm_andnot_ps(_mm_set1_ps(-0.0f), det);
+	if(_mm_comile_ss(abs_det, _mm_mul_ss(bound, _mm_set_ss(epsilon))))
+		return false;
+
+	__m128 inverse_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+	x = _mm_mul_ps(x, inverse_det);
+	y = _mm_mul_ps(y, inverse_det);
+	z = _mm_mul_ps(z, inverse_det);
+	w = _mm_mul_ps(w, inverse_det);
+
+	out->col[0] = XMATRIX4_SHUFFLE(x, y, 3, 1, 3, 1);
+	out->col[1] = XMATRIX4_SHUFFLE(x, y, 2, 0, 2, 0);
+	out->col[2] = XMATRIX4_SHUFFLE(z, w, 3, 1, 3, 1);
+	out->col[3] = XMATRIX4_SHUFFLE(z, w, 2, 0, 2, 0);
+	return true;
+}
+
+inline size_t InverseBatchXMatrix4Kernel(const xMatrix4* in, xMatrix4* out, uint8_t* invertible,
+                                         size_t count, float epsilon){
+	size_t inverted = 0;
+	for(size_t i = 0; i < count; ++i){
+		bool ok = Inverse(in[i], &out[i], epsilon);
+		if(invertible) invertible[i] = ok ? 1 : 0;
+		inverted += ok ? 1 : 0;
+	}
+	return inverted;
+}
+
+inline size_t InverseBatchMat4Kernel(const Mat4* in, Mat4* out, uint8_t* invertible,
+                                     size_t count, float epsilon){
+	size_t inverted = 0;
+	for(size_t i = 0; i < count; ++i){
+		xMatrix4 result;
+		bool ok = Inverse(xMatrix4(in[i]), &result, epsilon);
+		if(ok) result.store(&out[i]);
+		if(invertible) invertible[i] = ok ? 1 : 0;
+		inverted += ok ? 1 : 0;
+	}
+	return inverted;
+}
+
+} // namespace XMATH_ISA
+
+// Inverts count matrices. invertible[i] (when not NULL) receives the flag for
+// in[i]; out[i] is left untouched for singular inputs. in and out may alias.
+// Returns the number of matrices that were inverted. The trailing policy is
+// kSequential or kParallel (xParallel.h).
+template<typename Policy = xSequentialPolicy>
+inline size_t InverseBatch(const xMatrix4* in, xMatrix4* out, uint8_t* invertible,
+                           size_t count, float epsilon = kMat4InverseEpsilon, Policy policy = Policy()){
+	return ParallelReduce(policy, count, kInverseGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(InverseBatchXMatrix4)(in + begin, out + begin, invertible ? invertible + begin : NULL,
+		                                            end - begin, epsilon);
+	}, [](size_t a, size_t b){ return a + b; });
+}
+
+template<typename Policy = xSequentialPolicy>
+inline size_t InverseBatch(const Mat4* in, Mat4* out, uint8_t* invertible,
+                           size_t count, float epsilon = kMat4InverseEpsilon, Policy policy = Policy()){
+	return ParallelReduce(policy, count, kInverseGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(InverseBatchMat4)(in + begin, out + begin, invertible ? invertible + begin : NULL,
+		                                        end - begin, epsilon);
+	}, [](size_t a, size_t b){ return a + b; });
+}
+
+inline namespace XMATH_ISA {
+
+// Shared tail of the affine inverses. c0, c1, c2 are the columns of the
+// inverted 3x3 block (w = 0); col[i].w of the input holds translation i.
+__forceinline xMatrix4 __vectorcall ComposeAffineInverse(const xMatrix4& m, __m128 c0, __m128 c1, __m128 c2){
+	__m128 t = _mm_shuffle_ps(_mm_unpackhi_ps(m.col[0], m.col[1]), m.col[2], _MM_SHUFFLE(3, 3, 3, 2));
+	__m128 a = _mm_mul_ps(c0, Splat<0>(t));
+	__m128 b = _mm_mul_ps(c2, Splat<2>(t));
+	a = MultiplyAdd(c1, Splat<1>(t), a);
+	__m128 translation = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(a, b));
+
+	xMatrix4 result(c0, c1, c2, translation);
+	_MM_TRANSPOSE4_PS(result.col[0], result.col[1], result.col[2], result.col[3]);
+	result.col[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	return result;
+}
+
+// Same contract as Mat4::GetInverseAffine.
+__forceinline bool __vectorcall InverseAffine(const xMatrix4& m, xMatrix4* out, float epsilon = kMat4InverseEpsilon){
+	assert(m.ToMat4().IsAffine());
+
+	__m128 c0 = Cross3(m.col[1], m.col[2]);
+	__m128 c1 = Cross3(m.col[2], m.col[0]);
+	__m128 c2 = Cross3(m.col[0], m.col[1]);
+
+	__m128 det = _mm_mul_ps(m.col[0], c0);
+	det = _mm_add_ss(_mm_add_ss(det, Splat<1>(det)), _mm_movehl_ps(det, det));
+	__m128 bound = _mm_mul_ps(m.col[0], m.col[0]);
+	bound = MultiplyAdd(m.col[1], m.col[1], bound);
+	bound = _mm_sqrt_ps(MultiplyAdd(m.col[2], m.col[2], bound));
+	bound = _mm_mul_ss(_mm_mul_ss(bound, Splat<1>(bound)), _mm_movehl_ps(bound, bound));
+	if(_mm_comile_ss(_mm_andnot_ps(_mm_set1_ps(-0.0f), det), _mm_mul_ss(bound, _mm_set_ss(epsilon))))
+		return false;
+
+	__m128 inverse_det = _mm_div_ps(_mm_set1_ps(1.0f), Splat<0>(det));
+	*out = ComposeAffineInverse(m, _mm_mul_ps(c0, inverse_det), _mm_mul_ps(c1, inverse_det), _mm_mul_ps(c2, inverse_det));
+	return true;
+}
+
+// Same contract as Mat4::GetInverseRigid.
+__forceinline xMatrix4 __vectorcall InverseRigid(const xMatrix4& m){
+	assert(m.ToMat4().IsAffine());
+
+	const __m128 xyz_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	return ComposeAffineInverse(m, _mm_and_ps(m.col[0], xyz_mask), _mm_and_ps(m.col[1], xyz_mask),
+	                            _mm_and_ps(m.col[2], xyz_mask));
+}
+
+} // namespace XMATH_ISA
+
+#undef XMATRIX4_SHUFFLE
+#undef XMATRIX4_SWIZZLE
+
+#endif // __XMATRIX4_H__
@@ -0,0 +1,221 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Pairwise Distances.
+//--------------------------------------------------------------//
+//
+//   |a - b|^2 = |a|^2 + |b|^2 - 2 a . b
+//
+//   All-pairs squared distances between two Vec3SoA sets, for sets
+//   small enough (up to some 50k points) that a scan beats building
+//   a tree. The squared lengths come from DotProduct(a, a) once per
+//   point, so each pair costs a dot product and an add: three
+//   multiply-adds per register of kLaneWidth pairs.
+//
+//   The kernels work in tiles of kPairwiseRows points of a against
+//   one register of points of b. Columns go in blocks of
+//   kPairwiseColumns, 16 KB of b and its lengths, which stay in L1
+//   while a task's rows run over them; a task's rows and their top-k
+//   lists stay in L2.
+//
+//   The formula loses precision where the points are far from the
+//   origin compared to their distance apart: the error reaches
+//   5e-7 * (|a|^2 + |b|^2). Move both sets near the origin first
+//   when that matters. Results never go below zero.
+//
+//--------------------------------------------------------------//
+#ifndef __XPAIRWISE_H__
+#define __XPAIRWISE_H__ 1
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xVec3SoA.h"
+
+// Rows of a per task when a policy runs in parallel.
+const size_t kPairwiseGrain = 64;
+// Rows of a per register tile, and columns of b per cache block.
+const size_t kPairwiseRows = 4;
+const size_t kPairwiseColumns = 1024;
+// Index of a missing neighbor.
+const uint32_t kPairwiseNoPoint = 0xFFFFFFFFu;
+
+struct xPairwiseNeighbor {
+	float squared;
+	uint32_t index;
+};
+
+// Nearer first, then the lower index.
+struct xPairwiseCloser {
+	__forceinline bool operator()(const xPairwiseNeighbor& a, const xPairwiseNeighbor& b) const {
+		return a.squared < b.squared || (a.squared == b.squared && a.index < b.index);
+	}
+};
+
+const xPairwiseCloser PairwiseCloser = xPairwiseCloser();
+
+// Per-ISA kernels, over the rows [begin, end) of a. a_lengths and
+// b_lengths hold the squared length of every point.
+inline namespace XMATH_ISA {
+
+// Squared distances from Rows points of a, starting at row, to the n
+// points of b starting at column.
+template<size_t Rows>
+__forceinline void PairwiseTile(const Vec3SoA& a, const float* a_lengths, const Vec3SoA& b, const float* b_lengths,
+                                size_t row, size_t column, size_t n, xLane distances[Rows]){
+	xLane bx = LaneLoad(b.x + column, n), by = LaneLoad(b.y + column, n), bz = LaneLoad(b.z + column, n);
+	xLane lengths = LaneLoad(b_lengths + column, n);
+	const xLane zero = LaneSet(0.0f);
+	for(size_t r = 0; r < Rows; ++r){
+		size_t i = row + r;
+		xLane d = LaneDot3(LaneSet(-2.0f * a.x[i]), LaneSet(-2.0f * a.y[i]), LaneSet(-2.0f * a.z[i]), bx, by, bz);
+		distances[r] = LaneMax(LaneAdd(LaneAdd(d, lengths), LaneSet(a_lengths[i])), zero);
+	}
+}
+
+template<size_t Rows>
+__forceinline void PairwiseDistanceRows(const Vec3SoA& a, const float* a_lengths, const Vec3SoA& b, const float* b_lengths,
+                                        float* out, size_t stride, size_t row, size_t first, size_t last){
+	LaneLoop(first, last, [&](size_t j, size_t n){
+		xLane distances[Rows];
+		PairwiseTile<Rows>(a, a_lengths, b, b_lengths, row, j, n, distances);
+		for(size_t r = 0; r < Rows; ++r) LaneStore(out + (row + r) * stride + j, distances[r], n);
+	});
+}
+
+inline void PairwiseDistancesKernel(const Vec3SoA& a, const float* a_lengths, const Vec3SoA& b, const float* b_lengths,
+                                    float* out, size_t stride, size_t begin, size_t end){
+	for(size_t first = 0; first < b.count; first += kPairwiseColumns){
+		size_t last = first + kPairwiseColumns < b.count ? first + kPairwiseColumns : b.count;
+		size_t i = begin;
+		for(; i + kPairwiseRows <= end; i += kPairwiseRows)
+			PairwiseDistanceRows<kPairwiseRows>(a, a_lengths, b, b_lengths, out, stride, i, first, last);
+		for(; i < end; ++i) PairwiseDistanceRows<1>(a, a_lengths, b, b_lengths, out, stride, i, first, last);
+	}
+}
+
+// Puts candidate at the root of the max-heap heap[0, size) and sifts it
+// down to its place.
+__forceinline void PairwiseSiftDown(xPairwiseNeighbor candidate, size_t size, xPairwiseNeighbor* heap){
+	size_t at = 0;
+	for(size_t child = 1; child < size; child = 2 * at + 1){
+		if(child + 1 < size && PairwiseCloser(heap[child], heap[child + 1])) ++child;
+		if(!PairwiseCloser(candidate, heap[child])) break;
+		heap[at] = heap[child];
+		at = child;
+	}
+	heap[at] = candidate;
+}
+
+// heap is a max-heap of the size nearest so far under PairwiseCloser, so
+// its root is the one to beat. The sifts are written out so that nothing
+// here is a call that would spill the tile registers.
+__forceinline void PairwiseOffer(xPairwiseNeighbor candidate, size_t k, xPairwiseNeighbor* heap, size_t* size){
+	if(*size == k){
+		if(PairwiseCloser(candidate, heap[0])) PairwiseSiftDown(candidate, k, heap);
+		return;
+	}
+	size_t at = (*size)++;
+	for(; at > 0 && PairwiseCloser(heap[(at - 1) / 2], candidate); at = (at - 1) / 2) heap[at] = heap[(at - 1) / 2];
+	heap[at] = candidate;
+}
+
+// Sorts the max-heap heap[0, size) nearest first, in place.
+__forceinline void PairwiseSortHeap(xPairwiseNeighbor* heap, size_t size){
+	for(; size > 1; --size){
+		xPairwiseNeighbor root = heap[0];
+		PairwiseSiftDown(heap[size - 1], size - 1, heap);
+		heap[size - 1] = root;
+	}
+}
+
+// Only lanes at or under a row's current k-th distance leave the
+// registers, so after the first few blocks most tiles offer nothing. That
+// distance stays in a register and changes only after an offer.
+template<size_t Rows>
+__forceinline void PairwiseNearestRows(const Vec3SoA& a, const float* a_lengths, const Vec3SoA& b, const float* b_lengths,
+                                       size_t k, xPairwiseNeighbor* heaps, size_t* sizes, size_t row, size_t first, size_t last){
+	xLane limit[Rows];
+	for(size_t r = 0; r < Rows; ++r) limit[r] = LaneSet(sizes[r] == k ? heaps[r * k].squared : INFINITY);
+	LaneLoop(first, last, [&](size_t j, size_t n){
+		xLane distances[Rows];
+		PairwiseTile<Rows>(a, a_lengths, b, b_lengths, row, j, n, distances);
+		for(size_t r = 0; r < Rows; ++r){
+			uint32_t bits = ~LaneLessBits(limit[r], distances[r]) & LaneCountMask(n);
+			if(!bits) continue;
+			xPairwiseNeighbor* heap = heaps + r * k;
+			float lanes[kLaneWidth];
+			LaneStore(lanes, distances[r], kLaneWidth);
+			while(bits){
+				uint32_t c = LaneNextBit(&bits);
+				xPairwiseNeighbor candidate = { lanes[c], (uint32_t)(j + c) };
+				PairwiseOffer(candidate, k, heap, sizes + r);
+			}
+			if(sizes[r] == k) limit[r] = LaneSet(heap[0].squared);
+		}
+	});
+}
+
+inline void PairwiseNearestKernel(const Vec3SoA& a, const float* a_lengths, const Vec3SoA& b, const float* b_lengths,
+                                  size_t k, uint32_t* indices, float* squared_distances, size_t begin, size_t end){
+	if(!k) return;
+	xPairwiseNeighbor* heaps = (xPairwiseNeighbor*)_mm_malloc((end - begin) * k * sizeof(xPairwiseNeighbor), 64);
+	size_t* sizes = (size_t*)_mm_malloc((end - begin) * sizeof(size_t), 64);
+	for(size_t i = begin; i < end; ++i) sizes[i - begin] = 0;
+	for(size_t first = 0; first < b.count; first += kPairwiseColumns){
+		size_t last = first + kPairwiseColumns < b.count ? first + kPairwiseColumns : b.count;
+		size_t i = begin;
+		for(; i + kPairwiseRows <= end; i += kPairwiseRows)
+			PairwiseNearestRows<kPairwiseRows>(a, a_lengths, b, b_lengths, k, &heaps[(i - begin) * k], &sizes[i - begin], i, first, last);
+		for(; i < end; ++i)
+			PairwiseNearestRows<1>(a, a_lengths, b, b_lengths, k, &heaps[(i - begin) * k], &sizes[i - begin], i, first, last);
+	}
+	for(size_t i = begin; i < end; ++i){
+		xPairwiseNeighbor* heap = &heaps[(i - begin) * k];
+		size_t size = sizes[i - begin];
+		PairwiseSortHeap(heap, size);
+		for(size_t j = 0; j < k; ++j){
+			indices[i * k + j] = j < size ? heap[j].index : kPairwiseNoPoint;
+			if(squared_distances) squared_distances[i * k + j] = j < size ? heap[j].squared : INFINITY;
+		}
+	}
+	_mm_free(sizes);
+	_mm_free(heaps);
+}
+
+} // namespace XMATH_ISA
+
+// out[i stride + j] = |a[i] - b[j]|^2, for stride >= b.count. out holds
+// a.count rows; the floats past b.count in each row are left alone.
+template<typename Policy = xSequentialPolicy>
+inline void PairwiseSquaredDistances(const Vec3SoA& a, const Vec3SoA& b, float* out, size_t stride, Policy policy = Policy()){
+	assert(stride >= b.count);
+	std::vector<float> a_lengths(a.count + 1), b_lengths(b.count + 1);
+	DotProduct(a, a, &a_lengths[0], policy);
+	DotProduct(b, b, &b_lengths[0], policy);
+	ParallelFor(policy, a.count, kPairwiseGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(PairwiseDistances)(a, &a_lengths[0], b, &b_lengths[0], out, stride, begin, end);
+	});
+}
+
+// The k points of b nearest to each point of a, nearest first and the
+// lower index first between equals. Row i writes indices[i k, i k + k) and
+// the same range of squared_distances, which may be NULL. Rows with fewer
+// than k points in b are padded with kPairwiseNoPoint and INFINITY.
+template<typename Policy = xSequentialPolicy>
+inline void PairwiseNearest(const Vec3SoA& a, const Vec3SoA& b, size_t k, uint32_t* indices, float* squared_distances,
+                            Policy policy = Policy()){
+	std::vector<float> a_lengths(a.count + 1), b_lengths(b.count + 1);
+	DotProduct(a, a, &a_lengths[0], policy);
+	DotProduct(b, b, &b_lengths[0], policy);
+	ParallelFor(policy, a.count, kPairwiseGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(PairwiseNearest)(a, &a_lengths[0], b, &b_lengths[0], k, indices, squared_distances, begin, end);
+	});
+}
+
+#endif // __XPAIRWISE_H__
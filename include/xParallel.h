@@ -0,0 +1,345 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Work-Stealing Thread Pool.
+//--------------------------------------------------------------//
+//
+//   ParallelFor(policy, count, grain, kernel)
+//       kernel(begin, end) over [0, count)
+//   ParallelReduce(policy, count, grain, kernel, combine)
+//       combine() of kernel(begin, end) over [0, count)
+//   ParallelCompact(policy, count, grain, out, kernel)
+//       kernel(begin, end, out) appends to out, in index order
+//   ParallelInvoke(policy, a, b)
+//       a() and b(), for divide and conquer
+//
+//   kSequential makes each a single inline call of the kernel over [0, count):
+//   no pool, no atomics, nothing a hand-written loop would not do.
+//
+//   kParallel hands the range to one process-wide pool. Every
+//   thread owns a deque of ranges. A thread that takes a range
+//   larger than the grain splits it in half, pushes the upper half
+//   onto the bottom of its own deque and keeps the lower half.
+//   Idle threads steal from the top of the other deques, where the
+//   oldest and so the largest ranges sit. Range boundaries are
+//   multiples of the grain, and the grains below are multiples of
+//   64, so lane kernels only see a partial register at the very end
+//   and no two tasks write to one cache line.
+//
+//   The thread that calls ParallelFor works on its own range and
+//   then runs or steals queued tasks until the whole range is done.
+//   It never just blocks. A ParallelFor inside a kernel therefore
+//   feeds the same pool instead of starting threads of its own, so
+//   nesting never oversubscribes the machine.
+//
+//   The pool has std::thread::hardware_concurrency() threads,
+//   counting the caller. XMATH_THREADS=n in the environment sets n
+//   instead, for scaling runs. n may exceed the core count.
+//
+//--------------------------------------------------------------//
+#ifndef __XPARALLEL_H__
+#define __XPARALLEL_H__ 1
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Execution policies, taken by value as the last argument of the batch
+// functions.
+struct xSequentialPolicy {};
+
+struct xParallelPolicy {
+	// grain 0 keeps the default of the function it is passed to.
+	constexpr explicit xParallelPolicy(size_t grain = 0) : grain(grain) {}
+	size_t grain;
+};
+
+const xSequentialPolicy kSequential = xSequentialPolicy();
+const xParallelPolicy kParallel = xParallelPolicy();
+
+class xThreadPool {
+public:
+
+	static xThreadPool& Instance();
+
+	// Threads that run tasks, including the calling thread.
+	size_t Threads() const;
+
+	// kernel(begin, end) over [0, count) in ranges of at most grain items.
+	template<typename Kernel>
+	void For(size_t count, size_t grain, const Kernel& kernel);
+
+private:
+	struct Job {
+		void (*run)(const void* kernel, size_t begin, size_t end);
+		const void* kernel;
+		size_t grain;
+		std::atomic<size_t> remaining;
+	};
+
+	struct Task {
+		Job* job;
+		size_t begin;
+		size_t end;
+	};
+
+	struct Queue {
+		std::mutex lock;
+		std::deque<Task> tasks;
+	};
+
+	explicit xThreadPool(size_t threads);
+	~xThreadPool();
+	xThreadPool(const xThreadPool&) = delete;
+	xThreadPool& operator=(const xThreadPool&) = delete;
+
+	template<typename Kernel>
+	static void RunKernel(const void* kernel, size_t begin, size_t end);
+
+	static size_t& ThreadQueue();
+	size_t CurrentQueue() const;
+	void Push(size_t queue, const Task& task);
+	bool Pop(size_t queue, Task* task);
+	bool Steal(size_t thief, Task* task);
+	bool RunOne(size_t queue);
+	void Execute(size_t queue, Task task);
+	void WorkerMain(size_t queue);
+
+	// One queue per worker, plus a last one shared by threads outside the pool.
+	std::vector<Queue*> queues_;
+	std::vector<std::thread> workers_;
+	// Tasks sitting in any queue; workers sleep while it is zero.
+	std::atomic<size_t> queued_;
+	std::mutex sleep_lock_;
+	std::condition_variable wake_;
+	bool stop_;
+};
+
+const size_t kNoThreadQueue = (size_t)-1;
+
+inline size_t ThreadCount(){
+	const char* forced = getenv("XMATH_THREADS");
+	if(forced && atoi(forced) > 0) return (size_t)atoi(forced);
+	size_t threads = std::thread::hardware_concurrency();
+	return threads ? threads : 1;
+}
+
+inline xThreadPool& xThreadPool::Instance() {
+	static xThreadPool pool(ThreadCount());
+	return pool;
+}
+
+inline xThreadPool::xThreadPool(size_t threads) : queued_(0), stop_(false) {
+	for(size_t q = 0; q < threads; ++q) queues_.push_back(new Queue());
+	for(size_t q = 0; q + 1 < threads; ++q) workers_.push_back(std::thread(&xThreadPool::WorkerMain, this, q));
+}
+
+inline xThreadPool::~xThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(sleep_lock_);
+		stop_ = true;
+	}
+	wake_.notify_all();
+	for(size_t t = 0; t < workers_.size(); ++t) workers_[t].join();
+	for(size_t q = 0; q < queues_.size(); ++q) delete queues_[q];
+}
+
+inline size_t xThreadPool::Threads() const {
+	return queues_.size();
+}
+
+template<typename Kernel>
+inline void xThreadPool::RunKernel(const void* kernel, size_t begin, size_t end) {
+	(*(const Kernel*)kernel)(begin, end);
+}
+
+inline size_t& xThreadPool::ThreadQueue() {
+	static thread_local size_t queue = kNoThreadQueue;
+	return queue;
+}
+
+inline size_t xThreadPool::CurrentQueue() const {
+	size_t queue = ThreadQueue();
+	return queue == kNoThreadQueue ? queues_.size() - 1 : queue;
+}
+
+inline void xThreadPool::Push(size_t queue, const Task& task) {
+	{
+		std::lock_guard<std::mutex> lock(queues_[queue]->lock);
+		queues_[queue]->tasks.push_back(task);
+	}
+	queued_.fetch_add(1);
+	// Taking sleep_lock_ orders the increment against a worker that has
+	// just seen queued_ == 0 and is about to wait.
+	{ std::lock_guard<std::mutex> lock(sleep_lock_); }
+	wake_.notify_one();
+}
+
+inline bool xThreadPool::Pop(size_t queue, Task* task) {
+	std::lock_guard<std::mutex> lock(queues_[queue]->lock);
+	if(queues_[queue]->tasks.empty()) return false;
+	*task = queues_[queue]->tasks.back();
+	queues_[queue]->tasks.pop_back();
+	queued_.fetch_sub(1);
+	return true;
+}
+
+inline bool xThreadPool::Steal(size_t thief, Task* task) {
+	for(size_t k = 1; k < queues_.size(); ++k){
+		Queue* victim = queues_[(thief + k) % queues_.size()];
+		std::lock_guard<std::mutex> lock(victim->lock);
+		if(victim->tasks.empty()) continue;
+		*task = victim->tasks.front();
+		victim->tasks.pop_front();
+		queued_.fetch_sub(1);
+		return true;
+	}
+	return false;
+}
+
+inline bool xThreadPool::RunOne(size_t queue) {
+	Task task;
+	if(!Pop(queue, &task) && !Steal(queue, &task)) return false;
+	Execute(queue, task);
+	return true;
+}
+
+// The owner of a job returns once remaining reaches zero, so nothing may
+// touch the job after the final fetch_sub.
+inline void xThreadPool::Execute(size_t queue, Task task) {
+	Job* job = task.job;
+	while(task.end - task.begin > job->grain){
+		size_t blocks = (task.end - task.begin + job->grain - 1) / job->grain;
+		Task upper = { job, task.begin + blocks / 2 * job->grain, task.end };
+		Push(queue, upper);
+		task.end = upper.begin;
+	}
+	job->run(job->kernel, task.begin, task.end);
+	job->remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+}
+
+inline void xThreadPool::WorkerMain(size_t queue) {
+	ThreadQueue() = queue;
+	for(;;){
+		if(RunOne(queue)) continue;
+		std::unique_lock<std::mutex> lock(sleep_lock_);
+		wake_.wait(lock, [this](){ return stop_ || queued_.load() != 0; });
+		if(stop_) return;
+	}
+}
+
+template<typename Kernel>
+inline void xThreadPool::For(size_t count, size_t grain, const Kernel& kernel) {
+	if(grain == 0) grain = 1;
+	if(count <= grain || workers_.empty()){
+		kernel((size_t)0, count);
+		return;
+	}
+	Job job;
+	job.run = &RunKernel<Kernel>;
+	job.kernel = &kernel;
+	job.grain = grain;
+	job.remaining.store(count);
+
+	size_t queue = CurrentQueue();
+	Task all = { &job, 0, count };
+	Execute(queue, all);
+	while(job.remaining.load(std::memory_order_acquire) != 0){
+		if(!RunOne(queue)) std::this_thread::yield();
+	}
+}
+
+template<typename Kernel>
+__forceinline void ParallelFor(xSequentialPolicy, size_t count, size_t grain, const Kernel& kernel){
+	(void)grain;
+	kernel((size_t)0, count);
+}
+
+template<typename Kernel>
+inline void ParallelFor(const xParallelPolicy& policy, size_t count, size_t grain, const Kernel& kernel){
+	xThreadPool::Instance().For(count, policy.grain ? policy.grain : grain, kernel);
+}
+
+// Partial results are combined in index order, so the answer does not
+// depend on the thread count or on which thread ran which range.
+template<typename Kernel, typename Combine>
+__forceinline auto ParallelReduce(xSequentialPolicy, size_t count, size_t grain, const Kernel& kernel, Combine combine)
+    -> decltype(kernel((size_t)0, count)) {
+	(void)grain; (void)combine;
+	return kernel((size_t)0, count);
+}
+
+template<typename Kernel, typename Combine>
+inline auto ParallelReduce(const xParallelPolicy& policy, size_t count, size_t grain, const Kernel& kernel, Combine combine)
+    -> decltype(kernel((size_t)0, count)) {
+	typedef decltype(kernel((size_t)0, count)) Result;
+	if(policy.grain) grain = policy.grain;
+	if(grain == 0) grain = 1;
+	size_t blocks = (count + grain - 1) / grain;
+	if(blocks <= 1) return kernel((size_t)0, count);
+
+	std::vector<Result> partial(blocks);
+	xThreadPool::Instance().For(blocks, 1, [&](size_t first, size_t last){
+		for(size_t b = first; b < last; ++b)
+			partial[b] = kernel(b * grain, b + 1 < blocks ? (b + 1) * grain : count);
+	});
+	Result result = partial[0];
+	for(size_t b = 1; b < blocks; ++b) result = combine(result, partial[b]);
+	return result;
+}
+
+// For filters such as culling: kernel(begin, end, out) writes at most
+// end - begin items to out and returns how many. out must hold count items.
+// Each block writes to out + begin, then the blocks are slid down over the
+// gaps, so the result is the same as one sequential pass.
+template<typename T, typename Kernel>
+__forceinline size_t ParallelCompact(xSequentialPolicy, size_t count, size_t grain, T* out, const Kernel& kernel){
+	(void)grain;
+	return kernel((size_t)0, count, out);
+}
+
+template<typename T, typename Kernel>
+inline size_t ParallelCompact(const xParallelPolicy& policy, size_t count, size_t grain, T* out, const Kernel& kernel){
+	if(policy.grain) grain = policy.grain;
+	if(grain == 0) grain = 1;
+	size_t blocks = (count + grain - 1) / grain;
+	if(blocks <= 1) return kernel((size_t)0, count, out);
+
+	std::vector<size_t> written(blocks);
+	xThreadPool::Instance().For(blocks, 1, [&](size_t first, size_t last){
+		for(size_t b = first; b < last; ++b)
+			written[b] = kernel(b * grain, b + 1 < blocks ? (b + 1) * grain : count, out + b * grain);
+	});
+	size_t total = written[0];
+	for(size_t b = 1; b < blocks; ++b){
+		memmove(out + total, out + b * grain, written[b] * sizeof(T));
+		total += written[b];
+	}
+	return total;
+}
+
+// The two calls may run on different threads under xParallelPolicy; its
+// grain does not apply. Recursive callers fork only above a size of their
+// own choosing, since every fork is one task of the pool.
+template<typename A, typename B>
+__forceinline void ParallelInvoke(xSequentialPolicy, const A& a, const B& b){
+	a();
+	b();
+}
+
+template<typename A, typename B>
+inline void ParallelInvoke(const xParallelPolicy&, const A& a, const B& b){
+	xThreadPool::Instance().For(2, 1, [&](size_t begin, size_t end){
+		for(size_t k = begin; k < end; ++k){
+			if(k == 0) a();
+			else b();
+		}
+	});
+}
+
+#endif // __XPARALLEL_H__
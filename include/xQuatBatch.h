@@ -0,0 +1,126 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Batch Quaternion Blends.
+//--------------------------------------------------------------//
+//
+//   out[i] = Slerp(a[i], b[i], t[i])
+//
+//   Quat arrays stay in x y z w order in memory. Each step
+//   transposes kLaneWidth records into one register per component
+//   (4 pairs with SSE, 8 with AVX2, 16 with AVX-512), blends them
+//   with the same series as the single xQuaternion Slerp and
+//   transposes back. t is either one value for the whole batch or
+//   one value per pair.
+//
+//--------------------------------------------------------------//
+#ifndef __XQUATBATCH_H__
+#define __XQUATBATCH_H__ 1
+
+#include <stddef.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xQuaternion.h"
+#include "quaternion.h"
+
+// Items per task when a policy runs the blends in parallel.
+const size_t kQuatGrain = 8192;
+
+// Per-ISA kernels. t_step is 0 for a uniform t and 1 for one t per pair.
+inline namespace XMATH_ISA {
+
+__forceinline xLane __vectorcall LaneDot4(xLane ax, xLane ay, xLane az, xLane aw,
+                                          xLane bx, xLane by, xLane bz, xLane bw){
+	return LaneMultiplyAdd(aw, bw, LaneMultiplyAdd(az, bz, LaneMultiplyAdd(ay, by, LaneMul(ax, bx))));
+}
+
+__forceinline xLane LaneBlendFactor(const float* t, size_t t_step, size_t i, size_t n){
+	xLane s = t_step ? LaneLoad(t + i, n) : LaneSet(*t);
+	return LaneMin(LaneMax(s, LaneSet(0.0f)), LaneSet(1.0f));
+}
+
+// Lane form of SlerpWeight.
+__forceinline xLane __vectorcall LaneSlerpWeight(xLane t, xLane xm1){
+	xLane tt = LaneMul(t, t);
+	xLane one = LaneSet(1.0f);
+	xLane f = one;
+	for(int i = kSlerpTerms - 1; i >= 0; --i){
+		xLane b = LaneMul(LaneSub(LaneMul(LaneSet(kSlerpU[i]), tt), LaneSet(kSlerpV[i])), xm1);
+		f = LaneMultiplyAdd(b, f, one);
+	}
+	return LaneMul(t, f);
+}
+
+inline void SlerpQuatKernel(const Quat* a, const Quat* b, const float* t, size_t t_step, Quat* out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){
+		xLane ax, ay, az, aw, bx, by, bz, bw;
+		LaneLoadAoS4(&a[i].x, n, &ax, &ay, &az, &aw);
+		LaneLoadAoS4(&b[i].x, n, &bx, &by, &bz, &bw);
+		xLane s = LaneBlendFactor(t, t_step, i, n);
+		xLane dot = LaneDot4(ax, ay, az, aw, bx, by, bz, bw);
+		xLane sign = LaneAnd(dot, LaneSet(-0.0f));
+		xLane xm1 = LaneSub(LaneXor(dot, sign), LaneSet(1.0f));
+		xLane wa = LaneSlerpWeight(LaneSub(LaneSet(1.0f), s), xm1);
+		xLane wb = LaneXor(LaneSlerpWeight(s, xm1), sign);
+		LaneStoreAoS4(&out[i].x, n, LaneMultiplyAdd(bx, wb, LaneMul(ax, wa)),
+		                            LaneMultiplyAdd(by, wb, LaneMul(ay, wa)),
+		                            LaneMultiplyAdd(bz, wb, LaneMul(az, wa)),
+		                            LaneMultiplyAdd(bw, wb, LaneMul(aw, wa)));
+	});
+}
+
+template<int kPrecision>
+inline void NlerpQuatKernel(const Quat* a, const Quat* b, const float* t, size_t t_step, Quat* out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){
+		xLane ax, ay, az, aw, bx, by, bz, bw;
+		LaneLoadAoS4(&a[i].x, n, &ax, &ay, &az, &aw);
+		LaneLoadAoS4(&b[i].x, n, &bx, &by, &bz, &bw);
+		xLane s = LaneBlendFactor(t, t_step, i, n);
+		xLane sign = LaneAnd(LaneDot4(ax, ay, az, aw, bx, by, bz, bw), LaneSet(-0.0f));
+		xLane wa = LaneSub(LaneSet(1.0f), s);
+		xLane wb = LaneXor(s, sign);
+		xLane x = LaneMultiplyAdd(bx, wb, LaneMul(ax, wa));
+		xLane y = LaneMultiplyAdd(by, wb, LaneMul(ay, wa));
+		xLane z = LaneMultiplyAdd(bz, wb, LaneMul(az, wa));
+		xLane w = LaneMultiplyAdd(bw, wb, LaneMul(aw, wa));
+		xLane inverse = LaneReciprocalSqrt<kPrecision>(LaneDot4(x, y, z, w, x, y, z, w));
+		LaneStoreAoS4(&out[i].x, n, LaneMul(x, inverse), LaneMul(y, inverse),
+		                            LaneMul(z, inverse), LaneMul(w, inverse));
+	});
+}
+
+} // namespace XMATH_ISA
+
+// a, b and out hold count quaternions; out may alias a or b. a and b must
+// be unit length. t is clamped to [0, 1]. The trailing policy is
+// kSequential or kParallel (xParallel.h).
+template<typename Policy = xSequentialPolicy>
+inline void Slerp(const Quat* a, const Quat* b, float t, Quat* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kQuatGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SlerpQuat)(a + begin, b + begin, &t, 0, out + begin, end - begin);
+	});
+}
+
+// One t per pair.
+template<typename Policy = xSequentialPolicy>
+inline void Slerp(const Quat* a, const Quat* b, const float* t, Quat* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kQuatGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SlerpQuat)(a + begin, b + begin, t + begin, 1, out + begin, end - begin);
+	});
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void Nlerp(const Quat* a, const Quat* b, float t, Quat* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kQuatGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH_PRECISION(NlerpQuat, kPrecision)(a + begin, b + begin, &t, 0, out + begin, end - begin);
+	});
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void Nlerp(const Quat* a, const Quat* b, const float* t, Quat* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kQuatGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH_PRECISION(NlerpQuat, kPrecision)(a + begin, b + begin, t + begin, 1, out + begin, end - begin);
+	});
+}
+
+#endif // __XQUATBATCH_H__
@@ -0,0 +1,274 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  SSE Quaternion Definition.
+//--------------------------------------------------------------//
+//
+//   xmm = x y z w      q = w + xi + yj + zk
+//
+//   The vector part sits in the xyz lanes, so it can be handed to
+//   the xVector3 functions as is. Same memory order as Quat and Vec4,
+//   so converting either way is one unaligned load or store.
+//
+//--------------------------------------------------------------//
+#ifndef __XQUATERNION_H__
+#define __XQUATERNION_H__ 1
+
+#include <stdio.h>
+#include <xmmintrin.h>
+#include "xSimd.h"
+#include "xVector3.h"
+#include "xMatrix4.h"
+#include "vector_4.h"
+#include "quaternion.h"
+#include "math_utils.h"
+
+struct xQuaternion {
+
+	__forceinline xQuaternion() {}
+	__forceinline explicit xQuaternion(float x, float y, float z, float w) { xmm = _mm_setr_ps(x, y, z, w); }
+	__forceinline explicit xQuaternion(const float* p) { xmm = _mm_loadu_ps(p); }
+	__forceinline explicit xQuaternion(__m128 m) { xmm = m; }
+	__forceinline explicit xQuaternion(const Vec4& v) { xmm = _mm_loadu_ps(&v.x); }
+	__forceinline explicit xQuaternion(const Quat& q) { xmm = _mm_loadu_ps(&q.x); }
+
+	__forceinline static xQuaternion __vectorcall Identity() {
+		return xQuaternion(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	// axis must be unit length.
+	__forceinline static xQuaternion __vectorcall FromAxisAngle(xVector3 axis, float radians) {
+		__m128 v = _mm_mul_ps(axis.xmm, _mm_set1_ps(sinf(radians * 0.5f)));
+		__m128 zw = _mm_unpackhi_ps(v, _mm_set1_ps(cosf(radians * 0.5f)));
+		return xQuaternion(_mm_shuffle_ps(v, zw, _MM_SHUFFLE(1, 0, 1, 0)));
+	}
+
+	__forceinline float __vectorcall x() const { return _mm_cvtss_f32(xmm); }
+	__forceinline float __vectorcall y() const { return _mm_cvtss_f32(_mm_shuffle_ps(xmm, xmm, _MM_SHUFFLE(1, 1, 1, 1))); }
+	__forceinline float __vectorcall z() const { return _mm_cvtss_f32(_mm_shuffle_ps(xmm, xmm, _MM_SHUFFLE(2, 2, 2, 2))); }
+	__forceinline float __vectorcall w() const { return _mm_cvtss_f32(_mm_shuffle_ps(xmm, xmm, _MM_SHUFFLE(3, 3, 3, 3))); }
+
+	__forceinline void __vectorcall store(float* p) const { _mm_storeu_ps(p, xmm); }
+	__forceinline void __vectorcall store(Vec4* out) const { _mm_storeu_ps(&out->x, xmm); }
+	__forceinline void __vectorcall store(Quat* out) const { _mm_storeu_ps(&out->x, xmm); }
+
+	__forceinline Vec4 __vectorcall ToVec4() const {
+		Vec4 result;
+		store(&result);
+		return result;
+	}
+
+	__forceinline Quat __vectorcall ToQuat() const {
+		Quat result;
+		store(&result);
+		return result;
+	}
+
+	// The vector part; w is left in the fourth lane, which xVector3 ignores.
+	__forceinline xVector3 __vectorcall xyz() const { return xVector3(xmm); }
+
+	__forceinline float __vectorcall operator[] (size_t i) const { return xmm.m128_f32[i]; }
+	__forceinline float& __vectorcall operator[] (size_t i) { return xmm.m128_f32[i]; }
+
+	__m128 xmm;
+
+};
+
+inline namespace XMATH_ISA {
+
+__forceinline xQuaternion __vectorcall operator+(xQuaternion a, xQuaternion b){
+	a.xmm = _mm_add_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xQuaternion __vectorcall operator-(xQuaternion a, xQuaternion b){
+	a.xmm = _mm_sub_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xQuaternion __vectorcall operator-(xQuaternion a){
+	a.xmm = _mm_xor_ps(a.xmm, _mm_set1_ps(-0.0f));
+	return a;
+}
+
+// Hamilton product: a * b applies b first, then a.
+//
+//   x = aw bx + ax bw + ay bz - az by
+//   y = aw by - ax bz + ay bw + az bx
+//   z = aw bz + ax by - ay bx + az bw
+//   w = aw bw - ax bx - ay by - az bz
+__forceinline xQuaternion __vectorcall operator*(xQuaternion a, xQuaternion b){
+	const __m128 sign_x = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+	const __m128 sign_y = _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f);
+	const __m128 sign_z = _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+	__m128 b_wzyx = _mm_xor_ps(_mm_shuffle_ps(b.xmm, b.xmm, _MM_SHUFFLE(0, 1, 2, 3)), sign_x);
+	__m128 b_zwxy = _mm_xor_ps(_mm_shuffle_ps(b.xmm, b.xmm, _MM_SHUFFLE(1, 0, 3, 2)), sign_y);
+	__m128 b_yxwz = _mm_xor_ps(_mm_shuffle_ps(b.xmm, b.xmm, _MM_SHUFFLE(2, 3, 0, 1)), sign_z);
+	__m128 r0 = _mm_mul_ps(Splat<3>(a.xmm), b.xmm);
+	__m128 r1 = _mm_mul_ps(Splat<0>(a.xmm), b_wzyx);
+	r0 = MultiplyAdd(Splat<1>(a.xmm), b_zwxy, r0);
+	r1 = MultiplyAdd(Splat<2>(a.xmm), b_yxwz, r1);
+	a.xmm = _mm_add_ps(r0, r1);
+	return a;
+}
+
+__forceinline xQuaternion __vectorcall operator*(xQuaternion a, float b){
+	a.xmm = _mm_mul_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xQuaternion __vectorcall operator*(float a, xQuaternion b){
+	b.xmm = _mm_mul_ps(_mm_set1_ps(a), b.xmm);
+	return b;
+}
+
+__forceinline xQuaternion __vectorcall operator/(xQuaternion a, float b){
+	a.xmm = _mm_div_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xQuaternion& __vectorcall operator+=(xQuaternion& a, xQuaternion b) { a = a + b; return a; }
+__forceinline xQuaternion& __vectorcall operator-=(xQuaternion& a, xQuaternion b) { a = a - b; return a; }
+__forceinline xQuaternion& __vectorcall operator*=(xQuaternion& a, xQuaternion b) { a = a * b; return a; }
+__forceinline xQuaternion& __vectorcall operator*=(xQuaternion& a, float b) { a = a * b; return a; }
+__forceinline xQuaternion& __vectorcall operator/=(xQuaternion& a, float b) { a = a / b; return a; }
+
+// Exact comparison of all four components, like xMatrix4. q and -q are
+// the same rotation but compare unequal.
+__forceinline bool __vectorcall operator==(xQuaternion a, xQuaternion b){
+	return _mm_movemask_ps(_mm_cmpeq_ps(a.xmm, b.xmm)) == 0xF;
+}
+
+__forceinline bool __vectorcall operator!=(xQuaternion a, xQuaternion b){
+	return !(a == b);
+}
+
+__forceinline xQuaternion __vectorcall Conjugate(xQuaternion q){
+	q.xmm = _mm_xor_ps(q.xmm, _mm_setr_ps(-0.0f, -0.0f, -0.0f, 0.0f));
+	return q;
+}
+
+__forceinline __m128 __vectorcall DotProductV(xQuaternion a, xQuaternion b){
+	return Dot4(a.xmm, b.xmm);
+}
+
+__forceinline __m128 __vectorcall SqrMagnitudeV(xQuaternion q){
+	return Dot4(q.xmm, q.xmm);
+}
+
+__forceinline __m128 __vectorcall MagnitudeV(xQuaternion q){
+	return _mm_sqrt_ps(Dot4(q.xmm, q.xmm));
+}
+
+__forceinline float __vectorcall DotProduct(xQuaternion a, xQuaternion b){
+	return _mm_cvtss_f32(DotProductV(a, b));
+}
+
+__forceinline float __vectorcall SqrMagnitude(xQuaternion q){
+	return _mm_cvtss_f32(SqrMagnitudeV(q));
+}
+
+__forceinline float __vectorcall Magnitude(xQuaternion q){
+	return _mm_cvtss_f32(MagnitudeV(q));
+}
+
+template<int kPrecision = kPrecisionExact>
+__forceinline xQuaternion __vectorcall Normalize(xQuaternion q){
+	if(kPrecision == kPrecisionExact) return xQuaternion(_mm_div_ps(q.xmm, MagnitudeV(q)));
+	return xQuaternion(_mm_mul_ps(q.xmm, ReciprocalSqrt<kPrecision>(SqrMagnitudeV(q))));
+}
+
+// Conjugate / |q|^2. For unit quaternions Conjugate is the same and cheaper.
+template<int kPrecision = kPrecisionExact>
+__forceinline xQuaternion __vectorcall Inverse(xQuaternion q){
+	return xQuaternion(_mm_mul_ps(Conjugate(q).xmm, Reciprocal<kPrecision>(SqrMagnitudeV(q))));
+}
+
+// v + w * t + u x t with u = q.xyz and t = 2 * (u x v). The w lane of v
+// passes through unchanged.
+__forceinline xVector3 __vectorcall Rotate(xQuaternion q, xVector3 v){
+	__m128 t = Cross3(q.xmm, v.xmm);
+	t = _mm_add_ps(t, t);
+	__m128 r = MultiplyAdd(Splat<3>(q.xmm), t, v.xmm);
+	return xVector3(_mm_add_ps(r, Cross3(q.xmm, t)));
+}
+
+// Same matrix as Quat::ToMat4, so a pure rotation about one axis equals
+// xMatrix4(Mat4::RotateX/Y/Z).
+__forceinline xMatrix4 __vectorcall ToXMatrix4(xQuaternion q){
+	float x = q.x(), y = q.y(), z = q.z(), w = q.w();
+	float x2 = x + x, y2 = y + y, z2 = z + z;
+	float xx = x * x2, yy = y * y2, zz = z * z2;
+	float xy = x * y2, xz = x * z2, yz = y * z2;
+	float wx = w * x2, wy = w * y2, wz = w * z2;
+	return xMatrix4(_mm_setr_ps(1.0f - (yy + zz), xy - wz, xz + wy, 0.0f),
+	                _mm_setr_ps(xy + wz, 1.0f - (xx + zz), yz - wx, 0.0f),
+	                _mm_setr_ps(xz - wy, yz + wx, 1.0f - (xx + yy), 0.0f),
+	                _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+// Sign bit of a.b in every lane; xor with it turns b into the quaternion
+// on a's side of the 4D sphere, so the blends take the shorter arc.
+__forceinline __m128 __vectorcall ShortestArcSign(xQuaternion a, xQuaternion b){
+	return _mm_and_ps(DotProductV(a, b), _mm_set1_ps(-0.0f));
+}
+
+// Normalized linear blend; cheaper than Slerp but not constant speed.
+// t clamped to [0, 1].
+template<int kPrecision = kPrecisionExact>
+__forceinline xQuaternion __vectorcall Nlerp(xQuaternion a, xQuaternion b, float t){
+	__m128 s = _mm_set1_ps(MathUtils::Clamp(t, 0.0f, 1.0f));
+	b.xmm = _mm_xor_ps(b.xmm, ShortestArcSign(a, b));
+	return Normalize<kPrecision>(xQuaternion(MultiplyAdd(_mm_sub_ps(b.xmm, a.xmm), s, a.xmm)));
+}
+
+// Eberly, "A Fast and Accurate Algorithm for Computing SLERP". The
+// weights sin((1 - t) theta) / sin(theta) and sin(t theta) / sin(theta)
+// are expanded as a series in cos(theta) - 1, cut at kSlerpTerms terms
+// with the last one rescaled by mu to spread the truncation error. No
+// trig, no divide and no branch for nearly parallel inputs. The series
+// is within 3.3e-7 of the exact weights for cos(theta) in [0, 1]; 8
+// terms would leave 2e-5.
+const int kSlerpTerms = 13;
+const float kSlerpMu = 1.90110745351730037f;
+const float kSlerpU[kSlerpTerms] = {
+	1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9), 1.0f / (5 * 11),
+	1.0f / (6 * 13), 1.0f / (7 * 15), 1.0f / (8 * 17), 1.0f / (9 * 19), 1.0f / (10 * 21),
+	1.0f / (11 * 23), 1.0f / (12 * 25), kSlerpMu / (13 * 27)
+};
+const float kSlerpV[kSlerpTerms] = {
+	1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9, 5.0f / 11,
+	6.0f / 13, 7.0f / 15, 8.0f / 17, 9.0f / 19, 10.0f / 21,
+	11.0f / 23, 12.0f / 25, kSlerpMu * 13 / 27
+};
+
+// t * (1 + b0 (1 + b1 (... (1 + b12)))) with bi = (u[i] t^2 - v[i]) (x - 1).
+__forceinline __m128 __vectorcall SlerpWeight(__m128 t, __m128 xm1){
+	__m128 tt = _mm_mul_ps(t, t);
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 f = one;
+	for(int i = kSlerpTerms - 1; i >= 0; --i){
+		__m128 b = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(kSlerpU[i]), tt), _mm_set1_ps(kSlerpV[i])), xm1);
+		f = MultiplyAdd(b, f, one);
+	}
+	return _mm_mul_ps(t, f);
+}
+
+// Constant angular speed along the shorter arc. t clamped to [0, 1];
+// a and b must be unit length.
+__forceinline xQuaternion __vectorcall Slerp(xQuaternion a, xQuaternion b, float t){
+	__m128 s = _mm_set1_ps(MathUtils::Clamp(t, 0.0f, 1.0f));
+	__m128 sign = ShortestArcSign(a, b);
+	__m128 xm1 = _mm_sub_ps(_mm_xor_ps(DotProductV(a, b), sign), _mm_set1_ps(1.0f));
+	__m128 wa = SlerpWeight(_mm_sub_ps(_mm_set1_ps(1.0f), s), xm1);
+	__m128 wb = _mm_xor_ps(SlerpWeight(s, xm1), sign);
+	return xQuaternion(MultiplyAdd(b.xmm, wb, _mm_mul_ps(a.xmm, wa)));
+}
+
+} // namespace XMATH_ISA
+
+inline void Print(xQuaternion* p){
+	float* pointer = (float*)&p->xmm;
+	printf("X[%f] Y[%f] Z[%f] W[%f] \n", pointer[0], pointer[1], pointer[2], pointer[3]);
+}
+
+#endif // __XQUATERNION_H__
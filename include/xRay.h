@@ -0,0 +1,451 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Ray Intersection.
+//--------------------------------------------------------------//
+//
+//   origin + t * direction,   t_min <= t < t_max
+//
+//   A Segment is the ray from start with direction end - start and
+//   t in [0, 1]. Directions need not be unit length; t is measured
+//   in multiples of the direction.
+//
+//   Two batch shapes:
+//
+//   One ray, many primitives   IntersectTriangles, IntersectBoxes,
+//                              IntersectSpheres. One primitive per
+//                              lane; the nearest hit wins.
+//   Many rays, one primitive   IntersectTriangle, IntersectBox,
+//                              IntersectSphere over a RaySoA. One ray
+//                              per lane, 4 with SSE, 8 with AVX2, 16
+//                              with AVX-512; a closer hit replaces the
+//                              ray's entry in hits.
+//
+//   Triangles use Moller-Trumbore on a TriangleSoA that keeps the
+//   first vertex and both edges, so the loop does no subtraction of
+//   vertices. Boxes use the slab test and report where the ray
+//   enters (t_min when it starts inside). Spheres report the first
+//   crossing at or after t_min. The lanes compute every candidate
+//   and turn the accept tests into a bit mask; only masks with bits
+//   set, which are rare, leave the vector loop. Equal t goes to the
+//   lower index, so the answer does not depend on the lane width or
+//   on the thread count.
+//
+//--------------------------------------------------------------//
+#ifndef __XRAY_H__
+#define __XRAY_H__ 1
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xBounds.h"
+#include "xVec3SoA.h"
+#include "vector_3.h"
+
+// Primitives or rays per task when a policy intersects in parallel.
+const size_t kRayGrain = 8192;
+// Index of a RayHit that hit nothing.
+const uint32_t kNoHit = 0xFFFFFFFFu;
+// Triangles whose determinant is smaller than this in magnitude are
+// taken as parallel to the ray.
+const float kRayParallelEpsilon = 1.0e-12f;
+
+struct Segment {
+	Segment(const Vec3& start, const Vec3& end) : start(start), end(end) {}
+	Vec3 start;
+	Vec3 end;
+};
+
+struct Ray {
+	__forceinline Ray(const Vec3& origin, const Vec3& direction, float t_min = 0.0f, float t_max = INFINITY)
+		: origin(origin), direction(direction), t_min(t_min), t_max(t_max) {}
+	// Implicit, so segments go wherever rays do.
+	Ray(const Segment& segment)
+		: origin(segment.start), direction(segment.end - segment.start), t_min(0.0f), t_max(1.0f) {}
+
+	Vec3 At(float t) const { return origin + direction * t; }
+
+	Vec3 origin;
+	Vec3 direction;
+	float t_min;
+	float t_max;
+};
+
+// u and v are the barycentric weights of the second and third triangle
+// vertices; they are zero for boxes and spheres.
+struct RayHit {
+	__forceinline RayHit() : t(INFINITY), u(0.0f), v(0.0f), index(kNoHit) {}
+	__forceinline explicit RayHit(float t_max) : t(t_max), u(0.0f), v(0.0f), index(kNoHit) {}
+	__forceinline RayHit(float t, float u, float v, uint32_t index) : t(t), u(u), v(v), index(index) {}
+
+	__forceinline bool IsHit() const { return index != kNoHit; }
+
+	float t;
+	float u;
+	float v;
+	uint32_t index;
+};
+
+// Rays as streams. All rays start at t_min; the far limit of ray i is
+// hits[i].t in the packet functions, so start each hit as RayHit(t_max).
+struct RaySoA {
+	RaySoA() : t_min(0.0f) {}
+	explicit RaySoA(size_t size) : origin(size), direction(size), t_min(0.0f) {}
+
+	size_t Count() const { return origin.count; }
+	void Resize(size_t size) { origin.Resize(size); direction.Resize(size); }
+	void Set(size_t i, const Ray& ray) { origin.Set(i, ray.origin); direction.Set(i, ray.direction); }
+
+	Vec3SoA origin;
+	Vec3SoA direction;
+	float t_min;
+};
+
+// Triangle i is vertex[i], vertex[i] + edge1[i], vertex[i] + edge2[i].
+struct TriangleSoA {
+	TriangleSoA() {}
+	explicit TriangleSoA(size_t size) : vertex(size), edge1(size), edge2(size) {}
+	// Triangle i is vertices[indices[3 i]], vertices[indices[3 i + 1]],
+	// vertices[indices[3 i + 2]].
+	TriangleSoA(const Vec3* vertices, const uint32_t* indices, size_t triangles)
+		: vertex(triangles), edge1(triangles), edge2(triangles) {
+		for(size_t i = 0; i < triangles; ++i)
+			Set(i, vertices[indices[i * 3]], vertices[indices[i * 3 + 1]], vertices[indices[i * 3 + 2]]);
+	}
+
+	size_t Count() const { return vertex.count; }
+	void Resize(size_t size) { vertex.Resize(size); edge1.Resize(size); edge2.Resize(size); }
+	// Component-wise, so refits of large meshes build no Vec3 temporaries.
+	void Set(size_t i, const Vec3& a, const Vec3& b, const Vec3& c) {
+		vertex.x[i] = a.x; vertex.y[i] = a.y; vertex.z[i] = a.z;
+		edge1.x[i] = b.x - a.x; edge1.y[i] = b.y - a.y; edge1.z[i] = b.z - a.z;
+		edge2.x[i] = c.x - a.x; edge2.y[i] = c.y - a.y; edge2.z[i] = c.z - a.z;
+	}
+
+	Vec3SoA vertex;
+	Vec3SoA edge1;
+	Vec3SoA edge2;
+};
+
+// Single ray, single primitive. Each returns true and overwrites hit
+// when it finds a hit at t_min <= t < hit->t; the search starts from
+// ray.t_max when hit->t is larger.
+inline bool IntersectTriangle(const Ray& ray, const Vec3& a, const Vec3& b, const Vec3& c, uint32_t index, RayHit* hit){
+	Vec3 e1 = b - a, e2 = c - a;
+	Vec3 p = Vec3::CrossProduct(ray.direction, e2);
+	float det = Vec3::DotProduct(e1, p);
+	if(fabsf(det) <= kRayParallelEpsilon) return false;
+	float inverse = 1.0f / det;
+	Vec3 s = ray.origin - a;
+	float u = Vec3::DotProduct(s, p) * inverse;
+	Vec3 q = Vec3::CrossProduct(s, e1);
+	float v = Vec3::DotProduct(ray.direction, q) * inverse;
+	float t = Vec3::DotProduct(e2, q) * inverse;
+	float limit = hit->t < ray.t_max ? hit->t : ray.t_max;
+	if(!(u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= ray.t_min && t < limit)) return false;
+	*hit = RayHit(t, u, v, index);
+	return true;
+}
+
+inline bool IntersectBox(const Ray& ray, const AABB& box, uint32_t index, RayHit* hit){
+	const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+	const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+	const float low[3] = { box.min.x, box.min.y, box.min.z };
+	const float high[3] = { box.max.x, box.max.y, box.max.z };
+	float limit = hit->t < ray.t_max ? hit->t : ray.t_max;
+	float t_near = ray.t_min, t_far = limit;
+	for(int a = 0; a < 3; ++a){
+		float inverse = 1.0f / direction[a];
+		float t0 = (low[a] - origin[a]) * inverse, t1 = (high[a] - origin[a]) * inverse;
+		t_near = fmaxf(t_near, fminf(t0, t1));
+		t_far = fminf(t_far, fmaxf(t0, t1));
+	}
+	if(!(t_near <= t_far && t_near < limit)) return false;
+	*hit = RayHit(t_near, 0.0f, 0.0f, index);
+	return true;
+}
+
+inline bool IntersectSphere(const Ray& ray, const Sphere& sphere, uint32_t index, RayHit* hit){
+	Vec3 offset = ray.origin - sphere.center;
+	float a = ray.direction.SqrMagnitude();
+	float b = Vec3::DotProduct(offset, ray.direction);
+	float c = offset.SqrMagnitude() - sphere.radius * sphere.radius;
+	float discriminant = b * b - a * c;
+	if(discriminant < 0.0f) return false;
+	float root = sqrtf(discriminant);
+	float t = (-b - root) / a;
+	if(t < ray.t_min) t = (-b + root) / a;
+	float limit = hit->t < ray.t_max ? hit->t : ray.t_max;
+	if(!(t >= ray.t_min && t < limit)) return false;
+	*hit = RayHit(t, 0.0f, 0.0f, index);
+	return true;
+}
+
+inline RayHit NearerHit(const RayHit& a, const RayHit& b){
+	return b.t < a.t ? b : a;
+}
+
+// Per-ISA kernels. The one-ray kernels return the nearest hit among
+// primitives [begin, end) below ray.t_max; the packet kernels update
+// hits[begin, end).
+inline namespace XMATH_ISA {
+
+// Bits of the lanes where t_min <= t < limit.
+__forceinline uint32_t __vectorcall LaneRangeBits(xLane t, xLane t_min, xLane limit){
+	return ~LaneLessBits(t, t_min) & LaneLessBits(t, limit);
+}
+
+// Moller-Trumbore with the triangle and the ray in lanes, either of
+// which may be broadcast. Returns the bits of the lanes that pass every
+// test except the t range.
+__forceinline uint32_t LaneTriangle(const xLane o[3], const xLane d[3], const xLane v0[3], const xLane e1[3], const xLane e2[3],
+                                    xLane* t, xLane* u, xLane* v){
+	const xLane zero = LaneSet(0.0f), one = LaneSet(1.0f), epsilon = LaneSet(kRayParallelEpsilon);
+	xLane px = LaneSub(LaneMul(d[1], e2[2]), LaneMul(d[2], e2[1]));
+	xLane py = LaneSub(LaneMul(d[2], e2[0]), LaneMul(d[0], e2[2]));
+	xLane pz = LaneSub(LaneMul(d[0], e2[1]), LaneMul(d[1], e2[0]));
+	xLane det = LaneMultiplyAdd(e1[2], pz, LaneMultiplyAdd(e1[1], py, LaneMul(e1[0], px)));
+	xLane inverse = LaneDiv(one, det);
+	xLane sx = LaneSub(o[0], v0[0]), sy = LaneSub(o[1], v0[1]), sz = LaneSub(o[2], v0[2]);
+	*u = LaneMul(LaneMultiplyAdd(sz, pz, LaneMultiplyAdd(sy, py, LaneMul(sx, px))), inverse);
+	xLane qx = LaneSub(LaneMul(sy, e1[2]), LaneMul(sz, e1[1]));
+	xLane qy = LaneSub(LaneMul(sz, e1[0]), LaneMul(sx, e1[2]));
+	xLane qz = LaneSub(LaneMul(sx, e1[1]), LaneMul(sy, e1[0]));
+	*v = LaneMul(LaneMultiplyAdd(d[2], qz, LaneMultiplyAdd(d[1], qy, LaneMul(d[0], qx))), inverse);
+	*t = LaneMul(LaneMultiplyAdd(e2[2], qz, LaneMultiplyAdd(e2[1], qy, LaneMul(e2[0], qx))), inverse);
+	uint32_t parallel = ~(LaneLessBits(epsilon, det) | LaneLessBits(det, LaneSub(zero, epsilon)));
+	uint32_t outside = LaneLessBits(*u, zero) | LaneLessBits(*v, zero) | LaneLessBits(one, LaneAdd(*u, *v));
+	return ~(parallel | outside);
+}
+
+// Slab test with precomputed reciprocal directions; *t is the entry t,
+// clamped to t_min. Returns the bits of the lanes where the ray crosses
+// the box before limit.
+__forceinline uint32_t LaneBox(const xLane o[3], const xLane inverse[3], const xLane low[3], const xLane high[3],
+                               xLane t_min, xLane limit, xLane* t){
+	xLane t_near = t_min, t_far = limit;
+	for(int a = 0; a < 3; ++a){
+		xLane t0 = LaneMul(LaneSub(low[a], o[a]), inverse[a]);
+		xLane t1 = LaneMul(LaneSub(high[a], o[a]), inverse[a]);
+		t_near = LaneMax(t_near, LaneMin(t0, t1));
+		t_far = LaneMin(t_far, LaneMax(t0, t1));
+	}
+	*t = t_near;
+	return ~LaneLessBits(t_far, t_near) & LaneLessBits(t_near, limit);
+}
+
+// First crossing of the sphere at or after t_min, in *t.
+__forceinline uint32_t LaneSphere(const xLane o[3], const xLane d[3], const xLane center[3], xLane radius,
+                                  xLane t_min, xLane limit, xLane* t){
+	xLane ox = LaneSub(o[0], center[0]), oy = LaneSub(o[1], center[1]), oz = LaneSub(o[2], center[2]);
+	xLane a = LaneMultiplyAdd(d[2], d[2], LaneMultiplyAdd(d[1], d[1], LaneMul(d[0], d[0])));
+	xLane b = LaneMultiplyAdd(oz, d[2], LaneMultiplyAdd(oy, d[1], LaneMul(ox, d[0])));
+	xLane c = LaneSub(LaneMultiplyAdd(oz, oz, LaneMultiplyAdd(oy, oy, LaneMul(ox, ox))), LaneMul(radius, radius));
+	xLane discriminant = LaneSub(LaneMul(b, b), LaneMul(a, c));
+	uint32_t missed = LaneLessBits(discriminant, LaneSet(0.0f));
+	xLane root = LaneSqrt(LaneMax(discriminant, LaneSet(0.0f)));
+	xLane inverse_a = LaneDiv(LaneSet(1.0f), a);
+	xLane t_near = LaneMul(LaneSub(LaneSub(LaneSet(0.0f), b), root), inverse_a);
+	xLane t_far = LaneMul(LaneAdd(LaneSub(LaneSet(0.0f), b), root), inverse_a);
+	// t_far where t_near is behind t_min.
+	*t = LaneSelectLess(t_near, t_min, t_far, t_near);
+	return ~missed & LaneRangeBits(*t, t_min, limit);
+}
+
+// Scans the bits in lane order and keeps the first strictly nearer hit.
+__forceinline void KeepNearest(uint32_t bits, size_t i, xLane t, xLane u, xLane v, RayHit* best){
+	float ts[kLaneWidth], us[kLaneWidth], vs[kLaneWidth];
+	LaneStore(ts, t, kLaneWidth);
+	LaneStore(us, u, kLaneWidth);
+	LaneStore(vs, v, kLaneWidth);
+	for(size_t k = 0; k < kLaneWidth; ++k)
+		if(((bits >> k) & 1) && ts[k] < best->t) *best = RayHit(ts[k], us[k], vs[k], (uint32_t)(i + k));
+}
+
+// Writes the hit of every lane in bits to hits[i + lane].
+__forceinline void StoreHits(uint32_t bits, size_t i, xLane t, xLane u, xLane v, uint32_t index, RayHit* hits){
+	float ts[kLaneWidth], us[kLaneWidth], vs[kLaneWidth];
+	LaneStore(ts, t, kLaneWidth);
+	LaneStore(us, u, kLaneWidth);
+	LaneStore(vs, v, kLaneWidth);
+	for(size_t k = 0; k < kLaneWidth; ++k)
+		if((bits >> k) & 1) hits[i + k] = RayHit(ts[k], us[k], vs[k], index);
+}
+
+__forceinline void LaneBroadcast(const Vec3& v, xLane out[3]){
+	out[0] = LaneSet(v.x); out[1] = LaneSet(v.y); out[2] = LaneSet(v.z);
+}
+
+__forceinline void LaneLoadVec3(const Vec3SoA& stream, size_t i, size_t n, xLane out[3]){
+	out[0] = LaneLoad(stream.x + i, n); out[1] = LaneLoad(stream.y + i, n); out[2] = LaneLoad(stream.z + i, n);
+}
+
+// The t field of hits[i, i + n), the far limit of each ray.
+__forceinline xLane LaneLoadLimits(const RayHit* hits, size_t n){
+	xLane t, u, v, index;
+	LaneLoadAoS4((const float*)hits, n, &t, &u, &v, &index);
+	return t;
+}
+
+inline RayHit IntersectTrianglesKernel(const Ray& ray, const TriangleSoA& triangles, size_t begin, size_t end){
+	xLane o[3], d[3];
+	LaneBroadcast(ray.origin, o);
+	LaneBroadcast(ray.direction, d);
+	const xLane t_min = LaneSet(ray.t_min);
+	RayHit best(ray.t_max);
+	xLane limit = LaneSet(best.t);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane v0[3], e1[3], e2[3], t, u, v;
+		LaneLoadVec3(triangles.vertex, i, n, v0);
+		LaneLoadVec3(triangles.edge1, i, n, e1);
+		LaneLoadVec3(triangles.edge2, i, n, e2);
+		uint32_t bits = LaneTriangle(o, d, v0, e1, e2, &t, &u, &v) & LaneRangeBits(t, t_min, limit) & LaneCountMask(n);
+		if(!bits) return;
+		KeepNearest(bits, i, t, u, v, &best);
+		limit = LaneSet(best.t);
+	});
+	return best;
+}
+
+inline RayHit IntersectBoxesKernel(const Ray& ray, const Vec3SoA& min, const Vec3SoA& max, size_t begin, size_t end){
+	xLane o[3], inverse[3];
+	LaneBroadcast(ray.origin, o);
+	LaneBroadcast(Vec3(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z), inverse);
+	const xLane t_min = LaneSet(ray.t_min), zero = LaneSet(0.0f);
+	RayHit best(ray.t_max);
+	xLane limit = LaneSet(best.t);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane low[3], high[3], t;
+		LaneLoadVec3(min, i, n, low);
+		LaneLoadVec3(max, i, n, high);
+		uint32_t bits = LaneBox(o, inverse, low, high, t_min, limit, &t) & LaneCountMask(n);
+		if(!bits) return;
+		KeepNearest(bits, i, t, zero, zero, &best);
+		limit = LaneSet(best.t);
+	});
+	return best;
+}
+
+inline RayHit IntersectSpheresKernel(const Ray& ray, const Vec3SoA& centers, const float* radii, size_t begin, size_t end){
+	xLane o[3], d[3];
+	LaneBroadcast(ray.origin, o);
+	LaneBroadcast(ray.direction, d);
+	const xLane t_min = LaneSet(ray.t_min), zero = LaneSet(0.0f);
+	RayHit best(ray.t_max);
+	xLane limit = LaneSet(best.t);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane center[3], t;
+		LaneLoadVec3(centers, i, n, center);
+		uint32_t bits = LaneSphere(o, d, center, LaneLoad(radii + i, n), t_min, limit, &t) & LaneCountMask(n);
+		if(!bits) return;
+		KeepNearest(bits, i, t, zero, zero, &best);
+		limit = LaneSet(best.t);
+	});
+	return best;
+}
+
+inline void IntersectTrianglePacketKernel(const RaySoA& rays, const Vec3& a, const Vec3& b, const Vec3& c, uint32_t index,
+                                          RayHit* hits, size_t begin, size_t end){
+	xLane v0[3], e1[3], e2[3];
+	LaneBroadcast(a, v0);
+	LaneBroadcast(b - a, e1);
+	LaneBroadcast(c - a, e2);
+	const xLane t_min = LaneSet(rays.t_min);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane o[3], d[3], t, u, v;
+		LaneLoadVec3(rays.origin, i, n, o);
+		LaneLoadVec3(rays.direction, i, n, d);
+		xLane limit = LaneLoadLimits(hits + i, n);
+		uint32_t bits = LaneTriangle(o, d, v0, e1, e2, &t, &u, &v) & LaneRangeBits(t, t_min, limit) & LaneCountMask(n);
+		if(bits) StoreHits(bits, i, t, u, v, index, hits);
+	});
+}
+
+inline void IntersectBoxPacketKernel(const RaySoA& rays, const AABB& box, uint32_t index, RayHit* hits, size_t begin, size_t end){
+	xLane low[3], high[3];
+	LaneBroadcast(box.min, low);
+	LaneBroadcast(box.max, high);
+	const xLane t_min = LaneSet(rays.t_min), one = LaneSet(1.0f), zero = LaneSet(0.0f);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane o[3], d[3], inverse[3], t;
+		LaneLoadVec3(rays.origin, i, n, o);
+		LaneLoadVec3(rays.direction, i, n, d);
+		for(int k = 0; k < 3; ++k) inverse[k] = LaneDiv(one, d[k]);
+		xLane limit = LaneLoadLimits(hits + i, n);
+		uint32_t bits = LaneBox(o, inverse, low, high, t_min, limit, &t) & LaneCountMask(n);
+		if(bits) StoreHits(bits, i, t, zero, zero, index, hits);
+	});
+}
+
+inline void IntersectSpherePacketKernel(const RaySoA& rays, const Sphere& sphere, uint32_t index, RayHit* hits,
+                                        size_t begin, size_t end){
+	xLane center[3];
+	LaneBroadcast(sphere.center, center);
+	const xLane radius = LaneSet(sphere.radius), t_min = LaneSet(rays.t_min), zero = LaneSet(0.0f);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane o[3], d[3], t;
+		LaneLoadVec3(rays.origin, i, n, o);
+		LaneLoadVec3(rays.direction, i, n, d);
+		xLane limit = LaneLoadLimits(hits + i, n);
+		uint32_t bits = LaneSphere(o, d, center, radius, t_min, limit, &t) & LaneCountMask(n);
+		if(bits) StoreHits(bits, i, t, zero, zero, index, hits);
+	});
+}
+
+} // namespace XMATH_ISA
+
+// The nearest hit of ray among the triangles, with t_min <= t < t_max;
+// index is kNoHit when there is none.
+template<typename Policy = xSequentialPolicy>
+inline RayHit IntersectTriangles(const Ray& ray, const TriangleSoA& triangles, Policy policy = Policy()){
+	return ParallelReduce(policy, triangles.Count(), kRayGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(IntersectTriangles)(ray, triangles, begin, end);
+	}, NearerHit);
+}
+
+// Boxes run from min[i] to max[i]; t is where the ray enters box i.
+template<typename Policy = xSequentialPolicy>
+inline RayHit IntersectBoxes(const Ray& ray, const Vec3SoA& min, const Vec3SoA& max, Policy policy = Policy()){
+	assert(min.count == max.count);
+	return ParallelReduce(policy, min.count, kRayGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(IntersectBoxes)(ray, min, max, begin, end);
+	}, NearerHit);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline RayHit IntersectSpheres(const Ray& ray, const Vec3SoA& centers, const float* radii, Policy policy = Policy()){
+	return ParallelReduce(policy, centers.count, kRayGrain, [&](size_t begin, size_t end){
+		return XMATH_DISPATCH(IntersectSpheres)(ray, centers, radii, begin, end);
+	}, NearerHit);
+}
+
+// Tests every ray of rays against one triangle. hits holds rays.Count()
+// entries; where the triangle is hit before hits[i].t, hits[i] becomes
+// that hit with the given index. Call once per primitive to trace a
+// packet through a list.
+template<typename Policy = xSequentialPolicy>
+inline void IntersectTriangle(const RaySoA& rays, const Vec3& a, const Vec3& b, const Vec3& c, uint32_t index, RayHit* hits,
+                              Policy policy = Policy()){
+	ParallelFor(policy, rays.Count(), kRayGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(IntersectTrianglePacket)(rays, a, b, c, index, hits, begin, end);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void IntersectBox(const RaySoA& rays, const AABB& box, uint32_t index, RayHit* hits, Policy policy = Policy()){
+	ParallelFor(policy, rays.Count(), kRayGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(IntersectBoxPacket)(rays, box, index, hits, begin, end);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void IntersectSphere(const RaySoA& rays, const Sphere& sphere, uint32_t index, RayHit* hits, Policy policy = Policy()){
+	ParallelFor(policy, rays.Count(), kRayGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(IntersectSpherePacket)(rays, sphere, index, hits, begin, end);
+	});
+}
+
+#endif // __XRAY_H__
@@ -0,0 +1,451 @@
+#ifndef __XSIMD_H__
+#define __XSIMD_H__ 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <intrin.h>
+#include <xmmintrin.h>
+#include <immintrin.h>
+
+// Code whose instructions depend on /arch lives in an inline namespace named
+// after the ISA the translation unit targets, so each kernel object
+// (src/kernels) has its own copy under its own names. That is every
+// function that calls into XMATH_ISA or tests the ISA macros, including
+// the operators and free functions of the x types, which callers still
+// find unqualified. Global inline functions therefore read the same in
+// every object: the members of the x types (loads, stores, lane moves)
+// and the accessors of the spatial structures, which kernels may call,
+// and the containers, builders and thread pool, which only the wrappers
+// use. Out of line, one of those members emitted by the AVX2 object would
+// still carry AVX encodings, so the kernel objects are built with
+// inlining on (/O2 /Ob1, build/).
+#if defined(__AVX512F__)
+#define XMATH_ISA avx512
+#elif defined(__AVX2__)
+#define XMATH_ISA avx2
+#else
+#define XMATH_ISA sse2
+#endif
+
+// MSVC has no /arch switch for SSE4.1; /arch:AVX and up imply it.
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define XMATH_SSE41 1
+#endif
+
+// Precision tiers for the functions that take a kPrecision template
+// parameter. Bounds are relative unless stated otherwise and hold for
+// finite, nonzero, non-denormal inputs:
+//
+//   Exact    IEEE divide, sqrt and acosf; what the Vec3 path computes.
+//   Fast     Reciprocal and reciprocal sqrt: estimate plus one
+//            Newton-Raphson step, within 2^-21. Acos: 8-term
+//            polynomial, within 1.0e-6 rad absolute.
+//   Fastest  Reciprocal and reciprocal sqrt: raw estimate, within
+//            1.5 * 2^-12 (2^-14 under AVX-512). Acos: 4-term
+//            polynomial, within 8.0e-5 rad absolute.
+enum xPrecision {
+	kPrecisionExact,
+	kPrecisionFast,
+	kPrecisionFastest,
+	kPrecisionCount
+};
+
+// The bounds above, indexed by xPrecision. The Exact entries are the
+// rounding of one IEEE divide or sqrt and of acosf.
+const float kReciprocalError[kPrecisionCount] = { 1.2e-7f, 4.8e-7f, 3.7e-4f };
+const float kAcosError[kPrecisionCount] = { 2.4e-7f, 1.0e-6f, 8.0e-5f };
+
+inline namespace XMATH_ISA {
+
+// a * b + c. Fused when the translation unit is built with /arch:AVX2,
+// which on every AVX2 part also guarantees FMA3.
+__forceinline __m128 __vectorcall MultiplyAdd(__m128 a, __m128 b, __m128 c){
+#if defined(__AVX2__)
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+template<int i>
+__forceinline __m128 __vectorcall Splat(__m128 v){
+#if defined(__AVX__)
+	return _mm_permute_ps(v, _MM_SHUFFLE(i, i, i, i));
+#else
+	return _mm_shuffle_ps(v, v, _MM_SHUFFLE(i, i, i, i));
+#endif
+}
+
+// x + y + z of v in every lane; w is ignored. Three independent shuffles
+// keep the dependency chain at two adds.
+__forceinline __m128 __vectorcall HorizontalAdd3(__m128 v){
+	return _mm_add_ps(_mm_add_ps(Splat<0>(v), Splat<1>(v)), Splat<2>(v));
+}
+
+// Dot product of the xyz lanes of a and b, in every lane.
+__forceinline __m128 __vectorcall Dot3(__m128 a, __m128 b){
+#if defined(XMATH_SSE41)
+	return _mm_dp_ps(a, b, 0x7F);
+#else
+	return HorizontalAdd3(_mm_mul_ps(a, b));
+#endif
+}
+
+// Cross product of the xyz lanes of a and b; w comes out as 0 when
+// a.w * b.w is finite.
+__forceinline __m128 __vectorcall Cross3(__m128 a, __m128 b){
+	__m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 c = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+	return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+// x + y + z + w of v in every lane.
+__forceinline __m128 __vectorcall HorizontalAdd4(__m128 v){
+	__m128 pairs = _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_add_ps(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+// Dot product of all four lanes of a and b, in every lane.
+__forceinline __m128 __vectorcall Dot4(__m128 a, __m128 b){
+#if defined(XMATH_SSE41)
+	return _mm_dp_ps(a, b, 0xFF);
+#else
+	return HorizontalAdd4(_mm_mul_ps(a, b));
+#endif
+}
+
+// 1 / a.
+template<int kPrecision>
+__forceinline __m128 __vectorcall Reciprocal(__m128 a){
+	if(kPrecision == kPrecisionExact) return _mm_div_ps(_mm_set1_ps(1.0f), a);
+	__m128 estimate = _mm_rcp_ps(a);
+	if(kPrecision == kPrecisionFastest) return estimate;
+	// y * (2 - a * y)
+	return _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(a, estimate)));
+}
+
+// 1 / sqrt(a).
+template<int kPrecision>
+__forceinline __m128 __vectorcall ReciprocalSqrt(__m128 a){
+	if(kPrecision == kPrecisionExact) return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a));
+	__m128 estimate = _mm_rsqrt_ps(a);
+	if(kPrecision == kPrecisionFastest) return estimate;
+	// 0.5 * y * (3 - a * y * y)
+	__m128 ayy = _mm_mul_ps(_mm_mul_ps(a, estimate), estimate);
+	return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), estimate), _mm_sub_ps(_mm_set1_ps(3.0f), ayy));
+}
+
+// acos(|x|) = sqrt(1 - |x|) * p(|x|) (Abramowitz & Stegun 4.4.45 and
+// 4.4.46), mirrored to pi - acos(|x|) for negative x. Inputs are
+// clamped to [-1, 1], so rounding in a cosine cannot produce a NaN.
+template<int kPrecision>
+__forceinline __m128 __vectorcall AcosPolynomial(__m128 x){
+	const __m128 sign_mask = _mm_set1_ps(-0.0f);
+	__m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+	__m128 ax = _mm_min_ps(_mm_andnot_ps(sign_mask, x), _mm_set1_ps(1.0f));
+	__m128 p;
+	if(kPrecision == kPrecisionFastest){
+		p = MultiplyAdd(ax, _mm_set1_ps(-0.0187293f), _mm_set1_ps(0.0742610f));
+		p = MultiplyAdd(ax, p, _mm_set1_ps(-0.2121144f));
+		p = MultiplyAdd(ax, p, _mm_set1_ps(1.5707288f));
+	} else {
+		p = MultiplyAdd(ax, _mm_set1_ps(-0.0012624911f), _mm_set1_ps(0.0066700901f));
+		p = MultiplyAdd(ax, p, _mm_set1_ps(-0.0170881256f));
+		p = MultiplyAdd(ax, p, _mm_set1_ps(0.0308918810f));
+		p = MultiplyAdd(ax, p, _mm_set1_ps(-0.0501743046f));
+		p = MultiplyAdd(ax, p, _mm_set1_ps(0.0889789874f));
+		p = MultiplyAdd(ax, p, _mm_set1_ps(-0.2145988016f));
+		p = MultiplyAdd(ax, p, _mm_set1_ps(1.5707963050f));
+	}
+	__m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), ax)), p);
+	// r + (pi - 2r) on the negative lanes.
+	__m128 mirror = _mm_sub_ps(_mm_set1_ps(3.14159265f), _mm_add_ps(r, r));
+	return _mm_add_ps(r, _mm_and_ps(negative, mirror));
+}
+
+// Widest float register the translation unit was compiled for. Batch
+// kernels are written once against xLane and get 16 lanes under
+// /arch:AVX512, 8 under /arch:AVX2 and 4 otherwise.
+#if defined(__AVX512F__)
+
+typedef __m512 xLane;
+const size_t kLaneWidth = 16;
+
+// Loads/stores the first n lanes; the rest read as zero and are not written.
+__forceinline xLane LaneLoad(const float* p, size_t n){
+	if(n == kLaneWidth) return _mm512_loadu_ps(p);
+	return _mm512_maskz_loadu_ps((__mmask16)((1u << n) - 1), p);
+}
+__forceinline void __vectorcall LaneStore(float* p, xLane v, size_t n){
+	if(n == kLaneWidth) _mm512_storeu_ps(p, v);
+	else _mm512_mask_storeu_ps(p, (__mmask16)((1u << n) - 1), v);
+}
+
+__forceinline xLane LaneSet(float value) { return _mm512_set1_ps(value); }
+__forceinline xLane __vectorcall LaneAdd(xLane a, xLane b) { return _mm512_add_ps(a, b); }
+__forceinline xLane __vectorcall LaneSub(xLane a, xLane b) { return _mm512_sub_ps(a, b); }
+__forceinline xLane __vectorcall LaneMul(xLane a, xLane b) { return _mm512_mul_ps(a, b); }
+__forceinline xLane __vectorcall LaneDiv(xLane a, xLane b) { return _mm512_div_ps(a, b); }
+__forceinline xLane __vectorcall LaneSqrt(xLane a) { return _mm512_sqrt_ps(a); }
+__forceinline xLane __vectorcall LaneMin(xLane a, xLane b) { return _mm512_min_ps(a, b); }
+__forceinline xLane __vectorcall LaneMax(xLane a, xLane b) { return _mm512_max_ps(a, b); }
+__forceinline xLane __vectorcall LaneMultiplyAdd(xLane a, xLane b, xLane c) { return _mm512_fmadd_ps(a, b, c); }
+// Hardware estimates, relative error below 2^-14.
+__forceinline xLane __vectorcall LaneReciprocalEstimate(xLane a) { return _mm512_rcp14_ps(a); }
+__forceinline xLane __vectorcall LaneReciprocalSqrtEstimate(xLane a) { return _mm512_rsqrt14_ps(a); }
+// AVX512F has no float logic ops; these go through the integer unit.
+__forceinline xLane __vectorcall LaneAnd(xLane a, xLane b) {
+	return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+}
+__forceinline xLane __vectorcall LaneXor(xLane a, xLane b) {
+	return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+}
+// Bit i set where lane i of a < b; false for NaN.
+__forceinline uint32_t __vectorcall LaneLessBits(xLane a, xLane b) { return (uint32_t)_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+// Per lane, a < b ? x : y.
+__forceinline xLane __vectorcall LaneSelectLess(xLane a, xLane b, xLane x, xLane y) {
+	return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), y, x);
+}
+
+// 16 (x, y, z, w) records, stride floats apart, to and from one register
+// per component; lane i is record i. Four records share each 128-bit
+// lane, so the transpose is the in-lane 4x4 one.
+__forceinline void LaneLoadAoS4Full(const float* p, size_t stride, xLane* x, xLane* y, xLane* z, xLane* w){
+	__m512 r[4];
+	for(size_t k = 0; k < 4; ++k){
+		r[k] = _mm512_castps128_ps512(_mm_loadu_ps(p + stride * k));
+		r[k] = _mm512_insertf32x4(r[k], _mm_loadu_ps(p + stride * (k + 4)), 1);
+		r[k] = _mm512_insertf32x4(r[k], _mm_loadu_ps(p + stride * (k + 8)), 2);
+		r[k] = _mm512_insertf32x4(r[k], _mm_loadu_ps(p + stride * (k + 12)), 3);
+	}
+	__m512 t0 = _mm512_unpacklo_ps(r[0], r[1]), t1 = _mm512_unpacklo_ps(r[2], r[3]);
+	__m512 t2 = _mm512_unpackhi_ps(r[0], r[1]), t3 = _mm512_unpackhi_ps(r[2], r[3]);
+	*x = _mm512_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+	*y = _mm512_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+	*z = _mm512_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	*w = _mm512_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+__forceinline void __vectorcall LaneStoreAoS4Full(float* p, size_t stride, xLane x, xLane y, xLane z, xLane w){
+	__m512 t0 = _mm512_unpacklo_ps(x, y), t1 = _mm512_unpacklo_ps(z, w);
+	__m512 t2 = _mm512_unpackhi_ps(x, y), t3 = _mm512_unpackhi_ps(z, w);
+	__m512 r[4] = { _mm512_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0)), _mm512_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2)),
+	                _mm512_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0)), _mm512_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2)) };
+	for(size_t k = 0; k < 4; ++k){
+		_mm_storeu_ps(p + stride * k, _mm512_castps512_ps128(r[k]));
+		_mm_storeu_ps(p + stride * (k + 4), _mm512_extractf32x4_ps(r[k], 1));
+		_mm_storeu_ps(p + stride * (k + 8), _mm512_extractf32x4_ps(r[k], 2));
+		_mm_storeu_ps(p + stride * (k + 12), _mm512_extractf32x4_ps(r[k], 3));
+	}
+}
+
+#elif defined(__AVX2__)
+
+typedef __m256 xLane;
+const size_t kLaneWidth = 8;
+
+__forceinline __m256i LaneMask(size_t n){
+	return _mm256_cmpgt_epi32(_mm256_set1_epi32((int)n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Loads/stores the first n lanes; the rest read as zero and are not written.
+__forceinline xLane LaneLoad(const float* p, size_t n){
+	if(n == kLaneWidth) return _mm256_loadu_ps(p);
+	return _mm256_maskload_ps(p, LaneMask(n));
+}
+__forceinline void __vectorcall LaneStore(float* p, xLane v, size_t n){
+	if(n == kLaneWidth) _mm256_storeu_ps(p, v);
+	else _mm256_maskstore_ps(p, LaneMask(n), v);
+}
+
+__forceinline xLane LaneSet(float value) { return _mm256_set1_ps(value); }
+__forceinline xLane __vectorcall LaneAdd(xLane a, xLane b) { return _mm256_add_ps(a, b); }
+__forceinline xLane __vectorcall LaneSub(xLane a, xLane b) { return _mm256_sub_ps(a, b); }
+__forceinline xLane __vectorcall LaneMul(xLane a, xLane b) { return _mm256_mul_ps(a, b); }
+__forceinline xLane __vectorcall LaneDiv(xLane a, xLane b) { return _mm256_div_ps(a, b); }
+__forceinline xLane __vectorcall LaneSqrt(xLane a) { return _mm256_sqrt_ps(a); }
+__forceinline xLane __vectorcall LaneMin(xLane a, xLane b) { return _mm256_min_ps(a, b); }
+__forceinline xLane __vectorcall LaneMax(xLane a, xLane b) { return _mm256_max_ps(a, b); }
+__forceinline xLane __vectorcall LaneMultiplyAdd(xLane a, xLane b, xLane c) { return _mm256_fmadd_ps(a, b, c); }
+// Hardware estimates, relative error below 1.5 * 2^-12.
+__forceinline xLane __vectorcall LaneReciprocalEstimate(xLane a) { return _mm256_rcp_ps(a); }
+__forceinline xLane __vectorcall LaneReciprocalSqrtEstimate(xLane a) { return _mm256_rsqrt_ps(a); }
+__forceinline xLane __vectorcall LaneAnd(xLane a, xLane b) { return _mm256_and_ps(a, b); }
+__forceinline xLane __vectorcall LaneXor(xLane a, xLane b) { return _mm256_xor_ps(a, b); }
+__forceinline uint32_t __vectorcall LaneLessBits(xLane a, xLane b) { return (uint32_t)_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+__forceinline xLane __vectorcall LaneSelectLess(xLane a, xLane b, xLane x, xLane y) {
+	return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ));
+}
+
+// 8 (x, y, z, w) records, stride floats apart, to and from one register
+// per component; lane i is record i. Records i and i + 4 share a
+// register so the transpose stays inside 128-bit lanes.
+__forceinline void LaneLoadAoS4Full(const float* p, size_t stride, xLane* x, xLane* y, xLane* z, xLane* w){
+	__m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + stride * 4), 1);
+	__m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + stride)), _mm_loadu_ps(p + stride * 5), 1);
+	__m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + stride * 2)), _mm_loadu_ps(p + stride * 6), 1);
+	__m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + stride * 3)), _mm_loadu_ps(p + stride * 7), 1);
+	__m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpacklo_ps(r2, r3);
+	__m256 t2 = _mm256_unpackhi_ps(r0, r1), t3 = _mm256_unpackhi_ps(r2, r3);
+	*x = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+	*y = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+	*z = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	*w = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+__forceinline void __vectorcall LaneStoreAoS4Full(float* p, size_t stride, xLane x, xLane y, xLane z, xLane w){
+	__m256 t0 = _mm256_unpacklo_ps(x, y), t1 = _mm256_unpacklo_ps(z, w);
+	__m256 t2 = _mm256_unpackhi_ps(x, y), t3 = _mm256_unpackhi_ps(z, w);
+	__m256 r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+	__m256 r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	__m256 r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	_mm_storeu_ps(p, _mm256_castps256_ps128(r0));
+	_mm_storeu_ps(p + stride, _mm256_castps256_ps128(r1));
+	_mm_storeu_ps(p + stride * 2, _mm256_castps256_ps128(r2));
+	_mm_storeu_ps(p + stride * 3, _mm256_castps256_ps128(r3));
+	_mm_storeu_ps(p + stride * 4, _mm256_extractf128_ps(r0, 1));
+	_mm_storeu_ps(p + stride * 5, _mm256_extractf128_ps(r1, 1));
+	_mm_storeu_ps(p + stride * 6, _mm256_extractf128_ps(r2, 1));
+	_mm_storeu_ps(p + stride * 7, _mm256_extractf128_ps(r3, 1));
+}
+
+#else
+
+typedef __m128 xLane;
+const size_t kLaneWidth = 4;
+
+__forceinline xLane LaneLoad(const float* p, size_t n){
+	if(n == kLaneWidth) return _mm_loadu_ps(p);
+	float tail[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for(size_t i = 0; i < n; ++i) tail[i] = p[i];
+	return _mm_loadu_ps(tail);
+}
+__forceinline void __vectorcall LaneStore(float* p, xLane v, size_t n){
+	if(n == kLaneWidth){
+		_mm_storeu_ps(p, v);
+		return;
+	}
+	float tail[4];
+	_mm_storeu_ps(tail, v);
+	for(size_t i = 0; i < n; ++i) p[i] = tail[i];
+}
+
+__forceinline xLane LaneSet(float value) { return _mm_set1_ps(value); }
+__forceinline xLane __vectorcall LaneAdd(xLane a, xLane b) { return _mm_add_ps(a, b); }
+__forceinline xLane __vectorcall LaneSub(xLane a, xLane b) { return _mm_sub_ps(a, b); }
+__forceinline xLane __vectorcall LaneMul(xLane a, xLane b) { return _mm_mul_ps(a, b); }
+__forceinline xLane __vectorcall LaneDiv(xLane a, xLane b) { return _mm_div_ps(a, b); }
+__forceinline xLane __vectorcall LaneSqrt(xLane a) { return _mm_sqrt_ps(a); }
+__forceinline xLane __vectorcall LaneMin(xLane a, xLane b) { return _mm_min_ps(a, b); }
+__forceinline xLane __vectorcall LaneMax(xLane a, xLane b) { return _mm_max_ps(a, b); }
+__forceinline xLane __vectorcall LaneMultiplyAdd(xLane a, xLane b, xLane c) { return MultiplyAdd(a, b, c); }
+// Hardware estimates, relative error below 1.5 * 2^-12.
+__forceinline xLane __vectorcall LaneReciprocalEstimate(xLane a) { return _mm_rcp_ps(a); }
+__forceinline xLane __vectorcall LaneReciprocalSqrtEstimate(xLane a) { return _mm_rsqrt_ps(a); }
+__forceinline xLane __vectorcall LaneAnd(xLane a, xLane b) { return _mm_and_ps(a, b); }
+__forceinline xLane __vectorcall LaneXor(xLane a, xLane b) { return _mm_xor_ps(a, b); }
+__forceinline uint32_t __vectorcall LaneLessBits(xLane a, xLane b) { return (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+__forceinline xLane __vectorcall LaneSelectLess(xLane a, xLane b, xLane x, xLane y) {
+	__m128 less = _mm_cmplt_ps(a, b);
+	return _mm_or_ps(_mm_and_ps(less, x), _mm_andnot_ps(less, y));
+}
+
+// 4 (x, y, z, w) records, stride floats apart, to and from one register
+// per component; lane i is record i.
+__forceinline void LaneLoadAoS4Full(const float* p, size_t stride, xLane* x, xLane* y, xLane* z, xLane* w){
+	__m128 r0 = _mm_loadu_ps(p), r1 = _mm_loadu_ps(p + stride);
+	__m128 r2 = _mm_loadu_ps(p + stride * 2), r3 = _mm_loadu_ps(p + stride * 3);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	*x = r0; *y = r1; *z = r2; *w = r3;
+}
+__forceinline void __vectorcall LaneStoreAoS4Full(float* p, size_t stride, xLane x, xLane y, xLane z, xLane w){
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_storeu_ps(p, x);
+	_mm_storeu_ps(p + stride, y);
+	_mm_storeu_ps(p + stride * 2, z);
+	_mm_storeu_ps(p + stride * 3, w);
+}
+
+#endif
+
+// LaneLoadAoS4Full/LaneStoreAoS4Full for the first n records. stride is
+// the distance between records in floats, 4 for packed arrays. The tail
+// goes through a stack copy; missing records read as zero and are not
+// written.
+__forceinline void LaneLoadAoS4(const float* p, size_t n, xLane* x, xLane* y, xLane* z, xLane* w, size_t stride = 4){
+	if(n == kLaneWidth){
+		LaneLoadAoS4Full(p, stride, x, y, z, w);
+		return;
+	}
+	float tail[kLaneWidth * 4] = {};
+	for(size_t i = 0; i < n; ++i)
+		for(size_t c = 0; c < 4; ++c) tail[i * 4 + c] = p[i * stride + c];
+	LaneLoadAoS4Full(tail, 4, x, y, z, w);
+}
+__forceinline void __vectorcall LaneStoreAoS4(float* p, size_t n, xLane x, xLane y, xLane z, xLane w, size_t stride = 4){
+	if(n == kLaneWidth){
+		LaneStoreAoS4Full(p, stride, x, y, z, w);
+		return;
+	}
+	float tail[kLaneWidth * 4];
+	LaneStoreAoS4Full(tail, 4, x, y, z, w);
+	for(size_t i = 0; i < n; ++i)
+		for(size_t c = 0; c < 4; ++c) p[i * stride + c] = tail[i * 4 + c];
+}
+
+// Lane forms of Reciprocal and ReciprocalSqrt, same tiers.
+template<int kPrecision>
+__forceinline xLane __vectorcall LaneReciprocal(xLane a){
+	if(kPrecision == kPrecisionExact) return LaneDiv(LaneSet(1.0f), a);
+	xLane estimate = LaneReciprocalEstimate(a);
+	if(kPrecision == kPrecisionFastest) return estimate;
+	return LaneMul(estimate, LaneSub(LaneSet(2.0f), LaneMul(a, estimate)));
+}
+
+template<int kPrecision>
+__forceinline xLane __vectorcall LaneReciprocalSqrt(xLane a){
+	if(kPrecision == kPrecisionExact) return LaneDiv(LaneSet(1.0f), LaneSqrt(a));
+	xLane estimate = LaneReciprocalSqrtEstimate(a);
+	if(kPrecision == kPrecisionFastest) return estimate;
+	xLane ayy = LaneMul(LaneMul(a, estimate), estimate);
+	return LaneMul(LaneMul(LaneSet(0.5f), estimate), LaneSub(LaneSet(3.0f), ayy));
+}
+
+// The LaneLessBits bits of the first n lanes.
+__forceinline uint32_t LaneCountMask(size_t n){
+	return (1u << n) - 1;
+}
+
+// Takes the lowest set bit off a nonzero LaneLessBits mask and returns its
+// lane, so loops over the set lanes skip the clear ones.
+__forceinline uint32_t LaneNextBit(uint32_t* bits){
+	unsigned long lane;
+	_BitScanForward(&lane, *bits);
+	*bits &= *bits - 1;
+	return (uint32_t)lane;
+}
+
+// Calls kernel(i, kLaneWidth) for every full lane and kernel(i, remainder)
+// once for the tail, so kernels only need LaneLoad/LaneStore with n.
+template<typename Kernel>
+__forceinline void LaneLoop(size_t count, Kernel kernel){
+	size_t i = 0;
+	for(; i + kLaneWidth <= count; i += kLaneWidth)
+		kernel(i, kLaneWidth);
+	if(i < count)
+		kernel(i, count - i);
+}
+
+// The same over [begin, end); i is an absolute index.
+template<typename Kernel>
+__forceinline void LaneLoop(size_t begin, size_t end, Kernel kernel){
+	size_t i = begin;
+	for(; i + kLaneWidth <= end; i += kLaneWidth)
+		kernel(i, kLaneWidth);
+	if(i < end)
+		kernel(i, end - i);
+}
+
+} // namespace XMATH_ISA
+
+#endif // __XSIMD_H__
@@ -0,0 +1,226 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Batch TRS Matrix Construction.
+//--------------------------------------------------------------//
+//
+//   out[i] = Quat(rotation[i]).ToTransform(translate[i], scale[i])
+//
+//   Translation and scale come as Vec3SoA streams and rotations as
+//   a QuatSoA stream of unit quaternions. Lane i of every register
+//   builds matrix i (4 at a time with SSE, 8 with AVX2, 16 with
+//   AVX-512); the finished rows are transposed into place, so the
+//   output is an ordinary Mat4 or xMatrix4 array with the same
+//   contents as Mat4::GetTransform.
+//
+//   Rotations can also come as a Vec3SoA of Euler angles in any
+//   RotationOrder; the half-angle sines and cosines are taken in
+//   lanes with SinCos and chained as quaternions.
+//
+//   By default batches run on the thread pool (xParallel.h) in tasks
+//   of kTRSGrain matrices, each writing its own slice of out; pass
+//   kSequential to keep them on the calling thread.
+//
+//--------------------------------------------------------------//
+#ifndef __XTRSBATCH_H__
+#define __XTRSBATCH_H__ 1
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include <xmmintrin.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xMatrix4.h"
+#include "xTranscendental.h"
+#include "xVec3SoA.h"
+#include "quaternion.h"
+#include "matrix_4.h"
+
+const size_t kTRSGrain = 8192;
+
+struct QuatSoA {
+
+	QuatSoA() : x(NULL), y(NULL), z(NULL), w(NULL), count(0), capacity(0) {}
+	explicit QuatSoA(size_t size) : x(NULL), y(NULL), z(NULL), w(NULL), count(0), capacity(0) { Resize(size); }
+	QuatSoA(const Quat* values, size_t size) : x(NULL), y(NULL), z(NULL), w(NULL), count(0), capacity(0) {
+		Resize(size);
+		for(size_t i = 0; i < size; ++i) Set(i, values[i]);
+	}
+	QuatSoA(const QuatSoA& copy) : x(NULL), y(NULL), z(NULL), w(NULL), count(0), capacity(0) {
+		*this = copy;
+	}
+	~QuatSoA() { Release(); }
+
+	QuatSoA& operator=(const QuatSoA& other) {
+		if(this == &other) return *this;
+		Resize(other.count);
+		memcpy(x, other.x, count * sizeof(float));
+		memcpy(y, other.y, count * sizeof(float));
+		memcpy(z, other.z, count * sizeof(float));
+		memcpy(w, other.w, count * sizeof(float));
+		return *this;
+	}
+
+	// Keeps the first min(count, size) elements; new elements are identity.
+	void Resize(size_t size) {
+		if(size > capacity) {
+			size_t new_capacity = (size + 15) & ~(size_t)15;
+			float* new_x = (float*)_mm_malloc(new_capacity * sizeof(float), kSoAAlignment);
+			float* new_y = (float*)_mm_malloc(new_capacity * sizeof(float), kSoAAlignment);
+			float* new_z = (float*)_mm_malloc(new_capacity * sizeof(float), kSoAAlignment);
+			float* new_w = (float*)_mm_malloc(new_capacity * sizeof(float), kSoAAlignment);
+			if(count) {
+				memcpy(new_x, x, count * sizeof(float));
+				memcpy(new_y, y, count * sizeof(float));
+				memcpy(new_z, z, count * sizeof(float));
+				memcpy(new_w, w, count * sizeof(float));
+			}
+			Release();
+			x = new_x; y = new_y; z = new_z; w = new_w;
+			capacity = new_capacity;
+		}
+		for(size_t i = count; i < size; ++i) Set(i, Quat::Identity());
+		count = size;
+	}
+
+	Quat Get(size_t i) const { return Quat(x[i], y[i], z[i], w[i]); }
+	void Set(size_t i, const Quat& q) { x[i] = q.x; y[i] = q.y; z[i] = q.z; w[i] = q.w; }
+
+	float* x;
+	float* y;
+	float* z;
+	float* w;
+	size_t count;
+	size_t capacity;
+
+ private:
+	void Release() {
+		_mm_free(x); _mm_free(y); _mm_free(z); _mm_free(w);
+		x = NULL; y = NULL; z = NULL; w = NULL;
+		capacity = 0;
+	}
+};
+
+// Per-ISA kernels. Write matrices [begin, end) as 16 floats each in Mat4
+// order, which is also the xMatrix4 layout.
+inline namespace XMATH_ISA {
+
+// Quat::ToMat3 in lanes, rows scaled by s and the translation column
+// computed from them; stores n matrices at p.
+__forceinline void StoreTransformLanes(float* p, size_t n, xLane qx, xLane qy, xLane qz, xLane qw,
+                                       xLane tx, xLane ty, xLane tz, const xLane s[3]){
+	const xLane zero = LaneSet(0.0f), one = LaneSet(1.0f);
+	xLane x2 = LaneAdd(qx, qx), y2 = LaneAdd(qy, qy), z2 = LaneAdd(qz, qz);
+	xLane xx = LaneMul(qx, x2), yy = LaneMul(qy, y2), zz = LaneMul(qz, z2);
+	xLane xy = LaneMul(qx, y2), xz = LaneMul(qx, z2), yz = LaneMul(qy, z2);
+	xLane wx = LaneMul(qw, x2), wy = LaneMul(qw, y2), wz = LaneMul(qw, z2);
+	xLane r[3][3] = {
+		{ LaneSub(one, LaneAdd(yy, zz)), LaneSub(xy, wz), LaneAdd(xz, wy) },
+		{ LaneAdd(xy, wz), LaneSub(one, LaneAdd(xx, zz)), LaneSub(yz, wx) },
+		{ LaneSub(xz, wy), LaneAdd(yz, wx), LaneSub(one, LaneAdd(xx, yy)) }
+	};
+
+	for(int row = 0; row < 3; ++row){
+		xLane r0 = LaneMul(r[row][0], s[row]);
+		xLane r1 = LaneMul(r[row][1], s[row]);
+		xLane r2 = LaneMul(r[row][2], s[row]);
+		xLane t = LaneMultiplyAdd(r2, tz, LaneMultiplyAdd(r1, ty, LaneMul(r0, tx)));
+		LaneStoreAoS4(p + row * 4, n, r0, r1, r2, t, 16);
+	}
+	LaneStoreAoS4(p + 12, n, zero, zero, zero, one, 16);
+}
+
+inline void ComposeTransformsKernel(const Vec3SoA& translate, const QuatSoA& rotation, const Vec3SoA& scale,
+                                    float* out, size_t begin, size_t end){
+	LaneLoop(end - begin, [&](size_t offset, size_t n){
+		size_t i = begin + offset;
+		xLane s[3] = { LaneLoad(scale.x + i, n), LaneLoad(scale.y + i, n), LaneLoad(scale.z + i, n) };
+		StoreTransformLanes(out + i * 16, n,
+		                    LaneLoad(rotation.x + i, n), LaneLoad(rotation.y + i, n),
+		                    LaneLoad(rotation.z + i, n), LaneLoad(rotation.w + i, n),
+		                    LaneLoad(translate.x + i, n), LaneLoad(translate.y + i, n), LaneLoad(translate.z + i, n), s);
+	});
+}
+
+// a * b, both as x y z w lanes.
+__forceinline void LaneQuatMultiply(const xLane a[4], const xLane b[4], xLane out[4]){
+	xLane x = LaneMultiplyAdd(a[3], b[0], LaneMultiplyAdd(a[0], b[3], LaneSub(LaneMul(a[1], b[2]), LaneMul(a[2], b[1]))));
+	xLane y = LaneMultiplyAdd(a[3], b[1], LaneMultiplyAdd(a[1], b[3], LaneSub(LaneMul(a[2], b[0]), LaneMul(a[0], b[2]))));
+	xLane z = LaneMultiplyAdd(a[3], b[2], LaneMultiplyAdd(a[2], b[3], LaneSub(LaneMul(a[0], b[1]), LaneMul(a[1], b[0]))));
+	xLane w = LaneSub(LaneMul(a[3], b[3]), LaneMultiplyAdd(a[2], b[2], LaneMultiplyAdd(a[1], b[1], LaneMul(a[0], b[0]))));
+	out[0] = x; out[1] = y; out[2] = z; out[3] = w;
+}
+
+// Euler angles go through one SinCos per axis on the half angles; the
+// three axis quaternions are chained in order and handed to the same
+// store as ComposeTransformsKernel. order is a RotationOrder.
+inline void ComposeTransformsEulerKernel(const Vec3SoA& translate, const Vec3SoA& radians, const Vec3SoA& scale,
+                                         int order, float* out, size_t begin, size_t end){
+	// Axes of each RotationOrder, in the order they are applied.
+	static const int kSequence[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+	const int* axis = kSequence[order];
+	const xLane zero = LaneSet(0.0f), half = LaneSet(0.5f);
+	LaneLoop(end - begin, [&](size_t offset, size_t n){
+		size_t i = begin + offset;
+		const float* angles[3] = { radians.x + i, radians.y + i, radians.z + i };
+		xLane q[3][4];
+		for(int k = 0; k < 3; ++k){
+			xLane s, c;
+			SinCos(LaneMul(LaneLoad(angles[axis[k]], n), half), &s, &c);
+			q[k][0] = zero; q[k][1] = zero; q[k][2] = zero; q[k][3] = c;
+			q[k][axis[k]] = s;
+		}
+		xLane q10[4], q210[4];
+		LaneQuatMultiply(q[1], q[0], q10);
+		LaneQuatMultiply(q[2], q10, q210);
+
+		xLane s[3] = { LaneLoad(scale.x + i, n), LaneLoad(scale.y + i, n), LaneLoad(scale.z + i, n) };
+		StoreTransformLanes(out + i * 16, n, q210[0], q210[1], q210[2], q210[3],
+		                    LaneLoad(translate.x + i, n), LaneLoad(translate.y + i, n), LaneLoad(translate.z + i, n), s);
+	});
+}
+
+} // namespace XMATH_ISA
+
+// out holds translate.count matrices. All three streams must have the
+// same count and rotations must be unit length.
+template<typename Policy = xParallelPolicy>
+inline void GetTransforms(const Vec3SoA& translate, const QuatSoA& rotation, const Vec3SoA& scale, Mat4* out,
+                          Policy policy = Policy()){
+	assert(translate.count == rotation.count && translate.count == scale.count);
+	ParallelFor(policy, translate.count, kTRSGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(ComposeTransforms)(translate, rotation, scale, out->m, begin, end);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void GetTransforms(const Vec3SoA& translate, const QuatSoA& rotation, const Vec3SoA& scale, xMatrix4* out,
+                          Policy policy = Policy()){
+	assert(translate.count == rotation.count && translate.count == scale.count);
+	ParallelFor(policy, translate.count, kTRSGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(ComposeTransforms)(translate, rotation, scale, (float*)out->col, begin, end);
+	});
+}
+
+// out[i] = Mat4::GetTransform(translate[i], scale[i], radians.x[i],
+// radians.y[i], radians.z[i], order).
+template<typename Policy = xParallelPolicy>
+inline void GetTransforms(const Vec3SoA& translate, const Vec3SoA& radians, const Vec3SoA& scale, Mat4* out,
+                          RotationOrder order = kRotateXYZ, Policy policy = Policy()){
+	assert(translate.count == radians.count && translate.count == scale.count);
+	ParallelFor(policy, translate.count, kTRSGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(ComposeTransformsEuler)(translate, radians, scale, order, out->m, begin, end);
+	});
+}
+
+template<typename Policy = xParallelPolicy>
+inline void GetTransforms(const Vec3SoA& translate, const Vec3SoA& radians, const Vec3SoA& scale, xMatrix4* out,
+                          RotationOrder order = kRotateXYZ, Policy policy = Policy()){
+	assert(translate.count == radians.count && translate.count == scale.count);
+	ParallelFor(policy, translate.count, kTRSGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(ComposeTransformsEuler)(translate, radians, scale, order, (float*)out->col, begin, end);
+	});
+}
+
+#endif // __XTRSBATCH_H__
@@ -0,0 +1,451 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Vector Transcendental Functions.
+//--------------------------------------------------------------//
+//
+//   Sin Cos SinCos Acos Atan2 Exp Sqrt
+//
+//   Each function is written once against xVectorOps and works on
+//   __m128, on __m256 in /arch:AVX2 builds and on __m512 in
+//   /arch:AVX512 builds; the float* forms run over arrays with
+//   kLaneWidth lanes per step through the dispatch table.
+//
+//   Max error against a double-precision libm, measured on a
+//   dense sweep of each range with SSE2, AVX2 and AVX-512:
+//
+//   Sin, Cos, SinCos  |x| < 1000                   1.7 ulp
+//                     1000 <= |x| <= 8192          2.4 ulp
+//                     larger |x|, inf              libm sinf/cosf
+//   Acos              [-1, 1]                      1.1 ulp; NaN outside
+//   Atan2             finite y, x                  3.1 ulp
+//   Exp               [-103.97, 88.72]             1.3 ulp; 0 below,
+//                                                  inf above
+//   Sqrt              all                          0.5 ulp (IEEE)
+//
+//   SinCos computes both results in one pass and gives the same bits
+//   as Sin and Cos called separately.
+//
+//   Sin and Cos reduce by pi/2 in four Cody-Waite parts, whose
+//   products are exact while the quadrant fits in 13 bits. Lanes beyond
+//   kTrigReductionLimit are rare in practice and are handed to
+//   libm, whose Payne-Hanek reduction is exact everywhere.
+//
+//--------------------------------------------------------------//
+#ifndef __XTRANSCENDENTAL_H__
+#define __XTRANSCENDENTAL_H__ 1
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+
+const float kTrigReductionLimit = 8192.0f;
+// Items per task when a policy runs the array functions in parallel.
+const size_t kTranscendentalGrain = 8192;
+
+inline namespace XMATH_ISA {
+
+// The operations the functions below need, for each register type.
+// Mask is what the comparisons return and Select consumes; Int is the
+// matching 32-bit integer register.
+template<typename V> struct xVectorOps;
+
+template<> struct xVectorOps<__m128> {
+	typedef __m128 Mask;
+	typedef __m128i Int;
+	static const size_t kWidth = 4;
+
+	static __forceinline __m128 Set(float value) { return _mm_set1_ps(value); }
+	static __forceinline __m128 Load(const float* p) { return _mm_loadu_ps(p); }
+	static __forceinline void Store(float* p, __m128 a) { _mm_storeu_ps(p, a); }
+	static __forceinline __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+	static __forceinline __m128 Sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+	static __forceinline __m128 Mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+	static __forceinline __m128 Div(__m128 a, __m128 b) { return _mm_div_ps(a, b); }
+	static __forceinline __m128 Sqrt(__m128 a) { return _mm_sqrt_ps(a); }
+	static __forceinline __m128 Min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+	static __forceinline __m128 Max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+	static __forceinline __m128 MultiplyAdd(__m128 a, __m128 b, __m128 c) { return XMATH_ISA::MultiplyAdd(a, b, c); }
+	static __forceinline __m128 And(__m128 a, __m128 b) { return _mm_and_ps(a, b); }
+	static __forceinline __m128 Xor(__m128 a, __m128 b) { return _mm_xor_ps(a, b); }
+	// ~a & b.
+	static __forceinline __m128 AndNot(__m128 a, __m128 b) { return _mm_andnot_ps(a, b); }
+	static __forceinline Mask Less(__m128 a, __m128 b) { return _mm_cmplt_ps(a, b); }
+	static __forceinline Mask Greater(__m128 a, __m128 b) { return _mm_cmpgt_ps(a, b); }
+	static __forceinline Mask Equal(__m128 a, __m128 b) { return _mm_cmpeq_ps(a, b); }
+	static __forceinline bool Any(Mask m) { return _mm_movemask_ps(m) != 0; }
+	// b where m is set, a elsewhere.
+	static __forceinline __m128 Select(Mask m, __m128 a, __m128 b) {
+#if defined(XMATH_SSE41)
+		return _mm_blendv_ps(a, b, m);
+#else
+		return _mm_or_ps(_mm_and_ps(m, b), _mm_andnot_ps(m, a));
+#endif
+	}
+
+	static __forceinline Int RoundToInt(__m128 a) { return _mm_cvtps_epi32(a); }
+	static __forceinline __m128 ToFloat(Int a) { return _mm_cvtepi32_ps(a); }
+	static __forceinline __m128 AsFloat(Int a) { return _mm_castsi128_ps(a); }
+	static __forceinline Int AsInt(__m128 a) { return _mm_castps_si128(a); }
+	static __forceinline Int IntSet(int value) { return _mm_set1_epi32(value); }
+	static __forceinline Int IntAdd(Int a, Int b) { return _mm_add_epi32(a, b); }
+	static __forceinline Int IntSub(Int a, Int b) { return _mm_sub_epi32(a, b); }
+	static __forceinline Int IntAnd(Int a, Int b) { return _mm_and_si128(a, b); }
+	template<int kBits> static __forceinline Int ShiftLeft(Int a) { return _mm_slli_epi32(a, kBits); }
+	template<int kBits> static __forceinline Int ShiftRightArithmetic(Int a) { return _mm_srai_epi32(a, kBits); }
+	static __forceinline Mask IntEqual(Int a, Int b) { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b)); }
+	static __forceinline Mask SignBit(__m128 a) { return _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(a), 31)); }
+};
+
+#if defined(__AVX2__)
+template<> struct xVectorOps<__m256> {
+	typedef __m256 Mask;
+	typedef __m256i Int;
+	static const size_t kWidth = 8;
+
+	static __forceinline __m256 Set(float value) { return _mm256_set1_ps(value); }
+	static __forceinline __m256 Load(const float* p) { return _mm256_loadu_ps(p); }
+	static __forceinline void Store(float* p, __m256 a) { _mm256_storeu_ps(p, a); }
+	static __forceinline __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+	static __forceinline __m256 Sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+	static __forceinline __m256 Mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+	static __forceinline __m256 Div(__m256 a, __m256 b) { return _mm256_div_ps(a, b); }
+	static __forceinline __m256 Sqrt(__m256 a) { return _mm256_sqrt_ps(a); }
+	static __forceinline __m256 Min(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+	static __forceinline __m256 Max(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+	static __forceinline __m256 MultiplyAdd(__m256 a, __m256 b, __m256 c) { return _mm256_fmadd_ps(a, b, c); }
+	static __forceinline __m256 And(__m256 a, __m256 b) { return _mm256_and_ps(a, b); }
+	static __forceinline __m256 Xor(__m256 a, __m256 b) { return _mm256_xor_ps(a, b); }
+	static __forceinline __m256 AndNot(__m256 a, __m256 b) { return _mm256_andnot_ps(a, b); }
+	static __forceinline Mask Less(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static __forceinline Mask Greater(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static __forceinline Mask Equal(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+	static __forceinline bool Any(Mask m) { return _mm256_movemask_ps(m) != 0; }
+	static __forceinline __m256 Select(Mask m, __m256 a, __m256 b) { return _mm256_blendv_ps(a, b, m); }
+
+	static __forceinline Int RoundToInt(__m256 a) { return _mm256_cvtps_epi32(a); }
+	static __forceinline __m256 ToFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+	static __forceinline __m256 AsFloat(Int a) { return _mm256_castsi256_ps(a); }
+	static __forceinline Int AsInt(__m256 a) { return _mm256_castps_si256(a); }
+	static __forceinline Int IntSet(int value) { return _mm256_set1_epi32(value); }
+	static __forceinline Int IntAdd(Int a, Int b) { return _mm256_add_epi32(a, b); }
+	static __forceinline Int IntSub(Int a, Int b) { return _mm256_sub_epi32(a, b); }
+	static __forceinline Int IntAnd(Int a, Int b) { return _mm256_and_si256(a, b); }
+	template<int kBits> static __forceinline Int ShiftLeft(Int a) { return _mm256_slli_epi32(a, kBits); }
+	template<int kBits> static __forceinline Int ShiftRightArithmetic(Int a) { return _mm256_srai_epi32(a, kBits); }
+	static __forceinline Mask IntEqual(Int a, Int b) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)); }
+	static __forceinline Mask SignBit(__m256 a) { return _mm256_castsi256_ps(_mm256_srai_epi32(_mm256_castps_si256(a), 31)); }
+};
+#endif
+
+#if defined(__AVX512F__)
+template<> struct xVectorOps<__m512> {
+	typedef __mmask16 Mask;
+	typedef __m512i Int;
+	static const size_t kWidth = 16;
+
+	static __forceinline __m512 Set(float value) { return _mm512_set1_ps(value); }
+	static __forceinline __m512 Load(const float* p) { return _mm512_loadu_ps(p); }
+	static __forceinline void Store(float* p, __m512 a) { _mm512_storeu_ps(p, a); }
+	static __forceinline __m512 Add(__m512 a, __m512 b) { return _mm512_add_ps(a, b); }
+	static __forceinline __m512 Sub(__m512 a, __m512 b) { return _mm512_sub_ps(a, b); }
+	static __forceinline __m512 Mul(__m512 a, __m512 b) { return _mm512_mul_ps(a, b); }
+	static __forceinline __m512 Div(__m512 a, __m512 b) { return _mm512_div_ps(a, b); }
+	static __forceinline __m512 Sqrt(__m512 a) { return _mm512_sqrt_ps(a); }
+	static __forceinline __m512 Min(__m512 a, __m512 b) { return _mm512_min_ps(a, b); }
+	static __forceinline __m512 Max(__m512 a, __m512 b) { return _mm512_max_ps(a, b); }
+	static __forceinline __m512 MultiplyAdd(__m512 a, __m512 b, __m512 c) { return _mm512_fmadd_ps(a, b, c); }
+	static __forceinline __m512 And(__m512 a, __m512 b) {
+		return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+	}
+	static __forceinline __m512 Xor(__m512 a, __m512 b) {
+		return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+	}
+	static __forceinline __m512 AndNot(__m512 a, __m512 b) {
+		return _mm512_castsi512_ps(_mm512_andnot_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+	}
+	static __forceinline Mask Less(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+	static __forceinline Mask Greater(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+	static __forceinline Mask Equal(__m512 a, __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+	static __forceinline bool Any(Mask m) { return m != 0; }
+	static __forceinline __m512 Select(Mask m, __m512 a, __m512 b) { return _mm512_mask_blend_ps(m, a, b); }
+
+	static __forceinline Int RoundToInt(__m512 a) { return _mm512_cvtps_epi32(a); }
+	static __forceinline __m512 ToFloat(Int a) { return _mm512_cvtepi32_ps(a); }
+	static __forceinline __m512 AsFloat(Int a) { return _mm512_castsi512_ps(a); }
+	static __forceinline Int AsInt(__m512 a) { return _mm512_castps_si512(a); }
+	static __forceinline Int IntSet(int value) { return _mm512_set1_epi32(value); }
+	static __forceinline Int IntAdd(Int a, Int b) { return _mm512_add_epi32(a, b); }
+	static __forceinline Int IntSub(Int a, Int b) { return _mm512_sub_epi32(a, b); }
+	static __forceinline Int IntAnd(Int a, Int b) { return _mm512_and_si512(a, b); }
+	template<int kBits> static __forceinline Int ShiftLeft(Int a) { return _mm512_slli_epi32(a, kBits); }
+	template<int kBits> static __forceinline Int ShiftRightArithmetic(Int a) { return _mm512_srai_epi32(a, kBits); }
+	static __forceinline Mask IntEqual(Int a, Int b) { return _mm512_cmpeq_epi32_mask(a, b); }
+	static __forceinline Mask SignBit(__m512 a) { return _mm512_cmplt_epi32_mask(_mm512_castps_si512(a), _mm512_setzero_si512()); }
+};
+#endif
+
+// Lanes of x with |x| > kTrigReductionLimit (or NaN) get sinf/cosf.
+template<typename V>
+inline void SinCosLibm(V x, V* s, V* c){
+	typedef xVectorOps<V> O;
+	float xs[O::kWidth], ss[O::kWidth], cs[O::kWidth];
+	O::Store(xs, x);
+	O::Store(ss, *s);
+	O::Store(cs, *c);
+	for(size_t i = 0; i < O::kWidth; ++i){
+		if(!(fabsf(xs[i]) <= kTrigReductionLimit)){
+			ss[i] = sinf(xs[i]);
+			cs[i] = cosf(xs[i]);
+		}
+	}
+	*s = O::Load(ss);
+	*c = O::Load(cs);
+}
+
+// sin(x) and cos(x) in one pass. x is reduced to r in [-pi/4, pi/4] and
+// quadrant q; both minimax polynomials on r are needed anyway, q picks
+// which one lands in which output and with what sign.
+template<typename V>
+__forceinline void SinCos(V x, V* s, V* c){
+	typedef xVectorOps<V> O;
+	typedef typename O::Int Int;
+	V sign = O::And(x, O::Set(-0.0f));
+	V ax = O::Xor(x, sign);
+
+	Int q = O::RoundToInt(O::Mul(ax, O::Set(0.636619772367581343f)));
+	V fq = O::ToFloat(q);
+	// pi/2 in four parts; the first three have 11 significant bits, so
+	// fq * part is exact for a 13-bit quadrant.
+	V r = O::MultiplyAdd(fq, O::Set(-1.5703125f), ax);
+	r = O::MultiplyAdd(fq, O::Set(-4.837512969970703125e-4f), r);
+	r = O::MultiplyAdd(fq, O::Set(-7.549533620476723e-8f), r);
+	r = O::MultiplyAdd(fq, O::Set(-2.5633440682570896e-12f), r);
+
+	V z = O::Mul(r, r);
+	V ps = O::MultiplyAdd(z, O::Set(-1.9515295891e-4f), O::Set(8.3321608736e-3f));
+	ps = O::MultiplyAdd(z, ps, O::Set(-1.6666654611e-1f));
+	ps = O::MultiplyAdd(O::Mul(z, r), ps, r);
+	V pc = O::MultiplyAdd(z, O::Set(2.443315711809948e-5f), O::Set(-1.388731625493765e-3f));
+	pc = O::MultiplyAdd(z, pc, O::Set(4.166664568298827e-2f));
+	pc = O::MultiplyAdd(O::Mul(z, z), pc, O::MultiplyAdd(z, O::Set(-0.5f), O::Set(1.0f)));
+
+	// Odd quadrants swap the polynomials; quadrants 2 and 3 negate sin,
+	// 1 and 2 negate cos. sin is odd, so it also takes the sign of x.
+	typename O::Mask odd = O::IntEqual(O::IntAnd(q, O::IntSet(1)), O::IntSet(1));
+	V sin_sign = O::Xor(sign, O::AsFloat(O::template ShiftLeft<30>(O::IntAnd(q, O::IntSet(2)))));
+	V cos_sign = O::AsFloat(O::template ShiftLeft<30>(O::IntAnd(O::IntAdd(q, O::IntSet(1)), O::IntSet(2))));
+	*s = O::Xor(O::Select(odd, ps, pc), sin_sign);
+	*c = O::Xor(O::Select(odd, pc, ps), cos_sign);
+
+	// NaN already propagates through the polynomials.
+	if(O::Any(O::Greater(ax, O::Set(kTrigReductionLimit))))
+		SinCosLibm(x, s, c);
+}
+
+template<typename V>
+__forceinline V Sin(V x){
+	V s, c;
+	SinCos(x, &s, &c);
+	return s;
+}
+
+template<typename V>
+__forceinline V Cos(V x){
+	V s, c;
+	SinCos(x, &s, &c);
+	return c;
+}
+
+// asin(a) for a in [0, 0.5], z = a * a.
+template<typename V>
+__forceinline V AsinKernel(V a, V z){
+	typedef xVectorOps<V> O;
+	V p = O::MultiplyAdd(z, O::Set(4.2163199048e-2f), O::Set(2.4181311049e-2f));
+	p = O::MultiplyAdd(z, p, O::Set(4.5470025998e-2f));
+	p = O::MultiplyAdd(z, p, O::Set(7.4953002686e-2f));
+	p = O::MultiplyAdd(z, p, O::Set(1.6666752422e-1f));
+	return O::MultiplyAdd(O::Mul(a, z), p, a);
+}
+
+// |x| <= 0.5: pi/2 - asin(x). Otherwise acos(|x|) = 2 asin(sqrt((1 - |x|) / 2)),
+// mirrored to pi - acos(|x|) for negative x. pi/2 and pi are split in two
+// so the subtraction keeps the low bits.
+template<typename V>
+__forceinline V Acos(V x){
+	typedef xVectorOps<V> O;
+	V sign = O::And(x, O::Set(-0.0f));
+	V ax = O::Xor(x, sign);
+	typename O::Mask large = O::Greater(ax, O::Set(0.5f));
+
+	V z_large = O::Mul(O::Set(0.5f), O::Sub(O::Set(1.0f), ax));
+	V a = O::Select(large, ax, O::Sqrt(z_large));
+	V z = O::Select(large, O::Mul(ax, ax), z_large);
+	V asin = AsinKernel(a, z);
+
+	V small_result = O::Sub(O::Set(1.57079637f), O::Add(O::Xor(asin, sign), O::Set(4.37113883e-8f)));
+	V twice = O::Add(asin, asin);
+	V mirrored = O::Sub(O::Set(3.14159274f), O::Add(twice, O::Set(8.74227766e-8f)));
+	V large_result = O::Select(O::SignBit(x), twice, mirrored);
+	return O::Select(large, small_result, large_result);
+}
+
+// atan(y / x) in the quadrant of (x, y). The ratio min/max of |x|, |y| is
+// reduced once more around tan(pi/8) before the polynomial. Signed zeros
+// follow atan2f; infinities are not handled.
+template<typename V>
+__forceinline V Atan2(V y, V x){
+	typedef xVectorOps<V> O;
+	V y_sign = O::And(y, O::Set(-0.0f));
+	V ax = O::AndNot(O::Set(-0.0f), x);
+	V ay = O::Xor(y, y_sign);
+	V num = O::Min(ax, ay), den = O::Max(ax, ay);
+	V t = O::Select(O::Equal(den, O::Set(0.0f)), O::Div(num, den), O::Set(0.0f));
+
+	typename O::Mask reduce = O::Greater(t, O::Set(0.414213562373095f));
+	V offset = O::Select(reduce, O::Set(0.0f), O::Set(0.785398163397448f));
+	t = O::Select(reduce, t, O::Div(O::Sub(t, O::Set(1.0f)), O::Add(t, O::Set(1.0f))));
+
+	V z = O::Mul(t, t);
+	V p = O::MultiplyAdd(z, O::Set(8.05374449538e-2f), O::Set(-1.38776856032e-1f));
+	p = O::MultiplyAdd(z, p, O::Set(1.99777106478e-1f));
+	p = O::MultiplyAdd(z, p, O::Set(-3.33329491539e-1f));
+	V r = O::Add(offset, O::MultiplyAdd(O::Mul(z, t), p, t));
+
+	r = O::Select(O::Greater(ay, ax), r, O::Sub(O::Set(1.57079637f), O::Add(r, O::Set(4.37113883e-8f))));
+	r = O::Select(O::SignBit(x), r, O::Sub(O::Set(3.14159274f), O::Add(r, O::Set(8.74227766e-8f))));
+	return O::Xor(r, y_sign);
+}
+
+// 2^n for n in [-126, 127].
+template<typename V>
+__forceinline V Pow2(typename xVectorOps<V>::Int n){
+	typedef xVectorOps<V> O;
+	return O::AsFloat(O::template ShiftLeft<23>(O::IntAdd(n, O::IntSet(127))));
+}
+
+// e^x = 2^n e^r with n = round(x / ln 2) and |r| <= ln 2 / 2. 2^n is
+// applied as two factors so n can reach the denormal and overflow ends.
+template<typename V>
+__forceinline V Exp(V x){
+	typedef xVectorOps<V> O;
+	typedef typename O::Int Int;
+	// max(lo, x) and min(hi, x) pass NaN through.
+	V clamped = O::Min(O::Set(88.7228394f), O::Max(O::Set(-103.972084f), x));
+	Int n = O::RoundToInt(O::Mul(clamped, O::Set(1.44269504088896341f)));
+	V fn = O::ToFloat(n);
+	V r = O::MultiplyAdd(fn, O::Set(-0.693359375f), clamped);
+	r = O::MultiplyAdd(fn, O::Set(2.12194440e-4f), r);
+
+	V p = O::MultiplyAdd(r, O::Set(1.9875691500e-4f), O::Set(1.3981999507e-3f));
+	p = O::MultiplyAdd(r, p, O::Set(8.3334519073e-3f));
+	p = O::MultiplyAdd(r, p, O::Set(4.1665795894e-2f));
+	p = O::MultiplyAdd(r, p, O::Set(1.6666665459e-1f));
+	p = O::MultiplyAdd(r, p, O::Set(5.0000001201e-1f));
+	p = O::MultiplyAdd(O::Mul(r, r), p, O::Add(r, O::Set(1.0f)));
+
+	Int half = O::template ShiftRightArithmetic<1>(n);
+	V result = O::Mul(O::Mul(p, Pow2<V>(half)), Pow2<V>(O::IntSub(n, half)));
+	result = O::Select(O::Greater(x, O::Set(88.7228394f)), result, O::Set(HUGE_VALF));
+	return O::Select(O::Less(x, O::Set(-103.972084f)), result, O::Set(0.0f));
+}
+
+// IEEE square root, for symmetry with the array forms.
+template<typename V>
+__forceinline V Sqrt(V x){
+	return xVectorOps<V>::Sqrt(x);
+}
+
+// Per-ISA array kernels; count floats from in to out, which may alias.
+inline void SinArrayKernel(const float* in, float* out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){ LaneStore(out + i, Sin(LaneLoad(in + i, n)), n); });
+}
+
+inline void CosArrayKernel(const float* in, float* out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){ LaneStore(out + i, Cos(LaneLoad(in + i, n)), n); });
+}
+
+inline void SinCosArrayKernel(const float* in, float* sin_out, float* cos_out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){
+		xLane s, c;
+		SinCos(LaneLoad(in + i, n), &s, &c);
+		LaneStore(sin_out + i, s, n);
+		LaneStore(cos_out + i, c, n);
+	});
+}
+
+inline void AcosArrayKernel(const float* in, float* out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){ LaneStore(out + i, Acos(LaneLoad(in + i, n)), n); });
+}
+
+inline void Atan2ArrayKernel(const float* y, const float* x, float* out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){ LaneStore(out + i, Atan2(LaneLoad(y + i, n), LaneLoad(x + i, n)), n); });
+}
+
+inline void ExpArrayKernel(const float* in, float* out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){ LaneStore(out + i, Exp(LaneLoad(in + i, n)), n); });
+}
+
+inline void SqrtArrayKernel(const float* in, float* out, size_t count){
+	LaneLoop(count, [&](size_t i, size_t n){ LaneStore(out + i, LaneSqrt(LaneLoad(in + i, n)), n); });
+}
+
+} // namespace XMATH_ISA
+
+// out[i] = f(in[i]) for count floats; out may be in. The trailing policy is
+// kSequential or kParallel (xParallel.h).
+template<typename Policy = xSequentialPolicy>
+inline void Sin(const float* in, float* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kTranscendentalGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SinArray)(in + begin, out + begin, end - begin);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Cos(const float* in, float* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kTranscendentalGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(CosArray)(in + begin, out + begin, end - begin);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void SinCos(const float* in, float* sin_out, float* cos_out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kTranscendentalGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SinCosArray)(in + begin, sin_out + begin, cos_out + begin, end - begin);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Acos(const float* in, float* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kTranscendentalGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(AcosArray)(in + begin, out + begin, end - begin);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Atan2(const float* y, const float* x, float* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kTranscendentalGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(Atan2Array)(y + begin, x + begin, out + begin, end - begin);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Exp(const float* in, float* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kTranscendentalGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(ExpArray)(in + begin, out + begin, end - begin);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Sqrt(const float* in, float* out, size_t count, Policy policy = Policy()){
+	ParallelFor(policy, count, kTranscendentalGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SqrtArray)(in + begin, out + begin, end - begin);
+	});
+}
+
+#endif // __XTRANSCENDENTAL_H__
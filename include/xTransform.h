@@ -0,0 +1,403 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Batched Matrix 4 Transforms.
+//--------------------------------------------------------------//
+//
+//   One matrix applied to a contiguous array of Vec3, Vec4 or
+//   xVector3, with the same conventions as xMatrix4 Transform:
+//   points are columns, p' = M p, and the translation is
+//   m[3], m[7], m[11] (matrix_4.h).
+//
+//   Points      w = 1, no divide.
+//   Directions  w = 0, translation ignored.
+//   Projective  w = 1, result divided by the transformed w. The
+//               divide follows kPrecision (xPrecision, xSimd.h).
+//
+//   in and out may be the same array (in-place) but must not
+//   otherwise overlap. Outputs of kStreamingStoreBytes or more that
+//   are 16-byte aligned are written with non-temporal stores so a
+//   large batch does not evict the working set from the cache. The
+//   choice is made once per call from the whole output, so under
+//   kParallel every task of a large batch streams.
+//
+//--------------------------------------------------------------//
+#ifndef __XTRANSFORM_H__
+#define __XTRANSFORM_H__ 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <xmmintrin.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xVector3.h"
+#include "xMatrix4.h"
+#include "vector_3.h"
+#include "vector_4.h"
+#include "matrix_4.h"
+
+const size_t kStreamingStoreBytes = 4 * 1024 * 1024;
+// Items per task when a policy runs the functions below in parallel.
+const size_t kTransformGrain = 16384;
+
+enum xTransformMode {
+	kTransformPoint,
+	kTransformDirection,
+	kTransformProjective
+};
+
+// Made by the wrappers for the whole output and passed to every slice.
+inline bool UseStreamingStores(const void* in, const void* out, size_t bytes){
+	return in != out && bytes >= kStreamingStoreBytes && ((uintptr_t)out & 15) == 0;
+}
+
+inline namespace XMATH_ISA {
+
+template<bool kStream>
+__forceinline void __vectorcall StoreBatch(float* p, __m128 v){
+	if(kStream) _mm_stream_ps(p, v);
+	else _mm_storeu_ps(p, v);
+}
+
+// A slice streams if its call does and its own start is aligned, which
+// it is whenever the grain keeps slice starts on 16 bytes.
+__forceinline bool StreamSlice(bool stream, const void* out){
+	return stream && ((uintptr_t)out & 15) == 0;
+}
+
+// t is the transposed matrix (CombinePoint, xMatrix4.h).
+template<int kPrecision>
+__forceinline xVector3 __vectorcall TransformByMode(const xMatrix4& t, xVector3 v, int mode){
+	if(mode == kTransformDirection) return CombineDirection(t, v);
+	xVector3 r = CombinePoint(t, v);
+	if(mode == kTransformProjective) r.xmm = _mm_mul_ps(r.xmm, Reciprocal<kPrecision>(Splat<3>(r.xmm)));
+	return r;
+}
+
+// Four Vec3 per iteration: the 12 floats are loaded as three registers,
+// transposed to x/y/z lanes, transformed with broadcast matrix entries and
+// interleaved back, so every load and store is a full 16 bytes. e holds
+// the transposed matrix, so cij is entry (j, i) and ci3 the translation.
+template<int kMode, bool kStream, int kPrecision>
+inline void TransformVec3Loop(const xMatrix4& m, const float* in, float* out, size_t count){
+	const xMatrix4 t = Transpose(m);
+	float e[16];
+	t.store(e);
+	const __m128 c00 = _mm_set1_ps(e[0]), c01 = _mm_set1_ps(e[1]), c02 = _mm_set1_ps(e[2]), c03 = _mm_set1_ps(e[3]);
+	const __m128 c10 = _mm_set1_ps(e[4]), c11 = _mm_set1_ps(e[5]), c12 = _mm_set1_ps(e[6]), c13 = _mm_set1_ps(e[7]);
+	const __m128 c20 = _mm_set1_ps(e[8]), c21 = _mm_set1_ps(e[9]), c22 = _mm_set1_ps(e[10]), c23 = _mm_set1_ps(e[11]);
+	const __m128 c30 = _mm_set1_ps(e[12]), c31 = _mm_set1_ps(e[13]), c32 = _mm_set1_ps(e[14]), c33 = _mm_set1_ps(e[15]);
+
+	size_t i = 0;
+	for(; i + 4 <= count; i += 4, in += 12, out += 12){
+		__m128 v0 = _mm_loadu_ps(in);
+		__m128 v1 = _mm_loadu_ps(in + 4);
+		__m128 v2 = _mm_loadu_ps(in + 8);
+
+		__m128 x = _mm_shuffle_ps(v0, _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+		__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1)),
+		                          _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2)), v2, _MM_SHUFFLE(3, 0, 2, 0));
+
+		__m128 rx = MultiplyAdd(c20, z, _mm_mul_ps(c10, y));
+		__m128 ry = MultiplyAdd(c21, z, _mm_mul_ps(c11, y));
+		__m128 rz = MultiplyAdd(c22, z, _mm_mul_ps(c12, y));
+		if(kMode == kTransformDirection){
+			rx = MultiplyAdd(c00, x, rx);
+			ry = MultiplyAdd(c01, x, ry);
+			rz = MultiplyAdd(c02, x, rz);
+		} else {
+			rx = _mm_add_ps(MultiplyAdd(c00, x, c30), rx);
+			ry = _mm_add_ps(MultiplyAdd(c01, x, c31), ry);
+			rz = _mm_add_ps(MultiplyAdd(c02, x, c32), rz);
+		}
+		if(kMode == kTransformProjective){
+			__m128 rw = _mm_add_ps(MultiplyAdd(c03, x, c33), MultiplyAdd(c23, z, _mm_mul_ps(c13, y)));
+			__m128 inverse_w = Reciprocal<kPrecision>(rw);
+			rx = _mm_mul_ps(rx, inverse_w);
+			ry = _mm_mul_ps(ry, inverse_w);
+			rz = _mm_mul_ps(rz, inverse_w);
+		}
+
+		v0 = _mm_shuffle_ps(_mm_shuffle_ps(rx, ry, _MM_SHUFFLE(0, 0, 0, 0)),
+		                    _mm_shuffle_ps(rz, rx, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		v1 = _mm_shuffle_ps(_mm_shuffle_ps(ry, rz, _MM_SHUFFLE(1, 1, 1, 1)),
+		                    _mm_shuffle_ps(rx, ry, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+		v2 = _mm_shuffle_ps(_mm_shuffle_ps(rz, rx, _MM_SHUFFLE(3, 3, 2, 2)),
+		                    _mm_shuffle_ps(ry, rz, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+		StoreBatch<kStream>(out, v0);
+		StoreBatch<kStream>(out + 4, v1);
+		StoreBatch<kStream>(out + 8, v2);
+	}
+	for(; i < count; ++i, in += 3, out += 3)
+		TransformByMode<kPrecision>(t, xVector3(in), kMode).store(out);
+
+	if(kStream) _mm_sfence();
+}
+
+template<int kMode, int kPrecision>
+inline void TransformVec3Array(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count, bool stream){
+	if(StreamSlice(stream, out))
+		TransformVec3Loop<kMode, true, kPrecision>(m, &in->x, &out->x, count);
+	else
+		TransformVec3Loop<kMode, false, kPrecision>(m, &in->x, &out->x, count);
+}
+
+template<int kMode, bool kStream, int kPrecision>
+inline void TransformXVector3Loop(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count){
+	const xMatrix4 t = Transpose(m);
+	size_t i = 0;
+	for(; i + 4 <= count; i += 4){
+		xVector3 r0 = TransformByMode<kPrecision>(t, in[i], kMode);
+		xVector3 r1 = TransformByMode<kPrecision>(t, in[i + 1], kMode);
+		xVector3 r2 = TransformByMode<kPrecision>(t, in[i + 2], kMode);
+		xVector3 r3 = TransformByMode<kPrecision>(t, in[i + 3], kMode);
+		StoreBatch<kStream>((float*)&out[i], r0.xmm);
+		StoreBatch<kStream>((float*)&out[i + 1], r1.xmm);
+		StoreBatch<kStream>((float*)&out[i + 2], r2.xmm);
+		StoreBatch<kStream>((float*)&out[i + 3], r3.xmm);
+	}
+	for(; i < count; ++i)
+		out[i] = TransformByMode<kPrecision>(t, in[i], kMode);
+
+	if(kStream) _mm_sfence();
+}
+
+template<int kMode, int kPrecision>
+inline void TransformXVector3Array(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count, bool stream){
+	if(StreamSlice(stream, out))
+		TransformXVector3Loop<kMode, true, kPrecision>(m, in, out, count);
+	else
+		TransformXVector3Loop<kMode, false, kPrecision>(m, in, out, count);
+}
+
+template<bool kStream>
+inline void TransformVec4Loop(const xMatrix4& m, const float* in, float* out, size_t count){
+	const xMatrix4 t = Transpose(m);
+	size_t i = 0;
+	for(; i + 4 <= count; i += 4, in += 16, out += 16){
+		__m128 r0 = Combine(t, _mm_loadu_ps(in));
+		__m128 r1 = Combine(t, _mm_loadu_ps(in + 4));
+		__m128 r2 = Combine(t, _mm_loadu_ps(in + 8));
+		__m128 r3 = Combine(t, _mm_loadu_ps(in + 12));
+		StoreBatch<kStream>(out, r0);
+		StoreBatch<kStream>(out + 4, r1);
+		StoreBatch<kStream>(out + 8, r2);
+		StoreBatch<kStream>(out + 12, r3);
+	}
+	for(; i < count; ++i, in += 4, out += 4)
+		_mm_storeu_ps(out, Combine(t, _mm_loadu_ps(in)));
+
+	if(kStream) _mm_sfence();
+}
+
+inline void TransformPointsVec3Kernel(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count, bool stream){
+	TransformVec3Array<kTransformPoint, kPrecisionExact>(m, in, out, count, stream);
+}
+
+inline void TransformDirectionsVec3Kernel(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count, bool stream){
+	TransformVec3Array<kTransformDirection, kPrecisionExact>(m, in, out, count, stream);
+}
+
+template<int kPrecision>
+inline void TransformProjectiveVec3Kernel(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count, bool stream){
+	TransformVec3Array<kTransformProjective, kPrecision>(m, in, out, count, stream);
+}
+
+inline void TransformPointsXVector3Kernel(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count,
+                                          bool stream){
+	TransformXVector3Array<kTransformPoint, kPrecisionExact>(m, in, out, count, stream);
+}
+
+inline void TransformDirectionsXVector3Kernel(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count,
+                                              bool stream){
+	TransformXVector3Array<kTransformDirection, kPrecisionExact>(m, in, out, count, stream);
+}
+
+template<int kPrecision>
+inline void TransformProjectiveXVector3Kernel(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count,
+                                              bool stream){
+	TransformXVector3Array<kTransformProjective, kPrecision>(m, in, out, count, stream);
+}
+
+inline void TransformVec4Kernel(const xMatrix4& m, const Vec4* in, Vec4* out, size_t count, bool stream){
+	if(StreamSlice(stream, out))
+		TransformVec4Loop<true>(m, &in->x, &out->x, count);
+	else
+		TransformVec4Loop<false>(m, &in->x, &out->x, count);
+}
+
+} // namespace XMATH_ISA
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformPoints(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count, Policy policy = Policy()){
+	const bool stream = UseStreamingStores(in, out, count * sizeof(Vec3));
+	ParallelFor(policy, count, kTransformGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(TransformPointsVec3)(m, in + begin, out + begin, end - begin, stream);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformDirections(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count, Policy policy = Policy()){
+	const bool stream = UseStreamingStores(in, out, count * sizeof(Vec3));
+	ParallelFor(policy, count, kTransformGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(TransformDirectionsVec3)(m, in + begin, out + begin, end - begin, stream);
+	});
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void TransformPointsProjective(const xMatrix4& m, const Vec3* in, Vec3* out, size_t count,
+                                      Policy policy = Policy()){
+	const bool stream = UseStreamingStores(in, out, count * sizeof(Vec3));
+	ParallelFor(policy, count, kTransformGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH_PRECISION(TransformProjectiveVec3, kPrecision)(m, in + begin, out + begin, end - begin, stream);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformPoints(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count,
+                            Policy policy = Policy()){
+	const bool stream = UseStreamingStores(in, out, count * sizeof(xVector3));
+	ParallelFor(policy, count, kTransformGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(TransformPointsXVector3)(m, in + begin, out + begin, end - begin, stream);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformDirections(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count,
+                                Policy policy = Policy()){
+	const bool stream = UseStreamingStores(in, out, count * sizeof(xVector3));
+	ParallelFor(policy, count, kTransformGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(TransformDirectionsXVector3)(m, in + begin, out + begin, end - begin, stream);
+	});
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void TransformPointsProjective(const xMatrix4& m, const xVector3* in, xVector3* out, size_t count,
+                                      Policy policy = Policy()){
+	const bool stream = UseStreamingStores(in, out, count * sizeof(xVector3));
+	ParallelFor(policy, count, kTransformGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH_PRECISION(TransformProjectiveXVector3, kPrecision)(m, in + begin, out + begin, end - begin, stream);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Transform(const xMatrix4& m, const Vec4* in, Vec4* out, size_t count, Policy policy = Policy()){
+	const bool stream = UseStreamingStores(in, out, count * sizeof(Vec4));
+	ParallelFor(policy, count, kTransformGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(TransformVec4)(m, in + begin, out + begin, end - begin, stream);
+	});
+}
+
+// In-place forms.
+template<typename Policy = xSequentialPolicy>
+inline void TransformPoints(const xMatrix4& m, Vec3* points, size_t count, Policy policy = Policy()){
+	TransformPoints(m, points, points, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformDirections(const xMatrix4& m, Vec3* directions, size_t count, Policy policy = Policy()){
+	TransformDirections(m, directions, directions, count, policy);
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void TransformPointsProjective(const xMatrix4& m, Vec3* points, size_t count, Policy policy = Policy()){
+	TransformPointsProjective<kPrecision>(m, points, points, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformPoints(const xMatrix4& m, xVector3* points, size_t count, Policy policy = Policy()){
+	TransformPoints(m, points, points, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformDirections(const xMatrix4& m, xVector3* directions, size_t count, Policy policy = Policy()){
+	TransformDirections(m, directions, directions, count, policy);
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void TransformPointsProjective(const xMatrix4& m, xVector3* points, size_t count, Policy policy = Policy()){
+	TransformPointsProjective<kPrecision>(m, points, points, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Transform(const xMatrix4& m, Vec4* vectors, size_t count, Policy policy = Policy()){
+	Transform(m, vectors, vectors, count, policy);
+}
+
+// Mat4 forms of all of the above, so scalar callers do not have to
+// convert by hand.
+template<typename Policy = xSequentialPolicy>
+inline void TransformPoints(const Mat4& m, const Vec3* in, Vec3* out, size_t count, Policy policy = Policy()){
+	TransformPoints(xMatrix4(m), in, out, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformDirections(const Mat4& m, const Vec3* in, Vec3* out, size_t count, Policy policy = Policy()){
+	TransformDirections(xMatrix4(m), in, out, count, policy);
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void TransformPointsProjective(const Mat4& m, const Vec3* in, Vec3* out, size_t count, Policy policy = Policy()){
+	TransformPointsProjective<kPrecision>(xMatrix4(m), in, out, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Transform(const Mat4& m, const Vec4* in, Vec4* out, size_t count, Policy policy = Policy()){
+	Transform(xMatrix4(m), in, out, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformPoints(const Mat4& m, const xVector3* in, xVector3* out, size_t count, Policy policy = Policy()){
+	TransformPoints(xMatrix4(m), in, out, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformDirections(const Mat4& m, const xVector3* in, xVector3* out, size_t count,
+                                Policy policy = Policy()){
+	TransformDirections(xMatrix4(m), in, out, count, policy);
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void TransformPointsProjective(const Mat4& m, const xVector3* in, xVector3* out, size_t count,
+                                      Policy policy = Policy()){
+	TransformPointsProjective<kPrecision>(xMatrix4(m), in, out, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformPoints(const Mat4& m, Vec3* points, size_t count, Policy policy = Policy()){
+	TransformPoints(xMatrix4(m), points, points, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformDirections(const Mat4& m, Vec3* directions, size_t count, Policy policy = Policy()){
+	TransformDirections(xMatrix4(m), directions, directions, count, policy);
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void TransformPointsProjective(const Mat4& m, Vec3* points, size_t count, Policy policy = Policy()){
+	TransformPointsProjective<kPrecision>(xMatrix4(m), points, points, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformPoints(const Mat4& m, xVector3* points, size_t count, Policy policy = Policy()){
+	TransformPoints(xMatrix4(m), points, points, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void TransformDirections(const Mat4& m, xVector3* directions, size_t count, Policy policy = Policy()){
+	TransformDirections(xMatrix4(m), directions, directions, count, policy);
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void TransformPointsProjective(const Mat4& m, xVector3* points, size_t count, Policy policy = Policy()){
+	TransformPointsProjective<kPrecision>(xMatrix4(m), points, points, count, policy);
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Transform(const Mat4& m, Vec4* vectors, size_t count, Policy policy = Policy()){
+	Transform(xMatrix4(m), vectors, vectors, count, policy);
+}
+
+#endif // __XTRANSFORM_H__
@@ -0,0 +1,273 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Transform Hierarchy.
+//--------------------------------------------------------------//
+//
+//   World(i) = Local(i).Multiply(World(Parent(i)))
+//
+//   In the layout of Mat4::Translate and RotateX/Y/Z that is the
+//   parent's transform applied after the node's own.
+//
+//   Nodes live in one linear array in parent-before-child order:
+//   AddNode only accepts a parent that already exists. Local and
+//   world matrices are xMatrix4 arrays aligned to 64 bytes, one
+//   cache line per matrix.
+//
+//   SetLocal marks a node dirty. Update files the dirty nodes by
+//   depth, then goes down one level at a time: it recomputes the
+//   level and queues the children of everything it recomputed for
+//   the next. Its cost follows the moved subtrees, not the size of
+//   the hierarchy. The nodes of one level do not depend on each
+//   other; by default levels wider than kHierarchyGrain are split
+//   across the thread pool (xParallel.h).
+//
+//--------------------------------------------------------------//
+#ifndef __XTRANSFORMHIERARCHY_H__
+#define __XTRANSFORMHIERARCHY_H__ 1
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <xmmintrin.h>
+#include "xMatrix4.h"
+#include "xParallel.h"
+#include "matrix_4.h"
+
+const size_t kHierarchyAlignment = 64;
+const size_t kHierarchyGrain = 2048;
+// Parent of a root.
+const uint32_t kNoParent = 0xFFFFFFFFu;
+
+class xTransformHierarchy {
+public:
+
+	xTransformHierarchy();
+	~xTransformHierarchy();
+
+	// Appends a node and returns its index. parent is kNoParent for a
+	// root or the index of an existing node. New nodes start dirty.
+	uint32_t AddNode(uint32_t parent, const xMatrix4& local);
+	uint32_t AddNode(uint32_t parent, const Mat4& local);
+	void Reserve(size_t size);
+	void Clear();
+
+	size_t Count() const;
+	size_t Depth() const;
+	uint32_t Parent(uint32_t node) const;
+	uint32_t Level(uint32_t node) const;
+
+	void SetLocal(uint32_t node, const xMatrix4& local);
+	void SetLocal(uint32_t node, const Mat4& local);
+	const xMatrix4& Local(uint32_t node) const;
+	// As of the last Update.
+	const xMatrix4& World(uint32_t node) const;
+	const xMatrix4* Worlds() const;
+	bool IsDirty(uint32_t node) const;
+
+	// Recomputes the world matrices of dirty nodes and their descendants
+	// and returns how many were recomputed.
+	template<typename Policy = xParallelPolicy>
+	size_t Update(Policy policy = Policy());
+	// Recomputes every world matrix.
+	template<typename Policy = xParallelPolicy>
+	size_t UpdateAll(Policy policy = Policy());
+
+private:
+	xTransformHierarchy(const xTransformHierarchy&) = delete;
+	xTransformHierarchy& operator=(const xTransformHierarchy&) = delete;
+
+	enum NodeState { kClean, kDirty, kScheduled };
+
+	void MarkDirty(uint32_t node);
+	template<typename Policy>
+	void UpdateLevel(const uint32_t* nodes, size_t count, Policy policy);
+
+	xMatrix4* local_;
+	xMatrix4* world_;
+	size_t count_;
+	size_t capacity_;
+	std::vector<uint32_t> parent_;
+	// Child lists in ascending order; kNoParent ends them.
+	std::vector<uint32_t> first_child_;
+	std::vector<uint32_t> last_child_;
+	std::vector<uint32_t> next_sibling_;
+	std::vector<uint32_t> level_;
+	std::vector<uint8_t> state_;
+	// Nodes marked kDirty since the last Update.
+	std::vector<uint32_t> dirty_;
+	// Scratch for Update: nodes to recompute, one list per level.
+	std::vector<std::vector<uint32_t> > work_;
+};
+
+inline xTransformHierarchy::xTransformHierarchy() : local_(NULL), world_(NULL), count_(0), capacity_(0) {}
+
+inline xTransformHierarchy::~xTransformHierarchy() {
+	_mm_free(local_);
+	_mm_free(world_);
+}
+
+inline void xTransformHierarchy::Reserve(size_t size) {
+	if(size <= capacity_) return;
+	xMatrix4* new_local = (xMatrix4*)_mm_malloc(size * sizeof(xMatrix4), kHierarchyAlignment);
+	xMatrix4* new_world = (xMatrix4*)_mm_malloc(size * sizeof(xMatrix4), kHierarchyAlignment);
+	if(count_) {
+		memcpy(new_local, local_, count_ * sizeof(xMatrix4));
+		memcpy(new_world, world_, count_ * sizeof(xMatrix4));
+	}
+	_mm_free(local_);
+	_mm_free(world_);
+	local_ = new_local;
+	world_ = new_world;
+	capacity_ = size;
+	parent_.reserve(size);
+	first_child_.reserve(size);
+	last_child_.reserve(size);
+	next_sibling_.reserve(size);
+	level_.reserve(size);
+	state_.reserve(size);
+}
+
+inline void xTransformHierarchy::Clear() {
+	count_ = 0;
+	parent_.clear();
+	first_child_.clear();
+	last_child_.clear();
+	next_sibling_.clear();
+	level_.clear();
+	state_.clear();
+	dirty_.clear();
+	work_.clear();
+}
+
+inline uint32_t xTransformHierarchy::AddNode(uint32_t parent, const xMatrix4& local) {
+	assert(parent == kNoParent || parent < count_);
+	if(count_ == capacity_) Reserve(capacity_ ? capacity_ * 2 : 64);
+
+	uint32_t node = (uint32_t)count_++;
+	local_[node] = local;
+	world_[node] = local;
+	parent_.push_back(parent);
+	first_child_.push_back(kNoParent);
+	last_child_.push_back(kNoParent);
+	next_sibling_.push_back(kNoParent);
+	level_.push_back(parent == kNoParent ? 0 : level_[parent] + 1);
+	if(parent != kNoParent) {
+		if(last_child_[parent] == kNoParent) first_child_[parent] = node;
+		else next_sibling_[last_child_[parent]] = node;
+		last_child_[parent] = node;
+	}
+	if(level_[node] == work_.size()) work_.push_back(std::vector<uint32_t>());
+	state_.push_back(kClean);
+	MarkDirty(node);
+	return node;
+}
+
+inline uint32_t xTransformHierarchy::AddNode(uint32_t parent, const Mat4& local) {
+	return AddNode(parent, xMatrix4(local));
+}
+
+inline size_t xTransformHierarchy::Count() const {
+	return count_;
+}
+
+inline size_t xTransformHierarchy::Depth() const {
+	return work_.size();
+}
+
+inline uint32_t xTransformHierarchy::Parent(uint32_t node) const {
+	return parent_[node];
+}
+
+inline uint32_t xTransformHierarchy::Level(uint32_t node) const {
+	return level_[node];
+}
+
+inline void xTransformHierarchy::MarkDirty(uint32_t node) {
+	if(state_[node] != kClean) return;
+	state_[node] = kDirty;
+	dirty_.push_back(node);
+}
+
+inline void xTransformHierarchy::SetLocal(uint32_t node, const xMatrix4& local) {
+	local_[node] = local;
+	MarkDirty(node);
+}
+
+inline void xTransformHierarchy::SetLocal(uint32_t node, const Mat4& local) {
+	SetLocal(node, xMatrix4(local));
+}
+
+inline const xMatrix4& xTransformHierarchy::Local(uint32_t node) const {
+	return local_[node];
+}
+
+inline const xMatrix4& xTransformHierarchy::World(uint32_t node) const {
+	return world_[node];
+}
+
+inline const xMatrix4* xTransformHierarchy::Worlds() const {
+	return world_;
+}
+
+inline bool xTransformHierarchy::IsDirty(uint32_t node) const {
+	return state_[node] != kClean;
+}
+
+template<typename Policy>
+inline void xTransformHierarchy::UpdateLevel(const uint32_t* nodes, size_t count, Policy policy) {
+	ParallelFor(policy, count, kHierarchyGrain, [this, nodes](size_t begin, size_t end){
+		for(size_t k = begin; k < end; ++k){
+			uint32_t node = nodes[k];
+			uint32_t parent = parent_[node];
+			world_[node] = parent == kNoParent ? local_[node] : Multiply(local_[node], world_[parent]);
+		}
+	});
+}
+
+// A node is kScheduled from when it joins a work list until its level is
+// done, so a dirty node under another dirty one is queued only once.
+// A level lists its dirty nodes in the order they were marked, then the
+// children of the level above in that level's order, so it is not sorted
+// and may read the matrix arrays out of order.
+template<typename Policy>
+inline size_t xTransformHierarchy::Update(Policy policy) {
+	if(dirty_.empty()) return 0;
+	size_t first = work_.size();
+	for(size_t d = 0; d < dirty_.size(); ++d){
+		uint32_t node = dirty_[d];
+		state_[node] = kScheduled;
+		work_[level_[node]].push_back(node);
+		if(level_[node] < first) first = level_[node];
+	}
+	dirty_.clear();
+
+	size_t updated = 0;
+	for(size_t l = first; l < work_.size(); ++l){
+		std::vector<uint32_t>& nodes = work_[l];
+		if(nodes.empty()) continue;
+		UpdateLevel(&nodes[0], nodes.size(), policy);
+		for(size_t k = 0; k < nodes.size(); ++k){
+			for(uint32_t child = first_child_[nodes[k]]; child != kNoParent; child = next_sibling_[child]){
+				if(state_[child] == kScheduled) continue;
+				state_[child] = kScheduled;
+				work_[l + 1].push_back(child);
+			}
+			state_[nodes[k]] = kClean;
+		}
+		updated += nodes.size();
+		nodes.clear();
+	}
+	return updated;
+}
+
+// Every node is under some root, so dirtying the roots reaches them all.
+template<typename Policy>
+inline size_t xTransformHierarchy::UpdateAll(Policy policy) {
+	for(size_t node = 0; node < count_; ++node)
+		if(parent_[node] == kNoParent) MarkDirty((uint32_t)node);
+	return Update(policy);
+}
+
+#endif // __XTRANSFORMHIERARCHY_H__
@@ -0,0 +1,318 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Vec3 Structure-of-Arrays Stream.
+//--------------------------------------------------------------//
+//
+//   x[0] x[1] x[2] ... x[count - 1]
+//   y[0] y[1] y[2] ... y[count - 1]
+//   z[0] z[1] z[2] ... z[count - 1]
+//
+//   Every lane of every register carries a useful component, so the
+//   kernels below do kLaneWidth vectors per instruction (8 with
+//   AVX2, 16 with AVX-512) and never need a horizontal add. Arrays are 64-byte
+//   aligned and the last partial register is handled with masked
+//   loads and stores.
+//
+//--------------------------------------------------------------//
+#ifndef __XVEC3SOA_H__
+#define __XVEC3SOA_H__ 1
+
+#include <assert.h>
+#include <stddef.h>
+#include <string.h>
+#include <xmmintrin.h>
+#include "xSimd.h"
+#include "xDispatch.h"
+#include "xParallel.h"
+#include "xTranscendental.h"
+#include "xVector3.h"
+#include "vector_3.h"
+
+const size_t kSoAAlignment = 64;
+// Items per task when a policy runs the functions below in parallel.
+const size_t kSoAGrain = 16384;
+
+struct Vec3SoA {
+
+	Vec3SoA() : x(NULL), y(NULL), z(NULL), count(0), capacity(0) {}
+	explicit Vec3SoA(size_t size) : x(NULL), y(NULL), z(NULL), count(0), capacity(0) { Resize(size); }
+	Vec3SoA(const Vec3* values, size_t size) : x(NULL), y(NULL), z(NULL), count(0), capacity(0) {
+		Resize(size);
+		for(size_t i = 0; i < size; ++i) Set(i, values[i]);
+	}
+	Vec3SoA(const Vec3SoA& copy) : x(NULL), y(NULL), z(NULL), count(0), capacity(0) {
+		*this = copy;
+	}
+	~Vec3SoA() { Release(); }
+
+	Vec3SoA& operator=(const Vec3SoA& other) {
+		if(this == &other) return *this;
+		Resize(other.count);
+		memcpy(x, other.x, count * sizeof(float));
+		memcpy(y, other.y, count * sizeof(float));
+		memcpy(z, other.z, count * sizeof(float));
+		return *this;
+	}
+
+	// Keeps the first min(count, size) elements; new elements are zero.
+	void Resize(size_t size) {
+		if(size > capacity) {
+			size_t new_capacity = (size + 15) & ~(size_t)15;
+			float* new_x = (float*)_mm_malloc(new_capacity * sizeof(float), kSoAAlignment);
+			float* new_y = (float*)_mm_malloc(new_capacity * sizeof(float), kSoAAlignment);
+			float* new_z = (float*)_mm_malloc(new_capacity * sizeof(float), kSoAAlignment);
+			if(count) {
+				memcpy(new_x, x, count * sizeof(float));
+				memcpy(new_y, y, count * sizeof(float));
+				memcpy(new_z, z, count * sizeof(float));
+			}
+			Release();
+			x = new_x; y = new_y; z = new_z;
+			capacity = new_capacity;
+		}
+		if(size > count) {
+			memset(x + count, 0, (size - count) * sizeof(float));
+			memset(y + count, 0, (size - count) * sizeof(float));
+			memset(z + count, 0, (size - count) * sizeof(float));
+		}
+		count = size;
+	}
+
+	__forceinline Vec3 Get(size_t i) const { return Vec3(x[i], y[i], z[i]); }
+	xVector3 GetX(size_t i) const { return xVector3(x[i], y[i], z[i]); }
+	void Set(size_t i, const Vec3& v) { x[i] = v.x; y[i] = v.y; z[i] = v.z; }
+	void Set(size_t i, xVector3 v) { x[i] = v.x(); y[i] = v.y(); z[i] = v.z(); }
+
+	void ToAoS(Vec3* out) const {
+		for(size_t i = 0; i < count; ++i) { out[i].x = x[i]; out[i].y = y[i]; out[i].z = z[i]; }
+	}
+
+	float* x;
+	float* y;
+	float* z;
+	size_t count;
+	size_t capacity;
+
+ private:
+	void Release() {
+		_mm_free(x); _mm_free(y); _mm_free(z);
+		x = NULL; y = NULL; z = NULL;
+		capacity = 0;
+	}
+};
+
+// Per-ISA kernels. They expect *out to be sized already and are reached
+// through the public functions below.
+inline namespace XMATH_ISA {
+
+inline void SoAAddKernel(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		LaneStore(out->x + i, LaneAdd(LaneLoad(a.x + i, n), LaneLoad(b.x + i, n)), n);
+		LaneStore(out->y + i, LaneAdd(LaneLoad(a.y + i, n), LaneLoad(b.y + i, n)), n);
+		LaneStore(out->z + i, LaneAdd(LaneLoad(a.z + i, n), LaneLoad(b.z + i, n)), n);
+	});
+}
+
+inline void SoASubtractKernel(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		LaneStore(out->x + i, LaneSub(LaneLoad(a.x + i, n), LaneLoad(b.x + i, n)), n);
+		LaneStore(out->y + i, LaneSub(LaneLoad(a.y + i, n), LaneLoad(b.y + i, n)), n);
+		LaneStore(out->z + i, LaneSub(LaneLoad(a.z + i, n), LaneLoad(b.z + i, n)), n);
+	});
+}
+
+inline void SoAScaleKernel(const Vec3SoA& a, float scale, Vec3SoA* out, size_t begin, size_t end){
+	xLane s = LaneSet(scale);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		LaneStore(out->x + i, LaneMul(LaneLoad(a.x + i, n), s), n);
+		LaneStore(out->y + i, LaneMul(LaneLoad(a.y + i, n), s), n);
+		LaneStore(out->z + i, LaneMul(LaneLoad(a.z + i, n), s), n);
+	});
+}
+
+__forceinline xLane __vectorcall LaneDot3(xLane ax, xLane ay, xLane az, xLane bx, xLane by, xLane bz){
+	return LaneMultiplyAdd(az, bz, LaneMultiplyAdd(ay, by, LaneMul(ax, bx)));
+}
+
+inline void SoADotProductKernel(const Vec3SoA& a, const Vec3SoA& b, float* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		LaneStore(out + i, LaneDot3(LaneLoad(a.x + i, n), LaneLoad(a.y + i, n), LaneLoad(a.z + i, n),
+		                            LaneLoad(b.x + i, n), LaneLoad(b.y + i, n), LaneLoad(b.z + i, n)), n);
+	});
+}
+
+inline void SoACrossProductKernel(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane ax = LaneLoad(a.x + i, n), ay = LaneLoad(a.y + i, n), az = LaneLoad(a.z + i, n);
+		xLane bx = LaneLoad(b.x + i, n), by = LaneLoad(b.y + i, n), bz = LaneLoad(b.z + i, n);
+		LaneStore(out->x + i, LaneSub(LaneMul(ay, bz), LaneMul(az, by)), n);
+		LaneStore(out->y + i, LaneSub(LaneMul(az, bx), LaneMul(ax, bz)), n);
+		LaneStore(out->z + i, LaneSub(LaneMul(ax, by), LaneMul(ay, bx)), n);
+	});
+}
+
+inline void SoAMagnitudeKernel(const Vec3SoA& a, float* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane ax = LaneLoad(a.x + i, n), ay = LaneLoad(a.y + i, n), az = LaneLoad(a.z + i, n);
+		LaneStore(out + i, LaneSqrt(LaneDot3(ax, ay, az, ax, ay, az)), n);
+	});
+}
+
+template<int kPrecision>
+inline void SoANormalizeKernel(const Vec3SoA& a, Vec3SoA* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane ax = LaneLoad(a.x + i, n), ay = LaneLoad(a.y + i, n), az = LaneLoad(a.z + i, n);
+		xLane inverse = LaneReciprocalSqrt<kPrecision>(LaneDot3(ax, ay, az, ax, ay, az));
+		LaneStore(out->x + i, LaneMul(ax, inverse), n);
+		LaneStore(out->y + i, LaneMul(ay, inverse), n);
+		LaneStore(out->z + i, LaneMul(az, inverse), n);
+	});
+}
+
+inline void SoADistanceKernel(const Vec3SoA& a, const Vec3SoA& b, float* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane dx = LaneSub(LaneLoad(a.x + i, n), LaneLoad(b.x + i, n));
+		xLane dy = LaneSub(LaneLoad(a.y + i, n), LaneLoad(b.y + i, n));
+		xLane dz = LaneSub(LaneLoad(a.z + i, n), LaneLoad(b.z + i, n));
+		LaneStore(out + i, LaneSqrt(LaneDot3(dx, dy, dz, dx, dy, dz)), n);
+	});
+}
+
+inline void SoALerpKernel(const Vec3SoA& a, const Vec3SoA& b, float t, Vec3SoA* out, size_t begin, size_t end){
+	xLane s = LaneSet(t);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane ax = LaneLoad(a.x + i, n), ay = LaneLoad(a.y + i, n), az = LaneLoad(a.z + i, n);
+		LaneStore(out->x + i, LaneMultiplyAdd(LaneSub(LaneLoad(b.x + i, n), ax), s, ax), n);
+		LaneStore(out->y + i, LaneMultiplyAdd(LaneSub(LaneLoad(b.y + i, n), ay), s, ay), n);
+		LaneStore(out->z + i, LaneMultiplyAdd(LaneSub(LaneLoad(b.z + i, n), az), s, az), n);
+	});
+}
+
+inline void SoAReflectKernel(const Vec3SoA& direction, const Vec3SoA& normal, Vec3SoA* out, size_t begin, size_t end){
+	xLane minus_two = LaneSet(-2.0f);
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane dx = LaneLoad(direction.x + i, n), dy = LaneLoad(direction.y + i, n), dz = LaneLoad(direction.z + i, n);
+		xLane nx = LaneLoad(normal.x + i, n), ny = LaneLoad(normal.y + i, n), nz = LaneLoad(normal.z + i, n);
+		xLane k = LaneMul(LaneDot3(dx, dy, dz, nx, ny, nz), minus_two);
+		LaneStore(out->x + i, LaneMultiplyAdd(nx, k, dx), n);
+		LaneStore(out->y + i, LaneMultiplyAdd(ny, k, dy), n);
+		LaneStore(out->z + i, LaneMultiplyAdd(nz, k, dz), n);
+	});
+}
+
+// The cosine is clamped to [-1, 1] so rounding never turns parallel
+// vectors into NaN.
+inline void SoAAngleKernel(const Vec3SoA& a, const Vec3SoA& b, float* out, size_t begin, size_t end){
+	LaneLoop(begin, end, [&](size_t i, size_t n){
+		xLane ax = LaneLoad(a.x + i, n), ay = LaneLoad(a.y + i, n), az = LaneLoad(a.z + i, n);
+		xLane bx = LaneLoad(b.x + i, n), by = LaneLoad(b.y + i, n), bz = LaneLoad(b.z + i, n);
+		xLane length_product = LaneMul(LaneDot3(ax, ay, az, ax, ay, az), LaneDot3(bx, by, bz, bx, by, bz));
+		xLane cosine = LaneDiv(LaneDot3(ax, ay, az, bx, by, bz), LaneSqrt(length_product));
+		cosine = LaneMin(LaneMax(cosine, LaneSet(-1.0f)), LaneSet(1.0f));
+		LaneStore(out + i, Acos(cosine), n);
+	});
+}
+
+} // namespace XMATH_ISA
+
+// All of these size *out to the input count and allow out to alias an input.
+// The trailing policy is kSequential or kParallel (xParallel.h).
+
+template<typename Policy = xSequentialPolicy>
+inline void Add(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, Policy policy = Policy()){
+	assert(a.count == b.count);
+	out->Resize(a.count);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoAAdd)(a, b, out, begin, end);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Subtract(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, Policy policy = Policy()){
+	assert(a.count == b.count);
+	out->Resize(a.count);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoASubtract)(a, b, out, begin, end);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Scale(const Vec3SoA& a, float scale, Vec3SoA* out, Policy policy = Policy()){
+	out->Resize(a.count);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoAScale)(a, scale, out, begin, end);
+	});
+}
+
+// out[i] = DotProduct(a[i], b[i]); out holds a.count floats.
+template<typename Policy = xSequentialPolicy>
+inline void DotProduct(const Vec3SoA& a, const Vec3SoA& b, float* out, Policy policy = Policy()){
+	assert(a.count == b.count);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoADotProduct)(a, b, out, begin, end);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void CrossProduct(const Vec3SoA& a, const Vec3SoA& b, Vec3SoA* out, Policy policy = Policy()){
+	assert(a.count == b.count);
+	out->Resize(a.count);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoACrossProduct)(a, b, out, begin, end);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Magnitude(const Vec3SoA& a, float* out, Policy policy = Policy()){
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoAMagnitude)(a, out, begin, end);
+	});
+}
+
+template<int kPrecision = kPrecisionExact, typename Policy = xSequentialPolicy>
+inline void Normalize(const Vec3SoA& a, Vec3SoA* out, Policy policy = Policy()){
+	out->Resize(a.count);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH_PRECISION(SoANormalize, kPrecision)(a, out, begin, end);
+	});
+}
+
+// out[i] = Vec3::Angle(a[i], b[i]), with the lane Acos in place of acosf.
+template<typename Policy = xSequentialPolicy>
+inline void Angle(const Vec3SoA& a, const Vec3SoA& b, float* out, Policy policy = Policy()){
+	assert(a.count == b.count);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoAAngle)(a, b, out, begin, end);
+	});
+}
+
+template<typename Policy = xSequentialPolicy>
+inline void Distance(const Vec3SoA& a, const Vec3SoA& b, float* out, Policy policy = Policy()){
+	assert(a.count == b.count);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoADistance)(a, b, out, begin, end);
+	});
+}
+
+// a + (b - a) * t with t clamped to [0, 1], like Vec3::Lerp.
+template<typename Policy = xSequentialPolicy>
+inline void Lerp(const Vec3SoA& a, const Vec3SoA& b, float t, Vec3SoA* out, Policy policy = Policy()){
+	assert(a.count == b.count);
+	out->Resize(a.count);
+	t = MathUtils::Clamp(t, 0.0f, 1.0f);
+	ParallelFor(policy, a.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoALerp)(a, b, t, out, begin, end);
+	});
+}
+
+// direction - normal * (2 * DotProduct(direction, normal)), like Reflect.
+template<typename Policy = xSequentialPolicy>
+inline void Reflect(const Vec3SoA& direction, const Vec3SoA& normal, Vec3SoA* out, Policy policy = Policy()){
+	assert(direction.count == normal.count);
+	out->Resize(direction.count);
+	ParallelFor(policy, direction.count, kSoAGrain, [&](size_t begin, size_t end){
+		XMATH_DISPATCH(SoAReflect)(direction, normal, out, begin, end);
+	});
+}
+
+#endif // __XVEC3SOA_H__
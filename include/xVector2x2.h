@@ -0,0 +1,242 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  SSE Vector 2 Pair Definition.
+//--------------------------------------------------------------//
+//
+//   xmm = a.x a.y b.x b.y
+//
+//   Two independent Vec2 in one register, in the order two
+//   consecutive elements of a Vec2 array sit in memory, so a pair
+//   loads and stores with one unaligned move. Arithmetic is per
+//   lane. Reductions work per pair: the ...V forms return
+//   (ra, ra, rb, rb) and the scalar forms return a Vec2 holding
+//   (ra, rb).
+//
+//--------------------------------------------------------------//
+#ifndef __XVECTOR2X2_H__
+#define __XVECTOR2X2_H__ 1
+
+#include <stdio.h>
+#include <xmmintrin.h>
+#include "xSimd.h"
+#include "vector_2.h"
+#include "math_utils.h"
+
+struct xVector2x2 {
+
+	__forceinline xVector2x2() {}
+	__forceinline explicit xVector2x2(float ax, float ay, float bx, float by) { xmm = _mm_setr_ps(ax, ay, bx, by); }
+	__forceinline explicit xVector2x2(float value) { xmm = _mm_set1_ps(value); }
+	// Reads p[0..3], i.e. two consecutive Vec2 of an array.
+	__forceinline explicit xVector2x2(const float* p) { xmm = _mm_loadu_ps(p); }
+	__forceinline explicit xVector2x2(const Vec2* pair) { xmm = _mm_loadu_ps(&pair->x); }
+	__forceinline explicit xVector2x2(__m128 m) { xmm = m; }
+	__forceinline explicit xVector2x2(const Vec2& a, const Vec2& b) { xmm = _mm_setr_ps(a.x, a.y, b.x, b.y); }
+
+	__forceinline Vec2 __vectorcall a() const { return Vec2(xmm.m128_f32[0], xmm.m128_f32[1]); }
+	__forceinline Vec2 __vectorcall b() const { return Vec2(xmm.m128_f32[2], xmm.m128_f32[3]); }
+
+	__forceinline void __vectorcall store(float* p) const { _mm_storeu_ps(p, xmm); }
+	// Writes pair[0] and pair[1].
+	__forceinline void __vectorcall store(Vec2* pair) const { _mm_storeu_ps(&pair->x, xmm); }
+
+	__forceinline float __vectorcall operator[] (size_t i) const { return xmm.m128_f32[i]; }
+	__forceinline float& __vectorcall operator[] (size_t i) { return xmm.m128_f32[i]; }
+
+	__m128 xmm;
+
+};
+
+inline namespace XMATH_ISA {
+
+// (ra, ra, rb, rb) from a register whose pair sums are wanted.
+__forceinline __m128 __vectorcall PairSum(__m128 v){
+	return _mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+// (lane 0, lane 2) of a ...V result.
+__forceinline Vec2 __vectorcall PairResult(__m128 v){
+	return Vec2(_mm_cvtss_f32(v), _mm_cvtss_f32(_mm_movehl_ps(v, v)));
+}
+
+__forceinline xVector2x2 __vectorcall operator+(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_add_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator+(xVector2x2 a, float b){
+	a.xmm = _mm_add_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator-(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_sub_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator-(xVector2x2 a, float b){
+	a.xmm = _mm_sub_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator*(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_mul_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator*(xVector2x2 a, float b){
+	a.xmm = _mm_mul_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator*(float a, xVector2x2 b){
+	b.xmm = _mm_mul_ps(_mm_set1_ps(a), b.xmm);
+	return b;
+}
+
+__forceinline xVector2x2 __vectorcall operator/(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_div_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator/(xVector2x2 a, float b){
+	a.xmm = _mm_div_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator/(float a, xVector2x2 b){
+	b.xmm = _mm_div_ps(_mm_set1_ps(a), b.xmm);
+	return b;
+}
+
+__forceinline xVector2x2& __vectorcall operator+=(xVector2x2& a, xVector2x2 b) { a = a + b; return a; }
+__forceinline xVector2x2& __vectorcall operator+=(xVector2x2& a, float b) { a = a + b; return a; }
+__forceinline xVector2x2& __vectorcall operator-=(xVector2x2& a, xVector2x2 b) { a = a - b; return a; }
+__forceinline xVector2x2& __vectorcall operator-=(xVector2x2& a, float b) { a = a - b; return a; }
+__forceinline xVector2x2& __vectorcall operator*=(xVector2x2& a, xVector2x2 b) { a = a * b; return a; }
+__forceinline xVector2x2& __vectorcall operator*=(xVector2x2& a, float b) { a = a * b; return a; }
+__forceinline xVector2x2& __vectorcall operator/=(xVector2x2& a, xVector2x2 b) { a = a / b; return a; }
+__forceinline xVector2x2& __vectorcall operator/=(xVector2x2& a, float b) { a = a / b; return a; }
+
+// Comparisons return a lane mask, like xVector3.
+__forceinline xVector2x2 __vectorcall operator==(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_cmpeq_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator!=(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_cmpneq_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator>(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_cmpgt_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator<(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_cmplt_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator>=(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_cmpge_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator<=(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_cmple_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall operator-(xVector2x2 a){
+	a.xmm = _mm_xor_ps(a.xmm, _mm_set1_ps(-0.0f));
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall Abs(xVector2x2 a){
+	a.xmm = _mm_andnot_ps(_mm_set1_ps(-0.0f), a.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall Max(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_max_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall Min(xVector2x2 a, xVector2x2 b){
+	a.xmm = _mm_min_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector2x2 __vectorcall Clamp(xVector2x2 t, xVector2x2 a, xVector2x2 b){
+	return Min(Max(t, a), b);
+}
+
+__forceinline __m128 __vectorcall DotProductV(xVector2x2 a, xVector2x2 b){
+	return PairSum(_mm_mul_ps(a.xmm, b.xmm));
+}
+
+__forceinline __m128 __vectorcall SqrMagnitudeV(xVector2x2 a){
+	return PairSum(_mm_mul_ps(a.xmm, a.xmm));
+}
+
+__forceinline __m128 __vectorcall MagnitudeV(xVector2x2 a){
+	return _mm_sqrt_ps(SqrMagnitudeV(a));
+}
+
+__forceinline __m128 __vectorcall DistanceV(xVector2x2 a, xVector2x2 b){
+	return MagnitudeV(a - b);
+}
+
+__forceinline Vec2 __vectorcall DotProduct(xVector2x2 a, xVector2x2 b){
+	return PairResult(DotProductV(a, b));
+}
+
+__forceinline Vec2 __vectorcall SqrMagnitude(xVector2x2 a){
+	return PairResult(SqrMagnitudeV(a));
+}
+
+__forceinline Vec2 __vectorcall Magnitude(xVector2x2 a){
+	return PairResult(MagnitudeV(a));
+}
+
+__forceinline Vec2 __vectorcall Distance(xVector2x2 a, xVector2x2 b){
+	return PairResult(DistanceV(a, b));
+}
+
+template<int kPrecision = kPrecisionExact>
+__forceinline xVector2x2 __vectorcall Normalize(xVector2x2 a){
+	if(kPrecision == kPrecisionExact) return xVector2x2(_mm_div_ps(a.xmm, MagnitudeV(a)));
+	return xVector2x2(_mm_mul_ps(a.xmm, ReciprocalSqrt<kPrecision>(SqrMagnitudeV(a))));
+}
+
+template<int kPrecision = kPrecisionExact>
+__forceinline xVector2x2 __vectorcall Divide(xVector2x2 a, xVector2x2 b){
+	if(kPrecision == kPrecisionExact) return a / b;
+	return xVector2x2(_mm_mul_ps(a.xmm, Reciprocal<kPrecision>(b.xmm)));
+}
+
+template<int kPrecision = kPrecisionExact>
+__forceinline xVector2x2 __vectorcall Divide(xVector2x2 a, float b){
+	if(kPrecision == kPrecisionExact) return a / b;
+	return xVector2x2(_mm_mul_ps(a.xmm, Reciprocal<kPrecision>(_mm_set1_ps(b))));
+}
+
+__forceinline xVector2x2 __vectorcall LerpUnclamped(xVector2x2 a, xVector2x2 b, float t){
+	return xVector2x2(MultiplyAdd(_mm_sub_ps(b.xmm, a.xmm), _mm_set1_ps(t), a.xmm));
+}
+
+// t clamped to [0, 1], like Vec2::Lerp.
+__forceinline xVector2x2 __vectorcall Lerp(xVector2x2 a, xVector2x2 b, float t){
+	return LerpUnclamped(a, b, MathUtils::Clamp(t, 0.0f, 1.0f));
+}
+
+} // namespace XMATH_ISA
+
+inline void Print(xVector2x2* p){
+	float* pointer = (float*)&p->xmm;
+	printf("A[%f, %f] B[%f, %f] \n", pointer[0], pointer[1], pointer[2], pointer[3]);
+}
+
+#endif // __XVECTOR2X2_H__
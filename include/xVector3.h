@@ -6,6 +6,7 @@
 #include <stdint.h>
 #include <math.h>
 #include <xmmintrin.h>
+#include "xSimd.h"
 
 struct xVector3 {
 
@@ -43,12 +44,14 @@ struct xVector3 {
 
 };
 
-xVector3 __vectorcall operator+(xVector3 a, xVector3 b){
+inline namespace XMATH_ISA {
+
+__forceinline xVector3 __vectorcall operator+(xVector3 a, xVector3 b){
 	a.xmm = _mm_add_ps(a.xmm, b.xmm);
 	return a;
 }
 
-__forceinline xVector3& __vectorcall operator+=(xVector3 a, xVector3 b){
+__forceinline xVector3& __vectorcall operator+=(xVector3& a, xVector3 b){
 	a = a + b;
 	return a;
 }
@@ -58,7 +61,7 @@ __forceinline xVector3 __vectorcall operator-(xVector3 a, xVector3 b){
 	return a;
 }
 
-__forceinline xVector3& __vectorcall operator-=(xVector3 a, xVector3 b){
+__forceinline xVector3& __vectorcall operator-=(xVector3& a, xVector3 b){
 	a = a - b;
 	return a;
 }
@@ -78,12 +81,12 @@ __forceinline xVector3 __vectorcall operator*(float a, xVector3 b){
 	return b;
 }
 
-__forceinline xVector3& __vectorcall operator*=(xVector3 a, xVector3 b){
+__forceinline xVector3& __vectorcall operator*=(xVector3& a, xVector3 b){
 	a = a * b;
 	return a;
 }
 
-__forceinline xVector3& __vectorcall operator*=(xVector3 a, float b){
+__forceinline xVector3& __vectorcall operator*=(xVector3& a, float b){
 	a = a * b; 
 	return a;
 }
@@ -103,12 +106,12 @@ __forceinline xVector3 __vectorcall operator/(float a, xVector3 b){
 	return b;
 }
 
-__forceinline xVector3& __vectorcall operator/=(xVector3 a, xVector3 b){
+__forceinline xVector3& __vectorcall operator/=(xVector3& a, xVector3 b){
 	a = a / b;
 	return a;
 }
 
-__forceinline xVector3& __vectorcall operator/=(xVector3 a, float b){
+__forceinline xVector3& __vectorcall operator/=(xVector3& a, float b){
 	a = a / b; 
 	return a;
 }
@@ -166,32 +169,84 @@ __forceinline xVector3 __vectorcall Clamp(xVector3 t, xVector3 a, xVector3 b){
 	return Min(Max(t, a), b);
 }
 
+// The ...V reductions return their result in every lane of an __m128, so
+// chained math stays in registers. The float versions extract lane 0.
+__forceinline __m128 __vectorcall SumV(xVector3 v){
+	return HorizontalAdd3(v.xmm);
+}
+
+__forceinline __m128 __vectorcall DotProductV(xVector3 a, xVector3 b){
+	return Dot3(a.xmm, b.xmm);
+}
+
+__forceinline __m128 __vectorcall SqrMagnitudeV(xVector3 a){
+	return Dot3(a.xmm, a.xmm);
+}
+
+__forceinline __m128 __vectorcall MagnitudeV(xVector3 a){
+	return _mm_sqrt_ps(Dot3(a.xmm, a.xmm));
+}
+
+__forceinline __m128 __vectorcall DistanceV(xVector3 a, xVector3 b){
+	return MagnitudeV(a - b);
+}
+
+// Exact: only the final acosf leaves the vector unit. Fast and Fastest
+// stay in registers with ReciprocalSqrt and AcosPolynomial; their error
+// is the polynomial bound plus the cosine error, which acos amplifies
+// for nearly parallel or opposite vectors.
+template<int kPrecision = kPrecisionExact>
+__forceinline __m128 __vectorcall AngleV(xVector3 a, xVector3 b){
+	__m128 length_product = _mm_mul_ps(SqrMagnitudeV(a), SqrMagnitudeV(b));
+	if(kPrecision == kPrecisionExact){
+		float cosine = _mm_cvtss_f32(_mm_div_ps(DotProductV(a, b), _mm_sqrt_ps(length_product)));
+		return _mm_set1_ps(acosf(cosine));
+	}
+	return AcosPolynomial<kPrecision>(_mm_mul_ps(DotProductV(a, b), ReciprocalSqrt<kPrecision>(length_product)));
+}
+
 __forceinline float __vectorcall Sum(xVector3 v){
-	return v.x() + v.y() + v.z();
+	return _mm_cvtss_f32(SumV(v));
 }
 
 __forceinline float __vectorcall DotProduct(xVector3 a, xVector3 b){
-	return Sum(a * b);
+	return _mm_cvtss_f32(DotProductV(a, b));
 }
 
 __forceinline float __vectorcall Magnitude(xVector3 a){
-	return sqrtf(DotProduct(a, a));
+	return _mm_cvtss_f32(MagnitudeV(a));
 }
 
 __forceinline float __vectorcall SqrMagnitude(xVector3 a){
-	return DotProduct(a, a);
+	return _mm_cvtss_f32(SqrMagnitudeV(a));
 }
 
+template<int kPrecision = kPrecisionExact>
 __forceinline float __vectorcall Angle(xVector3 a, xVector3 b){
-	return acosf(DotProduct(a ,b) / (Magnitude(a) * Magnitude(b)));
+	return _mm_cvtss_f32(AngleV<kPrecision>(a, b));
 }
 
 __forceinline float __vectorcall Distance(xVector3 a, xVector3 b){
-	return Magnitude(a - b);
+	return _mm_cvtss_f32(DistanceV(a, b));
 } 
 
+template<int kPrecision = kPrecisionExact>
 __forceinline xVector3 __vectorcall Normalize(xVector3 a){
-	return a * (1.0f / Magnitude(a));
+	if(kPrecision == kPrecisionExact) return xVector3(_mm_div_ps(a.xmm, MagnitudeV(a)));
+	return xVector3(_mm_mul_ps(a.xmm, ReciprocalSqrt<kPrecision>(SqrMagnitudeV(a))));
+}
+
+// operator/ at a chosen tier; Exact is the same as operator/.
+template<int kPrecision = kPrecisionExact>
+__forceinline xVector3 __vectorcall Divide(xVector3 a, xVector3 b){
+	if(kPrecision == kPrecisionExact) return a / b;
+	return xVector3(_mm_mul_ps(a.xmm, Reciprocal<kPrecision>(b.xmm)));
+}
+
+template<int kPrecision = kPrecisionExact>
+__forceinline xVector3 __vectorcall Divide(xVector3 a, float b){
+	if(kPrecision == kPrecisionExact) return a / b;
+	return xVector3(_mm_mul_ps(a.xmm, Reciprocal<kPrecision>(_mm_set1_ps(b))));
 }
 
 __forceinline xVector3 __vectorcall LerpUnclamped(xVector3 a, xVector3 b, float t){
@@ -202,20 +257,22 @@ __forceinline xVector3 __vectorcall LerpUnclamped(xVector3 a, xVector3 b, float
 
 // }
 
-// __forceinline xVector3 __vectorcall CrossProduct(xVector3 a, xVector3 b){
-
-// }
+__forceinline xVector3 __vectorcall CrossProduct(xVector3 a, xVector3 b){
+	return xVector3(Cross3(a.xmm, b.xmm));
+}
 
 __forceinline xVector3 __vectorcall Reflect(xVector3 direction, xVector3 normal){
-	return (direction - normal * (DotProduct(direction, normal) * 2.0f));
+	__m128 dot = DotProductV(direction, normal);
+	return direction - normal * xVector3(_mm_add_ps(dot, dot));
 }
 
 __forceinline xVector3 __vectorcall Scale(xVector3 a){
 	return xVector3(a * a);
 }
 
+} // namespace XMATH_ISA
 
-void Print(xVector3* p){
+inline void Print(xVector3* p){
 	float* pointer = (float*)&p->xmm;
 	printf("X[%03f] Y[%f] Z[%f] \n", pointer[0], pointer[1], pointer[2]);
 }
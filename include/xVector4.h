@@ -0,0 +1,249 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  SSE Vector 4 Definition.
+//--------------------------------------------------------------//
+//
+//   xmm = x y z w
+//
+//   All four lanes are live, so unlike xVector3 the reductions
+//   include w. Same memory order as Vec4, so converting either way
+//   is one unaligned load or store.
+//
+//--------------------------------------------------------------//
+#ifndef __XVECTOR4_H__
+#define __XVECTOR4_H__ 1
+
+#include <stdio.h>
+#include <xmmintrin.h>
+#include "xSimd.h"
+#include "xVector3.h"
+#include "vector_4.h"
+#include "math_utils.h"
+
+struct xVector4 {
+
+	__forceinline xVector4() {}
+	__forceinline explicit xVector4(float x, float y, float z, float w) { xmm = _mm_setr_ps(x, y, z, w); }
+	__forceinline explicit xVector4(float value) { xmm = _mm_set1_ps(value); }
+	__forceinline explicit xVector4(const float* p) { xmm = _mm_loadu_ps(p); }
+	__forceinline explicit xVector4(__m128 m) { xmm = m; }
+	__forceinline explicit xVector4(const Vec4& v) { xmm = _mm_loadu_ps(&v.x); }
+	__forceinline explicit xVector4(xVector3 v, float w) {
+		xmm = _mm_shuffle_ps(v.xmm, _mm_unpackhi_ps(v.xmm, _mm_set1_ps(w)), _MM_SHUFFLE(1, 0, 1, 0));
+	}
+
+	__forceinline float __vectorcall x() const { return _mm_cvtss_f32(xmm); }
+	__forceinline float __vectorcall y() const { return _mm_cvtss_f32(_mm_shuffle_ps(xmm, xmm, _MM_SHUFFLE(1, 1, 1, 1))); }
+	__forceinline float __vectorcall z() const { return _mm_cvtss_f32(_mm_shuffle_ps(xmm, xmm, _MM_SHUFFLE(2, 2, 2, 2))); }
+	__forceinline float __vectorcall w() const { return _mm_cvtss_f32(_mm_shuffle_ps(xmm, xmm, _MM_SHUFFLE(3, 3, 3, 3))); }
+
+	__forceinline void __vectorcall store(float* p) const { _mm_storeu_ps(p, xmm); }
+	__forceinline void __vectorcall store(Vec4* out) const { _mm_storeu_ps(&out->x, xmm); }
+
+	__forceinline Vec4 __vectorcall ToVec4() const {
+		Vec4 result;
+		store(&result);
+		return result;
+	}
+
+	// Drops w.
+	__forceinline xVector3 __vectorcall xyz() const { return xVector3(xmm); }
+
+	__forceinline float __vectorcall operator[] (size_t i) const { return xmm.m128_f32[i]; }
+	__forceinline float& __vectorcall operator[] (size_t i) { return xmm.m128_f32[i]; }
+
+	__m128 xmm;
+
+};
+
+inline namespace XMATH_ISA {
+
+__forceinline xVector4 __vectorcall operator+(xVector4 a, xVector4 b){
+	a.xmm = _mm_add_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator+(xVector4 a, float b){
+	a.xmm = _mm_add_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator-(xVector4 a, xVector4 b){
+	a.xmm = _mm_sub_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator-(xVector4 a, float b){
+	a.xmm = _mm_sub_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator*(xVector4 a, xVector4 b){
+	a.xmm = _mm_mul_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator*(xVector4 a, float b){
+	a.xmm = _mm_mul_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator*(float a, xVector4 b){
+	b.xmm = _mm_mul_ps(_mm_set1_ps(a), b.xmm);
+	return b;
+}
+
+__forceinline xVector4 __vectorcall operator/(xVector4 a, xVector4 b){
+	a.xmm = _mm_div_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator/(xVector4 a, float b){
+	a.xmm = _mm_div_ps(a.xmm, _mm_set1_ps(b));
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator/(float a, xVector4 b){
+	b.xmm = _mm_div_ps(_mm_set1_ps(a), b.xmm);
+	return b;
+}
+
+__forceinline xVector4& __vectorcall operator+=(xVector4& a, xVector4 b) { a = a + b; return a; }
+__forceinline xVector4& __vectorcall operator+=(xVector4& a, float b) { a = a + b; return a; }
+__forceinline xVector4& __vectorcall operator-=(xVector4& a, xVector4 b) { a = a - b; return a; }
+__forceinline xVector4& __vectorcall operator-=(xVector4& a, float b) { a = a - b; return a; }
+__forceinline xVector4& __vectorcall operator*=(xVector4& a, xVector4 b) { a = a * b; return a; }
+__forceinline xVector4& __vectorcall operator*=(xVector4& a, float b) { a = a * b; return a; }
+__forceinline xVector4& __vectorcall operator/=(xVector4& a, xVector4 b) { a = a / b; return a; }
+__forceinline xVector4& __vectorcall operator/=(xVector4& a, float b) { a = a / b; return a; }
+
+// Comparisons return a lane mask, like xVector3.
+__forceinline xVector4 __vectorcall operator==(xVector4 a, xVector4 b){
+	a.xmm = _mm_cmpeq_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator!=(xVector4 a, xVector4 b){
+	a.xmm = _mm_cmpneq_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator>(xVector4 a, xVector4 b){
+	a.xmm = _mm_cmpgt_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator<(xVector4 a, xVector4 b){
+	a.xmm = _mm_cmplt_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator>=(xVector4 a, xVector4 b){
+	a.xmm = _mm_cmpge_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator<=(xVector4 a, xVector4 b){
+	a.xmm = _mm_cmple_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall operator-(xVector4 a){
+	a.xmm = _mm_xor_ps(a.xmm, _mm_set1_ps(-0.0f));
+	return a;
+}
+
+__forceinline xVector4 __vectorcall Abs(xVector4 a){
+	a.xmm = _mm_andnot_ps(_mm_set1_ps(-0.0f), a.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall Max(xVector4 a, xVector4 b){
+	a.xmm = _mm_max_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall Min(xVector4 a, xVector4 b){
+	a.xmm = _mm_min_ps(a.xmm, b.xmm);
+	return a;
+}
+
+__forceinline xVector4 __vectorcall Clamp(xVector4 t, xVector4 a, xVector4 b){
+	return Min(Max(t, a), b);
+}
+
+__forceinline __m128 __vectorcall SumV(xVector4 v){
+	return HorizontalAdd4(v.xmm);
+}
+
+__forceinline __m128 __vectorcall DotProductV(xVector4 a, xVector4 b){
+	return Dot4(a.xmm, b.xmm);
+}
+
+__forceinline __m128 __vectorcall SqrMagnitudeV(xVector4 a){
+	return Dot4(a.xmm, a.xmm);
+}
+
+__forceinline __m128 __vectorcall MagnitudeV(xVector4 a){
+	return _mm_sqrt_ps(Dot4(a.xmm, a.xmm));
+}
+
+__forceinline __m128 __vectorcall DistanceV(xVector4 a, xVector4 b){
+	return MagnitudeV(a - b);
+}
+
+__forceinline float __vectorcall Sum(xVector4 v){
+	return _mm_cvtss_f32(SumV(v));
+}
+
+__forceinline float __vectorcall DotProduct(xVector4 a, xVector4 b){
+	return _mm_cvtss_f32(DotProductV(a, b));
+}
+
+__forceinline float __vectorcall SqrMagnitude(xVector4 a){
+	return _mm_cvtss_f32(SqrMagnitudeV(a));
+}
+
+__forceinline float __vectorcall Magnitude(xVector4 a){
+	return _mm_cvtss_f32(MagnitudeV(a));
+}
+
+__forceinline float __vectorcall Distance(xVector4 a, xVector4 b){
+	return _mm_cvtss_f32(DistanceV(a, b));
+}
+
+template<int kPrecision = kPrecisionExact>
+__forceinline xVector4 __vectorcall Normalize(xVector4 a){
+	if(kPrecision == kPrecisionExact) return xVector4(_mm_div_ps(a.xmm, MagnitudeV(a)));
+	return xVector4(_mm_mul_ps(a.xmm, ReciprocalSqrt<kPrecision>(SqrMagnitudeV(a))));
+}
+
+template<int kPrecision = kPrecisionExact>
+__forceinline xVector4 __vectorcall Divide(xVector4 a, xVector4 b){
+	if(kPrecision == kPrecisionExact) return a / b;
+	return xVector4(_mm_mul_ps(a.xmm, Reciprocal<kPrecision>(b.xmm)));
+}
+
+template<int kPrecision = kPrecisionExact>
+__forceinline xVector4 __vectorcall Divide(xVector4 a, float b){
+	if(kPrecision == kPrecisionExact) return a / b;
+	return xVector4(_mm_mul_ps(a.xmm, Reciprocal<kPrecision>(_mm_set1_ps(b))));
+}
+
+__forceinline xVector4 __vectorcall LerpUnclamped(xVector4 a, xVector4 b, float t){
+	return xVector4(MultiplyAdd(_mm_sub_ps(b.xmm, a.xmm), _mm_set1_ps(t), a.xmm));
+}
+
+// t clamped to [0, 1], like Vec4::Lerp.
+__forceinline xVector4 __vectorcall Lerp(xVector4 a, xVector4 b, float t){
+	return LerpUnclamped(a, b, MathUtils::Clamp(t, 0.0f, 1.0f));
+}
+
+} // namespace XMATH_ISA
+
+inline void Print(xVector4* p){
+	float* pointer = (float*)&p->xmm;
+	printf("X[%f] Y[%f] Z[%f] W[%f] \n", pointer[0], pointer[1], pointer[2], pointer[3]);
+}
+
+#endif // __XVECTOR4_H__
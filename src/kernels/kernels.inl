@@ -0,0 +1,118 @@
+//--------------------------------------------------------------//
+//  Math Library
+//  Batch Kernel Table.
+//--------------------------------------------------------------//
+//
+//   Single source for every batch kernel. Included by one .cc per
+//   ISA, each compiled with its own /arch flag; XMATH_ISA names the
+//   namespace the kernels land in for that build. Nothing outside
+//   that namespace may end up out of line here (xSimd.h).
+//
+//--------------------------------------------------------------//
+#include "xBounds.h"
+#include "xBvh.h"
+#include "xDispatch.h"
+#include "xFrustum.h"
+#include "xHashGrid.h"
+#include "xKdTree.h"
+#include "xMat4Batch.h"
+#include "xMatrix4.h"
+#include "xPairwise.h"
+#include "xQuatBatch.h"
+#include "xRay.h"
+#include "xTranscendental.h"
+#include "xTransform.h"
+#include "xTRSBatch.h"
+#include "xVec3SoA.h"
+
+namespace XMATH_ISA {
+
+void FillKernelTable(xKernelTable* table){
+	table->SoAAdd = SoAAddKernel;
+	table->SoASubtract = SoASubtractKernel;
+	table->SoAScale = SoAScaleKernel;
+	table->SoADotProduct = SoADotProductKernel;
+	table->SoACrossProduct = SoACrossProductKernel;
+	table->SoAMagnitude = SoAMagnitudeKernel;
+	table->SoANormalize[kPrecisionExact] = SoANormalizeKernel<kPrecisionExact>;
+	table->SoANormalize[kPrecisionFast] = SoANormalizeKernel<kPrecisionFast>;
+	table->SoANormalize[kPrecisionFastest] = SoANormalizeKernel<kPrecisionFastest>;
+	table->SoAAngle = SoAAngleKernel;
+	table->SoADistance = SoADistanceKernel;
+	table->SoALerp = SoALerpKernel;
+	table->SoAReflect = SoAReflectKernel;
+
+	table->TransformPointsVec3 = TransformPointsVec3Kernel;
+	table->TransformDirectionsVec3 = TransformDirectionsVec3Kernel;
+	table->TransformProjectiveVec3[kPrecisionExact] = TransformProjectiveVec3Kernel<kPrecisionExact>;
+	table->TransformProjectiveVec3[kPrecisionFast] = TransformProjectiveVec3Kernel<kPrecisionFast>;
+	table->TransformProjectiveVec3[kPrecisionFastest] = TransformProjectiveVec3Kernel<kPrecisionFastest>;
+	table->TransformPointsXVector3 = TransformPointsXVector3Kernel;
+	table->TransformDirectionsXVector3 = TransformDirectionsXVector3Kernel;
+	table->TransformProjectiveXVector3[kPrecisionExact] = TransformProjectiveXVector3Kernel<kPrecisionExact>;
+	table->TransformProjectiveXVector3[kPrecisionFast] = TransformProjectiveXVector3Kernel<kPrecisionFast>;
+	table->TransformProjectiveXVector3[kPrecisionFastest] = TransformProjectiveXVector3Kernel<kPrecisionFastest>;
+	table->TransformVec4 = TransformVec4Kernel;
+
+	table->InverseBatchXMatrix4 = InverseBatchXMatrix4Kernel;
+	table->InverseBatchMat4 = InverseBatchMat4Kernel;
+
+	table->SlerpQuat = SlerpQuatKernel;
+	table->NlerpQuat[kPrecisionExact] = NlerpQuatKernel<kPrecisionExact>;
+	table->NlerpQuat[kPrecisionFast] = NlerpQuatKernel<kPrecisionFast>;
+	table->NlerpQuat[kPrecisionFastest] = NlerpQuatKernel<kPrecisionFastest>;
+
+	table->ComposeTransforms = ComposeTransformsKernel;
+	table->ComposeTransformsEuler = ComposeTransformsEulerKernel;
+
+	table->CullSpheres = CullSpheresKernel;
+	table->CullBoxes = CullBoxesKernel;
+
+	table->BoundsSoA = BoundsSoAKernel;
+	table->BoundsStrided = BoundsStridedKernel;
+	table->FarthestSoA = FarthestSoAKernel;
+	table->FarthestStrided = FarthestStridedKernel;
+
+	table->IntersectTriangles = IntersectTrianglesKernel;
+	table->IntersectBoxes = IntersectBoxesKernel;
+	table->IntersectSpheres = IntersectSpheresKernel;
+	table->IntersectTrianglePacket = IntersectTrianglePacketKernel;
+	table->IntersectBoxPacket = IntersectBoxPacketKernel;
+	table->IntersectSpherePacket = IntersectSpherePacketKernel;
+
+	table->IntersectBvh4 = IntersectBvh4Kernel;
+	table->IntersectBvh8 = IntersectBvh8Kernel;
+	table->IntersectBvh4Rays = IntersectBvh4RaysKernel;
+	table->IntersectBvh8Rays = IntersectBvh8RaysKernel;
+
+	table->HashGridRadius = HashGridRadiusKernel;
+	table->HashGridNearest = HashGridNearestKernel;
+	table->HashGridNearestBatch = HashGridNearestBatchKernel;
+
+	table->KdTreeRadius = KdTreeRadiusKernel;
+	table->KdTreeNearest = KdTreeNearestKernel;
+	table->KdTreeNearestBatch = KdTreeNearestBatchKernel;
+	table->KdTreeRadiusBatch = KdTreeRadiusBatchKernel;
+
+	table->PairwiseDistances = PairwiseDistancesKernel;
+	table->PairwiseNearest = PairwiseNearestKernel;
+
+	table->Mat4MultiplyArrays = Mat4MultiplyArraysKernel;
+	table->Mat4MultiplyLeft = Mat4MultiplyLeftKernel;
+	table->Mat4MultiplyRight = Mat4MultiplyRightKernel;
+	table->Mat4SoAMultiply = Mat4SoAMultiplyKernel;
+	table->Mat4SoAMultiplyLeft = Mat4SoAMultiplyLeftKernel;
+	table->Mat4SoAMultiplyRight = Mat4SoAMultiplyRightKernel;
+	table->Mat4ToSoA = Mat4ToSoAKernel;
+	table->Mat4FromSoA = Mat4FromSoAKernel;
+
+	table->SinArray = SinArrayKernel;
+	table->CosArray = CosArrayKernel;
+	table->SinCosArray = SinCosArrayKernel;
+	table->AcosArray = AcosArrayKernel;
+	table->Atan2Array = Atan2ArrayKernel;
+	table->ExpArray = ExpArrayKernel;
+	table->SqrtArray = SqrtArrayKernel;
+}
+
+} // namespace XMATH_ISA
@@ -0,0 +1,5 @@
+#if !defined(__AVX2__) || defined(__AVX512F__)
+#error "kernels_avx2.cc must be built with /arch:AVX2"
+#endif
+
+#include "kernels.inl"
@@ -0,0 +1,5 @@
+#if !defined(__AVX512F__)
+#error "kernels_avx512.cc must be built with /arch:AVX512"
+#endif
+
+#include "kernels.inl"
@@ -0,0 +1,5 @@
+#if defined(__AVX2__) || defined(__AVX512F__)
+#error "kernels_sse2.cc must be built with /arch:SSE2"
+#endif
+
+#include "kernels.inl"
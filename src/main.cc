@@ -1,62 +1,50 @@
 
 #include <stdio.h>
-#include <chrono>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "xBounds.h"
+#include "xBvh.h"
+#include "xFrustum.h"
+#include "xHashGrid.h"
+#include "xKdTree.h"
+#include "xMat4Batch.h"
+#include "xPairwise.h"
+#include "xParallel.h"
+#include "xVector2x2.h"
 #include "xVector3.h"
+#include "xVector4.h"
+#include "xQuaternion.h"
+#include "xQuatBatch.h"
+#include "xRay.h"
+#include "xVec3SoA.h"
+#include "xTRSBatch.h"
+#include "xTranscendental.h"
+#include "xTransform.h"
+#include "xTransformHierarchy.h"
+#include "vector_2.h"
 #include "vector_3.h"
+#include "vector_4.h"
+#include "matrix_2.h"
+#include "matrix_3.h"
+#include "matrix_4.h"
+#include "quaternion.h"
 
-const unsigned int kRepetitions = 100;
-
-void MeasureVector3(){
-
-	xVector3 v1 = xVector3(1.0f, 2.0f, 3.0f);
-	xVector3 v2 = xVector3(3.0f, 2.0f, 1.0f);
-	xVector3 res;
-
-	xVector3 vecA = xVector3(12.0f, 27.0f, 50.0f);
-	xVector3 vecB = xVector3(8.0f, 95.0f, 12.0f);
-
-	float f_res = 0.0f;
-
-	std::chrono::time_point<std::chrono::high_resolution_clock> start_point, end_point;
-	start_point = std::chrono::high_resolution_clock::now();
-
-		for(unsigned int i = 0; i < kRepetitions; ++i){
-			res = res + v2;
-			f_res = DotProduct(vecA, vecB);
-			f_res = Magnitude(vecA);
-			f_res = SqrMagnitude(vecA);
-			f_res = Angle(vecA, vecB);
-			f_res = Distance(vecA, vecB);
-		}
-
-	end_point = std::chrono::high_resolution_clock::now();
-	auto start = std::chrono::time_point_cast<std::chrono::microseconds>(start_point).time_since_epoch().count();
-	auto end = std::chrono::time_point_cast<std::chrono::microseconds>(end_point).time_since_epoch().count();
-
-	printf("ASM Time: %lld\n",(end - start));
-	float* pointer = (float*)&res.xmm;
-	printf("X[%03f] Y[%f] Z[%f] \n", pointer[0], pointer[1], pointer[2]);
-}
-
-void MeasureVec3(){
-
-	Vec3 v1 = Vec3(1.0f, 2.0f, 3.0f);
-	Vec3 v2 = Vec3(5.0f, 4.0f, 3.0f);
-	Vec3 res = Vec3();
-
-	std::chrono::time_point<std::chrono::high_resolution_clock> start_point, end_point;
-	start_point = std::chrono::high_resolution_clock::now();
-
-	for(unsigned int i = 0; i < kRepetitions; ++i){
-		res = v1 + v2;
-	}
-
-	end_point = std::chrono::high_resolution_clock::now();
-	auto start = std::chrono::time_point_cast<std::chrono::microseconds>(start_point).time_since_epoch().count();
-	auto end = std::chrono::time_point_cast<std::chrono::microseconds>(end_point).time_since_epoch().count();
-	
-	printf("C++ Time: %lld\n",(end - start));
-}
+// The math types are plain data, so arrays of them copy with memcpy, and
+// their constants are built at compile time rather than at startup.
+static_assert(std::is_trivially_copyable<Vec2>::value, "Vec2 must be trivially copyable");
+static_assert(std::is_trivially_copyable<Vec3>::value, "Vec3 must be trivially copyable");
+static_assert(std::is_trivially_copyable<Vec4>::value, "Vec4 must be trivially copyable");
+static_assert(std::is_trivially_copyable<Mat2>::value, "Mat2 must be trivially copyable");
+static_assert(std::is_trivially_copyable<Mat3>::value, "Mat3 must be trivially copyable");
+static_assert(std::is_trivially_copyable<Mat4>::value, "Mat4 must be trivially copyable");
+static_assert(std::is_trivially_copyable<Quat>::value, "Quat must be trivially copyable");
+static_assert(Vec2::up.y == 1.0f && Vec3::forward.z == 1.0f && Vec4::one.w == 1.0f, "constants must be constexpr");
+static_assert(Mat4::Identity().m[15] == 1.0f && Mat4(2.0f).m[7] == 2.0f, "Mat4 must be constexpr");
+static_assert(Mat3::Identity().m[4] == 1.0f && Mat2::Identity().m[3] == 1.0f, "Mat2 and Mat3 must be constexpr");
 
 void CheckVectorOperations(){
 
@@ -102,14 +90,1905 @@ void CheckVectorOperations(){
 
 }
 
+// The compound operators change their left side and return it, so they
+// chain; every step here is exact.
+bool CheckCompoundOperators(){
+	xVector3 v = xVector3(1.0f, 2.0f, 3.0f);
+	v += xVector3(3.0f, 6.0f, 9.0f);
+	v -= xVector3(2.0f, 4.0f, 6.0f);
+	v *= xVector3(1.0f, 2.0f, 4.0f);
+	(v *= 3.0f) /= xVector3(2.0f, 4.0f, 8.0f);
+	xVector3& same = (v /= 0.5f);
+	bool ok = &same == &v && v.x() == 6.0f && v.y() == 12.0f && v.z() == 18.0f;
+	printf("Vector   compound operators %s  %s\n", ok ? "in place" : "lost", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+static float CheckRandom(uint32_t* state){
+	*state = *state * 1664525u + 1013904223u;
+	return (float)(*state >> 8) * (1.0f / 16777216.0f) * 2.0f - 1.0f;
+}
+
+static Quat CheckRandomQuat(uint32_t* state){
+	Quat q = Quat(CheckRandom(state), CheckRandom(state), CheckRandom(state), CheckRandom(state));
+	return q.Normalized();
+}
+
+static float QuatError(const Quat& a, const Quat& b){
+	return fmaxf(fmaxf(fabsf(a.x - b.x), fabsf(a.y - b.y)), fmaxf(fabsf(a.z - b.z), fabsf(a.w - b.w)));
+}
+
+// Worst error of each tier against the Vec3 path, over random vectors in
+// [-1, 1]^3, with the allowed bound from kReciprocalError/kAcosError.
+// The exact path rounds too, so its own bound is added to every limit.
+// Angle is only checked where |cos| <= 0.999: near there, acos turns a
+// cosine error e into up to e / sqrt(1 - cos^2) radians. The batch forms
+// are checked on 1003 items, so the tails run too: Normalize(Vec3SoA)
+// against Vec3, and TransformPointsProjective and Nlerp against their
+// own Exact tier, from which they differ only in the reciprocal.
+template<int kPrecision>
+bool CheckPrecisionTier(const char* name){
+	const float reciprocal_bound = kReciprocalError[kPrecision] + kReciprocalError[kPrecisionExact];
+	float normalize_error = 0.0f, divide_error = 0.0f, angle_excess = 0.0f;
+	uint32_t state = 7;
+
+	for(int i = 0; i < 100000; ++i){
+		Vec3 a = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state));
+		Vec3 b = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state));
+		float divisor = CheckRandom(&state) * 0.5f + 1.5f;
+		xVector3 xa = xVector3(&a.x);
+		xVector3 xb = xVector3(&b.x);
+
+		Vec3 exact = a.Normalized();
+		xVector3 normalized = Normalize<kPrecision>(xa);
+		normalize_error = fmaxf(normalize_error, fabsf(normalized.x() - exact.x));
+		normalize_error = fmaxf(normalize_error, fabsf(normalized.y() - exact.y));
+		normalize_error = fmaxf(normalize_error, fabsf(normalized.z() - exact.z));
+
+		exact = a / divisor;
+		xVector3 quotient = Divide<kPrecision>(xa, divisor);
+		for(int c = 0; c < 3; ++c)
+			if((&exact.x)[c] != 0.0f)
+				divide_error = fmaxf(divide_error, fabsf(quotient[c] / (&exact.x)[c] - 1.0f));
+
+		float cosine = Vec3::DotProduct(a, b) / (a.Magnitude() * b.Magnitude());
+		if(fabsf(cosine) > 0.999f)
+			continue;
+		float angle_bound = kAcosError[kPrecision] + kAcosError[kPrecisionExact] +
+		                    3.0f * reciprocal_bound / sqrtf(1.0f - cosine * cosine);
+		float error = fabsf(Angle<kPrecision>(xa, xb) - Vec3::Angle(a, b));
+		angle_excess = fmaxf(angle_excess, error / angle_bound);
+	}
+
+	const size_t count = 1003;
+	std::vector<Vec3> points(count), exact_points(count), projected(count);
+	std::vector<xVector3> x_points(count), x_exact(count), x_projected(count);
+	std::vector<Quat> qa(count), qb(count), exact_quats(count), blended(count);
+	for(size_t i = 0; i < count; ++i){
+		points[i] = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 5.0f;
+		x_points[i] = xVector3(&points[i].x);
+		qa[i] = CheckRandomQuat(&state);
+		qb[i] = CheckRandomQuat(&state);
+	}
+
+	Vec3SoA soa(&points[0], count), normals;
+	Normalize<kPrecision>(soa, &normals);
+	float soa_error = 0.0f;
+	for(size_t i = 0; i < count; ++i){
+		Vec3 exact = points[i].Normalized();
+		soa_error = fmaxf(soa_error, fmaxf(fmaxf(fabsf(normals.x[i] - exact.x), fabsf(normals.y[i] - exact.y)),
+		                                   fabsf(normals.z[i] - exact.z)));
+	}
+
+	// w = 2 +- 0.3 over the points, far from the w = 0 plane.
+	float matrix[16];
+	for(int j = 0; j < 16; ++j) matrix[j] = CheckRandom(&state);
+	for(int j = 12; j < 15; ++j) matrix[j] *= 0.02f;
+	matrix[15] = 2.0f;
+	xMatrix4 m = xMatrix4(matrix);
+	TransformPointsProjective<kPrecisionExact>(m, &points[0], &exact_points[0], count);
+	TransformPointsProjective<kPrecision>(m, &points[0], &projected[0], count);
+	TransformPointsProjective<kPrecisionExact>(m, &x_points[0], &x_exact[0], count);
+	TransformPointsProjective<kPrecision>(m, &x_points[0], &x_projected[0], count);
+	float projective_error = 0.0f;
+	for(size_t i = 0; i < count; ++i){
+		for(int c = 0; c < 3; ++c){
+			float exact = (&exact_points[i].x)[c], x_exact_c = x_exact[i][c];
+			if(exact != 0.0f)
+				projective_error = fmaxf(projective_error, fabsf((&projected[i].x)[c] / exact - 1.0f));
+			if(x_exact_c != 0.0f)
+				projective_error = fmaxf(projective_error, fabsf(x_projected[i][c] / x_exact_c - 1.0f));
+		}
+	}
+
+	Nlerp<kPrecisionExact>(&qa[0], &qb[0], 0.3f, &exact_quats[0], count);
+	Nlerp<kPrecision>(&qa[0], &qb[0], 0.3f, &blended[0], count);
+	float nlerp_error = 0.0f;
+	for(size_t i = 0; i < count; ++i){
+		nlerp_error = fmaxf(nlerp_error, QuatError(blended[i], exact_quats[i]));
+		xQuaternion x = Nlerp<kPrecision>(xQuaternion(qa[i]), xQuaternion(qb[i]), 0.3f);
+		xQuaternion x_exact_q = Nlerp<kPrecisionExact>(xQuaternion(qa[i]), xQuaternion(qb[i]), 0.3f);
+		nlerp_error = fmaxf(nlerp_error, QuatError(x.ToQuat(), x_exact_q.ToQuat()));
+	}
+
+	// One rsqrt plus the multiplies, on components of magnitude <= 1.
+	float normalize_bound = reciprocal_bound + 2.0f * kReciprocalError[kPrecisionExact];
+	bool ok = normalize_error <= normalize_bound && divide_error <= reciprocal_bound && angle_excess <= 1.0f;
+	printf("%-8s Normalize %.3g (<= %.3g)  Divide %.3g (<= %.3g)  Angle %.2f of bound  %s\n",
+		name, normalize_error, normalize_bound, divide_error, reciprocal_bound, angle_excess,
+		ok ? "ok" : "FAILED");
+	bool batch_ok = soa_error <= normalize_bound && projective_error <= normalize_bound && nlerp_error <= normalize_bound;
+	printf("%-8s Normalize(Vec3SoA) %.3g  TransformPointsProjective %.3g  Nlerp %.3g (<= %.3g)  %s\n",
+		name, soa_error, projective_error, nlerp_error, normalize_bound, batch_ok ? "ok" : "FAILED");
+	return ok && batch_ok;
+}
+
+bool CheckPrecisionTiers(){
+	bool ok = CheckPrecisionTier<kPrecisionExact>("Exact");
+	ok = CheckPrecisionTier<kPrecisionFast>("Fast") && ok;
+	ok = CheckPrecisionTier<kPrecisionFastest>("Fastest") && ok;
+	return ok;
+}
+
+// The batch and xQuaternion blends against Quat::Slerp/Nlerp, and the
+// rotation paths against Mat4::RotateX/Y/Z. The batch runs 1003 pairs so
+// the tail of every lane width is covered.
+bool CheckQuaternions(){
+	const size_t count = 1003;
+	Quat a[count], b[count], slerp[count], nlerp[count];
+	float t[count];
+	uint32_t state = 11;
+	for(size_t i = 0; i < count; ++i){
+		a[i] = CheckRandomQuat(&state);
+		b[i] = CheckRandomQuat(&state);
+		// Every tenth pair nearly parallel, where Quat::Slerp switches to Nlerp.
+		if(i % 10 == 0) b[i] = (a[i] + b[i] * 0.01f).Normalized();
+		t[i] = CheckRandom(&state) * 0.6f + 0.5f;
+	}
+	Slerp(a, b, t, slerp, count);
+	Nlerp(a, b, t, nlerp, count);
+
+	float slerp_error = 0.0f, nlerp_error = 0.0f;
+	for(size_t i = 0; i < count; ++i){
+		Quat exact = Quat::Slerp(a[i], b[i], t[i]);
+		slerp_error = fmaxf(slerp_error, QuatError(slerp[i], exact));
+		slerp_error = fmaxf(slerp_error, QuatError(Slerp(xQuaternion(a[i]), xQuaternion(b[i]), t[i]).ToQuat(), exact));
+		exact = Quat::Nlerp(a[i], b[i], t[i]);
+		nlerp_error = fmaxf(nlerp_error, QuatError(nlerp[i], exact));
+		nlerp_error = fmaxf(nlerp_error, QuatError(Nlerp(xQuaternion(a[i]), xQuaternion(b[i]), t[i]).ToQuat(), exact));
+	}
+
+	float rotate_error = 0.0f;
+	const Vec3 axes[3] = { Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f), Vec3(0.0f, 0.0f, 1.0f) };
+	for(int i = 0; i < 100; ++i){
+		float radians = CheckRandom(&state) * 3.14159265f;
+		Mat4 rotations[3] = { Mat4::RotateX(radians), Mat4::RotateY(radians), Mat4::RotateZ(radians) };
+		for(int axis = 0; axis < 3; ++axis){
+			Mat4 m = Quat::FromAxisAngle(axes[axis], radians).ToMat4();
+			Mat4 x = ToXMatrix4(xQuaternion::FromAxisAngle(xVector3(&axes[axis].x), radians)).ToMat4();
+			for(int j = 0; j < 16; ++j){
+				rotate_error = fmaxf(rotate_error, fabsf(m.m[j] - rotations[axis].m[j]));
+				rotate_error = fmaxf(rotate_error, fabsf(x.m[j] - rotations[axis].m[j]));
+			}
+		}
+		Quat q = CheckRandomQuat(&state);
+		Vec3 v = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state));
+		Vec3 rotated = q.Rotate(v);
+		Mat3 r = q.ToMat3();
+		xVector3 x = Rotate(xQuaternion(q), xVector3(&v.x));
+		for(int c = 0; c < 3; ++c){
+			float expected = r.m[c * 3] * v.x + r.m[c * 3 + 1] * v.y + r.m[c * 3 + 2] * v.z;
+			rotate_error = fmaxf(rotate_error, fabsf((&rotated.x)[c] - expected));
+			rotate_error = fmaxf(rotate_error, fabsf(x[c] - expected));
+		}
+
+		// qa * qb and its matrices multiplied in the same order both
+		// rotate by qb first.
+		xQuaternion qa = xQuaternion(CheckRandomQuat(&state)), qb = xQuaternion(q);
+		xVector3 composed = Rotate(qa * qb, xVector3(&v.x));
+		xVector3 expected = Rotate(qa, Rotate(qb, xVector3(&v.x)));
+		xVector3 by_matrix = TransformPoint(ToXMatrix4(qa) * ToXMatrix4(qb), xVector3(&v.x));
+		for(int c = 0; c < 3; ++c){
+			rotate_error = fmaxf(rotate_error, fabsf(composed[c] - expected[c]));
+			rotate_error = fmaxf(rotate_error, fabsf(by_matrix[c] - expected[c]));
+		}
+	}
+
+	bool ok = slerp_error <= 2e-6f && nlerp_error <= 1e-6f && rotate_error <= 1e-5f;
+	printf("Quat     Slerp %.3g  Nlerp %.3g  Rotate %.3g  %s\n", slerp_error, nlerp_error, rotate_error,
+		ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// GetTransform for every RotationOrder against the product of the
+// RotateX/Y/Z, Scale and Translate matrices it replaces, and
+// Quat::ToTransform against GetTransform for the same rotation.
+bool CheckTransforms(){
+	const RotationOrder orders[6] = { kRotateXYZ, kRotateXZY, kRotateYXZ, kRotateYZX, kRotateZXY, kRotateZYX };
+	const Vec3 axes[3] = { Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f), Vec3(0.0f, 0.0f, 1.0f) };
+	// Axes of orders[i], in the order they are applied.
+	const int sequence[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+	float error = 0.0f;
+	uint32_t state = 13;
+
+	for(int i = 0; i < 1000; ++i){
+		Vec3 translate = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 10.0f;
+		Vec3 scale = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) + 2.0f;
+		float radians[3] = { CheckRandom(&state) * 3.14159265f, CheckRandom(&state) * 3.14159265f,
+		                     CheckRandom(&state) * 3.14159265f };
+		Mat4 rotations[3] = { Mat4::RotateX(radians[0]), Mat4::RotateY(radians[1]), Mat4::RotateZ(radians[2]) };
+
+		for(int o = 0; o < 6; ++o){
+			const int* axis = sequence[o];
+			// a.Multiply(b) composes as b * a in the RotateX/Y/Z layout.
+			Mat4 rotation = rotations[axis[0]].Multiply(rotations[axis[1]].Multiply(rotations[axis[2]]));
+			Mat4 expected = Mat4::Translate(translate).Multiply(rotation.Multiply(Mat4::Scale(scale)));
+			Mat4 m = Mat4::GetTransform(translate, scale, radians[0], radians[1], radians[2], orders[o]);
+
+			Quat q = Quat::Identity();
+			for(int k = 0; k < 3; ++k)
+				q = Quat::FromAxisAngle(axes[axis[k]], radians[axis[k]]) * q;
+			Mat4 from_quat = q.ToTransform(translate, scale);
+
+			for(int j = 0; j < 16; ++j){
+				error = fmaxf(error, fabsf(m.m[j] - expected.m[j]));
+				error = fmaxf(error, fabsf(from_quat.m[j] - expected.m[j]));
+			}
+		}
+	}
+
+	// Translation entries reach |50|, so allow a few ulps of that.
+	bool ok = error <= 2e-5f;
+	printf("TRS      GetTransform/ToTransform %.3g  %s\n", error, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// GetTransforms against Quat::ToTransform, once below and once well above
+// kTRSGrain so the threaded split and the tail are both covered.
+bool CheckTransformBatches(){
+	const size_t counts[2] = { 13, kTRSGrain * 8 + 5 };
+	float error = 0.0f;
+	uint32_t state = 17;
+
+	for(int c = 0; c < 2; ++c){
+		size_t count = counts[c];
+		Vec3SoA translate(count), scale(count);
+		QuatSoA rotation(count);
+		for(size_t i = 0; i < count; ++i){
+			translate.Set(i, Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 10.0f);
+			scale.Set(i, Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) + 2.0f);
+			rotation.Set(i, CheckRandomQuat(&state));
+		}
+		std::vector<Mat4> matrices(count);
+		std::vector<xMatrix4> x_matrices(count);
+		GetTransforms(translate, rotation, scale, &matrices[0]);
+		GetTransforms(translate, rotation, scale, &x_matrices[0]);
+
+		for(size_t i = 0; i < count; ++i){
+			Mat4 expected = rotation.Get(i).ToTransform(translate.Get(i), scale.Get(i));
+			Mat4 x = x_matrices[i].ToMat4();
+			for(int j = 0; j < 16; ++j){
+				error = fmaxf(error, fabsf(matrices[i].m[j] - expected.m[j]));
+				error = fmaxf(error, fabsf(x.m[j] - expected.m[j]));
+			}
+		}
+	}
+
+	bool ok = error <= 2e-5f;
+	printf("TRS      GetTransforms %.3g  %s\n", error, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+static float Vec4Error(const Vec4& a, const Vec4& b){
+	return fmaxf(fmaxf(fabsf(a.x - b.x), fabsf(a.y - b.y)), fmaxf(fabsf(a.z - b.z), fabsf(a.w - b.w)));
+}
+
+static float PointError(xVector3 a, xVector3 b){
+	return fmaxf(fmaxf(fabsf(a.x() - b.x()), fabsf(a.y() - b.y())), fabsf(a.z() - b.z()));
+}
+
+static Vec4 CheckRandomVec4(uint32_t* state){
+	return Vec4(CheckRandom(state), CheckRandom(state), CheckRandom(state), CheckRandom(state));
+}
+
+// Components in [1, 2] with random signs, safe to divide by.
+static float CheckRandomDivisor(uint32_t* state){
+	float r = CheckRandom(state);
+	return r < 0.0f ? r - 1.0f : r + 1.0f;
+}
+
+// Lane bits of the comparison of a and b under op, as _mm_movemask_ps
+// returns them for the matching xVector4 or xVector2x2 operator.
+static int CompareBits(const float* a, const float* b, int op){
+	int bits = 0;
+	for(int i = 0; i < 4; ++i){
+		bool set = op == 0 ? a[i] == b[i] : op == 1 ? a[i] != b[i] : op == 2 ? a[i] > b[i] :
+		           op == 3 ? a[i] < b[i] : op == 4 ? a[i] >= b[i] : a[i] <= b[i];
+		bits |= set ? 1 << i : 0;
+	}
+	return bits;
+}
+
+// Every xVector4 operator, conversion and reduction against Vec4, or
+// against the same arithmetic per component where Vec4 has no such
+// operation. The lane-wise forms round like the scalar code; Vec4 divides
+// by multiplying with the reciprocal and the reductions add in another
+// order, which is what the tolerance covers.
+bool CheckVector4(){
+	float error = 0.0f;
+	bool exact = true;
+	uint32_t state = 13;
+	for(int i = 0; i < 1000; ++i){
+		Vec4 a = CheckRandomVec4(&state), b = CheckRandomVec4(&state);
+		Vec4 d = Vec4(CheckRandomDivisor(&state), CheckRandomDivisor(&state), CheckRandomDivisor(&state),
+		              CheckRandomDivisor(&state));
+		float s = CheckRandomDivisor(&state);
+		float t = CheckRandom(&state) + 0.5f;
+		xVector4 xa = xVector4(a), xb = xVector4(b), xd = xVector4(d);
+
+		Vec4 stored;
+		xa.store(&stored);
+		float floats[4];
+		xa.store(floats);
+		xVector3 xyz = xa.xyz();
+		exact = exact && Vec4Error(stored, a) == 0.0f && Vec4Error(Vec4(floats), a) == 0.0f;
+		exact = exact && Vec4Error(xVector4(&a.x).ToVec4(), a) == 0.0f;
+		exact = exact && Vec4Error(xVector4(a.x, a.y, a.z, a.w).ToVec4(), a) == 0.0f;
+		exact = exact && Vec4Error(xVector4(xVector3(&a.x), a.w).ToVec4(), a) == 0.0f;
+		exact = exact && Vec4Error(xVector4(xa.xmm).ToVec4(), a) == 0.0f;
+		exact = exact && Vec4Error(xVector4(s).ToVec4(), Vec4(s)) == 0.0f;
+		exact = exact && xa.x() == a.x && xa.y() == a.y && xa.z() == a.z && xa.w() == a.w;
+		exact = exact && xa[0] == a.x && xa[1] == a.y && xa[2] == a.z && xa[3] == a.w;
+		exact = exact && xyz.x() == a.x && xyz.y() == a.y && xyz.z() == a.z;
+
+		Vec4 product = a, quotient = Vec4(a.x / d.x, a.y / d.y, a.z / d.z, a.w / d.w);
+		product.Scale(b);
+		error = fmaxf(error, Vec4Error((xa + xb).ToVec4(), a + b));
+		error = fmaxf(error, Vec4Error((xa + s).ToVec4(), a + s));
+		error = fmaxf(error, Vec4Error((xa - xb).ToVec4(), a - b));
+		error = fmaxf(error, Vec4Error((xa - s).ToVec4(), a - s));
+		error = fmaxf(error, Vec4Error((xa * xb).ToVec4(), product));
+		error = fmaxf(error, Vec4Error((xa * s).ToVec4(), a * s));
+		error = fmaxf(error, Vec4Error((s * xa).ToVec4(), a * s));
+		error = fmaxf(error, Vec4Error((xa / xd).ToVec4(), quotient));
+		error = fmaxf(error, Vec4Error((xa / s).ToVec4(), a / s));
+		error = fmaxf(error, Vec4Error((s / xd).ToVec4(), Vec4(s / d.x, s / d.y, s / d.z, s / d.w)));
+		error = fmaxf(error, Vec4Error((-xa).ToVec4(), Vec4(0.0f) - a));
+		error = fmaxf(error, Vec4Error(Divide(xa, xd).ToVec4(), quotient));
+		error = fmaxf(error, Vec4Error(Divide(xa, s).ToVec4(), a / s));
+
+		Vec4 v = a;
+		xVector4 x = xa;
+		v += b; x += xb; error = fmaxf(error, Vec4Error(x.ToVec4(), v));
+		v += s; x += s; error = fmaxf(error, Vec4Error(x.ToVec4(), v));
+		v -= b; x -= xb; error = fmaxf(error, Vec4Error(x.ToVec4(), v));
+		v -= s; x -= s; error = fmaxf(error, Vec4Error(x.ToVec4(), v));
+		v.Scale(b); x *= xb; error = fmaxf(error, Vec4Error(x.ToVec4(), v));
+		v *= s; x *= s; error = fmaxf(error, Vec4Error(x.ToVec4(), v));
+		v = Vec4(v.x / d.x, v.y / d.y, v.z / d.z, v.w / d.w); x /= xd; error = fmaxf(error, Vec4Error(x.ToVec4(), v));
+		v /= s; x /= s; error = fmaxf(error, Vec4Error(x.ToVec4(), v));
+
+		Vec4 clamped;
+		for(int c = 0; c < 4; ++c){
+			(&clamped.x)[c] = MathUtils::Clamp((&a.x)[c], -0.5f, 0.5f);
+			exact = exact && Abs(xa)[c] == fabsf((&a.x)[c]);
+			exact = exact && Max(xa, xb)[c] == fmaxf((&a.x)[c], (&b.x)[c]);
+			exact = exact && Min(xa, xb)[c] == fminf((&a.x)[c], (&b.x)[c]);
+		}
+		exact = exact && Vec4Error(Clamp(xa, xVector4(-0.5f), xVector4(0.5f)).ToVec4(), clamped) == 0.0f;
+
+		// Half the lanes equal, so == and != give mixed masks.
+		Vec4 c = Vec4(a.x, b.y, a.z, b.w);
+		xVector4 xc = xVector4(c);
+		const xVector4 masks[6] = { xa == xc, xa != xc, xa > xc, xa < xc, xa >= xc, xa <= xc };
+		for(int op = 0; op < 6; ++op)
+			exact = exact && _mm_movemask_ps(masks[op].xmm) == CompareBits(&a.x, &c.x, op);
+
+		float sum = a.x + a.y + a.z + a.w;
+		error = fmaxf(error, fabsf(Sum(xa) - sum));
+		error = fmaxf(error, fabsf(DotProduct(xa, xb) - Vec4::DotProduct(a, b)));
+		error = fmaxf(error, fabsf(SqrMagnitude(xa) - a.SqrMagnitude()));
+		error = fmaxf(error, fabsf(Magnitude(xa) - a.Magnitude()));
+		error = fmaxf(error, fabsf(Distance(xa, xb) - Vec4::Distance(a, b)));
+		const __m128 reductions[5] = { SumV(xa), DotProductV(xa, xb), SqrMagnitudeV(xa), MagnitudeV(xa),
+		                               DistanceV(xa, xb) };
+		const float scalars[5] = { Sum(xa), DotProduct(xa, xb), SqrMagnitude(xa), Magnitude(xa), Distance(xa, xb) };
+		for(int r = 0; r < 5; ++r)
+			exact = exact && Vec4Error(xVector4(reductions[r]).ToVec4(), Vec4(scalars[r])) == 0.0f;
+
+		error = fmaxf(error, Vec4Error(Normalize(xa).ToVec4(), a.Normalized()));
+		error = fmaxf(error, Vec4Error(LerpUnclamped(xa, xb, t).ToVec4(), a + (b - a) * t));
+		error = fmaxf(error, Vec4Error(Lerp(xa, xb, t).ToVec4(), Vec4::Lerp(a, b, t)));
+	}
+
+	bool ok = exact && error <= 1e-6f;
+	printf("Vector4  operators and reductions %.3g  exact forms %s  %s\n", error, exact ? "match" : "differ",
+		ok ? "ok" : "FAILED");
+	return ok;
+}
+
+static float Vec2Error(const Vec2& a, const Vec2& b){
+	return fmaxf(fabsf(a.x - b.x), fabsf(a.y - b.y));
+}
+
+// Error of both halves of x against the pair (a, b).
+static float PairError(xVector2x2 x, const Vec2& a, const Vec2& b){
+	return fmaxf(Vec2Error(x.a(), a), Vec2Error(x.b(), b));
+}
+
+// Every xVector2x2 operator, conversion and reduction against the two
+// Vec2 it holds, on the same terms as CheckVector4. The reductions are
+// checked per pair, in both their Vec2 and their (ra, ra, rb, rb) form.
+bool CheckVector2x2(){
+	float error = 0.0f;
+	bool exact = true;
+	uint32_t state = 17;
+	for(int i = 0; i < 1000; ++i){
+		Vec2 pair[2] = { Vec2(CheckRandom(&state), CheckRandom(&state)), Vec2(CheckRandom(&state), CheckRandom(&state)) };
+		Vec2 other[2] = { Vec2(CheckRandom(&state), CheckRandom(&state)), Vec2(CheckRandom(&state), CheckRandom(&state)) };
+		Vec2 divisor[2] = { Vec2(CheckRandomDivisor(&state), CheckRandomDivisor(&state)),
+		                    Vec2(CheckRandomDivisor(&state), CheckRandomDivisor(&state)) };
+		float s = CheckRandomDivisor(&state);
+		float t = CheckRandom(&state) + 0.5f;
+		const Vec2 &a = pair[0], &b = pair[1], &c = other[0], &d = other[1];
+		xVector2x2 xp = xVector2x2(pair), xo = xVector2x2(other), xd = xVector2x2(divisor);
+
+		Vec2 stored[2];
+		xp.store(stored);
+		float floats[4];
+		xp.store(floats);
+		exact = exact && stored[0] == a && stored[1] == b && Vec2(floats[0], floats[1]) == a && Vec2(floats[2], floats[3]) == b;
+		exact = exact && PairError(xVector2x2(&a.x), a, b) == 0.0f && PairError(xVector2x2(a, b), a, b) == 0.0f;
+		exact = exact && PairError(xVector2x2(a.x, a.y, b.x, b.y), a, b) == 0.0f;
+		exact = exact && PairError(xVector2x2(xp.xmm), a, b) == 0.0f && PairError(xVector2x2(s), Vec2(s, s), Vec2(s, s)) == 0.0f;
+		exact = exact && xp[0] == a.x && xp[1] == a.y && xp[2] == b.x && xp[3] == b.y;
+
+		Vec2 dx = divisor[0], dy = divisor[1];
+		error = fmaxf(error, PairError(xp + xo, a + c, b + d));
+		error = fmaxf(error, PairError(xp + s, Vec2(a) + s, Vec2(b) + s));
+		error = fmaxf(error, PairError(xp - xo, a - c, b - d));
+		error = fmaxf(error, PairError(xp - s, a - s, b - s));
+		error = fmaxf(error, PairError(xp * xo, Vec2(a.x * c.x, a.y * c.y), Vec2(b.x * d.x, b.y * d.y)));
+		error = fmaxf(error, PairError(xp * s, a * s, b * s));
+		error = fmaxf(error, PairError(s * xp, a * s, b * s));
+		Vec2 qa = Vec2(a.x / dx.x, a.y / dx.y), qb = Vec2(b.x / dy.x, b.y / dy.y);
+		error = fmaxf(error, PairError(xp / xd, qa, qb));
+		error = fmaxf(error, PairError(xp / s, a / s, b / s));
+		error = fmaxf(error, PairError(s / xd, Vec2(s / dx.x, s / dx.y), Vec2(s / dy.x, s / dy.y)));
+		error = fmaxf(error, PairError(-xp, -a, -b));
+		error = fmaxf(error, PairError(Divide(xp, xd), qa, qb));
+		error = fmaxf(error, PairError(Divide(xp, s), a / s, b / s));
+
+		Vec2 va = a, vb = b;
+		xVector2x2 x = xp;
+		va += c; vb += d; x += xo; error = fmaxf(error, PairError(x, va, vb));
+		va += s; vb += s; x += s; error = fmaxf(error, PairError(x, va, vb));
+		va -= c; vb -= d; x -= xo; error = fmaxf(error, PairError(x, va, vb));
+		va -= s; vb -= s; x -= s; error = fmaxf(error, PairError(x, va, vb));
+		va.Scale(c); vb.Scale(d); x *= xo; error = fmaxf(error, PairError(x, va, vb));
+		va *= s; vb *= s; x *= s; error = fmaxf(error, PairError(x, va, vb));
+		va = Vec2(va.x / dx.x, va.y / dx.y); vb = Vec2(vb.x / dy.x, vb.y / dy.y); x /= xd;
+		error = fmaxf(error, PairError(x, va, vb));
+		va /= s; vb /= s; x /= s; error = fmaxf(error, PairError(x, va, vb));
+
+		for(int l = 0; l < 4; ++l){
+			float p = xp[l], o = xo[l];
+			exact = exact && Abs(xp)[l] == fabsf(p) && Max(xp, xo)[l] == fmaxf(p, o) && Min(xp, xo)[l] == fminf(p, o);
+			exact = exact && Clamp(xp, xVector2x2(-0.5f), xVector2x2(0.5f))[l] == MathUtils::Clamp(p, -0.5f, 0.5f);
+		}
+
+		// Half the lanes equal, so == and != give mixed masks.
+		xVector2x2 xc = xVector2x2(a.x, c.y, b.x, d.y);
+		float lanes[4], equal[4];
+		xp.store(lanes);
+		xc.store(equal);
+		const xVector2x2 masks[6] = { xp == xc, xp != xc, xp > xc, xp < xc, xp >= xc, xp <= xc };
+		for(int op = 0; op < 6; ++op)
+			exact = exact && _mm_movemask_ps(masks[op].xmm) == CompareBits(lanes, equal, op);
+
+		error = fmaxf(error, Vec2Error(DotProduct(xp, xo), Vec2(Vec2::DotProduct(a, c), Vec2::DotProduct(b, d))));
+		error = fmaxf(error, Vec2Error(SqrMagnitude(xp), Vec2(a.SqrMagnitude(), b.SqrMagnitude())));
+		error = fmaxf(error, Vec2Error(Magnitude(xp), Vec2(a.Magnitude(), b.Magnitude())));
+		error = fmaxf(error, Vec2Error(Distance(xp, xo), Vec2(Vec2::Distance(a, c), Vec2::Distance(b, d))));
+		const __m128 reductions[4] = { DotProductV(xp, xo), SqrMagnitudeV(xp), MagnitudeV(xp), DistanceV(xp, xo) };
+		const Vec2 scalars[4] = { DotProduct(xp, xo), SqrMagnitude(xp), Magnitude(xp), Distance(xp, xo) };
+		for(int r = 0; r < 4; ++r){
+			Vec2 ra = Vec2(scalars[r].x, scalars[r].x), rb = Vec2(scalars[r].y, scalars[r].y);
+			exact = exact && PairError(xVector2x2(reductions[r]), ra, rb) == 0.0f;
+		}
+
+		error = fmaxf(error, PairError(Normalize(xp), a.Normalized(), b.Normalized()));
+		error = fmaxf(error, PairError(LerpUnclamped(xp, xo, t), Vec2::LerpUnclamped(a, c, t), Vec2::LerpUnclamped(b, d, t)));
+		error = fmaxf(error, PairError(Lerp(xp, xo, t), Vec2::Lerp(a, c, t), Vec2::Lerp(b, d, t)));
+	}
+
+	bool ok = exact && error <= 1e-6f;
+	printf("Vector2x2 operators and reductions %.3g  exact forms %s  %s\n", error, exact ? "match" : "differ",
+		ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// The batch and xMatrix4 transforms against the member Mat4TransformVec4
+// on a GetTransform matrix, whose translation sits in m[3], m[7], m[11].
+// 1003 points cover the tail of the four-wide loops.
+bool CheckPointTransforms(){
+	const size_t count = 1003;
+	uint32_t state = 19;
+	Mat4 m = Mat4::GetTransform(Vec3(10.0f, 20.0f, 30.0f), Vec3(2.0f, 0.5f, 1.5f), 0.4f, -0.9f, 1.7f);
+	xMatrix4 xm(m);
+
+	std::vector<Vec3> points(count), moved(count), turned(count);
+	std::vector<xVector3> x_points(count), x_moved(count), x_turned(count);
+	std::vector<Vec4> vectors(count), transformed(count);
+	for(size_t i = 0; i < count; ++i){
+		points[i] = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 5.0f;
+		x_points[i] = xVector3(&points[i].x);
+		vectors[i] = Vec4(points[i], CheckRandom(&state));
+	}
+	TransformPoints(m, &points[0], &moved[0], count);
+	TransformDirections(m, &points[0], &turned[0], count);
+	TransformPoints(xm, &x_points[0], &x_moved[0], count);
+	TransformDirections(xm, &x_points[0], &x_turned[0], count);
+	Transform(m, &vectors[0], &transformed[0], count);
+
+	float error = 0.0f;
+	for(size_t i = 0; i < count; ++i){
+		Vec4 point = m.Mat4TransformVec4(Vec4(points[i], 1.0f));
+		Vec4 direction = m.Mat4TransformVec4(Vec4(points[i], 0.0f));
+		Vec3 expected[2] = { Vec3(point.x, point.y, point.z), Vec3(direction.x, direction.y, direction.z) };
+		xVector3 single[2] = { TransformPoint(xm, x_points[i]), TransformDirection(xm, x_points[i]) };
+		const Vec3 got[5] = { moved[i], turned[i], Mat4::Mat4TransformVec3(m, points[i]),
+		                      Vec3(x_moved[i].x(), x_moved[i].y(), x_moved[i].z()),
+		                      Vec3(x_turned[i].x(), x_turned[i].y(), x_turned[i].z()) };
+		for(int k = 0; k < 5; ++k){
+			Vec3 difference = got[k] - expected[k == 1 || k == 4];
+			error = fmaxf(error, fmaxf(fmaxf(fabsf(difference.x), fabsf(difference.y)), fabsf(difference.z)));
+		}
+		for(int k = 0; k < 2; ++k)
+			for(int c = 0; c < 3; ++c) error = fmaxf(error, fabsf(single[k][c] - (&expected[k].x)[c]));
+		error = fmaxf(error, Vec4Error(transformed[i], m.Mat4TransformVec4(vectors[i])));
+		error = fmaxf(error, Vec4Error(Mat4::Mat4TransformVec4(m, vectors[i]), m.Mat4TransformVec4(vectors[i])));
+	}
+
+	// The Mat4 forms, in place or on xVector3, run the same kernels as the
+	// xMatrix4 ones above, so they match them bit for bit.
+	std::vector<Vec3> points_in_place(points), turned_in_place(points);
+	std::vector<xVector3> x_points_in_place(x_points), x_turned_mat4(count);
+	std::vector<Vec4> vectors_in_place(vectors);
+	TransformPoints(m, &points_in_place[0], count);
+	TransformDirections(m, &turned_in_place[0], count);
+	TransformPoints(m, &x_points_in_place[0], count);
+	TransformDirections(m, &x_points[0], &x_turned_mat4[0], count);
+	Transform(m, &vectors_in_place[0], count);
+	bool forms_ok = memcmp(&points_in_place[0], &moved[0], count * sizeof(Vec3)) == 0 &&
+	                memcmp(&turned_in_place[0], &turned[0], count * sizeof(Vec3)) == 0 &&
+	                memcmp(&vectors_in_place[0], &transformed[0], count * sizeof(Vec4)) == 0;
+	for(size_t i = 0; i < count; ++i)
+		forms_ok = forms_ok && PointError(x_points_in_place[i], x_moved[i]) == 0.0f && PointError(x_turned_mat4[i], x_turned[i]) == 0.0f;
+
+	// A pure translation moves (1, 2, 3) to (11, 22, 33) exactly.
+	const Vec3 point = Vec3(1.0f, 2.0f, 3.0f);
+	Vec3 moved_point;
+	TransformPoints(Mat4::GetTransform(10.0f, 20.0f, 30.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f), &point, &moved_point, 1);
+	bool translate_ok = moved_point.x == 11.0f && moved_point.y == 22.0f && moved_point.z == 33.0f;
+
+	// Translation entries reach |40|, so allow a few ulps of that.
+	bool ok = error <= 2e-5f && forms_ok && translate_ok;
+	printf("Points   TransformPoints/Directions/Vec4 %.3g  Mat4 forms %s  translation %s  %s\n", error,
+		forms_ok ? "same" : "differ", translate_ok ? "right" : "wrong", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// TransformPoint(inverse, TransformPoint(m, p)) gives p back for the
+// xMatrix4 and Mat4 affine and rigid inverses of GetTransform matrices,
+// and a flattened scale makes InverseAffine report a singular matrix.
+bool CheckAffineInverses(){
+	uint32_t state = 23;
+	float error = 0.0f;
+	bool singular_ok = true;
+	for(int i = 0; i < 1000; ++i){
+		Vec3 translate = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 10.0f;
+		Vec3 scale = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) + 2.0f;
+		Vec3 radians = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 3.14159265f;
+		xVector3 p = xVector3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 5.0f;
+
+		Mat4 m = Mat4::GetTransform(translate, scale, radians.x, radians.y, radians.z);
+		Mat4 rigid = Mat4::GetTransform(translate, Vec3(1.0f, 1.0f, 1.0f), radians.x, radians.y, radians.z);
+		Mat4 m_inverse, rigid_inverse;
+		xMatrix4 x_inverse;
+		bool inverted = m.GetInverseAffine(&m_inverse) && InverseAffine(xMatrix4(m), &x_inverse);
+		rigid.GetInverseRigid(&rigid_inverse);
+
+		xVector3 moved = TransformPoint(xMatrix4(m), p);
+		xVector3 moved_rigid = TransformPoint(xMatrix4(rigid), p);
+		error = fmaxf(error, inverted ? 0.0f : 1.0f);
+		error = fmaxf(error, PointError(TransformPoint(x_inverse, moved), p));
+		error = fmaxf(error, PointError(TransformPoint(xMatrix4(m_inverse), moved), p));
+		error = fmaxf(error, PointError(TransformPoint(InverseRigid(xMatrix4(rigid)), moved_rigid), p));
+		error = fmaxf(error, PointError(TransformPoint(xMatrix4(rigid_inverse), moved_rigid), p));
+
+		Mat4 flat = Mat4::GetTransform(translate, Vec3(scale.x, 0.0f, scale.z), radians.x, radians.y, radians.z);
+		singular_ok = singular_ok && !InverseAffine(xMatrix4(flat), &x_inverse);
+	}
+
+	// Points and translations reach |20|, so allow a few ulps of that.
+	bool ok = error <= 2e-5f && singular_ok;
+	printf("Affine   InverseAffine/InverseRigid round trip %.3g  singular %s  %s\n", error,
+		singular_ok ? "found" : "missed", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// |got - expected| in units of the float spacing at expected.
+static float Vec3Error(const Vec3& a, const Vec3& b){
+	return fmaxf(fmaxf(fabsf(a.x - b.x), fabsf(a.y - b.y)), fabsf(a.z - b.z));
+}
+
+// Each Vec3SoA kernel against the Vec3 function it mirrors. No count is a
+// multiple of a kLaneWidth, so every ISA runs its masked tail, and the
+// float outputs are checked to stay within count. Add, Subtract and Scale
+// round like Vec3; the others may fuse a multiply-add or sum in another
+// order, which the tolerance covers.
+bool CheckSoAKernels(){
+	const size_t counts[3] = { 3, 13, 1003 };
+	const float scale = 1.75f, t = 0.3f, sentinel = 12345.0f;
+	float error = 0.0f;
+	bool exact = true, tails = true;
+	uint32_t state = 23;
+	for(int k = 0; k < 3; ++k){
+		const size_t count = counts[k];
+		std::vector<Vec3> va(count), vb(count);
+		for(size_t i = 0; i < count; ++i){
+			va[i] = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state));
+			vb[i] = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state));
+		}
+		Vec3SoA a(&va[0], count), b(&vb[0], count), out;
+		std::vector<float> values(count + 16, sentinel);
+
+		Add(a, b, &out);
+		for(size_t i = 0; i < count; ++i) exact = exact && out.Get(i) == va[i] + vb[i];
+		Subtract(a, b, &out);
+		for(size_t i = 0; i < count; ++i) exact = exact && out.Get(i) == va[i] - vb[i];
+		Scale(a, scale, &out);
+		for(size_t i = 0; i < count; ++i) exact = exact && out.Get(i) == va[i] * scale;
+
+		CrossProduct(a, b, &out);
+		for(size_t i = 0; i < count; ++i) error = fmaxf(error, Vec3Error(out.Get(i), Vec3::CrossProduct(va[i], vb[i])));
+		Lerp(a, b, t, &out);
+		for(size_t i = 0; i < count; ++i) error = fmaxf(error, Vec3Error(out.Get(i), Vec3::Lerp(va[i], vb[i], t)));
+		Reflect(a, b, &out);
+		for(size_t i = 0; i < count; ++i) error = fmaxf(error, Vec3Error(out.Get(i), Vec3::Reflect(va[i], vb[i])));
+
+		DotProduct(a, b, &values[0]);
+		for(size_t i = 0; i < count; ++i) error = fmaxf(error, fabsf(values[i] - Vec3::DotProduct(va[i], vb[i])));
+		Magnitude(a, &values[0]);
+		for(size_t i = 0; i < count; ++i) error = fmaxf(error, fabsf(values[i] - va[i].Magnitude()));
+		Distance(a, b, &values[0]);
+		for(size_t i = 0; i < count; ++i) error = fmaxf(error, fabsf(values[i] - Vec3::Distance(va[i], vb[i])));
+		for(size_t i = count; i < values.size(); ++i) tails = tails && values[i] == sentinel;
+	}
+
+	bool ok = exact && tails && error <= 1e-6f;
+	printf("SoA      kernels %.3g  Add/Subtract/Scale %s  tails %s  %s\n", error, exact ? "exact" : "differ",
+		tails ? "kept" : "overwritten", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+static float UlpError(float got, double expected){
+	if(isnan(expected)) return isnan(got) ? 0.0f : 1e9f;
+	if(isinf((float)expected)) return got == (float)expected ? 0.0f : 1e9f;
+	int exponent;
+	frexp(expected, &exponent);
+	double ulp = ldexp(1.0, (exponent - 24 > -149 ? exponent - 24 : -149));
+	return (float)(fabs((double)got - expected) / ulp);
+}
+
+// Each array function against double libm at the bounds documented in
+// xTranscendental.h, then the two batches built on them: SoA Angle
+// against Vec3::Angle and Euler GetTransforms against Mat4::GetTransform.
+// 100003 inputs so every lane width ends on a partial register.
+bool CheckTranscendentals(){
+	const size_t count = 100003;
+	std::vector<float> x(count), y(count), unit(count), out(count), out2(count);
+	uint32_t state = 19;
+	for(size_t i = 0; i < count; ++i){
+		// Angles up to kTrigReductionLimit and past it, so libm lanes mix in.
+		x[i] = CheckRandom(&state) * (i % 7 == 0 ? 10000.0f : i % 3 == 0 ? 1000.0f : 10.0f);
+		y[i] = CheckRandom(&state) * 100.0f;
+		unit[i] = CheckRandom(&state);
+	}
+
+	float sin_error = 0.0f, cos_error = 0.0f, acos_error = 0.0f, atan2_error = 0.0f, exp_error = 0.0f;
+	bool sincos_same = true;
+	SinCos(&x[0], &out[0], &out2[0], count);
+	for(size_t i = 0; i < count; ++i){
+		sin_error = fmaxf(sin_error, UlpError(out[i], sin((double)x[i])));
+		cos_error = fmaxf(cos_error, UlpError(out2[i], cos((double)x[i])));
+	}
+	std::vector<float> separate(count);
+	Sin(&x[0], &separate[0], count);
+	sincos_same = sincos_same && memcmp(&separate[0], &out[0], count * sizeof(float)) == 0;
+	Cos(&x[0], &separate[0], count);
+	sincos_same = sincos_same && memcmp(&separate[0], &out2[0], count * sizeof(float)) == 0;
+
+	Acos(&unit[0], &out[0], count);
+	for(size_t i = 0; i < count; ++i) acos_error = fmaxf(acos_error, UlpError(out[i], acos((double)unit[i])));
+	Atan2(&y[0], &unit[0], &out[0], count);
+	for(size_t i = 0; i < count; ++i) atan2_error = fmaxf(atan2_error, UlpError(out[i], atan2((double)y[i], (double)unit[i])));
+	Exp(&y[0], &out[0], count);
+	for(size_t i = 0; i < count; ++i) exp_error = fmaxf(exp_error, UlpError(out[i], exp((double)y[i])));
+
+	bool ok = sin_error <= 2.4f && cos_error <= 2.4f && acos_error <= 1.1f && atan2_error <= 3.1f &&
+	          exp_error <= 1.3f && sincos_same;
+	printf("Math     Sin %.2f  Cos %.2f  Acos %.2f  Atan2 %.2f  Exp %.2f ulp  SinCos %s  %s\n",
+		sin_error, cos_error, acos_error, atan2_error, exp_error, sincos_same ? "same" : "differs",
+		ok ? "ok" : "FAILED");
+
+	// Angle on vectors in [-1, 1]^3; where |cos| is near 1 acos amplifies
+	// the cosine rounding, so those are skipped as in CheckPrecisionTier.
+	const size_t vectors = 1003;
+	Vec3SoA a(vectors), b(vectors), radians(vectors), translate(vectors), scale(vectors);
+	for(size_t i = 0; i < vectors; ++i){
+		a.Set(i, Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)));
+		b.Set(i, Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)));
+		radians.Set(i, Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 3.14159265f);
+		translate.Set(i, Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 10.0f);
+		scale.Set(i, Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) + 2.0f);
+	}
+	float angle_error = 0.0f;
+	Angle(a, b, &out[0]);
+	for(size_t i = 0; i < vectors; ++i){
+		Vec3 va = a.Get(i), vb = b.Get(i);
+		if(fabsf(Vec3::DotProduct(va, vb) / (va.Magnitude() * vb.Magnitude())) <= 0.999f)
+			angle_error = fmaxf(angle_error, fabsf(out[i] - Vec3::Angle(va, vb)));
+	}
+
+	const RotationOrder orders[6] = { kRotateXYZ, kRotateXZY, kRotateYXZ, kRotateYZX, kRotateZXY, kRotateZYX };
+	float transform_error = 0.0f;
+	std::vector<Mat4> matrices(vectors);
+	for(int o = 0; o < 6; ++o){
+		GetTransforms(translate, radians, scale, &matrices[0], orders[o]);
+		for(size_t i = 0; i < vectors; ++i){
+			Vec3 r = radians.Get(i);
+			Mat4 expected = Mat4::GetTransform(translate.Get(i), scale.Get(i), r.x, r.y, r.z, orders[o]);
+			for(int j = 0; j < 16; ++j)
+				transform_error = fmaxf(transform_error, fabsf(matrices[i].m[j] - expected.m[j]));
+		}
+	}
+
+	bool batch_ok = angle_error <= 1e-5f && transform_error <= 2e-5f;
+	printf("Math     Angle(Vec3SoA) %.3g  GetTransforms(Euler) %.3g  %s\n",
+		angle_error, transform_error, batch_ok ? "ok" : "FAILED");
+	return ok && batch_ok;
+}
+
+// Worlds of a random forest against a Mat4::Multiply walk, after a full
+// build and after moving a few nodes, plus the count Update reports.
+// One level is several times kHierarchyGrain wide so the split runs.
+bool CheckHierarchy(){
+	const size_t count = kHierarchyGrain * 4 + 4000;
+	xTransformHierarchy hierarchy;
+	std::vector<Mat4> locals(count), expected(count);
+	std::vector<uint32_t> parents(count);
+	uint32_t state = 23;
+
+	for(size_t i = 0; i < count; ++i){
+		Vec3 translate = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state));
+		Vec3 radians = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state));
+		locals[i] = Mat4::GetTransform(translate, Vec3(1.0f, 1.0f, 1.0f), radians.x, radians.y, radians.z);
+		// A few roots, a wide second level and random deeper chains.
+		if(i < 4) parents[i] = kNoParent;
+		else if(i < kHierarchyGrain * 4 + 4) parents[i] = (uint32_t)(i % 4);
+		else parents[i] = (uint32_t)((CheckRandom(&state) * 0.5f + 0.5f) * (float)i) % (uint32_t)i;
+		hierarchy.AddNode(parents[i], locals[i]);
+	}
+
+	float error = 0.0f;
+	size_t wrong_counts = 0;
+	std::vector<uint8_t> moved(count);
+	for(int frame = 0; frame < 3; ++frame){
+		size_t expected_count = count;
+		if(frame){
+			for(size_t i = 0; i < count; ++i) moved[i] = 0;
+			for(size_t i = frame * 7; i < count; i += 97){
+				locals[i] = locals[(i + 1) % count];
+				hierarchy.SetLocal((uint32_t)i, locals[i]);
+				moved[i] = 1;
+			}
+			expected_count = 0;
+			for(size_t i = 0; i < count; ++i){
+				if(parents[i] != kNoParent && moved[parents[i]]) moved[i] = 1;
+				expected_count += moved[i];
+			}
+		}
+		if(hierarchy.Update() != expected_count) ++wrong_counts;
+
+		for(size_t i = 0; i < count; ++i){
+			uint32_t parent = parents[i];
+			expected[i] = parent == kNoParent ? locals[i] : locals[i].Multiply(expected[parent]);
+			Mat4 world = hierarchy.World((uint32_t)i).ToMat4();
+			for(int j = 0; j < 16; ++j)
+				error = fmaxf(error, fabsf(world.m[j] - expected[i].m[j]) / (1.0f + fabsf(expected[i].m[j])));
+		}
+	}
+
+	// In the Mat4::Translate/RotateX/Y/Z layout, World applies the local
+	// transform first, then the parent's.
+	Vec4 point = Vec4(0.25f, -0.5f, 0.75f, 1.0f);
+	uint32_t leaf = (uint32_t)(count - 1);
+	Mat4 world = hierarchy.World(leaf).ToMat4(), parent_world = hierarchy.World(parents[leaf]).ToMat4();
+	Vec4 direct = world.Mat4TransformVec4(point);
+	Vec4 chained = parent_world.Mat4TransformVec4(locals[leaf].Mat4TransformVec4(point));
+	float order_error = fmaxf(fmaxf(fabsf(direct.x - chained.x), fabsf(direct.y - chained.y)), fabsf(direct.z - chained.z));
+
+	bool ok = error <= 1e-5f && wrong_counts == 0 && order_error <= 1e-4f && hierarchy.Update() == 0;
+	printf("Tree     World %.3g  order %.3g  update counts %s  %s\n", error, order_error,
+		wrong_counts ? "wrong" : "right", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+static Vec3 ProjectToNdc(const Mat4& m, const Vec3& point){
+	Vec4 clip = Mat4(m).Mat4TransformVec4(Vec4(point.x, point.y, point.z, 1.0f));
+	return Vec3(clip.x / clip.w, clip.y / clip.w, clip.z / clip.w);
+}
+
+// Near and far land on the depth range of each ClipDepth, the edges of the
+// field of view and of the ortho box on +-1, TransformPointsProjective
+// agrees with the scalar divide, and the frustum planes put a point just
+// inside each depth plane in and one just outside out.
+bool CheckProjection(){
+	const float kNearDepth[3] = { 0.0f, -1.0f, 1.0f };
+	const float kFarDepth[3] = { 1.0f, 1.0f, 0.0f };
+	const float fov = 1.2f, aspect = 1.5f, z_near = 0.5f, z_far = 100.0f;
+	const float edge = tanf(fov * 0.5f);
+	float error = 0.0f, batch_error = 0.0f;
+	bool planes_ok = true;
+
+	// Points inside the frustum, 37 to cover the tail of the batch loop.
+	const size_t count = 37;
+	uint32_t state = 29;
+	std::vector<Vec3> view_points(count), projected(count);
+	for(size_t i = 0; i < count; ++i){
+		float distance = z_near + (z_far - z_near) * (CheckRandom(&state) + 1.0f) * 0.5f;
+		view_points[i] = Vec3(CheckRandom(&state) * edge * aspect, CheckRandom(&state) * edge, -1.0f) * distance;
+	}
+	for(int d = 0; d < 3; ++d){
+		ClipDepth depth = (ClipDepth)d;
+		Mat4 perspective = Mat4::PerspectiveMatrix(fov, aspect, z_near, z_far, depth);
+		Mat4 infinite = Mat4::PerspectiveMatrix(fov, aspect, z_near, INFINITY, depth);
+		Mat4 ortho = Mat4::OrthoMatrix(4.0f, -2.0f, 3.0f, -1.0f, 1.0f, 11.0f, depth);
+
+		Vec3 near_point = ProjectToNdc(perspective, Vec3(0.0f, 0.0f, -z_near));
+		Vec3 far_point = ProjectToNdc(perspective, Vec3(0.0f, 0.0f, -z_far));
+		Vec3 corner = ProjectToNdc(perspective, Vec3(edge * aspect * 7.0f, edge * 7.0f, -7.0f));
+		Vec3 infinite_near = ProjectToNdc(infinite, Vec3(0.0f, 0.0f, -z_near));
+		Vec3 infinite_far = ProjectToNdc(infinite, Vec3(0.0f, 0.0f, -1.0e6f));
+		Vec3 ortho_high = ProjectToNdc(ortho, Vec3(4.0f, 3.0f, -1.0f));
+		Vec3 ortho_low = ProjectToNdc(ortho, Vec3(-2.0f, -1.0f, -11.0f));
+		error = fmaxf(error, fabsf(near_point.z - kNearDepth[d]));
+		error = fmaxf(error, fabsf(far_point.z - kFarDepth[d]));
+		error = fmaxf(error, fmaxf(fabsf(corner.x - 1.0f), fabsf(corner.y - 1.0f)));
+		error = fmaxf(error, fabsf(infinite_near.z - kNearDepth[d]));
+		error = fmaxf(error, fabsf(infinite_far.z - kFarDepth[d]) * 0.1f);
+		error = fmaxf(error, fmaxf(fmaxf(fabsf(ortho_high.x - 1.0f), fabsf(ortho_high.y - 1.0f)), fabsf(ortho_high.z - kNearDepth[d])));
+		error = fmaxf(error, fmaxf(fmaxf(fabsf(ortho_low.x + 1.0f), fabsf(ortho_low.y + 1.0f)), fabsf(ortho_low.z - kFarDepth[d])));
+
+		TransformPointsProjective(perspective, &view_points[0], &projected[0], count);
+		for(size_t i = 0; i < count; ++i){
+			Vec3 difference = projected[i] - ProjectToNdc(perspective, view_points[i]);
+			batch_error = fmaxf(batch_error, fmaxf(fmaxf(fabsf(difference.x), fabsf(difference.y)), fabsf(difference.z)));
+		}
+
+		// The camera sits at z = 5 looking down -z.
+		Mat4 view = Mat4::Translate(0.0f, 0.0f, -5.0f);
+		xFrustum frustum(view.Multiply(perspective), depth);
+		xFrustum unbounded(view.Multiply(infinite), depth);
+		planes_ok = planes_ok &&
+			frustum.ContainsPoint(Vec3(0.0f, 0.0f, 5.0f - z_near * 1.01f)) &&
+			!frustum.ContainsPoint(Vec3(0.0f, 0.0f, 5.0f - z_near * 0.99f)) &&
+			frustum.ContainsPoint(Vec3(0.0f, 0.0f, 5.0f - z_far * 0.99f)) &&
+			!frustum.ContainsPoint(Vec3(0.0f, 0.0f, 5.0f - z_far * 1.01f)) &&
+			unbounded.ContainsPoint(Vec3(0.0f, 0.0f, -1.0e6f)) &&
+			!unbounded.ContainsPoint(Vec3(0.0f, 0.0f, 5.0f - z_near * 0.99f)) &&
+			frustum.IntersectsSphere(Vec3(0.0f, 0.0f, 5.0f - z_far - 1.0f), 1.5f) &&
+			!frustum.IntersectsSphere(Vec3(0.0f, 0.0f, 5.0f - z_far - 1.0f), 0.5f);
+	}
+
+	bool ok = error <= 1e-4f && batch_error <= 1e-5f && planes_ok;
+	printf("Project  depth/edges %.3g  batch %.3g  planes %s  %s\n", error, batch_error, planes_ok ? "right" : "wrong",
+		ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// The lane kernels against the scalar IntersectsSphere and IntersectsBox.
+// Volumes within a small margin of a plane may go either way, since the
+// lane sums round differently; everything else must agree, the indices
+// must ascend, and kParallel must give the same list as kSequential.
+bool CheckCulling(){
+	const size_t count = kCullGrain * 3 + 1001;
+	const float margin = 1e-3f;
+	uint32_t state = 31;
+	Mat4 view = Mat4::Translate(0.0f, 0.0f, -5.0f);
+	Mat4 projection = Mat4::PerspectiveMatrix(1.0f, 1.25f, 0.5f, 40.0f, kDepthZeroToOne);
+	xFrustum frustum(view.Multiply(projection), kDepthZeroToOne);
+
+	Vec3SoA centers(count), min(count), max(count);
+	std::vector<float> radii(count);
+	for(size_t i = 0; i < count; ++i){
+		Vec3 center = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 30.0f;
+		Vec3 extent = Vec3(fabsf(CheckRandom(&state)), fabsf(CheckRandom(&state)), fabsf(CheckRandom(&state))) * 2.0f;
+		radii[i] = extent.x;
+		centers.Set(i, center);
+		min.Set(i, center - extent);
+		max.Set(i, center + extent);
+	}
+
+	std::vector<uint32_t> spheres(count), boxes(count), parallel_spheres(count), parallel_boxes(count);
+	size_t sphere_count = CullSpheres(frustum, centers, &radii[0], &spheres[0]);
+	size_t box_count = CullBoxes(frustum, min, max, &boxes[0]);
+	size_t parallel_sphere_count = CullSpheres(frustum, centers, &radii[0], &parallel_spheres[0], xParallelPolicy(4096));
+	size_t parallel_box_count = CullBoxes(frustum, min, max, &parallel_boxes[0], kParallel);
+
+	size_t wrong = 0, borderline = 0;
+	std::vector<uint8_t> sphere_visible(count), box_visible(count);
+	for(size_t k = 0; k < sphere_count; ++k) sphere_visible[spheres[k]] = 1;
+	for(size_t k = 0; k < box_count; ++k) box_visible[boxes[k]] = 1;
+	for(size_t k = 1; k < sphere_count; ++k) wrong += spheres[k] <= spheres[k - 1];
+	for(size_t k = 1; k < box_count; ++k) wrong += boxes[k] <= boxes[k - 1];
+	for(size_t i = 0; i < count; ++i){
+		Vec3 center = centers.Get(i), low = min.Get(i), high = max.Get(i);
+		Vec3 grow = Vec3(margin, margin, margin);
+		bool sphere_in = frustum.IntersectsSphere(center, radii[i] - margin);
+		bool sphere_maybe = frustum.IntersectsSphere(center, radii[i] + margin);
+		bool box_in = frustum.IntersectsBox(low + grow, high - grow);
+		bool box_maybe = frustum.IntersectsBox(low - grow, high + grow);
+		borderline += (sphere_in != sphere_maybe) + (box_in != box_maybe);
+		if(sphere_in != sphere_maybe ? false : sphere_visible[i] != (uint8_t)sphere_in) ++wrong;
+		if(box_in != box_maybe ? false : box_visible[i] != (uint8_t)box_in) ++wrong;
+	}
+
+	bool parallel_ok = parallel_sphere_count == sphere_count && parallel_box_count == box_count &&
+		memcmp(&spheres[0], &parallel_spheres[0], sphere_count * sizeof(uint32_t)) == 0 &&
+		memcmp(&boxes[0], &parallel_boxes[0], box_count * sizeof(uint32_t)) == 0;
+	bool ok = wrong == 0 && parallel_ok && sphere_count > 0 && sphere_count < count && box_count >= sphere_count;
+	printf("Cull     spheres %u/%u  boxes %u/%u  borderline %u  wrong %u  parallel %s  %s\n",
+		(unsigned)sphere_count, (unsigned)count, (unsigned)box_count, (unsigned)count, (unsigned)borderline,
+		(unsigned)wrong, parallel_ok ? "match" : "differ", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// ComputeBounds over a Vec3 array, a Vec3SoA and a strided buffer, with
+// and without the pool, against a scalar loop: min and max are exact, so
+// the boxes must match bit for bit at every count, including ones shorter
+// than a register. The bounding spheres must hold every point. Arvo's box
+// must match the box around the eight transformed corners.
+bool CheckBounds(){
+	const size_t kStride = 5;
+	const size_t counts[] = { 0, 1, 5, 17, 100, kBoundsGrain * 3 + 7 };
+	uint32_t state = 37;
+	size_t wrong_boxes = 0, loose_spheres = 0;
+	for(size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c){
+		size_t count = counts[c];
+		std::vector<Vec3> points(count);
+		std::vector<float> strided(count * kStride + 1);
+		Vec3SoA soa(count);
+		AABB expected;
+		for(size_t i = 0; i < count; ++i){
+			points[i] = Vec3(CheckRandom(&state) * 50.0f, CheckRandom(&state) * 5.0f - 20.0f, CheckRandom(&state) * 500.0f);
+			soa.Set(i, points[i]);
+			strided[i * kStride] = points[i].x;
+			strided[i * kStride + 1] = points[i].y;
+			strided[i * kStride + 2] = points[i].z;
+			strided[i * kStride + 3] = 1.0e9f;
+			strided[i * kStride + 4] = -1.0e9f;
+			expected.Merge(points[i]);
+		}
+		const Vec3* array = count ? &points[0] : NULL;
+		AABB boxes[6] = {
+			ComputeBounds(array, count, kSequential), ComputeBounds(array, count),
+			ComputeBounds(soa, kSequential), ComputeBounds(soa, xParallelPolicy(4096)),
+			ComputeBounds(&strided[0], kStride, count, kSequential), ComputeBounds(&strided[0], kStride, count),
+		};
+		for(int b = 0; b < 6; ++b){
+			bool same = boxes[b].IsEmpty() == expected.IsEmpty() && (expected.IsEmpty() ||
+				(boxes[b].min == expected.min && boxes[b].max == expected.max));
+			wrong_boxes += !same;
+		}
+
+		Sphere spheres[3] = {
+			ComputeBoundingSphere(array, count), ComputeBoundingSphere(soa, kSequential),
+			ComputeBoundingSphere(&strided[0], kStride, count),
+		};
+		for(int s = 0; s < 3; ++s){
+			if(spheres[s].IsEmpty() != (count == 0)) ++loose_spheres;
+			for(size_t i = 0; i < count; ++i) loose_spheres += !spheres[s].Contains(points[i]);
+			if(count && spheres[s].radius > Sphere(expected).radius) ++loose_spheres;
+		}
+	}
+
+	Mat4 m = Mat4::GetTransform(Vec3(3.0f, -2.0f, 1.0f), Vec3(2.0f, 3.0f, 4.0f), 0.7f, -0.4f, 1.3f);
+	AABB box(Vec3(-1.0f, 2.0f, -3.0f), Vec3(4.0f, 2.5f, 1.0f));
+	AABB corners;
+	for(int k = 0; k < 8; ++k){
+		Vec4 corner = m.Mat4TransformVec4(Vec4(k & 1 ? box.max.x : box.min.x, k & 2 ? box.max.y : box.min.y,
+		                                       k & 4 ? box.max.z : box.min.z, 1.0f));
+		corners.Merge(Vec3(corner.x, corner.y, corner.z));
+	}
+	AABB arvo = box.Transformed(m);
+	float transform_error = fmaxf(Vec3::Distance(arvo.min, corners.min), Vec3::Distance(arvo.max, corners.max));
+
+	// A point on the surface along the stretched axis must stay inside the
+	// transformed sphere.
+	Sphere sphere(Vec3(1.0f, 1.0f, 1.0f), 2.0f);
+	Sphere moved = sphere.Transformed(m);
+	Vec4 surface = m.Mat4TransformVec4(Vec4(1.0f, 1.0f, 3.0f, 1.0f));
+	Sphere merged = sphere;
+	merged.Merge(Sphere(Vec3(10.0f, 1.0f, 1.0f), 1.0f));
+	bool volumes_ok = fabsf(moved.radius - 8.0f) <= 1e-5f && moved.Contains(Vec3(surface.x, surface.y, surface.z) * 0.99999f + moved.center * 0.00001f) &&
+		fabsf(merged.radius - 6.0f) <= 1e-5f && fabsf(merged.center.x - 5.0f) <= 1e-5f &&
+		merged.Contains(sphere) && merged.Contains(Sphere(Vec3(10.0f, 1.0f, 1.0f), 0.99f)) &&
+		box.Overlaps(AABB(Vec3(3.0f, 2.5f, 0.0f), Vec3(5.0f, 3.0f, 2.0f))) &&
+		!box.Overlaps(AABB(Vec3(4.5f, 2.0f, 0.0f), Vec3(5.0f, 3.0f, 2.0f))) &&
+		box.Overlaps(Sphere(Vec3(5.0f, 2.0f, 0.0f), 1.01f)) && !box.Overlaps(Sphere(Vec3(5.0f, 2.0f, 2.0f), 1.01f)) &&
+		box.Contains(AABB(Vec3(0.0f, 2.1f, 0.0f), Vec3(1.0f, 2.2f, 0.5f))) && !box.Contains(AABB()) &&
+		!AABB().Overlaps(box) && Sphere().IsEmpty();
+
+	bool ok = wrong_boxes == 0 && loose_spheres == 0 && transform_error <= 1e-4f && volumes_ok;
+	printf("Bounds   boxes %s  spheres %s  Transformed %.3g  volumes %s  %s\n", wrong_boxes ? "differ" : "exact",
+		loose_spheres ? "loose" : "tight", transform_error, volumes_ok ? "right" : "wrong", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+static bool SameHit(const RayHit& a, const RayHit& b){
+	if(a.IsHit() != b.IsHit()) return false;
+	return !a.IsHit() || (a.index == b.index && fabsf(a.t - b.t) <= 1e-4f * (1.0f + fabsf(a.t)) &&
+		fabsf(a.u - b.u) <= 1e-4f && fabsf(a.v - b.v) <= 1e-4f);
+}
+
+// The lane kernels against the scalar single-primitive tests, one ray
+// over many primitives and packets of rays over a few. kParallel must pick
+// the same hit as kSequential. The barycentrics must rebuild the hit
+// point, and a segment must stop at its end.
+bool CheckRays(){
+	const size_t count = kRayGrain * 2 + 37, rays = 200, packet = 1003, packet_primitives = 24;
+	uint32_t state = 41;
+	std::vector<Vec3> a(count), b(count), c(count);
+	TriangleSoA triangles(count);
+	Vec3SoA min(count), max(count), centers(count);
+	std::vector<float> radii(count);
+	for(size_t i = 0; i < count; ++i){
+		Vec3 base = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 20.0f;
+		a[i] = base;
+		b[i] = base + Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 2.0f;
+		c[i] = base + Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 2.0f;
+		triangles.Set(i, a[i], b[i], c[i]);
+		float size = fabsf(CheckRandom(&state)) + 0.1f;
+		min.Set(i, base - Vec3(size, size, size));
+		max.Set(i, base + Vec3(size, size * 0.5f, size * 2.0f));
+		centers.Set(i, base);
+		radii[i] = size;
+	}
+
+	size_t wrong = 0, hits = 0;
+	float barycentric_error = 0.0f;
+	for(size_t r = 0; r < rays; ++r){
+		Vec3 origin = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 30.0f;
+		Vec3 target = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 10.0f;
+		Ray ray(origin, target - origin, r % 3 ? 0.0f : 0.5f, r % 5 ? INFINITY : 1.5f);
+		RayHit triangle_ref, box_ref, sphere_ref;
+		for(size_t i = 0; i < count; ++i){
+			IntersectTriangle(ray, a[i], b[i], c[i], (uint32_t)i, &triangle_ref);
+			IntersectBox(ray, AABB(min.Get(i), max.Get(i)), (uint32_t)i, &box_ref);
+			IntersectSphere(ray, Sphere(centers.Get(i), radii[i]), (uint32_t)i, &sphere_ref);
+		}
+		RayHit triangle_hit = IntersectTriangles(ray, triangles);
+		RayHit box_hit = IntersectBoxes(ray, min, max);
+		RayHit sphere_hit = IntersectSpheres(ray, centers, &radii[0]);
+		RayHit triangle_parallel = IntersectTriangles(ray, triangles, kParallel);
+		RayHit box_parallel = IntersectBoxes(ray, min, max, xParallelPolicy(1024));
+		RayHit sphere_parallel = IntersectSpheres(ray, centers, &radii[0], kParallel);
+		wrong += !SameHit(triangle_hit, triangle_ref) + !SameHit(box_hit, box_ref) + !SameHit(sphere_hit, sphere_ref);
+		wrong += memcmp(&triangle_hit, &triangle_parallel, sizeof(RayHit)) != 0;
+		wrong += memcmp(&box_hit, &box_parallel, sizeof(RayHit)) != 0;
+		wrong += memcmp(&sphere_hit, &sphere_parallel, sizeof(RayHit)) != 0;
+		hits += triangle_hit.IsHit() + box_hit.IsHit() + sphere_hit.IsHit();
+		if(triangle_hit.IsHit()){
+			uint32_t i = triangle_hit.index;
+			Vec3 rebuilt = a[i] * (1.0f - triangle_hit.u - triangle_hit.v) + b[i] * triangle_hit.u + c[i] * triangle_hit.v;
+			barycentric_error = fmaxf(barycentric_error, Vec3::Distance(rebuilt, ray.At(triangle_hit.t)));
+		}
+	}
+
+	RaySoA packet_rays(packet);
+	packet_rays.t_min = 0.25f;
+	std::vector<Ray> packet_list;
+	std::vector<RayHit> triangle_hits(packet), box_hits(packet), sphere_hits(packet);
+	for(size_t r = 0; r < packet; ++r){
+		// Coherent rays: one eye, targets spread over the scene.
+		Vec3 target = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 20.0f;
+		Ray ray(Vec3(1.0f, 2.0f, 40.0f), target - Vec3(1.0f, 2.0f, 40.0f), packet_rays.t_min);
+		packet_rays.Set(r, ray);
+		packet_list.push_back(ray);
+		triangle_hits[r] = box_hits[r] = sphere_hits[r] = RayHit(ray.t_max);
+	}
+	for(size_t i = 0; i < packet_primitives; ++i){
+		IntersectTriangle(packet_rays, a[i], b[i], c[i], (uint32_t)i, &triangle_hits[0]);
+		IntersectBox(packet_rays, AABB(min.Get(i), max.Get(i)), (uint32_t)i, &box_hits[0], kParallel);
+		IntersectSphere(packet_rays, Sphere(centers.Get(i), radii[i]), (uint32_t)i, &sphere_hits[0]);
+	}
+	for(size_t r = 0; r < packet; ++r){
+		RayHit triangle_ref, box_ref, sphere_ref;
+		for(size_t i = 0; i < packet_primitives; ++i){
+			IntersectTriangle(packet_list[r], a[i], b[i], c[i], (uint32_t)i, &triangle_ref);
+			IntersectBox(packet_list[r], AABB(min.Get(i), max.Get(i)), (uint32_t)i, &box_ref);
+			IntersectSphere(packet_list[r], Sphere(centers.Get(i), radii[i]), (uint32_t)i, &sphere_ref);
+		}
+		wrong += !SameHit(triangle_hits[r], triangle_ref) + !SameHit(box_hits[r], box_ref) + !SameHit(sphere_hits[r], sphere_ref);
+		hits += triangle_hits[r].IsHit() + box_hits[r].IsHit() + sphere_hits[r].IsHit();
+	}
+
+	TriangleSoA wall(1);
+	wall.Set(0, Vec3(-1.0f, -1.0f, 0.0f), Vec3(3.0f, -1.0f, 0.0f), Vec3(-1.0f, 3.0f, 0.0f));
+	bool segments_ok = !IntersectTriangles(Segment(Vec3(0.0f, 0.0f, 2.0f), Vec3(0.0f, 0.0f, 0.5f)), wall).IsHit() &&
+		fabsf(IntersectTriangles(Segment(Vec3(0.0f, 0.0f, 2.0f), Vec3(0.0f, 0.0f, -2.0f)), wall).t - 0.5f) <= 1e-6f;
+
+	bool ok = wrong == 0 && hits > rays && barycentric_error <= 1e-3f && segments_ok;
+	printf("Rays     hits %u  wrong %u  barycentric %.3g  segments %s  %s\n", (unsigned)hits, (unsigned)wrong,
+		barycentric_error, segments_ok ? "right" : "wrong", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// Every triangle in exactly one leaf, every box around what is below it
+// and children after their parents.
+template<int Width>
+static size_t BvhTreeErrors(const xBvh<Width>& bvh){
+	const xBvhNode<Width>* nodes = bvh.Nodes();
+	const TriangleSoA& triangles = bvh.Triangles();
+	std::vector<int> seen(bvh.TriangleCount(), 0), indexed(bvh.TriangleCount(), 0);
+	size_t errors = 0;
+	for(size_t n = 0; n < bvh.NodeCount(); ++n){
+		for(int k = 0; k < Width; ++k){
+			if(nodes[n].child[k] == kBvhEmptySlot) continue;
+			AABB box = nodes[n].Bounds(k);
+			AABB loose(box.min - Vec3(1e-4f, 1e-4f, 1e-4f), box.max + Vec3(1e-4f, 1e-4f, 1e-4f));
+			uint32_t child = nodes[n].child[k];
+			if(nodes[n].count[k]){
+				for(uint32_t i = child; i < child + nodes[n].count[k]; ++i){
+					Vec3 a = triangles.vertex.Get(i);
+					errors += !loose.Contains(a) + !loose.Contains(a + triangles.edge1.Get(i)) + !loose.Contains(a + triangles.edge2.Get(i));
+					++seen[i];
+				}
+				continue;
+			}
+			if(child <= n || child >= bvh.NodeCount()){
+				++errors;
+				continue;
+			}
+			for(int j = 0; j < Width; ++j)
+				if(nodes[child].child[j] != kBvhEmptySlot) errors += !box.Contains(nodes[child].Bounds(j));
+		}
+	}
+	for(size_t i = 0; i < seen.size(); ++i){
+		errors += seen[i] != 1;
+		if(bvh.TriangleIndex(i) < indexed.size()) ++indexed[bvh.TriangleIndex(i)];
+	}
+	for(size_t i = 0; i < indexed.size(); ++i) errors += indexed[i] != 1;
+	return errors;
+}
+
+// The same t, or the same miss, as the brute-force scan of the mesh. The
+// triangle may differ only where two meet at the hit point.
+template<int Width>
+static size_t BvhRayErrors(const xBvh<Width>& bvh, const TriangleSoA& mesh, const std::vector<Ray>& rays, size_t* hits){
+	size_t errors = 0;
+	for(size_t r = 0; r < rays.size(); ++r){
+		RayHit expected = IntersectTriangles(rays[r], mesh), got = bvh.Intersect(rays[r]);
+		*hits += got.IsHit();
+		if(expected.IsHit() != got.IsHit()) ++errors;
+		else if(got.IsHit() && got.t != expected.t) ++errors;
+		else if(got.IsHit() && got.index == expected.index && (got.u != expected.u || got.v != expected.v)) ++errors;
+	}
+	return errors;
+}
+
+// Both widths over a wavy indexed grid and a triangle soup against a
+// brute-force scan, before and after a Refit. A kParallel build must give
+// the same nodes as a sequential one.
+bool CheckBvh(){
+	const size_t side = 121, soup_count = 20000, rays = 400;
+	std::vector<Vec3> grid, moved, soup;
+	std::vector<uint32_t> indices;
+	for(size_t z = 0; z < side; ++z)
+		for(size_t x = 0; x < side; ++x)
+			grid.push_back(Vec3((float)x / 6.0f - 10.0f, sinf((float)x * 0.3f) * cosf((float)z * 0.2f), (float)z / 6.0f - 10.0f));
+	for(size_t z = 0; z + 1 < side; ++z){
+		for(size_t x = 0; x + 1 < side; ++x){
+			uint32_t v = (uint32_t)(z * side + x);
+			uint32_t quad[6] = { v, v + 1, v + (uint32_t)side, v + 1, v + (uint32_t)side + 1, v + (uint32_t)side };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	}
+	for(size_t i = 0; i < grid.size(); ++i)
+		moved.push_back(grid[i] + Vec3(0.0f, sinf(grid[i].x + grid[i].z) * 0.5f + 1.0f, 0.0f));
+	uint32_t state = 43;
+	for(size_t i = 0; i < soup_count; ++i){
+		Vec3 base = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 10.0f;
+		soup.push_back(base);
+		soup.push_back(base + Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)));
+		soup.push_back(base + Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)));
+	}
+	const size_t triangles = indices.size() / 3;
+	TriangleSoA grid_mesh(&grid[0], &indices[0], triangles), moved_mesh(&moved[0], &indices[0], triangles);
+	std::vector<uint32_t> soup_indices(soup.size());
+	for(size_t i = 0; i < soup.size(); ++i) soup_indices[i] = (uint32_t)i;
+	TriangleSoA soup_mesh(&soup[0], &soup_indices[0], soup_count);
+
+	std::vector<Ray> probes;
+	for(size_t r = 0; r < rays; ++r){
+		Vec3 origin = Vec3(CheckRandom(&state), CheckRandom(&state) + 2.0f, CheckRandom(&state)) * 12.0f;
+		Vec3 target = Vec3(CheckRandom(&state), CheckRandom(&state) * 0.2f, CheckRandom(&state)) * 10.0f;
+		probes.push_back(Ray(origin, target - origin, r % 4 ? 0.0f : 0.3f, r % 3 ? INFINITY : 1.0f));
+	}
+
+	xBvh4 bvh4, parallel4, empty;
+	xBvh8 bvh8, soup8;
+	bvh4.Build(&grid[0], &indices[0], triangles, kSequential);
+	parallel4.Build(&grid[0], &indices[0], triangles, kParallel);
+	bvh8.Build(&grid[0], &indices[0], triangles);
+	soup8.Build(&soup[0], soup_count);
+	bool same = bvh4.NodeCount() == parallel4.NodeCount() &&
+		memcmp(bvh4.Nodes(), parallel4.Nodes(), bvh4.NodeCount() * sizeof(xBvhNode<4>)) == 0;
+
+	size_t tree = BvhTreeErrors(bvh4) + BvhTreeErrors(bvh8) + BvhTreeErrors(soup8);
+	size_t hits = 0;
+	size_t wrong = BvhRayErrors(bvh4, grid_mesh, probes, &hits) + BvhRayErrors(bvh8, grid_mesh, probes, &hits) +
+		BvhRayErrors(soup8, soup_mesh, probes, &hits);
+	wrong += empty.Intersect(probes[0]).IsHit();
+
+	RaySoA stream(rays);
+	std::vector<RayHit> traced(rays);
+	for(size_t r = 0; r < rays; ++r){
+		stream.Set(r, probes[r]);
+		traced[r] = RayHit(probes[r].t_max);
+	}
+	soup8.Intersect(stream, &traced[0], kParallel);
+	for(size_t r = 0; r < rays; ++r){
+		Ray ray(probes[r].origin, probes[r].direction, 0.0f, probes[r].t_max);
+		RayHit expected = soup8.Intersect(ray);
+		wrong += memcmp(&expected, &traced[r], sizeof(RayHit)) != 0;
+	}
+
+	bvh4.Refit(&moved[0], kSequential);
+	bvh8.Refit(&moved[0]);
+	tree += BvhTreeErrors(bvh4) + BvhTreeErrors(bvh8);
+	wrong += BvhRayErrors(bvh4, moved_mesh, probes, &hits) + BvhRayErrors(bvh8, moved_mesh, probes, &hits);
+
+	bool ok = same && tree == 0 && wrong == 0 && hits > rays * 2;
+	printf("Bvh      nodes %u/%u  hits %u  tree errors %u  wrong %u  parallel build %s  %s\n", (unsigned)bvh4.NodeCount(),
+		(unsigned)bvh8.NodeCount(), (unsigned)hits, (unsigned)tree, (unsigned)wrong, same ? "same" : "different",
+		ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// Radius and k-nearest queries against a scan of the live points. The
+// grid may round a distance differently, so points within 1e-5 of the
+// radius, or tied with the k-th neighbor, may go either way.
+static size_t HashGridQueryErrors(const xHashGrid& grid, const std::vector<Vec3>& points, const std::vector<bool>& live,
+                                  const std::vector<Vec3>& queries, float radius, size_t k, size_t* found){
+	size_t errors = 0;
+	std::vector<uint32_t> near_list, indices(k);
+	std::vector<float> squared(k), expected;
+	for(size_t q = 0; q < queries.size(); ++q){
+		near_list.clear();
+		size_t count = grid.QueryRadius(queries[q], radius, &near_list);
+		*found += count;
+		errors += count != near_list.size();
+		std::vector<char> listed(points.size(), 0);
+		for(size_t i = 0; i < near_list.size(); ++i){
+			if(near_list[i] >= points.size() || !live[near_list[i]] || listed[near_list[i]]++){
+				++errors;
+				continue;
+			}
+		}
+		expected.clear();
+		for(size_t i = 0; i < points.size(); ++i){
+			if(!live[i]) continue;
+			float d = (points[i] - queries[q]).SqrMagnitude();
+			expected.push_back(d);
+			if(fabsf(sqrtf(d) - radius) > 1e-5f) errors += (d <= radius * radius) != (listed[i] != 0);
+		}
+
+		size_t nearest = grid.QueryNearest(queries[q], k, &indices[0], &squared[0]);
+		std::sort(expected.begin(), expected.end());
+		errors += nearest != std::min(k, expected.size());
+		for(size_t j = 0; j < k; ++j){
+			if(j >= nearest){
+				errors += indices[j] != kNoPoint || squared[j] != INFINITY;
+				continue;
+			}
+			if(indices[j] >= points.size() || !live[indices[j]]){
+				++errors;
+				continue;
+			}
+			float tolerance = 1e-5f * (1.0f + expected[j]);
+			errors += fabsf(squared[j] - expected[j]) > tolerance;
+			errors += fabsf(squared[j] - (points[indices[j]] - queries[q]).SqrMagnitude()) > tolerance;
+			errors += j > 0 && (squared[j] < squared[j - 1] || indices[j] == indices[j - 1]);
+		}
+	}
+	return errors;
+}
+
+// A clustered cloud with a few far outliers, built sequentially and in
+// parallel, then edited by Insert, Remove and Move, which must keep the
+// queries in step with the scan. The two builds must lay out every bucket
+// the same way.
+bool CheckHashGrid(){
+	const size_t count = 20000, query_count = 300, k = 8;
+	const float cell = 0.25f, radius = 0.3f;
+	uint32_t state = 71;
+	std::vector<Vec3> points, queries;
+	for(size_t i = 0; i < count; ++i){
+		Vec3 p = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 4.0f;
+		if(i % 4 == 0) p = p * 0.1f;
+		if(i % 5000 == 0) p = p + Vec3(500.0f, -300.0f, 80.0f);
+		points.push_back(p);
+	}
+	for(size_t q = 0; q < query_count; ++q)
+		queries.push_back(Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * (q % 10 ? 4.5f : 40.0f));
+	std::vector<bool> live(count, true);
+
+	xHashGrid grid, parallel, empty;
+	grid.Build(&points[0], count, cell, kSequential);
+	parallel.Build(&points[0], count, cell, kParallel);
+	bool same = grid.BucketCount() == parallel.BucketCount();
+	for(size_t b = 0; same && b < grid.BucketCount(); ++b){
+		size_t n, m;
+		const xHashGridEntry* a = grid.Entries(b, &n);
+		const xHashGridEntry* c = parallel.Entries(b, &m);
+		same = n == m && memcmp(a, c, n * sizeof(xHashGridEntry)) == 0;
+	}
+
+	size_t found = 0;
+	size_t errors = HashGridQueryErrors(grid, points, live, queries, radius, k, &found);
+	uint32_t none[2];
+	errors += empty.QueryNearest(queries[0], 2, none, NULL) != 0 || none[1] != kNoPoint;
+
+	// Cells far past int32_t on every axis: the outliers share the
+	// clamped outermost cells and must still be found by distance.
+	std::vector<Vec3> wide(points.begin(), points.begin() + 2000), wide_queries(queries.begin(), queries.begin() + 30);
+	for(size_t i = 0; i < wide.size(); i += 10) wide[i] = wide[i] * 1000.0f;
+	xHashGrid far;
+	far.Build(&wide[0], wide.size(), 1.0e-6f);
+	errors += HashGridQueryErrors(far, wide, std::vector<bool>(wide.size(), true), wide_queries, radius, k, &found);
+
+	for(size_t step = 0; step < 30000; ++step){
+		uint32_t i = (uint32_t)(state % points.size());
+		float pick = CheckRandom(&state);
+		Vec3 target = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 4.0f;
+		if(pick < -0.6f){
+			if(!live[i]) continue;
+			grid.Remove(i);
+			live[i] = false;
+		}else if(pick < -0.2f){
+			errors += grid.Insert(target) != points.size();
+			points.push_back(target);
+			live.push_back(true);
+		}else if(live[i]){
+			// Mostly small steps that stay in the cell.
+			Vec3 to = pick < 0.6f ? points[i] + (target * 0.005f) : target;
+			grid.Move(i, to);
+			points[i] = to;
+		}
+	}
+	size_t alive = 0;
+	for(size_t i = 0; i < points.size(); ++i){
+		alive += live[i];
+		errors += grid.Contains((uint32_t)i) != live[i];
+		if(live[i]) errors += grid.Position((uint32_t)i) != points[i];
+	}
+	errors += grid.Count() != alive || grid.IndexCount() != points.size();
+	errors += HashGridQueryErrors(grid, points, live, queries, radius, k, &found);
+
+	std::vector<uint32_t> batch(query_count * k), single(k);
+	std::vector<float> batch_squared(query_count * k), single_squared(k);
+	grid.QueryNearest(&queries[0], query_count, k, &batch[0], &batch_squared[0], kParallel);
+	for(size_t q = 0; q < query_count; ++q){
+		grid.QueryNearest(queries[q], k, &single[0], &single_squared[0]);
+		errors += memcmp(&single[0], &batch[q * k], k * sizeof(uint32_t)) != 0 ||
+			memcmp(&single_squared[0], &batch_squared[q * k], k * sizeof(float)) != 0;
+	}
+
+	bool ok = same && errors == 0 && found > query_count;
+	printf("HashGrid points %u  buckets %u  found %u  errors %u  parallel build %s  %s\n", (unsigned)grid.Count(),
+		(unsigned)grid.BucketCount(), (unsigned)found, (unsigned)errors, same ? "same" : "different", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// Every point once, every leaf at most kKdTreeLeaf points, and each side
+// of a split on its side of the split value.
+static size_t KdTreeErrors(const xKdTree& tree, size_t node, size_t begin, size_t end, size_t level){
+	const xKdTreePoint* points = tree.Points();
+	if(level == tree.Depth()) return end - begin > kKdTreeLeaf;
+	size_t errors = 0, middle = begin + (end - begin) / 2;
+	int axis = tree.Axes()[node];
+	float split = tree.Splits()[node];
+	for(size_t i = begin; i < middle; ++i) errors += (&points[i].x)[axis] > split;
+	for(size_t i = middle; i < end; ++i) errors += (&points[i].x)[axis] < split;
+	return errors + KdTreeErrors(tree, 2 * node + 1, begin, middle, level + 1) +
+		KdTreeErrors(tree, 2 * node + 2, middle, end, level + 1);
+}
+
+// Radius and k-nearest queries against a scan, one query at a time and
+// batched. Points within 1e-5 of the radius may go either way.
+static size_t KdTreeQueryErrors(const xKdTree& tree, const std::vector<Vec3>& points, const std::vector<Vec3>& queries,
+                                float radius, size_t k, size_t* found){
+	size_t errors = 0;
+	std::vector<uint32_t> near_list, indices(k);
+	std::vector<float> squared(k), expected;
+	for(size_t q = 0; q < queries.size(); ++q){
+		near_list.clear();
+		size_t count = tree.QueryRadius(queries[q], radius, &near_list);
+		*found += count;
+		errors += count != near_list.size();
+		std::vector<char> listed(points.size(), 0);
+		for(size_t i = 0; i < near_list.size(); ++i)
+			errors += near_list[i] >= points.size() || listed[near_list[i]]++;
+		expected.clear();
+		for(size_t i = 0; i < points.size(); ++i){
+			float d = (points[i] - queries[q]).SqrMagnitude();
+			expected.push_back(d);
+			if(fabsf(sqrtf(d) - radius) > 1e-5f) errors += (d <= radius * radius) != (listed[i] != 0);
+		}
+
+		size_t nearest = tree.QueryNearest(queries[q], k, &indices[0], &squared[0]);
+		std::sort(expected.begin(), expected.end());
+		errors += nearest != std::min(k, points.size());
+		for(size_t j = 0; j < k; ++j){
+			if(j >= nearest){
+				errors += indices[j] != kKdTreeNoPoint || squared[j] != INFINITY;
+				continue;
+			}
+			if(indices[j] >= points.size()){
+				++errors;
+				continue;
+			}
+			float tolerance = 1e-5f * (1.0f + expected[j]);
+			errors += fabsf(squared[j] - expected[j]) > tolerance;
+			errors += fabsf(squared[j] - (points[indices[j]] - queries[q]).SqrMagnitude()) > tolerance;
+			if(j > 0) errors += squared[j] < squared[j - 1] || (squared[j] == squared[j - 1] && indices[j] <= indices[j - 1]);
+		}
+	}
+
+	std::vector<uint32_t> batch(queries.size() * k), ranged;
+	std::vector<float> batch_squared(queries.size() * k);
+	std::vector<size_t> offsets;
+	tree.QueryNearest(&queries[0], queries.size(), k, &batch[0], &batch_squared[0], kParallel);
+	tree.QueryRadius(&queries[0], queries.size(), radius, &ranged, &offsets, xParallelPolicy(7));
+	for(size_t q = 0; q < queries.size(); ++q){
+		tree.QueryNearest(queries[q], k, &indices[0], &squared[0]);
+		errors += memcmp(&indices[0], &batch[q * k], k * sizeof(uint32_t)) != 0 ||
+			memcmp(&squared[0], &batch_squared[q * k], k * sizeof(float)) != 0;
+		near_list.clear();
+		tree.QueryRadius(queries[q], radius, &near_list);
+		errors += offsets[q + 1] - offsets[q] != near_list.size() ||
+			!std::equal(near_list.begin(), near_list.end(), ranged.begin() + offsets[q]);
+	}
+	return errors;
+}
+
+// A clustered cloud with repeated points and far outliers, and a cloud
+// smaller than one leaf. A kParallel build must match a sequential one.
+bool CheckKdTree(){
+	const size_t count = 30000, query_count = 300, k = 6;
+	const float radius = 0.25f;
+	uint32_t state = 83;
+	std::vector<Vec3> points, few, queries;
+	for(size_t i = 0; i < count; ++i){
+		Vec3 p = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 4.0f;
+		if(i % 3 == 0) p = Vec3(p.x, p.y * 0.01f, p.z * 0.5f);
+		if(i % 7 == 0 && i) p = points[i - 1];
+		if(i % 6000 == 0) p = p + Vec3(-200.0f, 900.0f, 30.0f);
+		points.push_back(p);
+	}
+	for(size_t i = 0; i < 5; ++i) few.push_back(points[i * 11]);
+	for(size_t q = 0; q < query_count; ++q)
+		queries.push_back(q % 9 ? points[q * 37] + Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 0.1f :
+			Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 50.0f);
+
+	xKdTree tree, parallel, small, empty;
+	tree.Build(&points[0], count, kSequential);
+	parallel.Build(&points[0], count, kParallel);
+	small.Build(&few[0], few.size());
+	bool same = tree.Depth() == parallel.Depth() &&
+		memcmp(tree.Points(), parallel.Points(), count * sizeof(xKdTreePoint)) == 0 &&
+		memcmp(tree.Splits(), parallel.Splits(), (((size_t)1 << tree.Depth()) - 1) * sizeof(float)) == 0;
+
+	size_t errors = KdTreeErrors(tree, 0, 0, count, 0) + KdTreeErrors(small, 0, 0, few.size(), 0);
+	std::vector<int> seen(count, 0);
+	for(size_t i = 0; i < count; ++i)
+		if(tree.Points()[i].index < count) ++seen[tree.Points()[i].index];
+	for(size_t i = 0; i < count; ++i) errors += seen[i] != 1;
+
+	size_t found = 0;
+	errors += KdTreeQueryErrors(tree, points, queries, radius, k, &found);
+	errors += KdTreeQueryErrors(small, few, queries, radius * 20.0f, k, &found);
+	uint32_t none[2];
+	errors += empty.QueryNearest(queries[0], 2, none, NULL) != 0 || none[0] != kKdTreeNoPoint;
+
+	bool ok = same && errors == 0 && found > query_count;
+	printf("KdTree   points %u  depth %u  found %u  errors %u  parallel build %s  %s\n", (unsigned)tree.Count(),
+		(unsigned)tree.Depth(), (unsigned)found, (unsigned)errors, same ? "same" : "different", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// The full matrix and the top-k lists against SqrMagnitude of every pair,
+// for sets that end mid-tile and mid-register, and a b smaller than k.
+// The difference of squares rounds at up to 5e-7 of |a|^2 + |b|^2.
+bool CheckPairwise(){
+	const size_t rows = 333, columns = 1500, k = 5, stride = 1504;
+	uint32_t state = 97;
+	std::vector<Vec3> a, b;
+	for(size_t i = 0; i < rows; ++i) a.push_back(Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 3.0f);
+	for(size_t j = 0; j < columns; ++j) b.push_back(Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 3.0f);
+	b[7] = a[0];
+	b[8] = a[0];
+	Vec3SoA a_soa(&a[0], rows), b_soa(&b[0], columns), few(&b[0], 3);
+
+	std::vector<float> matrix(rows * stride, -1.0f), parallel_matrix(rows * stride, -1.0f);
+	PairwiseSquaredDistances(a_soa, b_soa, &matrix[0], stride);
+	PairwiseSquaredDistances(a_soa, b_soa, &parallel_matrix[0], stride, kParallel);
+	std::vector<uint32_t> indices(rows * k), parallel_indices(rows * k), few_indices(rows * k);
+	std::vector<float> squared(rows * k), few_squared(rows * k);
+	PairwiseNearest(a_soa, b_soa, k, &indices[0], &squared[0]);
+	PairwiseNearest(a_soa, b_soa, k, &parallel_indices[0], NULL, xParallelPolicy(8));
+	PairwiseNearest(a_soa, few, k, &few_indices[0], &few_squared[0]);
+	bool same = matrix == parallel_matrix && indices == parallel_indices;
+
+	size_t errors = 0;
+	float worst = 0.0f;
+	std::vector<float> expected(columns);
+	for(size_t i = 0; i < rows; ++i){
+		for(size_t j = 0; j < columns; ++j){
+			expected[j] = (a[i] - b[j]).SqrMagnitude();
+			float tolerance = 1e-6f * (a[i].SqrMagnitude() + b[j].SqrMagnitude()) + 1e-7f;
+			float error = fabsf(matrix[i * stride + j] - expected[j]);
+			worst = std::max(worst, error);
+			errors += error > tolerance || matrix[i * stride + j] < 0.0f;
+		}
+		for(size_t j = columns; j < stride; ++j) errors += matrix[i * stride + j] != -1.0f;
+		std::vector<float> sorted(expected);
+		std::sort(sorted.begin(), sorted.end());
+		for(size_t j = 0; j < k; ++j){
+			uint32_t index = indices[i * k + j];
+			if(index >= columns){
+				++errors;
+				continue;
+			}
+			errors += fabsf(squared[i * k + j] - sorted[j]) > 1e-4f;
+			errors += squared[i * k + j] != matrix[i * stride + index];
+			if(j > 0) errors += !PairwiseCloser(xPairwiseNeighbor{ squared[i * k + j - 1], indices[i * k + j - 1] },
+				xPairwiseNeighbor{ squared[i * k + j], index });
+		}
+		for(size_t j = 0; j < k; ++j){
+			bool padded = j >= few.count;
+			errors += padded ? few_indices[i * k + j] != kPairwiseNoPoint || few_squared[i * k + j] != INFINITY :
+				few_indices[i * k + j] >= few.count;
+		}
+	}
+	errors += indices[0] != 7 || indices[1] != 8 || squared[0] != 0.0f;
+
+	bool ok = same && errors == 0;
+	printf("Pairwise pairs %u  worst error %.3g  errors %u  parallel %s  %s\n", (unsigned)(rows * columns), worst,
+		(unsigned)errors, same ? "same" : "different", ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// MultiplyBatch against Mat4::Multiply for every form, over a count with a
+// tail. The kernels sum in the order of xMatrix4 Multiply, which may fuse
+// where Mat4::Multiply does not, so those compare within a few roundings of
+// the sum of |a||b|; the AoS, SoA and in-place forms run the same kernel
+// arithmetic and compare exactly.
+static size_t Mat4ProductErrors(const Mat4& a, const Mat4& b, const Mat4& product, float* worst){
+	Mat4 expected = a.Multiply(b);
+	size_t errors = 0;
+	for(int c = 0; c < 4; ++c){
+		for(int r = 0; r < 4; ++r){
+			float bound = 0.0f;
+			for(int k = 0; k < 4; ++k) bound += fabsf(a.m[k * 4 + r] * b.m[c * 4 + k]);
+			float error = fabsf(product.m[c * 4 + r] - expected.m[c * 4 + r]);
+			*worst = std::max(*worst, error / (bound + 1e-30f));
+			errors += error > 5e-7f * bound;
+		}
+	}
+	return errors;
+}
+
+// xMatrix4 Multiply against Mat4::Multiply, M * Inverse(M) against the
+// identity on diagonally dominant matrices, and Inverse on integer
+// matrices with one line the difference of two others, whose determinant
+// rounds to exactly zero: it must return false and leave *out untouched.
+bool CheckMatrix4(){
+	uint32_t state = 37;
+	size_t errors = 0;
+	float worst = 0.0f, identity_error = 0.0f;
+	bool singular_ok = true;
+	for(int i = 0; i < 1000; ++i){
+		Mat4 a, b, singular;
+		for(int e = 0; e < 16; ++e){
+			a.m[e] = CheckRandom(&state) * 4.0f;
+			b.m[e] = CheckRandom(&state) * 4.0f;
+			singular.m[e] = floorf(CheckRandom(&state) * 4.0f);
+		}
+		errors += Mat4ProductErrors(a, b, Multiply(xMatrix4(a), xMatrix4(b)).ToMat4(), &worst);
+		errors += Mat4ProductErrors(a, b, (xMatrix4(b) * xMatrix4(a)).ToMat4(), &worst);
+
+		for(int d = 0; d < 4; ++d) a.m[d * 5] += a.m[d * 5] < 0.0f ? -16.0f : 16.0f;
+		xMatrix4 inverse;
+		if(!Inverse(xMatrix4(a), &inverse)){
+			++errors;
+			continue;
+		}
+		Mat4 products[2] = { Multiply(xMatrix4(a), inverse).ToMat4(), Multiply(inverse, xMatrix4(a)).ToMat4() };
+		for(int k = 0; k < 2; ++k)
+			for(int e = 0; e < 16; ++e)
+				identity_error = fmaxf(identity_error, fabsf(products[k].m[e] - Mat4::Identity().m[e]));
+
+		int line = i % 4;
+		for(int c = 0; c < 4; ++c)
+			singular.m[line * 4 + c] = singular.m[(line + 1) % 4 * 4 + c] - singular.m[(line + 2) % 4 * 4 + c];
+		xMatrix4 untouched = inverse;
+		singular_ok = singular_ok && !Inverse(xMatrix4(singular), &inverse) && inverse == untouched;
+	}
+
+	bool ok = errors == 0 && identity_error <= 1e-5f && singular_ok;
+	printf("xMatrix4 Multiply worst %.3g of |a||b|  M * Inverse(M) %.3g  singular %s  errors %u  %s\n", worst,
+		identity_error, singular_ok ? "found" : "missed", (unsigned)errors, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+static float Mat4Error(const Mat4& a, const Mat4& b){
+	float error = 0.0f;
+	for(int e = 0; e < 16; ++e) error = fmaxf(error, fabsf(a.m[e] - b.m[e]));
+	return error;
+}
+
+// Mat4::GetInverse/Inverse/Determinant and InverseBatch. The identity
+// inverts to itself, a uniform scale of 0.001 (det 1e-9) inverts through
+// every inverse, GetTransform matrices have det = sx * sy * sz, and
+// inverting twice gives the matrix back. Every third matrix of the batch
+// is an integer matrix with one line the sum of two others: its flag must
+// be clear and its output untouched. The batch runs 1003 matrices for the
+// tail, matches GetInverse and the single xMatrix4 Inverse, and gives the
+// same bits in place as out of place.
+bool CheckInverses(){
+	const size_t count = 1003;
+	uint32_t state = 43;
+	Mat4 identity = Mat4::Identity(), identity_inverse;
+	bool identity_ok = identity.GetInverse(&identity_inverse) && memcmp(identity_inverse.m, identity.m, sizeof(identity.m)) == 0 &&
+		identity.Determinant() == 1.0f;
+	Mat4 small = Mat4::GetTransform(Vec3(3.0f, -2.0f, 1.0f), Vec3(0.001f, 0.001f, 0.001f), 0.5f, 1.0f, 1.5f), small_inverse;
+	xMatrix4 x_small;
+	uint8_t small_flag = 0;
+	bool small_ok = small.GetInverse(&small_inverse) && small.GetInverseAffine(&small_inverse) &&
+		Inverse(xMatrix4(small), &x_small) && InverseAffine(xMatrix4(small), &x_small) &&
+		InverseBatch(&small, &small_inverse, &small_flag, 1) == 1 && small_flag == 1;
+
+	std::vector<Mat4> in(count), batch(count, Mat4(7.0f)), in_place;
+	std::vector<xMatrix4> x_in(count), x_batch(count), x_in_place;
+	std::vector<uint8_t> flags(count), x_flags(count), in_place_flags(count);
+	float error = 0.0f, determinant_error = 0.0f;
+	size_t errors = 0;
+	for(size_t i = 0; i < count; ++i){
+		if(i % 3 == 0){
+			for(int e = 0; e < 16; ++e) in[i].m[e] = floorf(CheckRandom(&state) * 4.0f);
+			for(int c = 0; c < 4; ++c) in[i].m[(i % 4) * 4 + c] = in[i].m[((i + 1) % 4) * 4 + c] + in[i].m[((i + 2) % 4) * 4 + c];
+			continue;
+		}
+		Vec3 scale = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) + 2.0f;
+		Vec3 radians = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 3.14159265f;
+		in[i] = Mat4::GetTransform(Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)), scale,
+		                           radians.x, radians.y, radians.z);
+		determinant_error = fmaxf(determinant_error, fabsf(in[i].Determinant() / (scale.x * scale.y * scale.z) - 1.0f));
+		// Fill the bottom line so the general path is exercised.
+		for(int c = 0; c < 4; ++c) in[i].m[12 + c] += CheckRandom(&state) * 0.25f;
+	}
+	for(size_t i = 0; i < count; ++i) x_in[i] = xMatrix4(in[i]);
+	in_place = in;
+	x_in_place = x_in;
+
+	size_t inverted = InverseBatch(&in[0], &batch[0], &flags[0], count);
+	size_t x_inverted = InverseBatch(&x_in[0], &x_batch[0], &x_flags[0], count);
+	size_t in_place_inverted = InverseBatch(&in_place[0], &in_place[0], &in_place_flags[0], count);
+	InverseBatch(&x_in_place[0], &x_in_place[0], NULL, count);
+	errors += inverted != count - (count + 2) / 3;
+	errors += x_inverted != inverted || in_place_inverted != inverted;
+
+	for(size_t i = 0; i < count; ++i){
+		Mat4 single = Mat4(7.0f), round_trip, self = in[i];
+		bool ok = in[i].GetInverse(&single);
+		errors += ok != (i % 3 != 0) || flags[i] != ok || x_flags[i] != ok || in_place_flags[i] != ok;
+		errors += self.Inverse() != ok;
+		if(!ok){
+			errors += memcmp(batch[i].m, Mat4(7.0f).m, sizeof(batch[i].m)) != 0;
+			errors += memcmp(in_place[i].m, in[i].m, sizeof(in[i].m)) != 0;
+			errors += memcmp(self.m, in[i].m, sizeof(in[i].m)) != 0;
+			continue;
+		}
+		xMatrix4 x_single;
+		errors += !Inverse(x_in[i], &x_single);
+		errors += memcmp(in_place[i].m, batch[i].m, sizeof(batch[i].m)) != 0;
+		errors += memcmp(x_in_place[i].col, x_batch[i].col, sizeof(x_batch[i].col)) != 0;
+		errors += memcmp(x_batch[i].col, batch[i].m, sizeof(batch[i].m)) != 0;
+		errors += memcmp(self.m, single.m, sizeof(single.m)) != 0;
+		errors += !single.GetInverse(&round_trip);
+		error = fmaxf(error, Mat4Error(batch[i], single));
+		error = fmaxf(error, Mat4Error(x_single.ToMat4(), single));
+		error = fmaxf(error, Mat4Error(round_trip, in[i]));
+	}
+
+	bool ok = identity_ok && small_ok && errors == 0 && error <= 1e-5f && determinant_error <= 1e-5f;
+	printf("Inverse  batch %u of %u  vs single %.3g  det %.3g  identity %s  0.001 scale %s  errors %u  %s\n", (unsigned)inverted,
+		(unsigned)count, error, determinant_error, identity_ok ? "right" : "wrong", small_ok ? "inverted" : "singular",
+		(unsigned)errors, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+bool CheckMat4Batch(){
+	const size_t count = 1003;
+	uint32_t state = 41;
+	std::vector<Mat4> a(count), b(count);
+	for(size_t i = 0; i < count; ++i){
+		for(int e = 0; e < 16; ++e){
+			a[i].m[e] = CheckRandom(&state) * 4.0f;
+			b[i].m[e] = CheckRandom(&state) * 4.0f;
+		}
+	}
+	const Mat4 fixed = Mat4::GetTransform(Vec3(1.0f, -2.0f, 3.0f), Vec3(0.5f, 2.0f, 1.5f), 0.3f, -1.1f, 2.0f);
+
+	std::vector<Mat4> pairs(count), left(count), right(count), parallel(count), in_place(a);
+	MultiplyBatch(&a[0], &b[0], &pairs[0], count, kSequential);
+	MultiplyBatch(fixed, &b[0], &left[0], count, kSequential);
+	MultiplyBatch(&a[0], fixed, &right[0], count, kSequential);
+	MultiplyBatch(&a[0], &b[0], &parallel[0], count, xParallelPolicy(64));
+	MultiplyBatch(&in_place[0], &b[0], &in_place[0], count);
+
+	std::vector<xMatrix4> xa(count), xb(count), x_pairs(count);
+	for(size_t i = 0; i < count; ++i){
+		xa[i] = xMatrix4(a[i]);
+		xb[i] = xMatrix4(b[i]);
+	}
+	MultiplyBatch(&xa[0], &xb[0], &x_pairs[0], count);
+
+	Mat4SoA a_soa, b_soa(&b[0], count), soa_pairs, soa_left, soa_right;
+	ToMat4SoA(&a[0], count, &a_soa);
+	MultiplyBatch(a_soa, b_soa, &soa_pairs);
+	MultiplyBatch(fixed, b_soa, &soa_left);
+	MultiplyBatch(a_soa, fixed, &soa_right);
+	std::vector<Mat4> round_trip(count), from_soa(count), from_left(count), from_right(count);
+	std::vector<xMatrix4> x_round_trip(count);
+	ToMat4Array(a_soa, &round_trip[0]);
+	ToMat4Array(a_soa, &x_round_trip[0]);
+	ToMat4Array(soa_pairs, &from_soa[0]);
+	ToMat4Array(soa_left, &from_left[0]);
+	ToMat4Array(soa_right, &from_right[0]);
+
+	size_t errors = 0;
+	float worst = 0.0f;
+	for(size_t i = 0; i < count; ++i){
+		errors += Mat4ProductErrors(a[i], b[i], pairs[i], &worst);
+		errors += Mat4ProductErrors(fixed, b[i], left[i], &worst);
+		errors += Mat4ProductErrors(a[i], fixed, right[i], &worst);
+		const float* same[] = { parallel[i].m, in_place[i].m, from_soa[i].m, (const float*)x_pairs[i].col };
+		for(size_t s = 0; s < sizeof(same) / sizeof(same[0]); ++s) errors += memcmp(same[s], pairs[i].m, 16 * sizeof(float)) != 0;
+		errors += memcmp(from_left[i].m, left[i].m, 16 * sizeof(float)) != 0;
+		errors += memcmp(from_right[i].m, right[i].m, 16 * sizeof(float)) != 0;
+		errors += memcmp(round_trip[i].m, a[i].m, 16 * sizeof(float)) != 0;
+		errors += memcmp(x_round_trip[i].col, a[i].m, 16 * sizeof(float)) != 0;
+		errors += memcmp(a_soa.Get(i).m, a[i].m, 16 * sizeof(float)) != 0;
+	}
+
+	bool ok = errors == 0;
+	printf("Mat4Batch products %u  worst error %.3g of |a||b|  errors %u  %s\n", (unsigned)(count * 3), worst,
+		(unsigned)errors, ok ? "ok" : "FAILED");
+	return ok;
+}
+
+// The batch functions under kParallel against the same calls under
+// kSequential. Both run the same kernels over grain-aligned ranges, so the
+// results must match bit for bit. ParallelFor must visit every index once,
+// also from inside another ParallelFor, and ParallelReduce must give the
+// same answer however the range was split.
+bool CheckParallel(){
+	const size_t count = 200003;
+	uint32_t state = 29;
+	std::vector<Vec3> points(count), sequential_points(count), parallel_points(count);
+	std::vector<float> angles(count), sequential_sin(count), parallel_sin(count);
+	Vec3SoA vectors(count), sequential_normals, parallel_normals;
+	for(size_t i = 0; i < count; ++i){
+		points[i] = Vec3(CheckRandom(&state), CheckRandom(&state), CheckRandom(&state)) * 10.0f;
+		vectors.Set(i, points[i] + Vec3(0.0f, 0.0f, 11.0f));
+		angles[i] = CheckRandom(&state) * 100.0f;
+	}
+	Mat4 m = Mat4::GetTransform(Vec3(1.0f, 2.0f, 3.0f), Vec3(2.0f, 2.0f, 2.0f), 0.3f, 0.2f, 0.1f);
+	TransformPoints(m, &points[0], &sequential_points[0], count);
+	TransformPoints(m, &points[0], &parallel_points[0], count, kParallel);
+	Normalize(vectors, &sequential_normals);
+	Normalize(vectors, &parallel_normals, kParallel);
+	Sin(&angles[0], &sequential_sin[0], count);
+	Sin(&angles[0], &parallel_sin[0], count, xParallelPolicy(1024));
+
+	// Every seventh matrix is singular.
+	const size_t matrices = 20000;
+	std::vector<Mat4> in(matrices), sequential_inverse(matrices), parallel_inverse(matrices);
+	for(size_t i = 0; i < matrices; ++i){
+		Vec3 scale = i % 7 ? Vec3(2.0f, 3.0f, 4.0f) : Vec3(0.0f, 1.0f, 1.0f);
+		in[i] = Mat4::GetTransform(points[i], scale, angles[i], angles[i + 1], angles[i + 2]);
+	}
+	size_t sequential_inverted = InverseBatch(&in[0], &sequential_inverse[0], NULL, matrices);
+	size_t parallel_inverted = InverseBatch(&in[0], &parallel_inverse[0], NULL, matrices, kMat4InverseEpsilon, kParallel);
+
+	bool batches_ok = memcmp(&sequential_points[0], &parallel_points[0], count * sizeof(Vec3)) == 0 &&
+		memcmp(sequential_normals.x, parallel_normals.x, count * sizeof(float)) == 0 &&
+		memcmp(sequential_normals.y, parallel_normals.y, count * sizeof(float)) == 0 &&
+		memcmp(sequential_normals.z, parallel_normals.z, count * sizeof(float)) == 0 &&
+		memcmp(&sequential_sin[0], &parallel_sin[0], count * sizeof(float)) == 0 &&
+		sequential_inverted == parallel_inverted && parallel_inverted == matrices - (matrices + 6) / 7 &&
+		memcmp(&sequential_inverse[0], &parallel_inverse[0], matrices * sizeof(Mat4)) == 0;
+
+	const size_t outer = 64, inner = 5000;
+	std::vector<uint8_t> visits(outer * inner);
+	ParallelFor(kParallel, outer, 1, [&](size_t begin, size_t end){
+		for(size_t o = begin; o < end; ++o){
+			ParallelFor(kParallel, inner, 256, [&](size_t inner_begin, size_t inner_end){
+				for(size_t i = inner_begin; i < inner_end; ++i) ++visits[o * inner + i];
+			});
+		}
+	});
+	bool nested_ok = true;
+	for(size_t i = 0; i < visits.size(); ++i) nested_ok = nested_ok && visits[i] == 1;
+
+	uint64_t sum = ParallelReduce(xParallelPolicy(1000), count, 0, [](size_t begin, size_t end){
+		uint64_t partial = 0;
+		for(size_t i = begin; i < end; ++i) partial += i;
+		return partial;
+	}, [](uint64_t a, uint64_t b){ return a + b; });
+	bool reduce_ok = sum == (uint64_t)count * (count - 1) / 2;
+
+	bool ok = batches_ok && nested_ok && reduce_ok;
+	printf("Parallel %u threads  batches %s  nested %s  reduce %s  %s\n", (unsigned)xThreadPool::Instance().Threads(),
+		batches_ok ? "match" : "differ", nested_ok ? "once" : "wrong", reduce_ok ? "right" : "wrong", ok ? "ok" : "FAILED");
+	return ok;
+}
+
 int main(int argc, char** argv){
 	argc = 0;
 	argv = NULL;
 
-	MeasureVec3();
-	system("pause");
-	MeasureVector3();
-	// CheckVectorOperations();
+	CheckVectorOperations();
 
-	return 0;
+	bool ok = CheckPrecisionTiers();
+	ok = CheckCompoundOperators() && ok;
+	ok = CheckQuaternions() && ok;
+	ok = CheckVector4() && ok;
+	ok = CheckVector2x2() && ok;
+	ok = CheckTransforms() && ok;
+	ok = CheckTransformBatches() && ok;
+	ok = CheckPointTransforms() && ok;
+	ok = CheckAffineInverses() && ok;
+	ok = CheckSoAKernels() && ok;
+	ok = CheckTranscendentals() && ok;
+	ok = CheckHierarchy() && ok;
+	ok = CheckProjection() && ok;
+	ok = CheckCulling() && ok;
+	ok = CheckBounds() && ok;
+	ok = CheckRays() && ok;
+	ok = CheckBvh() && ok;
+	ok = CheckHashGrid() && ok;
+	ok = CheckKdTree() && ok;
+	ok = CheckPairwise() && ok;
+	ok = CheckMatrix4() && ok;
+	ok = CheckInverses() && ok;
+	ok = CheckMat4Batch() && ok;
+	ok = CheckParallel() && ok;
+	return ok ? 0 : 1;
 }
\ No newline at end of file